@@ -0,0 +1,61 @@
+#ifndef ALSAAUDIOSINK_H
+#define ALSAAUDIOSINK_H
+
+#include "AudioSink.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Saída para placa de som via ALSA (Linux)
+ *
+ * Esta classe demonstra:
+ * - Polimorfismo: Mesma interface das saídas de arquivo e descarte; a engine não muda
+ * - Compilação condicional: Só fala com o ALSA quando o build encontra a biblioteca
+ *   (MP3PLAYER_HAVE_ALSA); sem ela open() falha e isAvailable() retorna false
+ * - Tempo real: write() bloqueia até o dispositivo ter espaço, o que dá o ritmo da
+ *   reprodução; underruns (xruns) são recuperados e contados
+ *
+ * Pede float32 intercalado ao dispositivo e cai para int16 se ele não aceitar. A latência
+ * reportada vem de snd_pcm_delay() após cada escrita (quadros ainda não tocados).
+ */
+class AlsaAudioSink : public AudioSink {
+public:
+    static constexpr unsigned DEFAULT_LATENCY_US = 100000; // Buffer pedido ao dispositivo
+
+private:
+    std::string device;
+    unsigned requestedLatencyUs;
+    void* pcm;                             // snd_pcm_t*, opaco para não expor o ALSA no header
+    bool floatSamples;
+    size_t periodFrames;
+    uint64_t xruns;
+    std::string lastError;
+    std::vector<int16_t> conversionBuffer;
+
+public:
+    explicit AlsaAudioSink(const std::string& deviceName = "default",
+                           unsigned latencyUs = DEFAULT_LATENCY_US);
+    ~AlsaAudioSink() override;
+
+    AlsaAudioSink(const AlsaAudioSink&) = delete;
+    AlsaAudioSink& operator=(const AlsaAudioSink&) = delete;
+
+    bool open(int rate, int channelCount) override;
+    void close() override;
+    bool isOpen() const override { return pcm != nullptr; }
+    size_t write(const float* interleaved, size_t frames) override;
+    std::string getName() const override { return "alsa:" + device; }
+    bool isRealtime() const override { return true; }
+
+    const std::string& getDevice() const { return device; }
+    size_t getPeriodFrames() const { return periodFrames; }
+    uint64_t getXrunCount() const { return xruns; }
+    // Motivo da última falha de open()/write() (mensagem do ALSA)
+    const std::string& getLastError() const { return lastError; }
+
+    // true quando o build foi feito com suporte a ALSA
+    static bool isAvailable();
+};
+
+#endif // ALSAAUDIOSINK_H
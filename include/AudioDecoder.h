@@ -0,0 +1,57 @@
+#ifndef AUDIODECODER_H
+#define AUDIODECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Interface abstrata para decodificadores de áudio em streaming
+ *
+ * Esta classe demonstra:
+ * - Abstração: Define o contrato comum para qualquer formato de áudio
+ * - Polimorfismo: Cada formato implementa sua própria decodificação
+ * - Tratamento de exceções: Falhas de abertura lançam DecoderException
+ *
+ * A saída é sempre PCM float intercalado (L R L R ...) na faixa [-1.0, 1.0].
+ * Um "quadro" (frame) corresponde a uma amostra de cada canal.
+ */
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() = default;
+
+    // Ciclo de vida do stream
+    virtual void open(const std::string& filePath) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Decodifica até maxFrames quadros em out; retorna 0 no fim do stream
+    virtual size_t decode(float* out, size_t maxFrames) = 0;
+
+    // Posicionamento em quadros desde o início do stream
+    virtual bool seek(uint64_t frame) = 0;
+    virtual uint64_t getPosition() const = 0;
+
+    // Propriedades do stream aberto
+    virtual int getSampleRate() const = 0;
+    virtual int getChannels() const = 0;
+    virtual uint64_t getTotalFrames() const = 0; // 0 quando desconhecido
+    virtual std::string getFormatName() const = 0;
+
+    // Método factory: escolhe o decodificador pela extensão do arquivo
+    static std::unique_ptr<AudioDecoder> createForFile(const std::string& filePath);
+    static bool hasDecoderFor(const std::string& format);
+
+    // Classe de exceção para erros de decodificação
+    class DecoderException : public std::exception {
+    private:
+        std::string message;
+    public:
+        explicit DecoderException(const std::string& msg) : message(msg) {}
+        const char* what() const noexcept override { return message.c_str(); }
+    };
+};
+
+#endif // AUDIODECODER_H
@@ -0,0 +1,224 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include "AudioDecoder.h"
+#include "AudioSink.h"
+#include "Crossfader.h"
+#include "MpscQueue.h"
+#include "PcmRingBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Engine de reprodução: thread de decodificação -> buffer circular -> thread de saída
+ *
+ * Esta classe demonstra:
+ * - Composição: Possui o decodificador, o buffer PCM e a saída de áudio
+ * - Concorrência: Produtor (decodificação) e consumidor (saída) ligados por um
+ *   PcmRingBuffer lock-free; a thread de saída não toma locks nem aloca
+ * - Extensibilidade: Hook de processamento (equalizador, volume, ...) na thread de saída
+ * - Eventos assíncronos: a thread da aplicação os retira em lote com drainEvents() (nenhum
+ *   callback roda nas threads de áudio). Só os erros passam pela MpscQueue lock-free; trocas
+ *   de fonte e fim do stream são reconstruídos do estado da engine (contador de trocas e flag
+ *   de fim) e a posição fica num único slot atômico com a mais recente, publicada no máximo
+ *   setPositionUpdateRate() vezes por segundo. Sem ninguém drenando, nada disso se perde nem
+ *   ocupa a fila
+ * - Reprodução sem lacunas: Perto do fim da fonte atual (LOOKAHEAD_SECONDS) a thread de
+ *   decodificação pede a próxima ao SourceProvider, abre-a e pré-decodifica um bloco; no fim
+ *   exato da atual a próxima continua no mesmo ponto do buffer circular, e a thread de saída
+ *   publica TRACK_CHANGED e zera a posição na amostra em que a nova fonte começa a tocar.
+ *   Custo limitado: no máximo uma fronteira pendente, três decodificadores abertos e um
+ *   bloco pré-decodificado
+ * - Crossfade: Com setCrossfade(), os últimos segundos da fonte atual são decodificados junto
+ *   com o início da próxima e misturados pelo Crossfader na thread de decodificação; a
+ *   fronteira (TRACK_CHANGED) fica no início do fade. A memória extra é um bloco e não
+ *   depende da duração do fade
+ */
+class AudioEngine {
+public:
+    // Processamento in-place de um bloco float intercalado
+    using Processor = std::function<void(float* interleaved, size_t frames, int channels)>;
+    // Próxima fonte (nullptr = nenhuma); chamado na thread de decodificação. Fontes com taxa
+    // ou canais diferentes dos da reprodução atual são descartadas e o stream termina
+    using SourceProvider = std::function<std::unique_ptr<AudioDecoder>()>;
+
+    static constexpr size_t BLOCK_FRAMES = 1024;          // Quadros por chamada ao decodificador
+    static constexpr size_t PERIOD_FRAMES = 1024;         // Quadros por escrita no sink
+    static constexpr size_t DEFAULT_BUFFER_FRAMES = 8192; // Capacidade padrão do buffer circular
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 256;
+    static constexpr double DEFAULT_POSITION_UPDATE_HZ = 10.0;
+    static constexpr double LOOKAHEAD_SECONDS = 5.0;      // Antecedência da abertura da próxima fonte
+
+    // Evento para a thread da aplicação; trivialmente copiável (mensagem em array fixo) para
+    // que publicar não aloque
+    struct Event {
+        enum class Type {
+            POSITION,       // seconds = posição mais recente entregue à saída (coalescida)
+            FINISHED,       // Fim do stream tocado; seconds = posição final
+            ERROR_MESSAGE,  // message = descrição (truncada em MESSAGE_CAPACITY - 1)
+            TRACK_CHANGED   // A saída começou a tocar a fonte do SourceProvider; seconds = 0
+        };
+        static constexpr size_t MESSAGE_CAPACITY = 128;
+
+        Type type = Type::POSITION;
+        double seconds = 0.0;
+        char message[MESSAGE_CAPACITY] = {};
+
+        static Event position(double seconds);
+        static Event finished(double seconds);
+        static Event error(const std::string& text);
+        static Event trackChanged();
+    };
+
+    // Métricas de desempenho da reprodução atual
+    struct Statistics {
+        uint64_t framesDecoded = 0;
+        double audioSeconds = 0.0;          // Duração do áudio decodificado
+        double decodeSeconds = 0.0;         // Tempo de parede gasto dentro do decodificador
+        double decodeSpeedFactor = 0.0;     // audioSeconds / decodeSeconds (x tempo real)
+        double timeToFirstSampleMs = -1.0;  // De start() até o primeiro bloco no sink (-1 = ainda não)
+        size_t bufferCapacityFrames = 0;
+        size_t bufferFillFrames = 0;
+        size_t bufferPeakFrames = 0;
+        uint64_t underruns = 0;             // Períodos preenchidos com silêncio por falta de dados
+        size_t sinkBufferFrames = 0;        // Buffer da saída (dispositivo/pipe), além do ring buffer
+        double outputLatencyMs = 0.0;       // Latência medida pela saída na última escrita
+        uint64_t realtimeViolations = 0;    // Alocações/bloqueios no processamento (build RT_GUARD)
+        uint64_t eventsDropped = 0;         // Erros perdidos com a fila cheia (ninguém drenando)
+        uint64_t positionUpdates = 0;       // Posições publicadas pela thread de saída
+        uint64_t trackTransitions = 0;      // Trocas sem lacuna para a fonte seguinte
+        double lookaheadMs = -1.0;          // Abertura + pré-decodificação da última próxima fonte
+    };
+
+private:
+    std::unique_ptr<AudioSink> sink;
+    std::unique_ptr<AudioDecoder> decoder;
+    std::unique_ptr<PcmRingBuffer> ringBuffer;
+    Processor processor;
+    size_t bufferFrames;
+    SourceProvider nextSourceProvider;
+    std::mutex providerMutex;              // setNextSourceProvider() x thread de decodificação
+
+    std::thread decodeThread;
+    std::thread outputThread;
+    std::mutex pauseMutex;                 // Usado apenas para dormir durante a pausa
+    std::condition_variable pauseChanged;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> paused;
+    std::atomic<bool> decoderFinished;
+    std::atomic<bool> running;
+    std::atomic<bool> finished;
+
+    std::atomic<uint64_t> framesRendered;
+    std::atomic<int64_t> pendingSeekFrame;  // -1 = nenhum seek pendente
+    std::atomic<uint64_t> positionBase;     // Posição do decodificador após o último seek
+    std::atomic<uint32_t> seekSerial;       // Incrementado pelo produtor a cada seek concluído
+    std::atomic<uint32_t> renderedSerial;   // Último seek já observado pela thread de saída
+    std::atomic<uint64_t> underruns;
+    static constexpr uint64_t NO_BOUNDARY = ~uint64_t(0);
+    // Quadros do stream (contados desde o último seek) antes da próxima fonte; quem trocar o
+    // valor por NO_BOUNDARY decide: a saída ao cruzá-la, a decodificação ao desfazê-la num seek
+    std::atomic<uint64_t> trackBoundary;
+    std::atomic<uint64_t> trackTransitions;
+    uint64_t sourceRequests;               // Chamadas ao provider (thread de decodificação)
+    std::atomic<uint64_t> boundarySource;  // Chamada que abriu a fonte além de trackBoundary
+    std::atomic<uint64_t> playingSource;   // Idem, da fonte que a saída está tocando
+    std::atomic<double> finishedSeconds;   // Posição final; escrita antes de finished
+    std::atomic<double> crossfadeSeconds;  // 0 = troca sem lacuna, sem sobreposição
+    std::atomic<Crossfader::Curve> crossfadeCurve;
+    std::atomic<double> firstSampleLatencyMs;
+    uint64_t realtimeViolationBase;        // Contagem global do RealtimeGuard em start()
+
+    MpscQueue<Event> events;               // Só erros: o resto não depende da fila
+    // Posição mais recente: troca (16 bits baixos de trackTransitions) << 48 | microssegundos,
+    // para que uma posição da fonte anterior nunca chegue depois do seu TRACK_CHANGED
+    static constexpr unsigned POSITION_TRACK_SHIFT = 48;
+    std::atomic<uint64_t> positionSlot;
+    std::atomic<bool> positionPending;
+    std::atomic<uint64_t> positionUpdates;
+    uint64_t transitionsDelivered;         // Thread que consome (drainEvents)
+    bool finishedDelivered;                // Idem
+    double positionUpdateHz;               // Thread de controle
+    std::atomic<uint64_t> positionIntervalFrames; // Lido pela thread de saída (0 = sem eventos)
+    std::atomic<int> sampleRate;
+    std::atomic<int> channels;
+
+    mutable std::mutex statsMutex;
+    Statistics statistics;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::vector<float> decodeBuffer;       // Exclusivo da thread de decodificação
+    std::vector<float> lookaheadBuffer;    // Início pré-decodificado da próxima fonte (idem)
+    std::vector<float> incomingBuffer;     // Bloco da fonte que entra durante o crossfade (idem)
+    Crossfader crossfader;                 // Idem
+    std::vector<float> outputBuffer;       // Exclusivo da thread de saída
+
+    void decodeLoop();
+    std::unique_ptr<AudioDecoder> openNextSource(size_t& headFrames);
+    void outputLoop();
+    void joinThreads();
+
+public:
+    explicit AudioEngine(std::unique_ptr<AudioSink> outputSink);
+    ~AudioEngine();
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // Configuração (a troca de sink interrompe a reprodução atual)
+    void setSink(std::unique_ptr<AudioSink> outputSink);
+    AudioSink* getSink() const { return sink.get(); }
+    void setProcessor(Processor blockProcessor);
+    // Fonte seguinte para a reprodução sem lacunas (nullptr desativa); vale imediatamente
+    void setNextSourceProvider(SourceProvider provider);
+    // Sobreposição entre fontes consecutivas (até Crossfader::MAX_SECONDS; limitada à metade
+    // da fonte mais curta); vale a partir da próxima troca
+    void setCrossfade(double seconds, Crossfader::Curve curve = Crossfader::Curve::EQUAL_POWER);
+    double getCrossfadeSeconds() const { return crossfadeSeconds.load(); }
+    Crossfader::Curve getCrossfadeCurve() const { return crossfadeCurve.load(); }
+    // Capacidade do buffer circular em quadros; vale a partir do próximo start()
+    void setBufferFrames(size_t frames);
+    size_t getBufferFrames() const { return bufferFrames; }
+
+    // Controle de reprodução
+    bool start(std::unique_ptr<AudioDecoder> source);
+    void pause();
+    void resume();
+    void stop();
+    // Assíncrono: a thread de decodificação reposiciona o stream e esvazia o buffer
+    bool seek(double seconds);
+
+    // Bloqueia até o fim do stream (ou parada); útil para renderização e benchmarks
+    void waitUntilFinished();
+
+    // Estado
+    bool isRunning() const { return running.load(); }
+    bool isFinished() const { return finished.load(); }
+    bool isPaused() const { return paused.load(); }
+    // Fonte que a saída toca agora: 0 = a de start(), n = a devolvida pela n-ésima chamada ao
+    // SourceProvider desde start() (contando as descartadas). Não depende da entrega de eventos
+    uint64_t getPlayingSource() const { return playingSource.load(std::memory_order_acquire); }
+    double getPositionSeconds() const;
+    int getSampleRate() const { return sampleRate.load(); }
+    int getChannels() const { return channels.load(); }
+    Statistics getStatistics() const;
+
+    // Eventos: postEvent() enfileira erros em qualquer thread (false com a fila cheia);
+    // publishPosition() substitui a posição pendente. drainEvents() só na thread que consome,
+    // retirando até maxEvents de uma vez: erros, trocas de fonte, fim e por último a posição
+    bool postEvent(const Event& event) { return events.push(event); }
+    void publishPosition(double seconds);
+    size_t drainEvents(Event* output, size_t maxEvents);
+    // Publicações de posição por segundo (0 = nenhuma); vale imediatamente
+    void setPositionUpdateRate(double hz);
+    double getPositionUpdateRate() const { return positionUpdateHz; }
+};
+
+#endif // AUDIOENGINE_H
@@ -0,0 +1,182 @@
+#ifndef AUDIOSINK_H
+#define AUDIOSINK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Interface abstrata para destinos de PCM (dispositivo, arquivo, descarte)
+ *
+ * Esta classe demonstra:
+ * - Abstração: A engine de áudio não conhece o destino concreto das amostras
+ * - Polimorfismo: Cada saída implementa open/write/close
+ * - Encapsulamento: Formato do stream guardado na classe base
+ * - Factory Method: createFromSpec() escolhe a saída a partir de um texto ("alsa:hw:0",
+ *   "wav:saida.wav", "stdout:f32", "null") vindo da linha de comando
+ *
+ * Cada saída informa o tamanho do seu buffer e a latência medida na última escrita
+ * (quadros entregues que ainda não foram ouvidos/consumidos).
+ */
+class AudioSink {
+protected:
+    int sampleRate;
+    int channels;
+    size_t bufferFrames;                   // Definido em open(); 0 = sem buffer próprio
+    std::atomic<uint64_t> latencyFrames;   // Atualizado por write(), lido por qualquer thread
+
+    void reportLatency(uint64_t frames) { latencyFrames.store(frames, std::memory_order_relaxed); }
+
+public:
+    AudioSink() : sampleRate(0), channels(0), bufferFrames(0), latencyFrames(0) {}
+    virtual ~AudioSink() = default;
+
+    // Ciclo de vida da saída
+    virtual bool open(int rate, int channelCount) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Escreve quadros PCM float intercalados; pode bloquear (saídas de tempo real)
+    virtual size_t write(const float* interleaved, size_t frames) = 0;
+
+    virtual std::string getName() const = 0;
+
+    // Saídas de tempo real consomem no ritmo do relógio (underrun vira silêncio);
+    // as demais esperam pelo produtor
+    virtual bool isRealtime() const { return false; }
+
+    // O consumidor deixou de ler (pipe fechado): write() passa a retornar 0 para sempre
+    virtual bool isConsumerClosed() const { return false; }
+
+    int getSampleRate() const { return sampleRate; }
+    int getChannels() const { return channels; }
+
+    // Capacidade do buffer da saída (dispositivo, pipe ou simulado)
+    size_t getBufferFrames() const { return bufferFrames; }
+    // Latência medida na última escrita, em quadros e em milissegundos
+    uint64_t getLatencyFrames() const { return latencyFrames.load(std::memory_order_relaxed); }
+    double getLatencyMs() const {
+        return sampleRate > 0 ? static_cast<double>(getLatencyFrames()) * 1000.0 / sampleRate : 0.0;
+    }
+
+    // "alsa[:dispositivo]", "null[:paced]", "wav:arquivo[:f32]", "stdout[:s16|f32]" ou um
+    // caminho terminado em .wav; nullptr para especificações inválidas ou indisponíveis
+    static std::unique_ptr<AudioSink> createFromSpec(const std::string& spec);
+    // Especificações aceitas por createFromSpec neste build (com descrição)
+    static std::vector<std::pair<std::string, std::string>> getAvailableSinks();
+};
+
+/**
+ * @brief Saída que descarta as amostras, opcionalmente no ritmo do relógio
+ *
+ * Sem ritmo (padrão) serve para benchmarks; com ritmo simula um dispositivo
+ * real para testes sem hardware de áudio. O buffer simulado faz write() retornar
+ * assim que houver espaço, como um dispositivo de verdade (latência = quadros na fila).
+ */
+class NullAudioSink : public AudioSink {
+private:
+    bool realtimePacing;
+    size_t simulatedBufferFrames;
+    bool opened;
+    uint64_t framesWritten;
+    std::chrono::steady_clock::time_point startTime;
+
+public:
+    explicit NullAudioSink(bool pacing = false, size_t simulatedBuffer = 0);
+    ~NullAudioSink() override = default;
+
+    bool open(int rate, int channelCount) override;
+    void close() override;
+    bool isOpen() const override { return opened; }
+    size_t write(const float* interleaved, size_t frames) override;
+    std::string getName() const override { return "null"; }
+    bool isRealtime() const override { return realtimePacing; }
+
+    uint64_t getFramesWritten() const { return framesWritten; }
+};
+
+/**
+ * @brief Saída que grava o PCM em um arquivo WAV (RIFF)
+ *
+ * O cabeçalho é reescrito no close() com os tamanhos finais.
+ */
+class WavFileSink : public AudioSink {
+public:
+    enum class SampleFormat {
+        INT16,    // PCM 16 bits com saturação
+        FLOAT32   // IEEE float de 32 bits (sem perdas em relação ao pipeline)
+    };
+
+private:
+    std::string filePath;
+    SampleFormat format;
+    std::FILE* file;
+    uint64_t dataBytes;
+    std::vector<int16_t> conversionBuffer;
+
+    void writeHeader();
+
+public:
+    explicit WavFileSink(const std::string& path, SampleFormat sampleFormat = SampleFormat::INT16);
+    ~WavFileSink() override;
+
+    WavFileSink(const WavFileSink&) = delete;
+    WavFileSink& operator=(const WavFileSink&) = delete;
+
+    bool open(int rate, int channelCount) override;
+    void close() override;
+    bool isOpen() const override { return file != nullptr; }
+    size_t write(const float* interleaved, size_t frames) override;
+    std::string getName() const override { return "wav:" + filePath; }
+
+    const std::string& getFilePath() const { return filePath; }
+};
+
+/**
+ * @brief Saída de PCM cru (sem cabeçalho) na saída padrão, para encadear com outros programas
+ *
+ * Uso típico: mp3player --sink stdout | aplay -f S16_LE -c 2 -r 44100. O descritor é
+ * duplicado na construção, de modo que a aplicação pode redirecionar o stdout original
+ * (mensagens) para o stderr sem misturar texto ao áudio. A escrita bloqueia quando o
+ * consumidor não acompanha; o buffer reportado é a capacidade do pipe e a latência é
+ * medida pelos bytes ainda não lidos do outro lado.
+ */
+class StdoutAudioSink : public AudioSink {
+public:
+    using SampleFormat = WavFileSink::SampleFormat;
+
+private:
+    SampleFormat format;
+    int descriptor;                        // Cópia do stdout original (-1 = indisponível)
+    bool opened;
+    std::atomic<bool> consumerClosed;      // EPIPE: o leitor do pipe saiu
+    std::vector<int16_t> conversionBuffer;
+
+    size_t writeBytes(const void* data, size_t bytes);
+
+public:
+    explicit StdoutAudioSink(SampleFormat sampleFormat = SampleFormat::INT16);
+    ~StdoutAudioSink() override;
+
+    StdoutAudioSink(const StdoutAudioSink&) = delete;
+    StdoutAudioSink& operator=(const StdoutAudioSink&) = delete;
+
+    bool open(int rate, int channelCount) override;
+    void close() override;
+    bool isOpen() const override { return opened; }
+    size_t write(const float* interleaved, size_t frames) override;
+    bool isConsumerClosed() const override { return consumerClosed.load(std::memory_order_relaxed); }
+    std::string getName() const override {
+        return format == SampleFormat::INT16 ? "stdout:s16" : "stdout:f32";
+    }
+
+    SampleFormat getFormat() const { return format; }
+};
+
+#endif // AUDIOSINK_H
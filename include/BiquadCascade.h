@@ -0,0 +1,101 @@
+#ifndef BIQUADCASCADE_H
+#define BIQUADCASCADE_H
+
+#include "CpuFeatures.h"
+#include <array>
+#include <cstddef>
+
+// Coeficientes normalizados (a0 = 1) de uma seção biquad
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    bool isIdentity() const { return b0 == 1.0f && b1 == 0.0f && b2 == 0.0f && a1 == 0.0f && a2 == 0.0f; }
+    // Módulo da resposta em frequência, em dB
+    double magnitudeDb(double sampleRate, double frequency) const;
+
+    // Projetos do "Audio EQ Cookbook" (RBJ); ganho 0 dB devolve a identidade exata
+    static BiquadCoefficients lowShelf(double sampleRate, double frequency, double gainDb, double slope = 1.0);
+    static BiquadCoefficients highShelf(double sampleRate, double frequency, double gainDb, double slope = 1.0);
+    static BiquadCoefficients peaking(double sampleRate, double frequency, double gainDb, double q);
+};
+
+/**
+ * @brief Cascata de Sections filtros biquad (forma direta II transposta) sobre PCM float intercalado
+ *
+ * Esta classe demonstra:
+ * - Templates: O número de seções é constante de compilação; os laços sobre seções e
+ *   grupos de lanes são desenrolados e o armazenamento é todo em std::array
+ * - Desempenho: Kernels SSE2/AVX2 que ocupam as lanes com pares (seção, canal); cada
+ *   seção processa a amostra t - s enquanto a seção anterior processa a amostra t
+ *   (pipeline), e o kernel escalar serve de referência com a mesma ordem de operações
+ * - Tempo real: Nenhuma alocação; process() só toca memória do próprio objeto
+ *
+ * O estado de cada seção/canal persiste entre blocos, portanto o resultado não depende
+ * do tamanho dos blocos nem do kernel escolhido. Instanciada em BiquadCascade.cpp para
+ * 2 seções (ponderação K da medição de loudness) e 3, 10 e 31 (tamanhos do equalizador).
+ *
+ * Abaixo do ponto de equilíbrio medido o kernel vetorial perde para o escalar (o pipeline
+ * de seções não chega a encher as lanes), e process() usa o escalar: SSE2 com menos de
+ * SSE2_MIN_SECTIONS seções ou mais de 4 canais, AVX2 com 5 a 7 canais (grupos parciais).
+ */
+template <size_t Sections>
+class BiquadCascade {
+public:
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr size_t SECTIONS = Sections;
+    static constexpr size_t SSE2_MIN_SECTIONS = 4;
+    using Coefficients = BiquadCoefficients;
+
+private:
+    // Uma leitura AVX2 completa a partir da última lane válida não sai do array
+    static constexpr size_t LANE_COUNT = Sections * MAX_CHANNELS + 8;
+    using LaneArray = std::array<float, LANE_COUNT>;
+
+    std::array<Coefficients, Sections> sections;
+
+    // Layout por lane: índice seção * canais + canal, com folga zerada para leituras vetoriais
+    alignas(32) LaneArray laneB0;
+    alignas(32) LaneArray laneB1;
+    alignas(32) LaneArray laneB2;
+    alignas(32) LaneArray laneA1;
+    alignas(32) LaneArray laneA2;
+    alignas(32) LaneArray stateZ1;
+    alignas(32) LaneArray stateZ2;
+    int preparedChannels;   // Canais para os quais o layout por lane foi montado
+    bool coefficientsDirty;
+
+    void prepareLanes(int channels);
+    void flushDenormals(int channels);
+
+    void runScalar(float* interleaved, size_t frames, int channels);
+    void runSse2(float* interleaved, size_t frames, int channels);
+    void runAvx2(float* interleaved, size_t frames, int channels);
+
+public:
+    BiquadCascade();
+
+    static constexpr size_t getSectionCount() { return Sections; }
+    // Kernel que process() de fato usa para o nível pedido (escalar abaixo do ponto de equilíbrio)
+    static CpuFeatures::SimdLevel getKernelLevel(int channels, CpuFeatures::SimdLevel level);
+    void setSection(size_t index, const Coefficients& coefficients);
+    const Coefficients& getSection(size_t index) const { return sections[index]; }
+
+    // Zera o estado (histórico) de todas as seções
+    void reset();
+
+    // Filtra in-place; blocos com mais de MAX_CHANNELS canais passam inalterados
+    void process(float* interleaved, size_t frames, int channels);
+    // Mesmo processamento com um kernel específico (testes e benchmark)
+    void process(float* interleaved, size_t frames, int channels, CpuFeatures::SimdLevel level);
+};
+
+extern template class BiquadCascade<2>;
+extern template class BiquadCascade<3>;
+extern template class BiquadCascade<10>;
+extern template class BiquadCascade<31>;
+
+#endif // BIQUADCASCADE_H
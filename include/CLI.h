@@ -44,7 +44,9 @@ private:
 
     void initializeCommands();
     void displayWelcome();
+    void displayGoodbye();
     void displayHelp();
+    void displayCommandHelp(const std::string& command);
     void displayStatus();
     
     // Implementações de comandos
@@ -58,11 +60,18 @@ private:
     void cmdPlaylist(const std::vector<std::string>& args);
     void cmdLoad(const std::vector<std::string>& args);
     void cmdSave(const std::vector<std::string>& args);
+    void cmdRender(const std::vector<std::string>& args);
     void cmdAdd(const std::vector<std::string>& args);
+    void cmdRemove(const std::vector<std::string>& args);
     void cmdScan(const std::vector<std::string>& args);
+    void cmdSearch(const std::vector<std::string>& args);
     void cmdList(const std::vector<std::string>& args);
     void cmdEqualizer(const std::vector<std::string>& args);
+    void cmdCrossfade(const std::vector<std::string>& args);
+    void cmdWaveform(const std::vector<std::string>& args);
+    void cmdSpectrum(const std::vector<std::string>& args);
     void cmdStatus(const std::vector<std::string>& args);
+    void cmdCurrent(const std::vector<std::string>& args);
     void cmdHelp(const std::vector<std::string>& args);
     void cmdQuit(const std::vector<std::string>& args);
 
@@ -78,7 +87,7 @@ public:
     explicit CLI(std::unique_ptr<MP3PlayerApp> application);
     ~CLI() = default;
 
-    // Interface principal
+    // Interface principal: lê comandos até 'quit' ou o fim da entrada
     void run();
     void processCommand(const std::string& commandLine);
     void shutdown();
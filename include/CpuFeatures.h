@@ -0,0 +1,59 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <string>
+
+// Arquitetura alvo e atributos para compilar funções com extensões específicas
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MP3PLAYER_ARCH_X86 1
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define MP3PLAYER_ARCH_NEON 1
+#endif
+
+#if defined(MP3PLAYER_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MP3PLAYER_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define MP3PLAYER_TARGET_AVX2 __attribute__((target("avx2")))
+#define MP3PLAYER_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#else
+// MSVC aceita intrínsecos de qualquer extensão sem atributo por função
+#define MP3PLAYER_TARGET_SSE41
+#define MP3PLAYER_TARGET_AVX2
+#define MP3PLAYER_TARGET_AVX2_FMA
+#endif
+
+/**
+ * @brief Detecção, em tempo de execução, das extensões SIMD da CPU
+ *
+ * Esta classe demonstra:
+ * - Despacho dinâmico: Um único binário escolhe a melhor implementação disponível
+ * - Singleton imutável: A detecção roda uma vez; consultas são leituras simples
+ * - Testabilidade: O nível pode ser rebaixado (variável MP3PLAYER_SIMD ou
+ *   setSimdLevelOverride) para comparar caminhos vetoriais com o escalar
+ */
+class CpuFeatures {
+public:
+    // Níveis em ordem crescente de capacidade (NEON é independente de x86)
+    enum class SimdLevel { Scalar = 0, SSE2 = 1, AVX2 = 2, NEON = 3 };
+
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool neon = false;
+
+    static const CpuFeatures& get();
+
+    // Melhor nível suportado, respeitando a sobreposição configurada
+    static SimdLevel getSimdLevel();
+    static SimdLevel getDetectedSimdLevel();
+    static bool isSupported(SimdLevel level);
+    // Rebaixa o nível usado pelo despacho; níveis não suportados são ignorados
+    static void setSimdLevelOverride(SimdLevel level);
+    static void clearSimdLevelOverride();
+
+    static std::string getSimdLevelName(SimdLevel level);
+    std::string describe() const;
+};
+
+#endif // CPUFEATURES_H
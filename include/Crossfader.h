@@ -0,0 +1,71 @@
+#ifndef CROSSFADER_H
+#define CROSSFADER_H
+
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Crossfade entre a fonte que sai e a que entra, bloco a bloco
+ *
+ * Esta classe demonstra:
+ * - Processamento de sinais: Curva linear (1 - t, t: amplitude constante, boa para material
+ *   correlacionado) ou de potência constante (cos, sen de t * pi/2: energia constante, boa
+ *   para faixas independentes)
+ * - Desempenho: A mistura saída * g_saída + entrada * g_entrada usa kernels SSE2/AVX2 com
+ *   despacho por CpuFeatures; a mesma ordem de operações (sem FMA) mantém o resultado
+ *   idêntico ao escalar, bit a bit
+ * - Memória limitada: Os ganhos são calculados por bloco em buffers alocados em prepare();
+ *   nada depende da duração do fade nem das faixas
+ *
+ * O ganho de cada quadro depende só da sua posição no fade, então o resultado não muda com
+ * o tamanho dos blocos. Contrato de threads: uma única thread (a de decodificação da
+ * AudioEngine) usa o objeto.
+ */
+class Crossfader {
+public:
+    enum class Curve { LINEAR = 0, EQUAL_POWER = 1 };
+
+    static constexpr double MAX_SECONDS = 30.0;
+
+private:
+    Curve curve;
+    uint64_t length;                  // Quadros do fade atual
+    uint64_t position;                // Quadros já misturados
+    size_t maxFrames;
+    std::vector<float> gainOut;       // Por amostra (quadro x canal) do bloco atual
+    std::vector<float> gainIn;
+
+    void computeGains(size_t frames, int channels);
+
+public:
+    Crossfader();
+
+    // Buffers para blocos de até frames quadros com channels canais (única alocação)
+    void prepare(size_t frames, int channels);
+    // Começa um fade de fadeFrames quadros; não aloca
+    void begin(Curve fadeCurve, uint64_t fadeFrames);
+    void reset();
+
+    // outgoing = outgoing * g_saída + incoming * g_entrada para até getRemaining() quadros;
+    // retorna quantos quadros foram misturados
+    size_t process(float* outgoing, const float* incoming, size_t frames, int channels);
+    size_t process(float* outgoing, const float* incoming, size_t frames, int channels,
+                   CpuFeatures::SimdLevel level);
+
+    bool isActive() const { return position < length; }
+    uint64_t getLength() const { return length; }
+    uint64_t getPosition() const { return position; }
+    uint64_t getRemaining() const { return length - position; }
+    Curve getCurve() const { return curve; }
+
+    // Ganhos da curva em t (0 = início do fade, 1 = fim)
+    static void getGains(Curve curve, double t, float& outgoing, float& incoming);
+    static std::string getCurveName(Curve curve);
+    // "linear" ou "potencia"/"equal-power"; false se o nome não for reconhecido
+    static bool parseCurve(const std::string& name, Curve& curve);
+};
+
+#endif // CROSSFADER_H
@@ -73,7 +73,7 @@ using CustomMediaScanner = DirectoryScanner<std::function<bool(const std::string
 
 // Funções factory para configurações comuns
 std::unique_ptr<MediaScanner> createMP3Scanner();
-std::unique_ptr<MediaScanner> createAudioScanner(); // MP3, WAV, OGG
+std::unique_ptr<MediaScanner> createAudioScanner(); // MP3, WAV, OGG, FLAC
 std::unique_ptr<CustomMediaScanner> createCustomScanner(
     const std::set<std::string>& extensions,
     std::function<bool(const std::string&)> filter
@@ -0,0 +1,57 @@
+#ifndef DURATIONSCANNER_H
+#define DURATIONSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Cálculo exato da duração de arquivos de áudio sem decodificá-los
+ *
+ * Esta classe demonstra:
+ * - Parsing binário: Cabeçalhos MPEG, chunks RIFF, páginas Ogg e blocos de metadados FLAC
+ *   lidos direto da memória mapeada
+ * - Desempenho: Busca vetorizada (SSE2/AVX2) do padrão de sincronismo 0xFFE entre quadros
+ *   e saltos de quadro em quadro; só as páginas tocadas são lidas do disco
+ * - Atalhos: Cabeçalho Xing/Info/VBRI encerra a varredura MP3 no primeiro quadro;
+ *   WAV usa o chunk "data", Ogg a posição de granule da última página e FLAC o STREAMINFO
+ *
+ * A varredura MP3 aplica as mesmas regras de sincronismo do Mp3Decoder e desconta o atraso
+ * e o preenchimento da extensão LAME, portanto a contagem coincide com o número de quadros
+ * PCM que a decodificação produz.
+ */
+class DurationScanner {
+public:
+    // Origem da informação de duração
+    enum class Method { None, XingHeader, VbriHeader, FrameScan, RiffHeader, OggGranule, FlacStreamInfo };
+
+    struct Result {
+        std::string format;            // "MP3", "WAV", "OGG" ou "FLAC"
+        Method method = Method::None;
+        int sampleRate = 0;
+        int channels = 0;
+        uint64_t totalFrames = 0;      // Quadros PCM (amostras por canal)
+        uint64_t bytesScanned = 0;     // Bytes efetivamente percorridos
+
+        double getSeconds() const {
+            return sampleRate > 0 ? static_cast<double>(totalFrames) / sampleRate : 0.0;
+        }
+    };
+
+    // Detecta o formato pelo conteúdo (não pela extensão)
+    static bool scanFile(const std::string& path, Result& result);
+
+    // Variantes sobre memória, usadas por scanFile
+    static bool scanMp3(const uint8_t* data, size_t size, Result& result);
+    static bool scanWav(const uint8_t* data, size_t size, Result& result);
+    static bool scanOgg(const uint8_t* data, size_t size, Result& result);
+    static bool scanFlac(const uint8_t* data, size_t size, Result& result);
+
+    // Primeira posição i >= from com data[i] == 0xFF e (data[i+1] & 0xE0) == 0xE0,
+    // ou size se não houver; usa o nível SIMD de CpuFeatures
+    static size_t findFrameSync(const uint8_t* data, size_t from, size_t size);
+
+    static std::string getMethodName(Method method);
+};
+
+#endif // DURATIONSCANNER_H
@@ -1,65 +1,135 @@
 #ifndef EQUALIZER_H
 #define EQUALIZER_H
 
+#include "BiquadCascade.h"
+#include "TripleBuffer.h"
 #include <array>
 #include <string>
 #include <memory>
 #include <map>
+#include <type_traits>
 #include <vector>
 
 /**
- * @brief Equalizador de 3 bandas para processamento de áudio
+ * @brief Equalizador de N bandas para processamento de áudio
  * 
  * Esta classe demonstra:
  * - Composição: Será composta no MP3Player
  * - Encapsulamento: Controles de banda privados com interface pública
- * - Templates e STL: Usa std::array, std::map
+ * - Templates e STL: Número de bandas como parâmetro de template; std::array, std::map
  * - Classes e Objetos: Representa componente de áudio do mundo real
+ * - Processamento de sinais: Low-shelf, peakings e high-shelf em cascata (BiquadCascade<N>),
+ *   com kernels SIMD; desativado ou plano, process() retorna sem tocar nas amostras
+ *
+ * Instanciado para 3 (Equalizer), 10 (oitavas) e 31 (terços de oitava) bandas. Os presets
+ * são curvas de 3 pontos (graves/médios/agudos) interpoladas na frequência de cada banda,
+ * portanto valem para qualquer N.
+ *
+ * Contrato de threads: a thread de controle (setters, presets, setSampleRate) calcula os
+ * coeficientes e os publica em um TripleBuffer; process() roda na thread de áudio, adota o
+ * conjunto mais recente sem bloquear e interpola dos coeficientes atuais até ele ao longo
+ * de RAMP_FRAMES quadros, de modo que mudanças de preset e ativar/desativar não geram cliques.
  */
-class Equalizer {
+template <size_t N>
+class BasicEqualizer {
 public:
+    static_assert(N >= 2, "O equalizador precisa de ao menos duas bandas");
+
+    // Bandas nomeadas do equalizador de 3 bandas
     enum class Band {
         LOW = 0,    // Graves (20Hz - 250Hz)
         MID = 1,    // Médios (250Hz - 4kHz)
         HIGH = 2    // Agudos (4kHz - 20kHz)
     };
 
-    static constexpr size_t NUM_BANDS = 3;
+    static constexpr size_t NUM_BANDS = N;
     static constexpr double MIN_GAIN = -12.0; // dB
     static constexpr double MAX_GAIN = 12.0;  // dB
     static constexpr double DEFAULT_GAIN = 0.0;
+    static constexpr double DEFAULT_SAMPLE_RATE = 44100.0;
+
+    // Filtros do equalizador de 3 bandas; também são as âncoras das curvas de preset
+    static constexpr double LOW_SHELF_FREQUENCY = 250.0;
+    static constexpr double MID_PEAK_FREQUENCY = 1000.0;
+    static constexpr double MID_PEAK_Q = 0.7;
+    static constexpr double HIGH_SHELF_FREQUENCY = 4000.0;
+
+    // Transição entre conjuntos de coeficientes: duração total e passo de interpolação
+    static constexpr size_t RAMP_FRAMES = 1024;
+    static constexpr size_t RAMP_STEP_FRAMES = 16;
 
 private:
-    std::array<double, NUM_BANDS> bandGains;
+    // Conjunto de coeficientes publicado pela thread de controle
+    struct CoefficientSet {
+        std::array<BiquadCoefficients, N> sections;
+        bool identity = true;       // Todas as seções são identidade (equalizador transparente)
+        uint64_t resetSerial = 0;   // Mudou: descartar histórico e aplicar sem transição
+    };
+
+    // Estado da thread de controle
+    std::array<double, N> bandGains;
     std::string presetName;
     bool enabled;
-    
-    // Presets predefinidos
-    static const std::map<std::string, std::array<double, NUM_BANDS>> presets;
+    double sampleRate;
+    // Inversa da matriz de interação entre bandas vizinhas (N > 3): converte os ganhos
+    // pedidos nos ganhos dos filtros para que a resposta acerte cada frequência central
+    std::array<std::array<double, N>, N> gainCorrection;
+    bool flat;                // Todos os ganhos em 0 dB
+    uint64_t resetSerial;
+
+    TripleBuffer<CoefficientSet> coefficientExchange;
+
+    // Estado da thread de áudio
+    BiquadCascade<N> filters; // Uma seção por banda, da mais grave para a mais aguda
+    std::array<BiquadCoefficients, N> rampStart;
+    size_t rampPosition;      // Quadros já percorridos da transição (RAMP_FRAMES = concluída)
+    uint64_t appliedResetSerial;
+    bool targetIdentity;
+    bool processing;          // O último bloco passou pelos filtros (estado válido)
+
+    // Presets predefinidos (graves, médios, agudos)
+    static const std::map<std::string, std::array<double, 3>> presets;
 
     void validateGain(double& gain);
+    void copySettings(const BasicEqualizer& other);
+    void updateFilters();
+    void updateGainCorrection();
+    BiquadCoefficients designBand(size_t band, double gainDb) const;
 
 public:
     // Construtores
-    Equalizer();
-    explicit Equalizer(double lowGain, double midGain, double highGain);
-    explicit Equalizer(const std::string& presetName);
-
-    // Semântica de cópia
-    Equalizer(const Equalizer& other) = default;
-    Equalizer& operator=(const Equalizer& other) = default;
-
-    // Semântica de movimento
-    Equalizer(Equalizer&& other) noexcept = default;
-    Equalizer& operator=(Equalizer&& other) noexcept = default;
+    BasicEqualizer();
+    explicit BasicEqualizer(const std::string& presetName);
+    template <size_t M = N, typename = std::enable_if_t<M == 3>>
+    explicit BasicEqualizer(double lowGain, double midGain, double highGain) : BasicEqualizer() {
+        setBands(lowGain, midGain, highGain);
+    }
+
+    // Semântica de cópia: transfere as configurações (ganhos, preset, ativo); taxa de
+    // amostragem e estado dos filtros pertencem ao destino, que faz a transição suave
+    BasicEqualizer(const BasicEqualizer& other);
+    BasicEqualizer& operator=(const BasicEqualizer& other);
+
+    // Semântica de movimento (equivalente à cópia: o estado publicado não é transferível)
+    BasicEqualizer(BasicEqualizer&& other) : BasicEqualizer(static_cast<const BasicEqualizer&>(other)) {}
+    BasicEqualizer& operator=(BasicEqualizer&& other) { return *this = static_cast<const BasicEqualizer&>(other); }
 
     // Destrutor
-    ~Equalizer() = default;
-
-    // Controle de bandas
-    void setBandGain(Band band, double gain);
-    double getBandGain(Band band) const;
-    void setBands(double lowGain, double midGain, double highGain);
+    ~BasicEqualizer() = default;
+
+    // Controle de bandas por índice (0 = mais grave)
+    void setBandGain(size_t band, double gain);
+    double getBandGain(size_t band) const;
+    void setGains(const std::array<double, N>& gains);
+    static double getBandFrequency(size_t band);
+
+    // Controle por banda nomeada (somente 3 bandas)
+    template <size_t M = N, typename = std::enable_if_t<M == 3>>
+    void setBandGain(Band band, double gain) { setBandGain(static_cast<size_t>(band), gain); }
+    template <size_t M = N, typename = std::enable_if_t<M == 3>>
+    double getBandGain(Band band) const { return getBandGain(static_cast<size_t>(band)); }
+    template <size_t M = N, typename = std::enable_if_t<M == 3>>
+    void setBands(double lowGain, double midGain, double highGain) { setGains({lowGain, midGain, highGain}); }
 
     // Gerenciamento de presets
     void applyPreset(const std::string& preset);
@@ -67,27 +137,44 @@ public:
     static std::vector<std::string> getAvailablePresets();
 
     // Controle global
-    void setEnabled(bool enable) { enabled = enable; }
+    void setEnabled(bool enable);
     bool isEnabled() const { return enabled; }
     void reset(); // Resetar todas as bandas para 0dB
 
+    // Processamento de áudio (in-place, float intercalado)
+    void setSampleRate(double rate);
+    double getSampleRate() const { return sampleRate; }
+    // Thread de áudio: nunca bloqueia nem aloca
+    void process(float* interleaved, size_t frames, int channels);
+    bool isBypassed() const { return !enabled || flat; }
+    // Pede à thread de áudio que descarte o histórico (novo stream); vale no próximo bloco
+    void resetState();
+
     // Métodos utilitários
-    std::array<double, NUM_BANDS> getAllGains() const { return bandGains; }
+    std::array<double, N> getAllGains() const { return bandGains; }
     std::string toString() const;
 
     // Sobrecarga de operadores para comparação fácil
-    bool operator==(const Equalizer& other) const;
-    bool operator!=(const Equalizer& other) const;
+    bool operator==(const BasicEqualizer& other) const;
+    bool operator!=(const BasicEqualizer& other) const;
 
     // Método factory para configurações comuns
-    static std::unique_ptr<Equalizer> createFlat();
-    static std::unique_ptr<Equalizer> createRock();
-    static std::unique_ptr<Equalizer> createJazz();
-    static std::unique_ptr<Equalizer> createClassical();
+    static std::unique_ptr<BasicEqualizer> createFlat();
+    static std::unique_ptr<BasicEqualizer> createRock();
+    static std::unique_ptr<BasicEqualizer> createJazz();
+    static std::unique_ptr<BasicEqualizer> createClassical();
 
 private:
-    void initializePresets();
     static std::string bandToString(Band band);
 };
 
-#endif // EQUALIZER_H
\ No newline at end of file
+extern template class BasicEqualizer<3>;
+extern template class BasicEqualizer<10>;
+extern template class BasicEqualizer<31>;
+
+// O equalizador do player continua sendo o de 3 bandas
+using Equalizer = BasicEqualizer<3>;
+using Equalizer10 = BasicEqualizer<10>;
+using Equalizer31 = BasicEqualizer<31>;
+
+#endif // EQUALIZER_H
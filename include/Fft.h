@@ -0,0 +1,70 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief FFT real de tamanho potência de 2 (radix-4 com um estágio radix-2 quando necessário)
+ *
+ * Esta classe demonstra:
+ * - Algoritmos: Stockham auto-ordenado (sem bit-reversal) sobre a FFT complexa de N/2
+ *   pontos, mais o pós-processamento que separa o espectro do sinal real
+ * - Desempenho: Formato complexo dividido (reais e imaginários em arrays separados), com
+ *   butterflies SSE2/AVX2 escolhidas em tempo de execução; a inversa reaproveita o mesmo
+ *   caminho trocando as partes real e imaginária
+ * - Tempo real: Tabelas e buffers alocados no construtor; forward()/inverse() não alocam
+ *
+ * O espectro tem getBinCount() = N/2 + 1 bins (0 .. Nyquist). inverse(forward(x)) == x,
+ * a escala 1/N é aplicada na inversa. Um objeto não deve ser usado por duas threads ao mesmo tempo.
+ */
+class Fft {
+public:
+    static constexpr size_t MIN_SIZE = 16;
+
+private:
+    // Estágio radix-4 de comprimento length sobre blocos de stride pontos
+    struct Stage {
+        size_t length;
+        size_t stride;
+        size_t twiddleOffset;   // w1, w2, w3 (real e imaginário) com length/4 pontos cada
+    };
+
+    size_t size;
+    size_t half;                // Pontos da FFT complexa interna
+    std::vector<Stage> stages;
+    bool finalRadix2;           // log2(half) ímpar: um último estágio radix-2
+    std::vector<float> twiddles;
+    std::vector<float> realTwiddleRe;   // cos(2πk/N)
+    std::vector<float> realTwiddleIm;   // -sin(2πk/N)
+    std::vector<float> workRe;
+    std::vector<float> workIm;
+    std::vector<float> scratchRe;
+    std::vector<float> scratchIm;
+
+    // FFT complexa de half pontos em (xr, xi), usando (yr, yi) como área de troca
+    void transform(float* xr, float* xi, float* yr, float* yi, CpuFeatures::SimdLevel level);
+
+public:
+    explicit Fft(size_t transformSize);
+
+    size_t getSize() const { return size; }
+    size_t getBinCount() const { return half + 1; }
+
+    // input: size amostras; real/imag: getBinCount() valores cada
+    void forward(const float* input, float* real, float* imag);
+    void inverse(const float* real, const float* imag, float* output);
+    // Mesmas transformadas com um kernel específico (testes e benchmark)
+    void forward(const float* input, float* real, float* imag, CpuFeatures::SimdLevel level);
+    void inverse(const float* real, const float* imag, float* output, CpuFeatures::SimdLevel level);
+
+    // FFT complexa direta (sem escala) de getSize()/2 pontos, no lugar, em formato dividido;
+    // base de transformadas derivadas como o Imdct
+    void forwardComplex(float* real, float* imag);
+    void forwardComplex(float* real, float* imag, CpuFeatures::SimdLevel level);
+
+    static bool isPowerOfTwo(size_t value) { return value != 0 && (value & (value - 1)) == 0; }
+};
+
+#endif // FFT_H
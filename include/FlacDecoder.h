@@ -0,0 +1,140 @@
+#ifndef FLACDECODER_H
+#define FLACDECODER_H
+
+#include "AudioDecoder.h"
+#include "CpuFeatures.h"
+#include "MappedFile.h"
+#include <array>
+#include <vector>
+
+class FlacBitReader;
+
+/**
+ * @brief Decodificador FLAC quadro a quadro sobre um arquivo mapeado em memória
+ *
+ * Esta classe demonstra:
+ * - Herança: Implementa a interface AudioDecoder, no mesmo pipeline de streaming do MP3
+ * - Algoritmos: Subquadros constante, literal, preditor fixo e LPC; resíduo Rice com
+ *   partições e escape; descorrelação esquerda/lateral, lateral/direita e média/lateral
+ * - Desempenho: Prefixo unário Rice pela contagem de zeros à esquerda de uma janela de 64
+ *   bits (instrução do processador, ou tabela de 256 entradas sem ela); reconstrução LPC
+ *   em blocos de 4 (SSE2) ou 8 (AVX2) amostras, em que a parte da predição que só depende
+ *   de amostras anteriores ao bloco é vetorizada e apenas o triângulo interno fica serial
+ * - Busca: A SEEKTABLE delimita a região do alvo; dentro dela, bisseção pelos números de
+ *   amostra dos cabeçalhos de quadro e saltos de quadro em quadro pelo sincronismo com
+ *   CRC-8, sem decodificar os subquadros. O quadro do alvo é decodificado e cortado.
+ *
+ * Preditores fixos são tratados como LPC de coeficientes inteiros e shift 0, então os dois
+ * tipos passam pelos mesmos kernels. A soma da predição usa 32 bits quando cabe pela regra
+ * bps + precisão + log2(ordem) <= 32 (áudio de 16 bits) e 64 bits nos demais casos.
+ *
+ * Quadros com cabeçalho íntegro cujo conteúdo não decodifica ou não confere com o CRC-16
+ * (tabelas fatiadas em 8) viram silêncio da mesma duração, mantendo a posição; a leitura
+ * ressincroniza no próximo cabeçalho válido. Limitações: até 8 canais e 24 bits por
+ * amostra; FLAC dentro de Ogg não é lido.
+ */
+class FlacDecoder : public AudioDecoder {
+public:
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int MAX_LPC_ORDER = 32;
+    static constexpr int MAX_BITS_PER_SAMPLE = 24;
+
+    struct FrameHeader {
+        uint64_t firstSample = 0;      // Primeira amostra do quadro (por canal)
+        int blockSize = 0;
+        int sampleRate = 0;
+        int channels = 0;
+        int channelAssignment = 0;     // 0-7 independentes, 8 esq/lat, 9 lat/dir, 10 média/lat
+        int bitsPerSample = 0;
+        size_t headerBytes = 0;        // Incluindo o CRC-8
+    };
+
+    // Ponto da SEEKTABLE; offset relativo ao primeiro quadro
+    struct SeekPoint {
+        uint64_t sample;
+        uint64_t offset;
+    };
+
+    struct Statistics {
+        uint64_t frames = 0;
+        uint64_t resyncs = 0;          // Trechos sem cabeçalho válido pulados
+        uint64_t crcFailures = 0;      // Quadros trocados por silêncio (CRC-16 ou subquadro inválido)
+        uint64_t lpcSubframes = 0;
+        uint64_t fixedSubframes = 0;
+        uint64_t otherSubframes = 0;   // Constantes e literais
+        uint64_t seekHops = 0;         // Quadros saltados pelo sincronismo durante buscas
+    };
+
+private:
+    MappedFile file;
+    size_t firstFrameOffset;
+    int sampleRate;
+    int channels;
+    int bitsPerSample;
+    int minBlockSize;
+    int maxBlockSize;
+    uint32_t minFrameSize;             // 0 = desconhecido (STREAMINFO)
+    uint32_t maxFrameSize;
+    uint64_t totalFrames;
+    uint64_t streamStart;              // Amostra inicial do primeiro quadro
+    std::vector<SeekPoint> seekTable;
+
+    std::array<std::vector<int32_t>, MAX_CHANNELS> samples; // Quadro atual, por canal
+    std::vector<float> pending;        // PCM intercalado do quadro atual
+    size_t pendingStart;
+    size_t pendingCount;
+    size_t frameOffset;                // Próximo quadro a decodificar
+    uint64_t discardBefore;            // Amostras anteriores são descartadas (seek)
+    uint64_t position;
+    Statistics statistics;
+
+    bool readMetadata();
+    bool parseFrameHeader(size_t offset, FrameHeader& header) const;
+    // Primeiro cabeçalho válido em [from, limit); limit se não houver
+    size_t findFrame(size_t from, size_t limit, FrameHeader& header) const;
+    uint64_t findLastSample() const;
+
+    bool decodeFrame();
+    bool decodeSubframe(FlacBitReader& bits, int32_t* out, int blockSize, int bps);
+    bool decodeResidual(FlacBitReader& bits, int32_t* out, int blockSize, int order);
+
+public:
+    FlacDecoder();
+    ~FlacDecoder() override;
+
+    FlacDecoder(const FlacDecoder&) = delete;
+    FlacDecoder& operator=(const FlacDecoder&) = delete;
+
+    // Implementação da interface AudioDecoder
+    void open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return file.isOpen(); }
+    size_t decode(float* out, size_t maxFrames) override;
+    bool seek(uint64_t frame) override;
+    uint64_t getPosition() const override { return position; }
+    int getSampleRate() const override { return sampleRate; }
+    int getChannels() const override { return channels; }
+    uint64_t getTotalFrames() const override { return totalFrames; }
+    std::string getFormatName() const override { return "FLAC"; }
+
+    int getBitsPerSample() const { return bitsPerSample; }
+    const std::vector<SeekPoint>& getSeekTable() const { return seekTable; }
+    const Statistics& getStatistics() const { return statistics; }
+
+    /**
+     * Reconstrução LPC em lugar: samples[0, order) são as amostras iniciais e
+     * samples[order, count) chegam com o resíduo e saem com as amostras
+     * (s[i] += (soma de coefficients[j] * s[i-1-j]) >> shift). 'wide' soma em 64 bits.
+     */
+    static void restoreLpc(const int32_t* coefficients, int order, int shift, int32_t* samples, size_t count,
+                           bool wide);
+    static void restoreLpc(const int32_t* coefficients, int order, int shift, int32_t* samples, size_t count,
+                           bool wide, CpuFeatures::SimdLevel level);
+    // Kernel que restoreLpc usa: o vetorial só a partir da ordem em que ele ganha do escalar
+    static CpuFeatures::SimdLevel getLpcKernelLevel(int order, bool wide, CpuFeatures::SimdLevel level);
+
+    static uint8_t crc8(const uint8_t* data, size_t length);
+    static uint16_t crc16(const uint8_t* data, size_t length);
+};
+
+#endif // FLACDECODER_H
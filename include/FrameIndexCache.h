@@ -0,0 +1,62 @@
+#ifndef FRAMEINDEXCACHE_H
+#define FRAMEINDEXCACHE_H
+
+#include "Mp3FrameIndex.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Cache em disco de índices de quadros, identificado pelo arquivo de mídia
+ *
+ * Esta classe demonstra:
+ * - Persistência: Um arquivo binário por mídia, escrito de forma atômica (tmp + rename)
+ * - Desempenho: Leitura por mmap, sem cópia nem parsing; o índice aponta para as páginas
+ * - Invalidação: Chave (dispositivo, inode) no nome, (tamanho, mtime) no cabeçalho;
+ *   qualquer alteração na mídia torna a entrada obsoleta e ela é reconstruída
+ */
+class FrameIndexCache {
+public:
+    // Identidade de um arquivo de mídia no sistema de arquivos
+    struct FileIdentity {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+    };
+
+    // Contadores de uso do cache
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;     // Sem entrada para o arquivo
+        uint64_t stale = 0;      // Entrada existente mas a mídia mudou
+        uint64_t stores = 0;
+    };
+
+private:
+    std::string directory;
+    mutable std::mutex statsMutex;   // load/store podem vir de várias threads de decodificação
+    Statistics statistics;
+
+    void count(uint64_t Statistics::*counter);
+
+    std::string entryPath(const FileIdentity& identity) const;
+
+public:
+    explicit FrameIndexCache(const std::string& cacheDirectory = getDefaultDirectory());
+
+    // Índice mapeado em memória, ou nullptr se ausente/obsoleto
+    std::shared_ptr<const Mp3FrameIndex> load(const std::string& mediaPath);
+    bool store(const std::string& mediaPath, const Mp3FrameIndex& index);
+    bool remove(const std::string& mediaPath);
+
+    const std::string& getDirectory() const { return directory; }
+    Statistics getStatistics() const;
+
+    static bool getFileIdentity(const std::string& path, FileIdentity& identity);
+    // $XDG_CACHE_HOME/mp3player/frame-index, ~/.cache/... ou o diretório temporário
+    static std::string getDefaultDirectory();
+};
+
+#endif // FRAMEINDEXCACHE_H
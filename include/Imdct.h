@@ -0,0 +1,55 @@
+#ifndef IMDCT_H
+#define IMDCT_H
+
+#include "CpuFeatures.h"
+#include "Fft.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief MDCT inversa de tamanho potência de 2 sobre a FFT complexa de N/4 pontos
+ *
+ * Esta classe demonstra:
+ * - Algoritmos: y[n] = soma X[k] cos(2π/N (n + 1/2 + N/4)(k + 1/2)) via DCT-IV de N/2
+ *   pontos (pré-rotação, FFT complexa, pós-rotação) e o desdobramento pelas simetrias
+ *   da DCT-IV, O(N log N) em vez de O(N²)
+ * - Desempenho: Rotações e sobreposição com janela em kernels SSE2/AVX2 escolhidos em
+ *   tempo de execução; a FFT usa os kernels da classe Fft
+ * - Tempo real: Tabelas e buffers alocados no construtor; inverse() não aloca
+ *
+ * Sem escala (como na especificação do Vorbis). Um objeto não deve ser usado por duas
+ * threads ao mesmo tempo.
+ */
+class Imdct {
+public:
+    static constexpr size_t MIN_SIZE = 32;
+
+private:
+    size_t size;                 // N amostras de saída, N/2 coeficientes
+    Fft fft;                     // Real de N/2 pontos = complexa de N/4 pontos
+    std::vector<float> preRe;    // exp(-iπ(k + 1/4) / (N/2))
+    std::vector<float> preIm;
+    std::vector<float> postRe;   // exp(-iπk / (N/2))
+    std::vector<float> postIm;
+    std::vector<float> workRe;
+    std::vector<float> workIm;
+    std::vector<float> dct;      // Saída da DCT-IV
+
+public:
+    explicit Imdct(size_t outputSize);
+
+    size_t getSize() const { return size; }
+
+    // coefficients: N/2 valores; output: N amostras, sem janela
+    void inverse(const float* coefficients, float* output);
+    void inverse(const float* coefficients, float* output, CpuFeatures::SimdLevel level);
+
+    // Sobreposição de dois blocos nas rampas da janela:
+    // out[i] = previous[i] * fall[i] + current[i] * rise[i]
+    static void overlapAdd(const float* previous, const float* fall, const float* current, const float* rise,
+                           float* out, size_t count);
+    static void overlapAdd(const float* previous, const float* fall, const float* current, const float* rise,
+                           float* out, size_t count, CpuFeatures::SimdLevel level);
+};
+
+#endif // IMDCT_H
@@ -0,0 +1,110 @@
+#ifndef LOUDNESSANALYZER_H
+#define LOUDNESSANALYZER_H
+
+#include "AudioDecoder.h"
+#include "FrameIndexCache.h"
+#include "Track.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Análise de loudness (EBU R128 / ReplayGain 2.0) de uma biblioteca inteira, em paralelo
+ *
+ * Esta classe demonstra:
+ * - Concorrência: Um pool fixo de threads consome os arquivos por um índice atômico; cada
+ *   thread tem o próprio decodificador e LoudnessMeter, sem estado compartilhado no caminho
+ *   quente, de modo que o throughput escala com os núcleos
+ * - Persistência retomável: Cada arquivo concluído vira uma linha no journal (anexada e
+ *   descarregada na hora); uma nova análise, após cancelamento ou queda, só decodifica os
+ *   arquivos ausentes ou alterados (identidade dispositivo/inode/tamanho/mtime)
+ * - Agregação: Ganho de álbum a partir da energia dos blocos aprovados de todas as faixas
+ *   do álbum (mesmo álbum no mesmo diretório)
+ *
+ * Os resultados vão para Track::setLoudness na thread que chamou analyze().
+ * O ganho de álbum usa a energia média e a contagem de blocos aprovados de cada faixa; como
+ * o gate relativo foi aplicado por faixa, o valor pode diferir do R128 do álbum concatenado
+ * em alguns centésimos de LU quando as faixas têm loudness muito diferentes.
+ */
+class LoudnessAnalyzer {
+public:
+    static constexpr double REFERENCE_LUFS = -18.0; // ReplayGain 2.0
+    static constexpr size_t DECODE_FRAMES = 4096;
+
+    // Medição de um arquivo; é o que o journal guarda
+    struct Measurement {
+        bool ok = false;
+        double integratedLufs = 0.0;
+        double truePeakDb = 0.0;
+        double gatedEnergy = 0.0;   // Energia média dos blocos aprovados pelos gates
+        uint64_t gatedBlocks = 0;
+        uint64_t frames = 0;
+    };
+
+    struct Summary {
+        size_t files = 0;           // Arquivos distintos
+        size_t analyzed = 0;        // Decodificados nesta execução
+        size_t resumed = 0;         // Reaproveitados do journal
+        size_t failed = 0;
+        size_t albums = 0;
+        uint64_t framesDecoded = 0;
+        unsigned threads = 0;
+        bool cancelled = false;
+        double seconds = 0.0;
+    };
+
+    // (concluídos, total, arquivo); chamado serializado, a partir das threads do pool
+    using ProgressCallback = std::function<void(size_t, size_t, const std::string&)>;
+
+private:
+    struct JournalEntry {
+        FrameIndexCache::FileIdentity identity;
+        Measurement measurement;
+    };
+
+    std::string journalPath;
+    unsigned threadCount;
+    std::atomic<bool> cancelRequested;
+    std::mutex journalMutex;                // Protege journal, journalFile e o callback
+    std::unordered_map<std::string, JournalEntry> journal;
+    size_t journalLines;
+    std::FILE* journalFile;
+
+    bool loadJournal();             // false: ausente ou de outra versão
+    void appendJournal(const std::string& path, const JournalEntry& entry);
+    void rewriteJournal();
+    // false se cancelado no meio do arquivo (nada a registrar)
+    static bool measure(AudioDecoder& decoder, Measurement& measurement, const std::atomic<bool>* cancel);
+
+public:
+    explicit LoudnessAnalyzer(const std::string& journalPath = getDefaultJournalPath(), unsigned threads = 0);
+    ~LoudnessAnalyzer();
+
+    LoudnessAnalyzer(const LoudnessAnalyzer&) = delete;
+    LoudnessAnalyzer& operator=(const LoudnessAnalyzer&) = delete;
+
+    // Analisa (ou retoma) e grava loudness e ganhos em cada Track; bloqueia até terminar ou
+    // até cancel(). Faixas cujo arquivo falhou ficam sem loudness.
+    Summary analyze(const std::vector<std::shared_ptr<Track>>& tracks, ProgressCallback progress = nullptr);
+
+    // Qualquer thread: as threads do pool terminam o bloco atual e param; o journal mantém
+    // tudo o que foi concluído
+    void cancel() { cancelRequested.store(true); }
+
+    unsigned getThreadCount() const { return threadCount; }
+    const std::string& getJournalPath() const { return journalPath; }
+
+    // Mede um único arquivo (lança AudioDecoder::DecoderException se não abrir)
+    static Measurement measureFile(const std::string& path);
+
+    // $XDG_CACHE_HOME/mp3player/loudness.journal, ~/.cache/... ou o diretório temporário
+    static std::string getDefaultJournalPath();
+};
+
+#endif // LOUDNESSANALYZER_H
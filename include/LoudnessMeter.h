@@ -0,0 +1,87 @@
+#ifndef LOUDNESSMETER_H
+#define LOUDNESSMETER_H
+
+#include "BiquadCascade.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Medição de loudness integrado (ITU-R BS.1770-4 / EBU R128) e true peak de um stream
+ *
+ * Esta classe demonstra:
+ * - Processamento de sinais: Ponderação K (shelf + passa-altas, BiquadCascade<2> com os
+ *   kernels SIMD do equalizador), blocos de 400 ms com sobreposição de 75% e gates
+ *   absoluto (-70 LUFS) e relativo (-10 LU)
+ * - True peak: Sobreamostragem 4x por FIR polifásica (48 taps) abaixo de 96 kHz; trechos
+ *   cujo limite superior não supera o pico já encontrado pulam a interpolação
+ * - Composição: Energia média dos blocos aprovados e contagem são expostas para que
+ *   medições de faixas sejam combinadas (loudness de álbum)
+ *
+ * Pesos de canal do BS.1770: 1.0 para frontais e central, 1.41 para surround e 0 para LFE
+ * (layout WAV/Vorbis de 5.1: L R C LFE Ls Rs). Streams com mais de MAX_CHANNELS canais
+ * não são medidos.
+ */
+class LoudnessMeter {
+public:
+    static constexpr int MAX_CHANNELS = BiquadCascade<2>::MAX_CHANNELS;
+    static constexpr double ABSOLUTE_GATE_LUFS = -70.0;
+    static constexpr double RELATIVE_GATE_LU = -10.0;
+    static constexpr double SILENCE_LUFS = -70.0;    // Resultado quando nenhum bloco passa no gate
+    static constexpr int TRUE_PEAK_OVERSAMPLING = 4;
+    static constexpr size_t TRUE_PEAK_PHASE_TAPS = 12;
+
+private:
+    static constexpr size_t CHUNK_FRAMES = 1024;
+    static constexpr size_t SUB_BLOCKS_PER_BLOCK = 4; // 400 ms em passos de 100 ms
+
+    int sampleRate;
+    int channels;
+    BiquadCascade<2> weighting;
+    std::array<double, MAX_CHANNELS> channelWeights;
+    std::vector<float> weighted;           // Bloco ponderado (intercalado)
+
+    // Loudness: somas de quadrados do sub-bloco de 100 ms corrente e energias dos últimos quatro
+    size_t subBlockFrames;
+    size_t subBlockPosition;
+    std::array<double, MAX_CHANNELS> subBlockSums;
+    std::array<double, SUB_BLOCKS_PER_BLOCK> recentSubBlocks;
+    uint64_t subBlockCount;
+    std::vector<double> blockEnergies;     // Energia ponderada de cada bloco de 400 ms
+
+    // True peak: fases da FIR de interpolação e histórico por canal
+    bool oversampling;
+    std::array<std::array<float, TRUE_PEAK_PHASE_TAPS>, TRUE_PEAK_OVERSAMPLING> phases;
+    float phaseGainBound;                  // Maior soma de |taps| entre as fases
+    std::vector<float> history;            // Por canal: TAPS - 1 amostras + bloco
+    float samplePeak;
+    float truePeak;
+    uint64_t framesMeasured;
+
+    void accumulate(const float* interleaved, size_t frames);
+    void finishSubBlock();
+    void measurePeaks(const float* interleaved, size_t frames);
+
+public:
+    LoudnessMeter(int sampleRate, int channels);
+
+    // Acrescenta PCM float intercalado (sem cópia do chamador; blocos de qualquer tamanho)
+    void addFrames(const float* interleaved, size_t frames);
+
+    // Loudness integrado em LUFS (SILENCE_LUFS sem blocos acima dos gates)
+    double getIntegratedLoudness() const;
+    // Energia média e quantidade dos blocos aprovados pelos gates (combinação entre faixas)
+    double getGatedEnergy(uint64_t& blocks) const;
+
+    float getSamplePeak() const { return samplePeak; }
+    float getTruePeak() const { return truePeak; }   // Linear; igual ao sample peak em >= 96 kHz
+    uint64_t getFramesMeasured() const { return framesMeasured; }
+    bool isSupported() const { return channels > 0 && channels <= MAX_CHANNELS && sampleRate > 0; }
+
+    // Conversões entre energia ponderada e LUFS (L = -0.691 + 10 log10 z)
+    static double energyToLufs(double energy);
+    static double lufsToEnergy(double lufs);
+};
+
+#endif // LOUDNESSMETER_H
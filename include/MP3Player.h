@@ -3,7 +3,16 @@
 
 #include "MediaPlayer.h"
 #include "Equalizer.h"
+#include "AudioEngine.h"
+#include "PartitionedConvolver.h"
+#include "Playlist.h"
+#include "Resampler.h"
+#include "SpectrumAnalyzer.h"
+#include "VolumeStage.h"
+#include "WaveformCache.h"
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <functional>
 
 /**
@@ -12,17 +21,59 @@
  * Esta classe demonstra:
  * - Herança: Herda da classe abstrata MediaPlayer
  * - Polimorfismo: Implementa métodos virtuais
- * - Composição: Contém objeto Equalizer
+ * - Composição: Contém objeto Equalizer, a convolução de correção de sala, o estágio de volume
+ *   e a AudioEngine de reprodução; na thread de saída o sinal passa pelo equalizador, pela
+ *   convolução e por fim pelo volume (rampas sem cliques e limitador contra clipping)
+ * - Conversão de taxa: Com uma taxa de saída fixa, o decodificador é envolvido por um
+ *   ResamplingDecoder; tudo depois dele (equalizador em diante) roda na taxa do dispositivo
+ * - Eventos assíncronos: Erros, trocas, fim e posição (inclusive os das threads de áudio)
+ *   chegam por AudioEngine::drainEvents(); os callbacks rodam só em processEvents(), na
+ *   thread da aplicação, e a posição entregue é sempre a mais recente
+ * - Reprodução sem lacunas: As faixas seguintes da playlist atual (na ordem de next(), com
+ *   embaralhamento e repetição) são entregues à AudioEngine como próxima fonte; a troca
+ *   acontece na amostra exata (ou, com crossfade, no início da sobreposição das duas faixas).
+ *   processEvents() avança a playlist até a fonte que a engine diz estar tocando
+ *   (getPlayingSource()), sem depender de quantos TRACK_CHANGED chegaram
+ * - Navegação visual: As pirâmides de picos (WaveformCache) da playlist são geradas em
+ *   segundo plano; a visão geral de qualquer trecho da faixa atual sai do cache mapeado
  * - Gerenciamento de recursos: Usa smart pointers
  */
 class MP3Player : public MediaPlayer {
+public:
+    // Normalização pelo loudness analisado (Track::getLoudness): nenhuma, por faixa ou por álbum
+    enum class ReplayGainMode { OFF, TRACK, ALBUM };
+
+    static constexpr size_t EVENT_BATCH_SIZE = 64;
+
 private:
     std::unique_ptr<Equalizer> equalizer;
+    std::unique_ptr<PartitionedConvolver> convolver;
+    std::unique_ptr<VolumeStage> volumeStage;
+    std::unique_ptr<WaveformCache> waveformCache;
+    std::unique_ptr<SpectrumAnalyzer> spectrumAnalyzer;
+    ReplayGainMode replayGainMode;
+    int outputSampleRate;                 // 0 = taxa nativa de cada track
+    Resampler::Quality resamplerQuality;
     std::function<void(const std::string&)> errorCallback;
     std::function<void(double)> positionCallback;
+    std::vector<std::shared_ptr<Playlist>> playlists;
+    std::shared_ptr<Playlist> currentPlaylist;
+
+    // Faixas seguintes para a thread de decodificação (snapshot tirado em play())
+    std::mutex upcomingMutex;
+    bool gaplessEnabled;
+    std::vector<std::shared_ptr<Track>> upcomingTracks; // Um ciclo, na ordem de Playlist::next()
+    bool upcomingRepeat;                  // Recomeçar o ciclo (playlist em modo repetição)
+    Resampler::Quality upcomingQuality;
+    size_t upcomingNext;                  // Passos à frente da faixa de play() já entregues
+    uint64_t upcomingCalls;               // Chamadas ao provider desde start(), como a engine conta
+    // Fontes entregues à engine: (número da chamada ao provider, passo), em ordem
+    std::deque<std::pair<uint64_t, size_t>> upcomingStarted;
+    size_t upcomingApplied;               // Passos já aplicados à playlist
+    uint64_t playingSourceApplied;        // Última AudioEngine::getPlayingSource() aplicada
     
     // Detalhes de implementação privados
-    void* audioEngine; // Ponteiro opaco para biblioteca de áudio
+    std::unique_ptr<AudioEngine> audioEngine; // Decodificação + saída de áudio
     bool initializeAudioEngine();
     void cleanupAudioEngine();
 
@@ -37,14 +88,70 @@ public:
     bool pause() override;
     bool stop() override;
     bool seek(double position) override;
+    double getCurrentPosition() const override;
+    void setVolume(double vol) override;
 
     // Funcionalidade específica do MP3
     Equalizer* getEqualizer() const;
     void setEqualizer(std::unique_ptr<Equalizer> newEqualizer);
 
-    // Gerenciamento de callbacks
+    // Correção de sala: resposta ao impulso em WAV, aplicada depois do equalizador
+    bool loadImpulseResponse(const std::string& path);
+    void clearImpulseResponse();
+    PartitionedConvolver* getConvolver() const { return convolver.get(); }
+
+    // Volume aplicado às amostras: forma das rampas e limitador com look-ahead
+    VolumeStage* getVolumeStage() const { return volumeStage.get(); }
+    void setReplayGainMode(ReplayGainMode mode);
+    ReplayGainMode getReplayGainMode() const { return replayGainMode; }
+
+    // Taxa fixa do dispositivo (0 = sem conversão); vale a partir do próximo play()
+    void setOutputSampleRate(int rate);
+    int getOutputSampleRate() const { return outputSampleRate; }
+    void setResamplerQuality(Resampler::Quality quality) { resamplerQuality = quality; }
+    Resampler::Quality getResamplerQuality() const { return resamplerQuality; }
+
+    // Saída de áudio e métricas de reprodução
+    void setAudioSink(std::unique_ptr<AudioSink> sink);
+    const AudioSink* getAudioSink() const { return audioEngine->getSink(); }
+    AudioEngine::Statistics getAudioStatistics() const;
+
+    // Gerenciamento de callbacks (chamados apenas dentro de processEvents)
     void setErrorCallback(std::function<void(const std::string&)> callback);
     void setPositionCallback(std::function<void(double)> callback);
+    // Thread da aplicação: entrega os eventos pendentes (até maxEvents); retorna quantos retirou
+    size_t processEvents(size_t maxEvents = EVENT_BATCH_SIZE);
+    // A engine já tocou o fim do stream (processEvents() ainda pode não tê-lo entregue)
+    bool isStreamFinished() const { return audioEngine->isFinished(); }
+    // Atualizações de posição por segundo durante a reprodução (0 = só em play/seek/fim)
+    void setPositionUpdateRate(double hz) { audioEngine->setPositionUpdateRate(hz); }
+    double getPositionUpdateRate() const { return audioEngine->getPositionUpdateRate(); }
+
+    // Playlist: next()/previous() carregam e tocam a faixa vizinha; durante a reprodução a
+    // seguinte entra sem lacuna e, se não der (formato diferente), ao fim da atual
+    void setCurrentPlaylist(std::shared_ptr<Playlist> playlist);
+    std::shared_ptr<Playlist> getCurrentPlaylist() const { return currentPlaylist; }
+    // Playlists abertas na sessão (criadas, carregadas ou da biblioteca)
+    void addPlaylist(std::shared_ptr<Playlist> playlist);
+    const std::vector<std::shared_ptr<Playlist>>& getPlaylists() const { return playlists; }
+    bool next();
+    bool previous();
+    void setGaplessEnabled(bool enabled);
+    bool isGaplessEnabled() const { return gaplessEnabled; }
+    // Crossfade entre faixas da playlist (0 = sem sobreposição); vale a partir da próxima troca
+    void setCrossfade(double seconds, Crossfader::Curve curve = Crossfader::Curve::EQUAL_POWER) {
+        audioEngine->setCrossfade(seconds, curve);
+    }
+    double getCrossfadeSeconds() const { return audioEngine->getCrossfadeSeconds(); }
+    Crossfader::Curve getCrossfadeCurve() const { return audioEngine->getCrossfadeCurve(); }
+
+    // Picos para desenhar a forma de onda e navegar por ela
+    WaveformCache* getWaveformCache() const { return waveformCache.get(); }
+    // Visão geral da faixa atual (do cache ou decodificada agora); nullptr sem faixa ou com erro
+    std::shared_ptr<const WaveformOverview> getCurrentWaveform();
+
+    // Espectro do sinal que sai (pós-EQ, convolução e volume); analyze() na thread da interface
+    SpectrumAnalyzer* getSpectrumAnalyzer() const { return spectrumAnalyzer.get(); }
 
     // Suporte a formatos de áudio
     static bool isFormatSupported(const std::string& format);
@@ -53,6 +160,11 @@ public:
 private:
     void notifyError(const std::string& message);
     void notifyPositionChanged(double position);
+    void applyReplayGain();
+    bool playNeighbour(bool forward);
+    void refreshUpcomingTracks();
+    std::unique_ptr<AudioDecoder> openUpcomingTrack(); // Thread de decodificação
+    void syncPlayingTrack();
 };
 
 #endif // MP3PLAYER_H
\ No newline at end of file
@@ -29,6 +29,7 @@ private:
     std::vector<std::unique_ptr<Playlist>> loadedPlaylists;
     std::string applicationPath;
     std::string playlistsDirectory;
+    bool running;                       // Laço do menu numerado (executar)
 
     // Callbacks para integração com UI
     std::function<void(std::shared_ptr<Track>)> trackChangedCallback;
@@ -94,6 +95,7 @@ public:
     const std::string& getPlaylistsDirectory() const { return playlistsDirectory; }
 
     // Métodos de menu (implementação CLI)
+    void executar();
     void menuReproducao();
     void menuBiblioteca();
     void menuPlaylists();
@@ -0,0 +1,45 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Arquivo somente leitura mapeado em memória
+ *
+ * Esta classe demonstra:
+ * - RAII: O mapeamento é desfeito no destrutor
+ * - Desempenho: Acesso direto às páginas do cache do sistema, sem cópias
+ * - Portabilidade: Sem mmap (Windows), o conteúdo é lido para um buffer alinhado
+ */
+class MappedFile {
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped;
+    std::vector<uint64_t> storage; // Cópia usada quando o mapeamento não está disponível
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Falha para arquivos inexistentes ou vazios; 'sequential' avisa o kernel (fadvise e
+    // madvise) antes de fechar o descritor, dobrando a janela de readahead das faltas de página
+    bool open(const std::string& path, bool sequential = false);
+    void close();
+    bool isOpen() const { return bytes != nullptr; }
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    // Dica ao kernel: o arquivo será percorrido do início ao fim
+    void adviseSequential() const;
+    // Dica ao kernel: carregar [offset, offset + count) em segundo plano (alinhado a páginas)
+    void adviseWillNeed(size_t offset, size_t count) const;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,213 @@
+#ifndef MP3DECODER_H
+#define MP3DECODER_H
+
+#include "AudioDecoder.h"
+#include "Mp3FrameIndex.h"
+#include "FrameIndexCache.h"
+#include "Mp3Filterbank.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Mp3BitReader;
+
+/**
+ * @brief Decodificador MPEG-1/2/2.5 Layer III quadro a quadro
+ *
+ * Esta classe demonstra:
+ * - Herança: Implementa a interface AudioDecoder
+ * - Encapsulamento: Reservatório de bits e estados de síntese privados
+ * - Gerenciamento de recursos: Arquivo fechado automaticamente (RAII)
+ *
+ * Pipeline por granule: Huffman -> requantização -> estéreo -> reordenação ->
+ * anti-aliasing -> IMDCT -> banco de síntese polifásico de 32 bandas.
+ *
+ * Huffman por tabelas de consulta multi-bit e requantização por tabelas de |x|^(4/3) e
+ * de ganho, todas geradas em tempo de compilação (Mp3LookupTables.h): o símbolo sai de
+ * uma janela de 57 bits com no máximo dois acessos, e o valor já é gravado requantizado.
+ * IMDCT e síntese polifásica ficam no Mp3Filterbank, com kernels SSE2/AVX2 pelo nível
+ * SIMD detectado e saída idêntica à do caminho escalar.
+ *
+ * Seek exato por amostra usa um Mp3FrameIndex (construído na primeira busca) e
+ * decodifica alguns quadros de pré-rolagem para reconstruir o reservatório de bits
+ * e o estado de overlap. A TOC Xing/VBRI serve de busca aproximada quando o
+ * índice não pode ser construído.
+ *
+ * Reprodução sem lacunas: o atraso do codificador e o preenchimento final gravados na
+ * extensão LAME do quadro Xing/Info (LAME, e também Lavc/Lavf) são descontados, somados
+ * ao atraso de 529 amostras do próprio decodificador. Posição, duração e seek passam a
+ * contar só as amostras originais do arquivo codificado.
+ */
+class Mp3Decoder : public AudioDecoder {
+public:
+    static constexpr size_t MAX_FRAME_BYTES = 2881;
+    static constexpr size_t SAMPLES_PER_GRANULE = 576;
+    static constexpr uint64_t DECODER_DELAY = 529; // Atraso da síntese (IMDCT + banco polifásico)
+
+    // Cabeçalho de quadro MPEG de 32 bits já interpretado
+    struct FrameHeader {
+        int version;          // 1 = MPEG-1, 2 = MPEG-2, 3 = MPEG-2.5
+        bool lsf;             // Low Sampling Frequency (MPEG-2/2.5)
+        bool hasCrc;
+        int bitrateKbps;
+        int sampleRateIndex;  // Índice em kMp3SampleRates
+        int sampleRate;
+        bool padding;
+        int mode;             // 0 = estéreo, 1 = joint, 2 = dual, 3 = mono
+        int modeExtension;
+        int channels;
+        size_t frameBytes;
+        int samplesPerFrame;
+    };
+
+    static bool parseHeader(const uint8_t* bytes, FrameHeader& header);
+
+    // Tempo acumulado por etapa do pipeline, em segundos (ver setStageTiming)
+    struct StageTimes {
+        double huffman = 0.0;          // Fatores de escala + Huffman (já com |x|^(4/3))
+        double requantize = 0.0;       // Ganho por banda
+        double stereo = 0.0;
+        double antialias = 0.0;        // Reordenação + anti-aliasing
+        double imdct = 0.0;            // IMDCT + janela + sobreposição
+        double synthesis = 0.0;        // Banco polifásico de 32 bandas
+        uint64_t granules = 0;         // Granules x canais cronometrados
+    };
+
+private:
+    struct GranuleChannel {
+        int part23Length;
+        int bigValues;
+        int globalGain;
+        int scalefacCompress;
+        bool windowSwitching;
+        int blockType;
+        bool mixedBlock;
+        std::array<int, 3> tableSelect;
+        std::array<int, 3> subblockGain;
+        int region0Count;
+        int region1Count;
+        bool preflag;
+        bool scalefacScale;
+        bool count1Table;
+    };
+
+    struct SideInfo {
+        int mainDataBegin;
+        std::array<std::array<int, 4>, 2> scfsi;
+        GranuleChannel granules[2][2];
+    };
+
+    struct ChannelState {
+        Mp3Filterbank::State filterbank;                  // Overlap da IMDCT e buffer V da síntese
+        std::array<int, 22> sfLong{};                     // Fatores de escala longos
+        std::array<std::array<int, 3>, 13> sfShort{};     // Fatores de escala curtos
+        std::array<int, 22> sfLongMax{};                  // Posição ilegal (intensity, LSF)
+        std::array<std::array<int, 3>, 13> sfShortMax{};
+        bool preflag = false;
+        bool intensityScale = false;
+    };
+
+    std::FILE* file;
+    std::string path;
+    std::vector<uint8_t> input;        // Buffer de leitura do arquivo
+    size_t inputPos;
+    size_t inputEnd;
+    bool inputEof;
+    uint64_t inputOffset;              // Offset no arquivo de input[0]
+
+    FrameHeader streamHeader;
+    uint64_t totalFrames;
+    bool firstFrame;
+    bool resyncPending;                // Após seek aproximado: validar o próximo cabeçalho
+    uint64_t position;                 // Quadros PCM já decodificados, sem descontar o atraso
+    int encoderDelay;                  // Extensão LAME (-1 = ausente)
+    int encoderPadding;
+    uint64_t leadingSkip;              // Amostras iniciais descartadas (atraso do codificador + síntese)
+
+    std::shared_ptr<const Mp3FrameIndex> frameIndex;
+    static std::shared_ptr<FrameIndexCache> indexCache; // Compartilhado por todas as instâncias
+    std::vector<std::pair<uint64_t, uint64_t>> tocPoints; // (amostra aproximada, offset) da TOC
+
+    std::vector<uint8_t> reservoir;    // Bits principais de quadros anteriores
+    std::array<ChannelState, 2> channelState;
+    std::array<std::array<float, SAMPLES_PER_GRANULE>, 2> spectrum;
+    std::array<int, 2> nonZeroLimit;   // Última linha espectral não nula + 1
+    std::vector<uint8_t> mainData;     // Reservatório + dados principais do quadro atual
+
+    std::vector<float> pcm;            // PCM intercalado ainda não consumido
+    size_t pcmPos;
+
+    using StageClock = std::chrono::steady_clock;
+    bool stageTiming;
+    StageTimes stageTimes;
+
+    bool fillInput(size_t needed);
+    bool nextFrame(FrameHeader& header, const uint8_t*& frame);
+    void skipBytes(size_t count);
+    void skipId3Tag();
+    bool parseInfoFrame(const FrameHeader& header, const uint8_t* frame, uint64_t frameOffset);
+    void parseLameTag(const FrameHeader& header, const uint8_t* frame, size_t offset);
+    bool decodeNextFrame();
+    size_t decodeRaw(float* out, size_t maxFrames);
+    uint64_t getStreamEnd() const;     // Última amostra útil + 1, na contagem sem desconto
+    bool decodeFrame(const FrameHeader& header, const uint8_t* frame);
+
+    void resetStream(uint64_t fileOffset);
+    size_t prerollStartFrame(size_t frame) const;
+    bool seekApproximate(uint64_t frame);
+
+    void readSideInfo(const FrameHeader& header, const uint8_t* data, SideInfo& side) const;
+    void readScalefactors(const FrameHeader& header, Mp3BitReader& bits,
+                          const SideInfo& side, int granule, int channel);
+    void readLsfScalefactors(const FrameHeader& header, Mp3BitReader& bits,
+                             const GranuleChannel& gc, int channel);
+    void readHuffman(const FrameHeader& header, Mp3BitReader& bits,
+                     const GranuleChannel& gc, int channel, size_t endBit);
+    void requantize(const FrameHeader& header, const GranuleChannel& gc, int channel);
+    void processStereo(const FrameHeader& header, const GranuleChannel& left,
+                       const GranuleChannel& right);
+    void reorder(const FrameHeader& header, const GranuleChannel& gc, int channel);
+    void antialias(const GranuleChannel& gc, int channel);
+    void inverseMdct(const GranuleChannel& gc, int channel, float (*subbandSamples)[32]);
+    void polyphaseSynthesis(int channel, const float (*subbandSamples)[32], float* out, int stride);
+
+public:
+    Mp3Decoder();
+    ~Mp3Decoder() override;
+
+    Mp3Decoder(const Mp3Decoder&) = delete;
+    Mp3Decoder& operator=(const Mp3Decoder&) = delete;
+
+    // Implementação da interface AudioDecoder
+    void open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return file != nullptr; }
+    size_t decode(float* out, size_t maxFrames) override;
+    bool seek(uint64_t frame) override;
+    uint64_t getPosition() const override { return position > leadingSkip ? position - leadingSkip : 0; }
+    int getSampleRate() const override { return streamHeader.sampleRate; }
+    int getChannels() const override { return streamHeader.channels; }
+    uint64_t getTotalFrames() const override;
+    std::string getFormatName() const override { return "MP3"; }
+
+    // Valores da extensão LAME (-1 = arquivo sem a informação; nada é descontado)
+    int getEncoderDelay() const { return encoderDelay; }
+    int getEncoderPadding() const { return encoderPadding; }
+
+    // Cronometragem por etapa para o microbenchmark; ativar zera os acumuladores
+    void setStageTiming(bool enabled);
+    const StageTimes& getStageTimes() const { return stageTimes; }
+
+    // Índice de quadros: cache em disco ou varredura só de cabeçalhos em uma segunda leitura
+    bool buildFrameIndex();
+    std::shared_ptr<const Mp3FrameIndex> getFrameIndex() const { return frameIndex; }
+
+    // Cache de índices do processo (nullptr desativa)
+    static void setFrameIndexCache(std::shared_ptr<FrameIndexCache> cache);
+    static std::shared_ptr<FrameIndexCache> getFrameIndexCache();
+};
+
+#endif // MP3DECODER_H
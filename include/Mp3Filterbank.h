@@ -0,0 +1,51 @@
+#ifndef MP3FILTERBANK_H
+#define MP3FILTERBANK_H
+
+#include "CpuFeatures.h"
+
+/**
+ * @brief Banco de filtros híbrido do Layer III: IMDCT por sub-banda e síntese polifásica
+ *
+ * Esta classe demonstra:
+ * - Algoritmos: IMDCT de 18 (blocos longos) ou 3 x 6 (blocos curtos) coeficientes com
+ *   janela e sobreposição, seguida do banco polifásico de 32 bandas da ISO 11172-3
+ * - Desempenho: Kernels SSE2/AVX2 escolhidos em tempo de execução. A IMDCT processa 4 ou 8
+ *   sub-bandas por vetor (a saída [amostra][sub-banda] já é a entrada da síntese); a
+ *   síntese calcula só as 32 linhas distintas da matriz de 64 e as demais por simetria
+ * - Testabilidade: O caminho escalar é a referência direta da norma, e cada nível SIMD faz
+ *   as mesmas operações na mesma ordem por amostra, então a saída é idêntica à escalar
+ *   (a menos do sinal de zeros exatos)
+ *
+ * Sem FMA de propósito: a multiplicação e a soma separadas mantêm o arredondamento da
+ * referência.
+ */
+class Mp3Filterbank {
+public:
+    static constexpr int SUBBANDS = 32;
+    static constexpr int SLOTS = 18;              // Amostras por sub-banda em um granule
+
+    // Estado de um canal entre granules (zerado = início do fluxo)
+    struct State {
+        float overlap[SLOTS][SUBBANDS] = {};      // Metade direita da IMDCT anterior
+        float v[1024] = {};                       // Buffer V circular da síntese
+        int offset = 0;
+    };
+
+    /**
+     * IMDCT, janela e sobreposição das 32 sub-bandas de um granule.
+     * spectrum: 576 linhas após o anti-aliasing; blockType 0-3 (com mixedBlock, as duas
+     * primeiras sub-bandas de um bloco curto são longas); a partir de activeSubbands o
+     * espectro é nulo. samples[slot][sb] recebe a saída já com a inversão de frequência.
+     */
+    static void inverseMdct(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                            State& state, float (*samples)[SUBBANDS]);
+    static void inverseMdct(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                            State& state, float (*samples)[SUBBANDS], CpuFeatures::SimdLevel level);
+
+    // Síntese polifásica: SLOTS x 32 amostras PCM em out[(slot * 32 + j) * stride]
+    static void synthesize(const float (*samples)[SUBBANDS], State& state, float* out, int stride);
+    static void synthesize(const float (*samples)[SUBBANDS], State& state, float* out, int stride,
+                           CpuFeatures::SimdLevel level);
+};
+
+#endif // MP3FILTERBANK_H
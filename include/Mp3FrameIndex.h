@@ -0,0 +1,80 @@
+#ifndef MP3FRAMEINDEX_H
+#define MP3FRAMEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Índice compacto de posições de quadros MPEG em um arquivo MP3
+ *
+ * Esta classe demonstra:
+ * - Encapsulamento: Representação compacta escondida atrás de consultas simples
+ * - Eficiência de memória: Um offset absoluto a cada CHECKPOINT_INTERVAL quadros
+ *   e a distância (16 bits) de cada quadro até o próximo, ~2,25 bytes por quadro
+ * - Flexibilidade de armazenamento: Os dados podem ser próprios (construção) ou
+ *   uma visão de memória mapeada de um arquivo de cache (FrameIndexCache)
+ *
+ * Como todos os quadros de um stream têm o mesmo número de amostras, localizar o
+ * quadro de uma amostra é uma divisão; o offset é o checkpoint mais próximo somado
+ * a no máximo CHECKPOINT_INTERVAL - 1 tamanhos.
+ */
+class Mp3FrameIndex {
+public:
+    static constexpr size_t CHECKPOINT_INTERVAL = 32;
+
+    // Salto maior que 64 KiB entre dois quadros (lixo no meio do stream)
+    struct LongSpan {
+        uint64_t frame;
+        uint64_t bytes;
+    };
+
+    // Visão somente leitura dos arrays do índice
+    struct View {
+        const uint64_t* checkpoints = nullptr;   // Offset do quadro i * CHECKPOINT_INTERVAL
+        size_t checkpointCount = 0;
+        const uint16_t* frameSpans = nullptr;    // Bytes até o próximo quadro (0 = ver longSpans)
+        size_t frameCount = 0;
+        const LongSpan* longSpans = nullptr;     // Ordenado por quadro
+        size_t longSpanCount = 0;
+    };
+
+private:
+    std::vector<uint64_t> checkpoints;
+    std::vector<uint16_t> frameSpans;
+    std::vector<LongSpan> longSpans;
+    int samplesPerFrame;
+    uint64_t lastOffset;
+
+    // Dados externos (arquivo mapeado); 'mappingOwner' mantém o mapeamento vivo
+    View mappedView;
+    std::shared_ptr<const void> mappingOwner;
+
+    View view() const;
+
+public:
+    explicit Mp3FrameIndex(int frameSamples = 1152);
+    // Índice sobre memória externa; 'owner' é liberado junto com o índice
+    Mp3FrameIndex(int frameSamples, const View& external, std::shared_ptr<const void> owner);
+
+    // Construção sequencial (na ordem do arquivo)
+    void addFrame(uint64_t offset, size_t bytes);
+    void reserve(size_t frames);
+
+    // Consultas
+    size_t getFrameCount() const { return view().frameCount; }
+    int getSamplesPerFrame() const { return samplesPerFrame; }
+    uint64_t getTotalSamples() const;
+    uint64_t getFrameOffset(size_t frame) const;
+    // Bytes ocupados pelo quadro, incluindo lixo até o próximo (limite superior do tamanho)
+    uint64_t getFrameSpan(size_t frame) const;
+    size_t findFrameForSample(uint64_t sample) const;
+    size_t getMemoryUsage() const;
+    bool isMapped() const { return mappingOwner != nullptr; }
+
+    // Arrays brutos para serialização
+    View getView() const { return view(); }
+};
+
+#endif // MP3FRAMEINDEX_H
@@ -0,0 +1,355 @@
+#ifndef MP3LOOKUPTABLES_H
+#define MP3LOOKUPTABLES_H
+
+#include "Mp3Tables.h"
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @file Mp3LookupTables.h
+ * @brief Tabelas derivadas do Layer III geradas em tempo de compilação
+ *
+ * Tudo aqui é calculado por funções constexpr a partir das tabelas normativas de
+ * Mp3Tables.h, então vai para .rodata já pronto: não há custo de inicialização nem
+ * guarda de estática local nos laços do decodificador.
+ *
+ * - Huffman: tabelas de consulta de kMp3HuffPrimaryBits bits (um acesso decodifica
+ *   qualquer código de até 8 bits) com subtabelas para os códigos longos: no máximo dois
+ *   acessos por símbolo, em vez de um desvio por bit na árvore
+ * - Requantização: |x|^(4/3) para todo valor representável e 2^(q/4) para o ganho
+ * - IMDCT: cossenos dos blocos longos e curtos e as quatro janelas por tipo de bloco
+ * - Síntese: matriz de cossenos do banco polifásico e janela D completa de 512 pontos
+ *
+ * Seno e cosseno recebem o ângulo como fração inteira de pi, reduzida sem erro antes da
+ * série de Taylor; os valores coincidem com os de std::cos/std::pow após o arredondamento
+ * para float, exceto os cossenos exatamente nulos, que std::cos devolve como ~1e-17
+ * (verificado pelo modo --mp3-stages do audio_benchmark).
+ */
+
+// Matemática constexpr usada pelas tabelas (double, precisão de poucos ulps)
+struct Mp3ConstMath {
+    static constexpr double PI = 3.14159265358979323846;
+
+    // Taylor em [-pi/4, pi/4]
+    static constexpr double taylorSin(double x) {
+        double term = x;
+        double sum = x;
+        for (int k = 1; k < 12; ++k) {
+            term *= -x * x / ((2.0 * k) * (2.0 * k + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static constexpr double taylorCos(double x) {
+        double term = 1.0;
+        double sum = 1.0;
+        for (int k = 1; k < 12; ++k) {
+            term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // cos(pi * n / d), com a redução de quadrante feita em inteiros
+    static constexpr double cosPi(long n, long d) {
+        if (d < 0) {
+            n = -n;
+            d = -d;
+        }
+        n %= 2 * d;
+        if (n < 0) {
+            n += 2 * d;
+        }
+        if (n > d) {
+            n = 2 * d - n;              // cos(2pi - x) = cos(x)
+        }
+        if (2 * n > d) {
+            return -cosPi(d - n, d);    // cos(pi - x) = -cos(x)
+        }
+        if (4 * n > d) {
+            return taylorSin(PI * static_cast<double>(d - 2 * n) / static_cast<double>(2 * d));
+        }
+        return taylorCos(PI * static_cast<double>(n) / static_cast<double>(d));
+    }
+
+    // sin(pi * n / d) = cos(pi/2 - pi * n / d)
+    static constexpr double sinPi(long n, long d) { return cosPi(d - 2 * n, 2 * d); }
+
+    static constexpr double sqrt(double x) {
+        if (x <= 0.0) {
+            return 0.0;
+        }
+        double root = x > 1.0 ? x : 1.0;
+        for (int i = 0; i < 64; ++i) {
+            const double next = 0.5 * (root + x / root);
+            if (next == root) {
+                break;
+            }
+            root = next;
+        }
+        return root;
+    }
+
+    // n^(4/3) = n * cbrt(n); Newton a partir da raiz cúbica inteira
+    static constexpr double pow43(int n) {
+        if (n <= 0) {
+            return 0.0;
+        }
+        long integer = 1;
+        while ((integer + 1) * (integer + 1) * (integer + 1) <= n) {
+            ++integer;
+        }
+        double root = static_cast<double>(integer) + 0.5;
+        for (int i = 0; i < 16; ++i) {
+            const double next = root - (root * root * root - n) / (3.0 * root * root);
+            if (next == root) {
+                break;
+            }
+            root = next;
+        }
+        return n * root;
+    }
+
+    // 2^(q/4) exato nas potências de 2
+    static constexpr double exp2Quarter(int q) {
+        constexpr double fractions[4] = {1.0, 1.18920711500272106672, 1.41421356237309504880,
+                                         1.68179283050742908606};
+        double value = fractions[q & 3];
+        for (int e = q >> 2; e > 0; --e) {
+            value *= 2.0;
+        }
+        for (int e = q >> 2; e < 0; ++e) {
+            value *= 0.5;
+        }
+        return value;
+    }
+};
+
+// Maior valor de big_values: 15 + (2^13 - 1) com linbits = 13
+inline constexpr int kMp3MaxQuantized = 8206;
+
+// Faixa do expoente de ganho em quartos (global_gain - 210 - fatores de escala - subblock_gain)
+inline constexpr int kMp3GainMin = -512;
+inline constexpr int kMp3GainMax = 63;
+
+struct Mp3RequantTables {
+    float pow43[kMp3MaxQuantized + 1];
+    float gain[kMp3GainMax - kMp3GainMin + 1]; // 2^(q/4), índice q - kMp3GainMin
+    float intensityLeft[7];                    // Intensity stereo MPEG-1 por posição
+    float intensityRight[7];
+};
+
+constexpr Mp3RequantTables makeMp3RequantTables() {
+    Mp3RequantTables tables{};
+    for (int n = 0; n <= kMp3MaxQuantized; ++n) {
+        tables.pow43[n] = static_cast<float>(Mp3ConstMath::pow43(n));
+    }
+    for (int q = kMp3GainMin; q <= kMp3GainMax; ++q) {
+        tables.gain[q - kMp3GainMin] = static_cast<float>(Mp3ConstMath::exp2Quarter(q));
+    }
+    for (int position = 0; position < 7; ++position) {
+        if (position == 6) {
+            tables.intensityLeft[position] = 1.0f;
+            tables.intensityRight[position] = 0.0f;
+        } else {
+            const double ratio = Mp3ConstMath::sinPi(position, 12) / Mp3ConstMath::cosPi(position, 12);
+            tables.intensityLeft[position] = static_cast<float>(ratio / (1.0 + ratio));
+            tables.intensityRight[position] = static_cast<float>(1.0 / (1.0 + ratio));
+        }
+    }
+    return tables;
+}
+
+inline constexpr Mp3RequantTables kMp3Requant = makeMp3RequantTables();
+
+struct Mp3FilterbankTables {
+    float antialiasCs[8];
+    float antialiasCa[8];
+    float imdctLong[36][18];
+    float imdctShort[12][6];
+    float windows[4][36];     // Tipos de bloco 0, 1, 3 (longos) e 2 (janela curta de 12)
+    float synthCos[64][32];
+    // Linhas distintas de synthCos, transpostas [k][j]: j < 16 -> linha j, j >= 16 -> linha j + 17.
+    // As demais saem por simetria exata: linha 32 - i = -linha i, linha 96 - i = linha i, linha 16 = 0
+    float synthMatrix[32][32];
+    float synthWindow[512];
+};
+
+constexpr Mp3FilterbankTables makeMp3FilterbankTables() {
+    Mp3FilterbankTables tables{};
+    for (int i = 0; i < 8; ++i) {
+        const double norm = Mp3ConstMath::sqrt(1.0 + kMp3AntialiasC[i] * kMp3AntialiasC[i]);
+        tables.antialiasCs[i] = static_cast<float>(1.0 / norm);
+        tables.antialiasCa[i] = static_cast<float>(kMp3AntialiasC[i] / norm);
+    }
+
+    for (int i = 0; i < 36; ++i) {
+        for (int k = 0; k < 18; ++k) {
+            tables.imdctLong[i][k] = static_cast<float>(Mp3ConstMath::cosPi((2 * i + 19) * (2 * k + 1), 72));
+        }
+    }
+    for (int i = 0; i < 12; ++i) {
+        for (int k = 0; k < 6; ++k) {
+            tables.imdctShort[i][k] = static_cast<float>(Mp3ConstMath::cosPi((2 * i + 7) * (2 * k + 1), 24));
+        }
+    }
+
+    for (int i = 0; i < 36; ++i) {
+        const float sine = static_cast<float>(Mp3ConstMath::sinPi(2 * i + 1, 72));
+        tables.windows[0][i] = sine;
+        // Bloco de início (tipo 1)
+        if (i < 18) tables.windows[1][i] = sine;
+        else if (i < 24) tables.windows[1][i] = 1.0f;
+        else if (i < 30) tables.windows[1][i] = static_cast<float>(Mp3ConstMath::sinPi(2 * (i - 18) + 1, 24));
+        else tables.windows[1][i] = 0.0f;
+        // Bloco de parada (tipo 3)
+        if (i < 6) tables.windows[3][i] = 0.0f;
+        else if (i < 12) tables.windows[3][i] = static_cast<float>(Mp3ConstMath::sinPi(2 * (i - 6) + 1, 24));
+        else if (i < 18) tables.windows[3][i] = 1.0f;
+        else tables.windows[3][i] = sine;
+        tables.windows[2][i] = i < 12 ? static_cast<float>(Mp3ConstMath::sinPi(2 * i + 1, 24)) : 0.0f;
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        for (int k = 0; k < 32; ++k) {
+            tables.synthCos[i][k] = static_cast<float>(Mp3ConstMath::cosPi((16 + i) * (2 * k + 1), 64));
+        }
+    }
+    for (int k = 0; k < 32; ++k) {
+        for (int j = 0; j < 32; ++j) {
+            tables.synthMatrix[k][j] = tables.synthCos[j < 16 ? j : j + 17][k];
+        }
+    }
+    for (int i = 0; i <= 256; ++i) {
+        const float value = static_cast<float>(kMp3SynthWindow[i] / 65536.0);
+        tables.synthWindow[i] = value;
+        if (i != 0) {
+            tables.synthWindow[512 - i] = (i % 64 != 0) ? -value : value;
+        }
+    }
+    return tables;
+}
+
+inline constexpr Mp3FilterbankTables kMp3Filterbank = makeMp3FilterbankTables();
+
+// Huffman por consulta: a entrada da janela de kMp3HuffPrimaryBits bits é uma folha
+// (bits 8-12 comprimento total do código, 0-7 símbolo) ou, com kMp3HuffLink, aponta para
+// uma subtabela (bits 0-15 início, 16-19 largura) indexada pelos bits seguintes.
+inline constexpr int kMp3HuffPrimaryBits = 8;
+inline constexpr uint32_t kMp3HuffLink = 0x80000000u;
+inline constexpr int kMp3HuffCount1A = 32;   // Índices extras de start: tabelas A e B de count1
+inline constexpr int kMp3HuffCount1B = 33;
+
+// Símbolos de código canônico (ver Mp3Tables.h) -> tabela primária + subtabelas.
+// Com entries nulo só conta o espaço; devolve o próximo índice livre.
+constexpr size_t buildMp3HuffSet(uint32_t* entries, size_t next, const uint8_t* symbols, const uint8_t* lengths,
+                                 size_t count) {
+    constexpr int primary = kMp3HuffPrimaryBits;
+    const size_t base = next;
+    next += size_t(1) << primary;
+
+    // Largura de cada subtabela: maior sufixo entre os códigos com aquele prefixo
+    int widths[1 << primary] = {};
+    uint64_t code = 0; // Alinhado à esquerda em 32 bits
+    for (size_t i = 0; i < count; ++i) {
+        const int length = lengths[i];
+        if (length > primary) {
+            const size_t prefix = static_cast<size_t>(code >> (32 - primary));
+            widths[prefix] = widths[prefix] > length - primary ? widths[prefix] : length - primary;
+        }
+        code += uint64_t(1) << (32 - length);
+    }
+    size_t subtables[1 << primary] = {};
+    for (size_t prefix = 0; prefix < (size_t(1) << primary); ++prefix) {
+        if (widths[prefix] > 0) {
+            subtables[prefix] = next;
+            if (entries) {
+                entries[base + prefix] = kMp3HuffLink | (static_cast<uint32_t>(widths[prefix]) << 16) |
+                                         static_cast<uint32_t>(next);
+            }
+            next += size_t(1) << widths[prefix];
+        }
+    }
+    if (!entries) {
+        return next;
+    }
+
+    code = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int length = lengths[i];
+        const uint32_t leaf = (static_cast<uint32_t>(length) << 8) | symbols[i];
+        size_t first = 0;
+        size_t span = 0;
+        if (length <= primary) {
+            first = base + static_cast<size_t>(code >> (32 - primary));
+            span = size_t(1) << (primary - length);
+        } else {
+            const size_t prefix = static_cast<size_t>(code >> (32 - primary));
+            const int width = widths[prefix];
+            first = subtables[prefix] + static_cast<size_t>((code >> (32 - primary - width)) & ((1u << width) - 1));
+            span = size_t(1) << (width - (length - primary));
+        }
+        for (size_t k = 0; k < span; ++k) {
+            entries[first + k] = leaf;
+        }
+        code += uint64_t(1) << (32 - length);
+    }
+    return next;
+}
+
+// Tabelas que compartilham símbolos (16-23 e 24-31 diferem só em linbits) compartilham a consulta
+constexpr size_t buildMp3HuffLookup(uint32_t* entries, uint16_t* start) {
+    constexpr uint8_t count1BSymbols[16] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    constexpr uint8_t count1BLengths[16] = {4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+    size_t next = 0;
+    for (int t = 0; t < 32; ++t) {
+        const Mp3HuffTableInfo& info = kMp3HuffTables[t];
+        if (info.count == 0) {
+            continue;
+        }
+        int shared = -1;
+        for (int u = 0; u < t && shared < 0; ++u) {
+            if (kMp3HuffTables[u].count > 0 && kMp3HuffTables[u].offset == info.offset) {
+                shared = u;
+            }
+        }
+        if (shared >= 0) {
+            if (start) {
+                start[t] = start[shared];
+            }
+            continue;
+        }
+        if (start) {
+            start[t] = static_cast<uint16_t>(next);
+        }
+        next = buildMp3HuffSet(entries, next, kMp3HuffSymbols + info.offset, kMp3HuffLengths + info.offset,
+                               info.count);
+    }
+    if (start) {
+        start[kMp3HuffCount1A] = static_cast<uint16_t>(next);
+    }
+    next = buildMp3HuffSet(entries, next, kMp3Count1ASymbols, kMp3Count1ALengths, 16);
+    if (start) {
+        start[kMp3HuffCount1B] = static_cast<uint16_t>(next);
+    }
+    next = buildMp3HuffSet(entries, next, count1BSymbols, count1BLengths, 16);
+    return next;
+}
+
+inline constexpr size_t kMp3HuffLookupSize = buildMp3HuffLookup(nullptr, nullptr);
+
+struct Mp3HuffLookup {
+    uint16_t start[34];                      // Tabela primária de cada table_select e de count1
+    uint32_t entries[kMp3HuffLookupSize];
+};
+
+constexpr Mp3HuffLookup makeMp3HuffLookup() {
+    Mp3HuffLookup lookup{};
+    buildMp3HuffLookup(lookup.entries, lookup.start);
+    return lookup;
+}
+
+inline constexpr Mp3HuffLookup kMp3Huff = makeMp3HuffLookup();
+
+#endif // MP3LOOKUPTABLES_H
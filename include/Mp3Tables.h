@@ -0,0 +1,286 @@
+#ifndef MP3TABLES_H
+#define MP3TABLES_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @file Mp3Tables.h
+ * @brief Tabelas normativas do MPEG-1/2/2.5 Layer III (ISO/IEC 11172-3 e 13818-3)
+ *
+ * As tabelas Huffman estão armazenadas de forma compacta: para cada tabela,
+ * os símbolos (x << 4 | y) aparecem em ordem crescente de código, junto com o
+ * comprimento de cada código. O código de cada símbolo é reconstruído somando
+ * 2^(32 - comprimento) dos símbolos anteriores (códigos alinhados à esquerda).
+ */
+
+// Símbolos das tabelas Huffman de big_values (1, 2, 3, 5-13, 15, 16 e 24)
+inline constexpr uint8_t kMp3HuffSymbols[] = {
+    0x11, 0x01, 0x10, 0x00, 0x22, 0x02, 0x12, 0x21, 0x20, 0x11, 0x01, 0x10, 0x00, 0x22, 0x02, 0x12,
+    0x21, 0x20, 0x10, 0x11, 0x01, 0x00, 0x33, 0x23, 0x32, 0x31, 0x13, 0x03, 0x30, 0x22, 0x12, 0x21,
+    0x02, 0x20, 0x11, 0x01, 0x10, 0x00, 0x33, 0x03, 0x23, 0x32, 0x30, 0x13, 0x31, 0x22, 0x02, 0x12,
+    0x21, 0x20, 0x01, 0x11, 0x10, 0x00, 0x55, 0x45, 0x54, 0x53, 0x35, 0x44, 0x25, 0x52, 0x15, 0x51,
+    0x05, 0x34, 0x50, 0x43, 0x33, 0x24, 0x42, 0x14, 0x41, 0x40, 0x04, 0x23, 0x32, 0x03, 0x13, 0x31,
+    0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01, 0x10, 0x00, 0x55, 0x54, 0x45, 0x53, 0x35, 0x44,
+    0x25, 0x52, 0x05, 0x15, 0x51, 0x34, 0x43, 0x50, 0x33, 0x24, 0x42, 0x14, 0x41, 0x04, 0x40, 0x23,
+    0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x02, 0x20, 0x12, 0x21, 0x11, 0x01, 0x10, 0x00, 0x55, 0x45,
+    0x35, 0x53, 0x54, 0x05, 0x44, 0x25, 0x52, 0x15, 0x51, 0x34, 0x43, 0x50, 0x04, 0x24, 0x42, 0x33,
+    0x40, 0x14, 0x41, 0x23, 0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x02, 0x12, 0x21, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0x77, 0x67, 0x76, 0x57, 0x75, 0x66, 0x47, 0x74, 0x56, 0x65, 0x37, 0x73, 0x46, 0x55,
+    0x54, 0x63, 0x27, 0x72, 0x64, 0x07, 0x70, 0x62, 0x45, 0x35, 0x06, 0x53, 0x44, 0x17, 0x71, 0x36,
+    0x26, 0x25, 0x52, 0x15, 0x51, 0x34, 0x43, 0x16, 0x61, 0x60, 0x05, 0x50, 0x24, 0x42, 0x33, 0x04,
+    0x14, 0x41, 0x40, 0x23, 0x32, 0x03, 0x13, 0x31, 0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0x77, 0x67, 0x76, 0x75, 0x66, 0x47, 0x74, 0x57, 0x55, 0x56, 0x65, 0x37, 0x73, 0x46,
+    0x45, 0x54, 0x35, 0x53, 0x27, 0x72, 0x64, 0x07, 0x71, 0x17, 0x70, 0x36, 0x63, 0x60, 0x44, 0x25,
+    0x52, 0x05, 0x15, 0x62, 0x26, 0x06, 0x16, 0x61, 0x51, 0x34, 0x50, 0x43, 0x33, 0x24, 0x42, 0x14,
+    0x41, 0x04, 0x40, 0x23, 0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x21, 0x12, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0x77, 0x67, 0x76, 0x57, 0x75, 0x66, 0x47, 0x74, 0x65, 0x56, 0x37, 0x73, 0x55, 0x27,
+    0x72, 0x46, 0x64, 0x17, 0x71, 0x07, 0x70, 0x36, 0x63, 0x45, 0x54, 0x44, 0x06, 0x05, 0x26, 0x62,
+    0x61, 0x16, 0x60, 0x35, 0x53, 0x25, 0x52, 0x15, 0x51, 0x34, 0x43, 0x50, 0x04, 0x24, 0x42, 0x14,
+    0x33, 0x41, 0x23, 0x32, 0x40, 0x03, 0x30, 0x13, 0x31, 0x22, 0x12, 0x21, 0x02, 0x20, 0x00, 0x11,
+    0x01, 0x10, 0xfe, 0xfc, 0xfd, 0xed, 0xff, 0xef, 0xdf, 0xee, 0xcf, 0xde, 0xbf, 0xfb, 0xce, 0xdc,
+    0xaf, 0xe9, 0xec, 0xdd, 0xfa, 0xcd, 0xbe, 0xeb, 0x9f, 0xf9, 0xea, 0xbd, 0xdb, 0x8f, 0xf8, 0xcc,
+    0xae, 0x9e, 0x8e, 0x7f, 0x7e, 0xf7, 0xda, 0xad, 0xbc, 0xcb, 0xf6, 0x6f, 0xe8, 0x5f, 0x9d, 0xd9,
+    0xf5, 0xe7, 0xac, 0xbb, 0x4f, 0xf4, 0xca, 0xe6, 0xf3, 0x3f, 0x8d, 0xd8, 0x2f, 0xf2, 0x6e, 0x9c,
+    0x0f, 0xc9, 0x5e, 0xab, 0x7d, 0xd7, 0x4e, 0xc8, 0xd6, 0x3e, 0xb9, 0x9b, 0xaa, 0x1f, 0xf1, 0xf0,
+    0xba, 0xe5, 0xe4, 0x8c, 0x6d, 0xe3, 0xe2, 0x2e, 0x0e, 0x1e, 0xe1, 0xe0, 0x5d, 0xd5, 0x7c, 0xc7,
+    0x4d, 0x8b, 0xb8, 0xd4, 0x9a, 0xa9, 0x6c, 0xc6, 0x3d, 0xd3, 0x7b, 0x2d, 0xd2, 0x1d, 0xb7, 0x5c,
+    0xc5, 0x99, 0x7a, 0xc3, 0xa7, 0x97, 0x4b, 0xd1, 0x0d, 0xd0, 0x8a, 0xa8, 0x4c, 0xc4, 0x6b, 0xb6,
+    0x3c, 0x2c, 0xc2, 0x5b, 0xb5, 0x89, 0x1c, 0xc1, 0x98, 0x0c, 0xc0, 0xb4, 0x6a, 0xa6, 0x79, 0x3b,
+    0xb3, 0x88, 0x5a, 0x2b, 0xa5, 0x69, 0xa4, 0x78, 0x87, 0x94, 0x77, 0x76, 0xb2, 0x1b, 0xb1, 0x0b,
+    0xb0, 0x96, 0x4a, 0x3a, 0xa3, 0x59, 0x95, 0x2a, 0xa2, 0x1a, 0xa1, 0x0a, 0x68, 0xa0, 0x86, 0x49,
+    0x93, 0x39, 0x58, 0x85, 0x67, 0x29, 0x92, 0x57, 0x75, 0x38, 0x83, 0x66, 0x47, 0x74, 0x56, 0x65,
+    0x73, 0x19, 0x91, 0x09, 0x90, 0x48, 0x84, 0x72, 0x46, 0x64, 0x28, 0x82, 0x18, 0x37, 0x27, 0x17,
+    0x71, 0x55, 0x07, 0x70, 0x36, 0x63, 0x45, 0x54, 0x26, 0x62, 0x35, 0x81, 0x08, 0x80, 0x16, 0x61,
+    0x06, 0x60, 0x53, 0x44, 0x25, 0x52, 0x05, 0x15, 0x51, 0x34, 0x43, 0x50, 0x24, 0x42, 0x33, 0x14,
+    0x41, 0x04, 0x40, 0x23, 0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0xff, 0xef, 0xfe, 0xdf, 0xee, 0xfd, 0xcf, 0xfc, 0xde, 0xed, 0xbf, 0xfb, 0xce, 0xec,
+    0xdd, 0xaf, 0xfa, 0xbe, 0xeb, 0xcd, 0xdc, 0x9f, 0xf9, 0xea, 0xbd, 0xdb, 0x8f, 0xf8, 0xcc, 0x9e,
+    0xe9, 0x7f, 0xf7, 0xad, 0xda, 0xbc, 0x6f, 0xae, 0x0f, 0xcb, 0xf6, 0x8e, 0xe8, 0x5f, 0x9d, 0xf5,
+    0x7e, 0xe7, 0xac, 0xca, 0xbb, 0xd9, 0x8d, 0x4f, 0xf4, 0x3f, 0xf3, 0xd8, 0xe6, 0x2f, 0xf2, 0x6e,
+    0xf0, 0x1f, 0xf1, 0x9c, 0xc9, 0x5e, 0xab, 0xba, 0xe5, 0x7d, 0xd7, 0x4e, 0xe4, 0x8c, 0xc8, 0x3e,
+    0x6d, 0xd6, 0xe3, 0x9b, 0xb9, 0x2e, 0xaa, 0xe2, 0x1e, 0xe1, 0x0e, 0xe0, 0x5d, 0xd5, 0x7c, 0xc7,
+    0x4d, 0x8b, 0xd4, 0xb8, 0x9a, 0xa9, 0x6c, 0xc6, 0x3d, 0xd3, 0xd2, 0x2d, 0x0d, 0x1d, 0x7b, 0xb7,
+    0xd1, 0x5c, 0xd0, 0xc5, 0x8a, 0xa8, 0x4c, 0xc4, 0x6b, 0xb6, 0x99, 0x0c, 0x3c, 0xc3, 0x7a, 0xa7,
+    0xa6, 0xc0, 0x0b, 0xc2, 0x2c, 0x5b, 0xb5, 0x1c, 0x89, 0x98, 0xc1, 0x4b, 0xb4, 0x6a, 0x3b, 0x79,
+    0xb3, 0x97, 0x88, 0x2b, 0x5a, 0xb2, 0xa5, 0x1b, 0xb1, 0xb0, 0x69, 0x96, 0x4a, 0xa4, 0x78, 0x87,
+    0x3a, 0xa3, 0x59, 0x95, 0x2a, 0xa2, 0x1a, 0xa1, 0x0a, 0xa0, 0x68, 0x86, 0x49, 0x94, 0x39, 0x93,
+    0x77, 0x09, 0x58, 0x85, 0x29, 0x67, 0x76, 0x92, 0x91, 0x19, 0x90, 0x48, 0x84, 0x57, 0x75, 0x38,
+    0x83, 0x66, 0x47, 0x28, 0x82, 0x18, 0x81, 0x74, 0x08, 0x80, 0x56, 0x65, 0x37, 0x73, 0x46, 0x27,
+    0x72, 0x64, 0x17, 0x55, 0x71, 0x07, 0x70, 0x36, 0x63, 0x45, 0x54, 0x26, 0x62, 0x16, 0x06, 0x60,
+    0x35, 0x61, 0x53, 0x44, 0x25, 0x52, 0x15, 0x51, 0x05, 0x50, 0x34, 0x43, 0x24, 0x42, 0x33, 0x41,
+    0x14, 0x04, 0x23, 0x32, 0x40, 0x03, 0x13, 0x31, 0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0xef, 0xfe, 0xdf, 0xfd, 0xcf, 0xfc, 0xbf, 0xfb, 0xaf, 0xfa, 0x9f, 0xf9, 0xf8, 0x8f,
+    0x7f, 0xf7, 0x6f, 0xf6, 0xff, 0x5f, 0xf5, 0x4f, 0xf4, 0xf3, 0xf0, 0x3f, 0xce, 0xec, 0xdd, 0xde,
+    0xe9, 0xea, 0xd9, 0xee, 0xed, 0xeb, 0xbe, 0xcd, 0xdc, 0xdb, 0xae, 0xcc, 0xad, 0xda, 0x7e, 0xac,
+    0xca, 0xc9, 0x7d, 0x5e, 0xbd, 0xf2, 0x2f, 0x0f, 0x1f, 0xf1, 0x9e, 0xbc, 0xcb, 0x8e, 0xe8, 0x9d,
+    0xe7, 0xbb, 0x8d, 0xd8, 0x6e, 0xe6, 0x9c, 0xab, 0xba, 0xe5, 0xd7, 0x4e, 0xe4, 0x8c, 0xc8, 0x3e,
+    0x6d, 0xd6, 0x9b, 0xb9, 0xaa, 0xe1, 0xd4, 0xb8, 0xa9, 0x7b, 0xb7, 0xd0, 0xe3, 0x0e, 0xe0, 0x5d,
+    0xd5, 0x7c, 0xc7, 0x4d, 0x8b, 0x9a, 0x6c, 0xc6, 0x3d, 0x5c, 0xc5, 0x0d, 0x8a, 0xa8, 0x99, 0x4c,
+    0xb6, 0x7a, 0x3c, 0x5b, 0x89, 0x1c, 0xc0, 0x98, 0x79, 0xe2, 0x2e, 0x1e, 0xd3, 0x2d, 0xd2, 0xd1,
+    0x3b, 0x97, 0x88, 0x1d, 0xc4, 0x6b, 0xc3, 0xa7, 0x2c, 0xc2, 0xb5, 0xc1, 0x0c, 0x4b, 0xb4, 0x6a,
+    0xa6, 0xb3, 0x5a, 0xa5, 0x2b, 0xb2, 0x1b, 0xb1, 0x0b, 0xb0, 0x69, 0x96, 0x4a, 0xa4, 0x78, 0x87,
+    0xa3, 0x3a, 0x59, 0x2a, 0x95, 0x68, 0xa1, 0x86, 0x77, 0x94, 0x49, 0x57, 0x67, 0xa2, 0x1a, 0x0a,
+    0xa0, 0x39, 0x93, 0x58, 0x85, 0x29, 0x92, 0x76, 0x09, 0x19, 0x91, 0x90, 0x48, 0x84, 0x75, 0x38,
+    0x83, 0x66, 0x28, 0x82, 0x47, 0x74, 0x18, 0x81, 0x80, 0x08, 0x56, 0x37, 0x73, 0x65, 0x46, 0x27,
+    0x72, 0x64, 0x55, 0x07, 0x17, 0x71, 0x70, 0x36, 0x63, 0x45, 0x54, 0x26, 0x62, 0x16, 0x61, 0x06,
+    0x60, 0x53, 0x35, 0x44, 0x25, 0x52, 0x51, 0x15, 0x05, 0x34, 0x43, 0x50, 0x24, 0x42, 0x33, 0x14,
+    0x41, 0x04, 0x40, 0x23, 0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00, 0xef, 0xfe, 0xdf, 0xfd, 0xcf, 0xfc, 0xbf, 0xfb, 0xfa, 0xaf, 0x9f, 0xf9, 0xf8, 0x8f,
+    0x7f, 0xf7, 0x6f, 0xf6, 0x5f, 0xf5, 0x4f, 0xf4, 0x3f, 0xf3, 0x2f, 0xf2, 0xf1, 0x1f, 0xf0, 0x0f,
+    0xee, 0xde, 0xed, 0xce, 0xec, 0xdd, 0xbe, 0xeb, 0xcd, 0xdc, 0xae, 0xea, 0xbd, 0xdb, 0xcc, 0x9e,
+    0xe9, 0xad, 0xda, 0xbc, 0xcb, 0x8e, 0xe8, 0x9d, 0xd9, 0x7e, 0xe7, 0xac, 0xff, 0xca, 0xbb, 0x8d,
+    0xd8, 0x0e, 0xe0, 0x0d, 0xe6, 0x6e, 0x9c, 0xc9, 0x5e, 0xba, 0xe5, 0xab, 0x7d, 0xd7, 0xe4, 0x8c,
+    0xc8, 0x4e, 0x2e, 0x3e, 0x6d, 0xd6, 0xe3, 0x9b, 0xb9, 0xaa, 0xe2, 0x1e, 0xe1, 0x5d, 0xd5, 0x7c,
+    0xc7, 0x4d, 0x8b, 0xb8, 0xd4, 0x9a, 0xa9, 0x6c, 0xc6, 0x3d, 0xd3, 0x2d, 0xd2, 0x1d, 0x7b, 0xb7,
+    0xd1, 0x5c, 0xc5, 0x8a, 0xa8, 0x99, 0x4c, 0xc4, 0x6b, 0xb6, 0xd0, 0x0c, 0x3c, 0xc3, 0x7a, 0xa7,
+    0x2c, 0xc2, 0x5b, 0xb5, 0x1c, 0x89, 0x98, 0xc1, 0x4b, 0xc0, 0x0b, 0x3b, 0xb0, 0x0a, 0x1a, 0xb4,
+    0x6a, 0xa6, 0x79, 0x97, 0xa0, 0x09, 0x90, 0xb3, 0x88, 0x2b, 0x5a, 0xb2, 0xa5, 0x1b, 0xb1, 0x69,
+    0x96, 0xa4, 0x4a, 0x78, 0x87, 0x3a, 0xa3, 0x59, 0x95, 0x2a, 0xa2, 0xa1, 0x68, 0x86, 0x77, 0x49,
+    0x94, 0x39, 0x93, 0x58, 0x85, 0x29, 0x67, 0x76, 0x92, 0x19, 0x91, 0x48, 0x84, 0x57, 0x75, 0x38,
+    0x83, 0x66, 0x28, 0x82, 0x18, 0x47, 0x74, 0x81, 0x08, 0x80, 0x56, 0x65, 0x17, 0x07, 0x70, 0x73,
+    0x37, 0x27, 0x72, 0x46, 0x64, 0x55, 0x71, 0x36, 0x63, 0x45, 0x54, 0x26, 0x62, 0x16, 0x61, 0x06,
+    0x60, 0x35, 0x53, 0x44, 0x25, 0x52, 0x15, 0x05, 0x50, 0x51, 0x34, 0x43, 0x24, 0x42, 0x33, 0x14,
+    0x41, 0x04, 0x40, 0x23, 0x32, 0x13, 0x31, 0x03, 0x30, 0x22, 0x12, 0x21, 0x02, 0x20, 0x11, 0x01,
+    0x10, 0x00,
+};
+
+// Comprimento (em bits) do código de cada símbolo em kMp3HuffSymbols
+inline constexpr uint8_t kMp3HuffLengths[] = {
+    3, 3, 2, 1, 6, 6, 5, 5, 5, 3, 3, 3, 1, 6, 6, 5, 5, 5, 3, 2, 2, 2, 8, 8,
+    7, 6, 7, 7, 7, 7, 6, 6, 6, 6, 3, 3, 3, 1, 7, 7, 6, 6, 6, 5, 5, 5, 5, 4,
+    4, 4, 3, 2, 3, 3, 10, 10, 10, 10, 9, 9, 9, 9, 8, 8, 9, 9, 8, 9, 9, 8, 8, 7,
+    7, 7, 8, 8, 8, 8, 7, 7, 7, 7, 6, 5, 6, 6, 4, 3, 3, 1, 11, 11, 10, 9, 10, 10,
+    9, 9, 9, 8, 8, 9, 9, 9, 9, 8, 8, 8, 7, 8, 8, 8, 8, 8, 8, 8, 8, 6, 6, 6,
+    4, 4, 2, 3, 3, 2, 9, 9, 8, 8, 9, 9, 8, 8, 8, 8, 7, 7, 7, 8, 8, 7, 7, 7,
+    7, 6, 6, 6, 6, 5, 5, 6, 6, 5, 5, 4, 4, 4, 3, 3, 3, 3, 11, 11, 11, 11, 11, 11,
+    10, 10, 10, 10, 10, 10, 10, 11, 11, 10, 9, 9, 10, 10, 9, 9, 10, 10, 9, 10, 10, 8, 8, 9,
+    9, 10, 10, 9, 9, 10, 10, 8, 8, 8, 9, 9, 9, 9, 9, 9, 8, 8, 8, 8, 8, 8, 7, 7,
+    7, 7, 6, 6, 6, 6, 4, 3, 3, 1, 10, 10, 10, 10, 10, 10, 10, 11, 11, 10, 10, 9, 9, 9,
+    10, 10, 10, 10, 8, 8, 9, 9, 7, 8, 8, 8, 8, 8, 9, 9, 9, 9, 8, 7, 8, 8, 7, 7,
+    8, 8, 8, 9, 9, 8, 8, 8, 8, 8, 8, 7, 7, 6, 6, 7, 7, 6, 5, 4, 5, 5, 3, 3,
+    3, 2, 10, 10, 9, 9, 9, 9, 9, 9, 9, 8, 8, 9, 9, 8, 8, 8, 8, 8, 8, 9, 9, 8,
+    8, 8, 8, 8, 9, 9, 7, 7, 7, 8, 8, 8, 8, 8, 8, 7, 7, 7, 7, 8, 8, 7, 7, 7,
+    6, 6, 6, 6, 7, 7, 6, 5, 5, 5, 4, 4, 5, 5, 4, 3, 3, 3, 19, 19, 18, 17, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 17, 17, 15, 15, 16, 16, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    16, 16, 15, 16, 16, 14, 14, 15, 15, 15, 15, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15,
+    14, 13, 14, 14, 13, 13, 14, 14, 13, 14, 14, 13, 14, 14, 13, 14, 14, 13, 13, 14, 14, 12, 12, 12,
+    13, 13, 13, 13, 13, 13, 12, 13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12,
+    12, 13, 13, 12, 12, 12, 12, 13, 13, 13, 13, 12, 13, 13, 12, 11, 12, 12, 12, 12, 12, 12, 12, 12,
+    11, 11, 11, 11, 12, 12, 11, 11, 12, 12, 11, 12, 12, 12, 12, 11, 11, 12, 12, 11, 12, 12, 11, 12,
+    12, 11, 12, 12, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 11, 10, 10, 10, 10, 11, 11, 10, 11, 11,
+    10, 11, 11, 11, 11, 10, 10, 11, 11, 10, 10, 11, 11, 11, 11, 11, 11, 9, 9, 10, 10, 10, 10, 10,
+    11, 11, 9, 9, 9, 10, 10, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 8, 9, 9, 9, 9,
+    9, 9, 10, 10, 9, 9, 9, 8, 8, 9, 9, 9, 9, 9, 9, 8, 7, 8, 8, 8, 8, 7, 7, 7,
+    7, 7, 6, 6, 6, 6, 4, 4, 3, 1, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 12, 13, 13,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 13,
+    13, 11, 11, 12, 12, 12, 12, 11, 11, 11, 11, 11, 11, 12, 12, 11, 11, 11, 11, 11, 11, 11, 11, 12,
+    12, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+    11, 11, 12, 12, 11, 11, 11, 11, 11, 11, 10, 11, 11, 11, 11, 11, 11, 10, 10, 11, 11, 10, 10, 10,
+    10, 11, 11, 10, 10, 10, 10, 10, 10, 10, 11, 11, 10, 10, 10, 10, 10, 11, 11, 9, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 9, 10, 10, 10, 10, 9, 10, 10, 9, 10, 10, 10, 10, 10, 10, 10,
+    10, 9, 9, 9, 9, 9, 9, 9, 10, 10, 9, 9, 9, 9, 9, 9, 10, 10, 9, 9, 9, 9, 9, 9,
+    8, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 8,
+    8, 8, 8, 8, 8, 9, 9, 8, 8, 8, 8, 8, 8, 8, 9, 9, 8, 7, 8, 8, 7, 7, 7, 7,
+    8, 8, 7, 7, 7, 7, 7, 6, 7, 7, 6, 6, 7, 7, 6, 6, 6, 5, 5, 5, 5, 5, 3, 4,
+    4, 3, 11, 11, 11, 11, 11, 11, 11, 11, 10, 11, 11, 11, 11, 10, 10, 10, 10, 10, 8, 10, 10, 9,
+    9, 9, 9, 10, 16, 17, 17, 15, 15, 16, 16, 14, 15, 15, 14, 14, 15, 15, 14, 14, 15, 15, 15, 15,
+    14, 15, 15, 14, 13, 8, 9, 9, 8, 8, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 13, 13, 14,
+    14, 14, 14, 13, 14, 14, 13, 13, 13, 14, 14, 14, 14, 13, 13, 14, 14, 13, 14, 14, 12, 13, 13, 13,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 12, 13, 13, 12, 12, 13,
+    13, 11, 12, 12, 12, 12, 12, 12, 12, 13, 13, 11, 12, 12, 12, 12, 11, 12, 12, 12, 12, 12, 12, 12,
+    12, 11, 12, 12, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 12, 12, 11, 12, 12, 11, 12, 12, 11, 12,
+    12, 11, 12, 12, 11, 10, 10, 11, 11, 11, 11, 11, 11, 10, 10, 11, 11, 10, 10, 11, 11, 11, 11, 11,
+    11, 11, 11, 10, 11, 11, 10, 10, 10, 11, 11, 10, 10, 11, 11, 10, 10, 11, 11, 10, 9, 9, 10, 10,
+    10, 10, 10, 10, 9, 9, 9, 10, 10, 9, 10, 10, 9, 9, 8, 9, 9, 9, 9, 9, 9, 9, 9, 8,
+    8, 9, 9, 8, 8, 7, 7, 8, 8, 7, 6, 6, 6, 6, 4, 4, 3, 1, 8, 8, 8, 8, 8, 8,
+    8, 8, 7, 8, 8, 7, 7, 8, 8, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 9,
+    11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+    11, 11, 11, 11, 4, 11, 11, 11, 11, 12, 12, 11, 10, 11, 11, 10, 10, 10, 10, 11, 11, 10, 10, 10,
+    10, 11, 11, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 10, 11, 11, 10, 9, 10, 10, 10, 10, 11, 11, 10, 9,
+    9, 10, 10, 9, 10, 10, 10, 10, 9, 9, 10, 10, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    10, 10, 9, 9, 9, 10, 10, 8, 9, 9, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9,
+    9, 8, 8, 8, 8, 8, 8, 9, 9, 7, 8, 8, 7, 7, 7, 7, 7, 8, 8, 7, 7, 6, 6, 7,
+    7, 6, 5, 5, 6, 6, 4, 4, 4, 4,
+};
+
+struct Mp3HuffTableInfo {
+    uint16_t offset;   // Primeiro símbolo em kMp3HuffSymbols
+    uint16_t count;    // Número de símbolos (0 = tabela vazia/zero)
+    uint8_t linbits;   // Bits extras para valores >= 15
+};
+
+// Descritores das 32 tabelas selecionáveis por table_select
+inline constexpr Mp3HuffTableInfo kMp3HuffTables[32] = {
+    {0, 0, 0},      {0, 4, 0},      {4, 9, 0},      {13, 9, 0},
+    {0, 0, 0},      {22, 16, 0},    {38, 16, 0},    {54, 36, 0},
+    {90, 36, 0},    {126, 36, 0},   {162, 64, 0},   {226, 64, 0},
+    {290, 64, 0},   {354, 256, 0},  {0, 0, 0},      {610, 256, 0},
+    {866, 256, 1},  {866, 256, 2},  {866, 256, 3},  {866, 256, 4},
+    {866, 256, 6},  {866, 256, 8},  {866, 256, 10}, {866, 256, 13},
+    {1122, 256, 4}, {1122, 256, 5}, {1122, 256, 6}, {1122, 256, 7},
+    {1122, 256, 8}, {1122, 256, 9}, {1122, 256, 11}, {1122, 256, 13}
+};
+
+// Tabela A da região count1: símbolos (v << 3 | w << 2 | x << 1 | y) por código
+inline constexpr uint8_t kMp3Count1ASymbols[16] = {
+    11, 15, 13, 14, 7, 5, 9, 6, 3, 10, 12, 2, 1, 4, 8, 0
+};
+inline constexpr uint8_t kMp3Count1ALengths[16] = {
+    6, 6, 6, 6, 6, 6, 5, 5, 5, 5, 5, 4, 4, 4, 4, 1
+};
+
+// Bitrates em kbps indexados por [lsf][bitrate_index] (Layer III)
+inline constexpr uint16_t kMp3Bitrates[2][16] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+// Taxas de amostragem: MPEG-1, MPEG-2 (LSF) e MPEG-2.5
+inline constexpr int kMp3SampleRates[9] = {
+    44100, 48000, 32000, 22050, 24000, 16000, 11025, 12000, 8000
+};
+
+// Limites das bandas de fator de escala (blocos longos) por taxa de amostragem
+inline constexpr uint16_t kMp3SfbLong[9][23] = {
+    {0, 4, 8, 12, 16, 20, 24, 30, 36, 44, 52, 62, 74, 90, 110, 134, 162, 196, 238, 288, 342, 418, 576},
+    {0, 4, 8, 12, 16, 20, 24, 30, 36, 42, 50, 60, 72, 88, 106, 128, 156, 190, 230, 276, 330, 384, 576},
+    {0, 4, 8, 12, 16, 20, 24, 30, 36, 44, 54, 66, 82, 102, 126, 156, 194, 240, 296, 364, 448, 550, 576},
+    {0, 6, 12, 18, 24, 30, 36, 44, 54, 66, 80, 96, 116, 140, 168, 200, 238, 284, 336, 396, 464, 522, 576},
+    {0, 6, 12, 18, 24, 30, 36, 44, 54, 66, 80, 96, 114, 136, 162, 194, 232, 278, 332, 394, 464, 540, 576},
+    {0, 6, 12, 18, 24, 30, 36, 44, 54, 66, 80, 96, 116, 140, 168, 200, 238, 284, 336, 396, 464, 522, 576},
+    {0, 6, 12, 18, 24, 30, 36, 44, 54, 66, 80, 96, 116, 140, 168, 200, 238, 284, 336, 396, 464, 522, 576},
+    {0, 6, 12, 18, 24, 30, 36, 44, 54, 66, 80, 96, 116, 140, 168, 200, 238, 284, 336, 396, 464, 522, 576},
+    {0, 12, 24, 36, 48, 60, 72, 88, 108, 132, 160, 192, 232, 280, 336, 400, 476, 566, 568, 570, 572, 574, 576}
+};
+
+// Limites das bandas de fator de escala (blocos curtos, por janela)
+inline constexpr uint16_t kMp3SfbShort[9][14] = {
+    {0, 4, 8, 12, 16, 22, 30, 40, 52, 66, 84, 106, 136, 192},
+    {0, 4, 8, 12, 16, 22, 28, 38, 50, 64, 80, 100, 126, 192},
+    {0, 4, 8, 12, 16, 22, 30, 42, 58, 78, 104, 138, 180, 192},
+    {0, 4, 8, 12, 18, 24, 32, 42, 56, 74, 100, 132, 174, 192},
+    {0, 4, 8, 12, 18, 26, 36, 48, 62, 80, 104, 136, 180, 192},
+    {0, 4, 8, 12, 18, 26, 36, 48, 62, 80, 104, 134, 174, 192},
+    {0, 4, 8, 12, 18, 26, 36, 48, 62, 80, 104, 134, 174, 192},
+    {0, 4, 8, 12, 18, 26, 36, 48, 62, 80, 104, 134, 174, 192},
+    {0, 8, 16, 24, 36, 52, 72, 96, 124, 160, 162, 164, 166, 192}
+};
+
+// Pré-ênfase aplicada aos fatores de escala longos quando preflag = 1
+inline constexpr uint8_t kMp3Pretab[22] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 3, 2, 0
+};
+
+// slen1/slen2 indexados por scalefac_compress (MPEG-1)
+inline constexpr uint8_t kMp3Slen[16][2] = {
+    {0, 0}, {0, 1}, {0, 2}, {0, 3}, {3, 0}, {1, 1}, {1, 2}, {1, 3},
+    {2, 1}, {2, 2}, {2, 3}, {3, 1}, {3, 2}, {3, 3}, {4, 2}, {4, 3}
+};
+
+// Número de fatores de escala por partição (MPEG-2 LSF): [tabela][tipo de bloco][partição]
+inline constexpr uint8_t kMp3LsfSfbCount[6][3][4] = {
+    {{6, 5, 5, 5}, {9, 9, 9, 9}, {6, 9, 9, 9}},
+    {{6, 5, 7, 3}, {9, 9, 12, 6}, {6, 9, 12, 6}},
+    {{11, 10, 0, 0}, {18, 18, 0, 0}, {15, 18, 0, 0}},
+    {{7, 7, 7, 0}, {12, 12, 12, 0}, {6, 15, 12, 0}},
+    {{6, 6, 6, 3}, {12, 9, 9, 6}, {6, 12, 9, 6}},
+    {{8, 8, 5, 0}, {15, 12, 9, 0}, {6, 18, 9, 0}}
+};
+
+// Coeficientes da redução de aliasing (Ci)
+inline constexpr double kMp3AntialiasC[8] = {
+    -0.6, -0.535, -0.33, -0.185, -0.095, -0.041, -0.0142, -0.0037
+};
+
+// Janela de síntese D[0..256] multiplicada por 65536 (valores exatos da norma).
+// D[512 - i] = -D[i] quando i não é múltiplo de 64, e D[i] caso contrário.
+inline constexpr int32_t kMp3SynthWindow[257] = {
+    0, -1, -1, -1, -1, -1, -1, -2, -2, -2, -2, -3,
+    -3, -4, -4, -5, -5, -6, -7, -7, -8, -9, -10, -11,
+    -13, -14, -16, -17, -19, -21, -24, -26, -29, -31, -35, -38,
+    -41, -45, -49, -53, -58, -63, -68, -73, -79, -85, -91, -97,
+    -104, -111, -117, -125, -132, -139, -147, -154, -161, -169, -176, -183,
+    -190, -196, -202, -208, 213, 218, 222, 225, 227, 228, 228, 227,
+    224, 221, 215, 208, 200, 189, 177, 163, 146, 127, 106, 83,
+    57, 29, -2, -36, -72, -111, -153, -197, -244, -294, -347, -401,
+    -459, -519, -581, -645, -711, -779, -848, -919, -991, -1064, -1137, -1210,
+    -1283, -1356, -1428, -1498, -1567, -1634, -1698, -1759, -1817, -1870, -1919, -1962,
+    -2001, -2032, -2057, -2075, -2085, -2087, -2080, -2063, 2037, 2000, 1952, 1893,
+    1822, 1739, 1644, 1535, 1414, 1280, 1131, 970, 794, 605, 402, 185,
+    -45, -288, -545, -814, -1095, -1388, -1692, -2006, -2330, -2663, -3004, -3351,
+    -3705, -4063, -4425, -4788, -5153, -5517, -5879, -6237, -6589, -6935, -7271, -7597,
+    -7910, -8209, -8491, -8755, -8998, -9219, -9416, -9585, -9727, -9838, -9916, -9959,
+    -9966, -9935, -9863, -9750, -9592, -9389, -9139, -8840, -8492, -8092, -7640, -7134,
+    6574, 5959, 5288, 4561, 3776, 2935, 2037, 1082, 70, -998, -2122, -3300,
+    -4533, -5818, -7154, -8540, -9975, -11455, -12980, -14548, -16155, -17799, -19478, -21189,
+    -22929, -24694, -26482, -28289, -30112, -31947, -33791, -35640, -37489, -39336, -41176, -43006,
+    -44821, -46617, -48390, -50137, -51853, -53534, -55178, -56778, -58333, -59838, -61289, -62684,
+    -64019, -65290, -66494, -67629, -68692, -69679, -70590, -71420, -72169, -72835, -73415, -73908,
+    -74313, -74630, -74856, -74992, 75038,
+};
+
+#endif // MP3TABLES_H
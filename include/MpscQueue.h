@@ -0,0 +1,111 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Fila limitada lock-free de vários produtores para um consumidor
+ *
+ * Esta classe demonstra:
+ * - Concorrência sem locks: Cada célula carrega um número de sequência; produtores reservam
+ *   uma posição com compare-exchange e publicam a célula com um store de release, o
+ *   consumidor avança sem nenhuma operação read-modify-write
+ * - Tempo real: Nenhuma alocação depois da construção; push() nunca espera (fila cheia
+ *   descarta o item e conta o descarte)
+ * - Templates: Header-only, para qualquer T trivialmente copiável
+ *
+ * Contrato de threads: push() em qualquer thread, pop()/popBatch() apenas no consumidor.
+ * A capacidade é arredondada para a próxima potência de 2.
+ */
+template <typename T>
+class MpscQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePosition;  // Disputado pelos produtores
+    alignas(CACHE_LINE_SIZE) size_t dequeuePosition;               // Exclusivo do consumidor
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dropped;
+
+    static size_t roundCapacity(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+public:
+    explicit MpscQueue(size_t capacity)
+        : cells(new Cell[roundCapacity(capacity)]), mask(roundCapacity(capacity) - 1), enqueuePosition(0),
+          dequeuePosition(0), dropped(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Qualquer thread: false (e o item descartado) se a fila estiver cheia
+    bool push(const T& value) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                // Célula livre nesta volta: reservar (falha = outro produtor chegou antes)
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumidor: false se não houver item publicado
+    bool pop(T& value) {
+        Cell& cell = cells[dequeuePosition & mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePosition + 1) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(dequeuePosition + mask + 1, std::memory_order_release); // Livre na próxima volta
+        ++dequeuePosition;
+        return true;
+    }
+
+    // Consumidor: retira até maxItems de uma vez; retorna quantos
+    size_t popBatch(T* output, size_t maxItems) {
+        size_t count = 0;
+        while (count < maxItems && pop(output[count])) {
+            ++count;
+        }
+        return count;
+    }
+
+    size_t getCapacity() const { return mask + 1; }
+    // Itens descartados por fila cheia desde a construção
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,101 @@
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+#include "AudioSink.h"
+#include "Equalizer.h"
+#include "MP3Player.h"
+#include "Playlist.h"
+#include "Resampler.h"
+#include "Track.h"
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Renderização offline de uma playlist para WAV, mais rápida que o tempo real
+ *
+ * Esta classe demonstra:
+ * - Concorrência: Um pool fixo de threads renderiza faixas independentes (índice atômico,
+ *   decodificador, resampler, equalizador e volume próprios em cada thread) para arquivos
+ *   temporários; a thread que chamou render() concatena as faixas prontas em ordem enquanto
+ *   as seguintes ainda estão sendo processadas
+ * - Reuso do pipeline: O mesmo caminho da reprodução (ResamplingDecoder -> Equalizer ->
+ *   VolumeStage com ReplayGain e limitador), sem ritmo de relógio nem dispositivo de áudio
+ * - Tratamento de exceções: Saída que não abre lança RenderException; faixas que falham
+ *   são puladas e listadas no resultado
+ *
+ * Todas as faixas saem na mesma taxa e número de canais (mono é duplicado; saída mono recebe
+ * a média dos canais). O atraso do limitador é descontado, de modo que cada faixa
+ * ocupa exatamente a sua duração convertida e as faixas se emendam sem lacunas.
+ */
+class OfflineRenderer {
+public:
+    struct Options {
+        int sampleRate = 0;                     // 0 = taxa da primeira faixa que abrir
+        int channels = 2;                       // 0 = canais da primeira faixa que abrir
+        Resampler::Quality quality = Resampler::Quality::MEDIUM;
+        WavFileSink::SampleFormat format = WavFileSink::SampleFormat::INT16;
+        double volume = 1.0;
+        MP3Player::ReplayGainMode replayGain = MP3Player::ReplayGainMode::TRACK;
+        bool limiter = true;
+        unsigned threads = 0;                   // 0 = núcleos disponíveis
+        std::shared_ptr<const Equalizer> equalizer; // nullptr = sem equalização
+    };
+
+    struct Result {
+        size_t tracks = 0;
+        size_t rendered = 0;
+        size_t failed = 0;
+        uint64_t frames = 0;                    // Quadros gravados na saída
+        int sampleRate = 0;
+        int channels = 0;
+        unsigned threads = 0;
+        bool cancelled = false;
+        double audioSeconds = 0.0;
+        double seconds = 0.0;                   // Tempo de parede
+        double speedFactor = 0.0;               // audioSeconds / seconds (x tempo real)
+        std::vector<std::string> errors;        // "arquivo: motivo" das faixas puladas
+    };
+
+    // (faixas gravadas, total, arquivo); chamado na thread de render()
+    using ProgressCallback = std::function<void(size_t, size_t, const std::string&)>;
+
+    class RenderException : public std::exception {
+    private:
+        std::string message;
+    public:
+        explicit RenderException(const std::string& msg) : message(msg) {}
+        const char* what() const noexcept override { return message.c_str(); }
+    };
+
+private:
+    struct Slot; // Estado de uma faixa; definido em OfflineRenderer.cpp
+
+    Options options;
+    std::atomic<bool> cancelRequested;
+
+    bool renderTrack(const Track& track, int rate, int channels, Slot& slot) const;
+
+public:
+    OfflineRenderer();
+    explicit OfflineRenderer(Options renderOptions);
+
+    // Bloqueia até gravar todas as faixas (ou até cancel(); o WAV fica válido com o que já
+    // foi concatenado). Lança RenderException se a saída não abrir ou nenhuma faixa abrir.
+    Result render(const std::vector<std::shared_ptr<Track>>& tracks, const std::string& outputPath,
+                  ProgressCallback progress = nullptr);
+    Result render(const Playlist& playlist, const std::string& outputPath, ProgressCallback progress = nullptr) {
+        return render(std::vector<std::shared_ptr<Track>>(playlist.begin(), playlist.end()), outputPath,
+                      std::move(progress));
+    }
+
+    void cancel() { cancelRequested.store(true); }
+
+    const Options& getOptions() const { return options; }
+};
+
+#endif // OFFLINERENDERER_H
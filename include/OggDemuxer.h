@@ -0,0 +1,120 @@
+#ifndef OGGDEMUXER_H
+#define OGGDEMUXER_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Demultiplexador de páginas Ogg sobre um arquivo mapeado em memória
+ *
+ * Esta classe demonstra:
+ * - Parsing binário: Páginas "OggS" com tabela de lacing, CRC-32 verificado (8 bytes por
+ *   passo, slicing-by-8) e ressincronização pelo padrão de captura depois de dados corrompidos
+ * - Desempenho: Pacotes contidos em uma página são entregues como ponteiros para o
+ *   mapeamento, sem cópia; só pacotes que atravessam páginas são montados em um buffer
+ * - Busca: Um índice (offset, granule) das páginas do stream, construído na primeira busca
+ *   lendo apenas os cabeçalhos, e o último granule obtido lendo o arquivo de trás para frente
+ *
+ * Um arquivo pode multiplexar vários streams lógicos; apenas o selecionado é entregue.
+ * Streams encadeados (um novo BOS depois do EOS) terminam no primeiro EOS.
+ */
+class OggDemuxer {
+public:
+    static constexpr size_t HEADER_BYTES = 27;
+    static constexpr size_t MAX_PAGE_BYTES = HEADER_BYTES + 255 + 255 * 255;
+
+    struct Packet {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        int64_t granule = -1;        // Granule da página quando o pacote é o último a terminar nela
+        bool endOfStream = false;    // Último pacote da página EOS
+        uint64_t pageOffset = 0;     // Página em que o pacote começa (alvo de seekToPage)
+    };
+
+    // Página do stream selecionado em que termina pelo menos um pacote
+    struct PageEntry {
+        uint64_t offset;
+        uint64_t nextOffset;         // Início da página seguinte no arquivo
+        int64_t granule;
+    };
+
+    struct Statistics {
+        uint64_t pages = 0;
+        uint64_t crcFailures = 0;    // Páginas descartadas por CRC inválido
+        uint64_t bytesSkipped = 0;   // Lixo ignorado ao ressincronizar
+        uint64_t packetsAssembled = 0; // Pacotes copiados por atravessarem páginas
+    };
+
+private:
+    struct Page {
+        uint64_t offset = 0;
+        uint64_t nextOffset = 0;
+        uint8_t flags = 0;
+        int64_t granule = -1;
+        uint32_t serial = 0;
+        const uint8_t* segments = nullptr;
+        size_t segmentCount = 0;
+        const uint8_t* body = nullptr;
+    };
+
+    MappedFile file;
+    std::vector<uint32_t> serials;   // Streams iniciados nas páginas BOS do começo do arquivo
+    uint32_t serial;
+
+    Page page;                       // Página atual do stream selecionado
+    bool pageLoaded;
+    uint64_t readOffset;             // Onde procurar a próxima página quando nenhuma está carregada
+    size_t segmentIndex;
+    size_t bodyPosition;
+    bool finished;
+    std::vector<uint8_t> assembly;
+
+    std::vector<PageEntry> index;
+    bool indexBuilt;
+    uint64_t indexStart;
+    Statistics statistics;
+
+    bool parsePage(uint64_t offset, bool verifyCrc, Page& out) const;
+    // Próxima página válida em offset ou depois (qualquer stream); false no fim do arquivo
+    bool findPage(uint64_t offset, bool verifyCrc, Page& out);
+    bool loadNextPage(uint64_t offset);
+
+public:
+    OggDemuxer();
+
+    OggDemuxer(const OggDemuxer&) = delete;
+    OggDemuxer& operator=(const OggDemuxer&) = delete;
+
+    // Falha se o arquivo não existir ou não começar com uma página Ogg
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    const std::vector<uint32_t>& getStreamSerials() const { return serials; }
+    // Passa a entregar o stream 'serialNumber' desde o início do arquivo
+    void selectStream(uint32_t serialNumber);
+    uint32_t getSerial() const { return serial; }
+
+    // Próximo pacote completo do stream; false no fim do stream ou do arquivo
+    bool nextPacket(Packet& packet);
+    // Fim da página atual (início da próxima); usado para marcar onde começa o áudio
+    uint64_t getNextPageOffset() const { return pageLoaded ? page.nextOffset : 0; }
+    // Continua a partir da página em 'offset', descartando o resto de um pacote que venha
+    // de uma página anterior
+    void seekToPage(uint64_t offset);
+
+    // Páginas do stream a partir de 'startOffset' em que algum pacote termina (lazy)
+    const std::vector<PageEntry>& getPageIndex(uint64_t startOffset);
+    // Maior granule do stream, lendo o fim do arquivo; -1 se não houver
+    int64_t findLastGranule();
+
+    uint64_t getFileSize() const { return file.size(); }
+    const Statistics& getStatistics() const { return statistics; }
+
+    static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+};
+
+#endif // OGGDEMUXER_H
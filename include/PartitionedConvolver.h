@@ -0,0 +1,98 @@
+#ifndef PARTITIONEDCONVOLVER_H
+#define PARTITIONEDCONVOLVER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Convolução com resposta ao impulso longa (correção de sala), overlap-save particionado
+ *
+ * Esta classe demonstra:
+ * - Algoritmos: A resposta ao impulso é dividida em partições uniformes de B quadros; cada
+ *   bloco de entrada passa por uma FFT de 2B pontos e o espectro é acumulado contra todas as
+ *   partições (linha de atraso no domínio da frequência). Latência: exatamente B quadros
+ * - Desempenho: FFT própria (Fft) e multiplicação-acumulação complexa SSE2/AVX2+FMA
+ * - Tempo real: Filtros e buffers são montados na thread de controle e entregues por troca
+ *   atômica de ponteiros; a thread de áudio não aloca, não libera memória e nunca bloqueia
+ *
+ * Contrato de threads: loadImpulseResponse/setImpulseResponse/prepare/setEnabled na thread
+ * de controle; process() na thread de áudio. O destrutor exige a thread de áudio parada.
+ */
+class PartitionedConvolver {
+public:
+    static constexpr size_t DEFAULT_PARTITION_FRAMES = 1024;
+    static constexpr size_t MAX_IMPULSE_FRAMES = size_t(1) << 20; // ~21 s em 48 kHz
+    static constexpr int MAX_CHANNELS = 8;
+
+    // Resposta ao impulso carregada (PCM float intercalado)
+    struct ImpulseResponse {
+        std::vector<float> samples;
+        int channels = 0;
+        int sampleRate = 0;
+        size_t frames = 0;
+        std::string source;
+    };
+
+private:
+    struct Kernel; // Filtros + estado de um stream; definido em PartitionedConvolver.cpp
+    static constexpr size_t RETIRED_SLOTS = 4;
+
+    const size_t partitionFrames;
+
+    // Estado da thread de controle
+    std::shared_ptr<const ImpulseResponse> impulse;
+    int streamSampleRate;
+    int streamChannels;
+    bool enabled;
+    bool active;                 // Último kernel publicado filtra o sinal
+
+    // Entrega controle -> áudio e devolução áudio -> controle (liberado fora do áudio)
+    std::atomic<Kernel*> pending;
+    std::array<std::atomic<Kernel*>, RETIRED_SLOTS> retired;
+
+    // Estado da thread de áudio
+    Kernel* current;
+
+    void rebuild();
+    void publish(Kernel* kernel);
+    void collectRetired();
+    void adoptPending();
+
+public:
+    explicit PartitionedConvolver(size_t partitionFrames = DEFAULT_PARTITION_FRAMES);
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    // Resposta ao impulso: WAV (lança WavReader::WavException) ou amostras em memória
+    // (lança std::invalid_argument se vazia ou maior que MAX_IMPULSE_FRAMES)
+    void loadImpulseResponse(const std::string& path);
+    void setImpulseResponse(std::vector<float> interleaved, int channels, int sampleRate,
+                            const std::string& source = "memória");
+    void clearImpulseResponse();
+    bool hasImpulseResponse() const { return impulse != nullptr; }
+    std::shared_ptr<const ImpulseResponse> getImpulseResponse() const { return impulse; }
+
+    // Formato do stream; false se há resposta ao impulso mas ela não pode ser aplicada
+    // (taxa de amostragem diferente ou canais demais); nesse caso o sinal passa inalterado
+    bool prepare(int sampleRate, int channels);
+
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled; }
+    bool isActive() const { return active; }
+
+    size_t getPartitionFrames() const { return partitionFrames; }
+    size_t getPartitionCount() const;
+    size_t getLatencyFrames() const { return active ? partitionFrames : 0; }
+
+    // Thread de áudio: filtra in-place (float intercalado); nunca bloqueia nem aloca
+    void process(float* interleaved, size_t frames, int channels);
+};
+
+#endif // PARTITIONEDCONVOLVER_H
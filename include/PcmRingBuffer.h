@@ -0,0 +1,81 @@
+#ifndef PCMRINGBUFFER_H
+#define PCMRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Buffer circular lock-free de quadros PCM float intercalados (1 produtor, 1 consumidor)
+ *
+ * Esta classe demonstra:
+ * - Concorrência sem locks: Índices atômicos monotônicos com acquire/release
+ * - Desempenho: Índices de cada lado em linhas de cache distintas (sem false sharing)
+ * - Tempo real: Nenhuma alocação após a construção; write/read nunca bloqueiam
+ *
+ * Contrato de threads: write() apenas no produtor, read() apenas no consumidor,
+ * requestFlush()/availableToRead()/getStatistics() em qualquer thread.
+ */
+class PcmRingBuffer {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Contadores de ocupação, consultáveis de qualquer thread
+    struct Statistics {
+        size_t capacityFrames = 0;
+        size_t fillFrames = 0;         // Quadros prontos para leitura agora
+        size_t peakFillFrames = 0;     // Maior ocupação observada pelo produtor
+        uint64_t framesWritten = 0;
+        uint64_t framesRead = 0;
+        uint64_t framesFlushed = 0;    // Quadros descartados por flush
+    };
+
+private:
+    // Lado do produtor: índice publicado + cópia local do índice de leitura
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> writeIndex;
+    uint64_t cachedReadIndex;
+
+    // Lado do consumidor: índice publicado + cópia local do índice de escrita
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> readIndex;
+    uint64_t cachedWriteIndex;
+
+    // Flush pendente: tudo que foi escrito antes deste índice deve ser descartado
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> flushIndex;
+    std::atomic<uint64_t> framesFlushed;
+    std::atomic<size_t> peakFill;
+
+    // Imutáveis após a construção
+    alignas(CACHE_LINE_SIZE) size_t capacity;   // Em quadros, potência de 2
+    size_t mask;
+    int channels;
+    std::vector<float> storage;
+
+    void applyPendingFlush();
+
+public:
+    PcmRingBuffer(size_t capacityFrames, int channelCount);
+
+    PcmRingBuffer(const PcmRingBuffer&) = delete;
+    PcmRingBuffer& operator=(const PcmRingBuffer&) = delete;
+
+    // Produtor: copia até 'frames' quadros; retorna quantos couberam
+    size_t write(const float* interleaved, size_t frames);
+
+    // Consumidor: copia até 'frames' quadros; retorna quantos estavam disponíveis
+    size_t read(float* interleaved, size_t frames);
+
+    // Qualquer thread: descarta em O(1) tudo que já foi escrito até agora.
+    // Chamado pelo produtor logo após um seek, não afeta os quadros escritos depois.
+    void requestFlush();
+    // Somente com produtor e consumidor parados
+    void reset();
+
+    size_t availableToRead() const;
+    size_t availableToWrite() const;
+    size_t getCapacity() const { return capacity; }
+    int getChannels() const { return channels; }
+    Statistics getStatistics() const;
+};
+
+#endif // PCMRINGBUFFER_H
@@ -65,6 +65,9 @@ public:
     std::shared_ptr<Track> next();
     std::shared_ptr<Track> previous();
     bool setCurrentIndex(size_t index);
+    // Próximas faixas na ordem em que next() as devolveria (embaralhamento e repetição
+    // inclusos), sem alterar a posição atual; no máximo maxTracks
+    std::vector<std::shared_ptr<Track>> getUpcomingTracks(size_t maxTracks) const;
 
     // Propriedades
     const std::string& getName() const { return name; }
@@ -81,6 +84,7 @@ public:
 
     // Funções utilitárias
     std::chrono::seconds getTotalDuration() const;
+    std::string getTotalDurationString() const; // hh:mm:ss (mm:ss abaixo de uma hora)
     std::vector<std::shared_ptr<Track>> getAllTracks() const;
     void sortByTitle();
     void sortByArtist();
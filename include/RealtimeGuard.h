@@ -0,0 +1,82 @@
+#ifndef REALTIMEGUARD_H
+#define REALTIMEGUARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Detector de violações de tempo real na thread de áudio (modo de depuração)
+ *
+ * Esta classe demonstra:
+ * - RAII: RealtimeGuard::Scope marca o trecho da thread atual que não pode alocar nem
+ *   bloquear (o processamento de cada período na thread de saída da AudioEngine)
+ * - Interposição: Com MP3PLAYER_RT_GUARD definido, o build substitui operator new/delete e
+ *   intercepta mutex, variáveis de condição, sleeps e escrita em arquivo/stdio (std::cout
+ *   inclusive); fora de um Scope as chamadas seguem direto para a implementação original
+ * - Registro sem alocação: Cada violação incrementa um contador e, até MAX_RECORDED, guarda
+ *   o backtrace em um slot pré-alocado; a simbolização acontece só em getViolations() /
+ *   formatReport(), fora da thread de áudio
+ *
+ * Sem MP3PLAYER_RT_GUARD (build normal) o Scope é vazio e nada é interceptado.
+ * Os backtraces mostram nomes de funções quando o executável exporta símbolos (-rdynamic,
+ * ligado pela opção de CMake junto com a definição).
+ */
+class RealtimeGuard {
+public:
+    enum class ViolationKind {
+        ALLOCATION,     // operator new
+        DEALLOCATION,   // operator delete
+        LOCK,           // pthread_mutex_lock (std::mutex, std::lock_guard...)
+        WAIT,           // pthread_cond_wait/timedwait (std::condition_variable)
+        SLEEP,          // nanosleep/clock_nanosleep/usleep (std::this_thread::sleep_*)
+        IO              // write/fwrite/fflush (std::cout, printf, arquivos)
+    };
+    static constexpr size_t KIND_COUNT = 6;
+    static constexpr size_t MAX_RECORDED = 32;  // Violações com backtrace guardado
+    static constexpr size_t MAX_FRAMES = 24;    // Profundidade de cada backtrace
+
+    struct Violation {
+        ViolationKind kind;
+        size_t bytes;                       // Tamanho pedido (alocações)
+        std::vector<std::string> backtrace; // Do ponto da violação para fora
+    };
+
+    struct Statistics {
+        uint64_t counts[KIND_COUNT] = {};
+        uint64_t total = 0;
+        size_t recorded = 0;                // Quantas têm backtrace (até MAX_RECORDED)
+    };
+
+    class Scope {
+    public:
+#if defined(MP3PLAYER_RT_GUARD)
+        Scope();
+        ~Scope();
+#else
+        Scope() {}
+        ~Scope() {}
+#endif
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // true quando o build tem os ganchos (MP3PLAYER_RT_GUARD)
+    static bool isCompiledIn();
+    // true dentro de um Scope na thread atual
+    static bool isInRealtimeScope();
+
+    // Para primitivas próprias que bloqueiam sem passar pelos ganchos
+    static void reportViolation(ViolationKind kind, size_t bytes = 0);
+
+    static Statistics getStatistics();
+    static std::vector<Violation> getViolations();
+    static std::string formatReport();
+    // Zera contadores e registros; só com nenhuma thread dentro de um Scope
+    static void reset();
+
+    static std::string getKindName(ViolationKind kind);
+};
+
+#endif // REALTIMEGUARD_H
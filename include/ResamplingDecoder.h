@@ -0,0 +1,64 @@
+#ifndef RESAMPLINGDECODER_H
+#define RESAMPLINGDECODER_H
+
+#include "AudioDecoder.h"
+#include "Resampler.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Decorador de AudioDecoder que entrega o stream em outra taxa de amostragem
+ *
+ * Esta classe demonstra:
+ * - Padrão Decorator: Implementa a mesma interface do decodificador que envolve; a engine,
+ *   o equalizador e o sink veem apenas a taxa de saída
+ * - Composição: Decodificador de origem + Resampler polifásico
+ * - Tempo real: Buffers dimensionados em open(); decode() e seek() não alocam
+ *
+ * Posições, seek e total de quadros são expressos na taxa de saída e convertidos para a
+ * taxa de origem. No fim do stream a cauda do filtro é emitida, de modo que a duração
+ * resultante é ceil(quadros de origem * saída / origem).
+ */
+class ResamplingDecoder : public AudioDecoder {
+public:
+    static constexpr size_t SOURCE_FRAMES = 1024; // Quadros lidos da origem por vez
+
+private:
+    std::unique_ptr<AudioDecoder> source;
+    std::unique_ptr<Resampler> resampler;
+    int outputRate;
+    Resampler::Quality quality;
+
+    std::vector<float> sourceBuffer;
+    std::vector<float> pending;          // Saída do resampler ainda não entregue
+    size_t pendingOffset;
+    size_t pendingFrames;
+    uint64_t position;                   // Em quadros de saída
+    bool sourceFinished;
+
+    void configure();
+    uint64_t toOutputFrames(uint64_t sourceFrames) const;
+
+public:
+    // A origem pode já estar aberta; lança DecoderException se a conversão não for possível
+    ResamplingDecoder(std::unique_ptr<AudioDecoder> sourceDecoder, int outputSampleRate,
+                      Resampler::Quality resamplerQuality = Resampler::Quality::MEDIUM);
+
+    void open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override;
+
+    size_t decode(float* out, size_t maxFrames) override;
+    bool seek(uint64_t frame) override;
+    uint64_t getPosition() const override { return position; }
+
+    int getSampleRate() const override { return outputRate; }
+    int getChannels() const override;
+    uint64_t getTotalFrames() const override;
+    std::string getFormatName() const override;
+
+    AudioDecoder* getSource() const { return source.get(); }
+    const Resampler* getResampler() const { return resampler.get(); }
+};
+
+#endif // RESAMPLINGDECODER_H
@@ -0,0 +1,112 @@
+#ifndef SPECTRUMANALYZER_H
+#define SPECTRUMANALYZER_H
+
+#include "Fft.h"
+#include "TripleBuffer.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Analisador de espectro em barras logarítmicas, alimentado pela thread de áudio
+ *
+ * Esta classe demonstra:
+ * - Tempo real: push() roda na thread de saída, depois de toda a cadeia de processamento;
+ *   só soma os canais em um histórico circular e, a PUBLISH_HZ, copia as últimas FFT_SIZE
+ *   amostras para um TripleBuffer. Sem locks, sem alocação, sem esperar o leitor
+ * - Processamento de sinais: analyze() roda em outra thread (a da interface): janela de
+ *   Hann, FFT real (kernels SIMD da classe Fft) e, por barra, a maior potência entre os bins
+ *   da sua faixa de frequências (espaçadas em escala logarítmica), em dB relativos a uma
+ *   senoide de fundo de escala
+ * - Apresentação: Barras sobem na hora e caem a FALL_DB_PER_SECOND; os picos ficam parados
+ *   PEAK_HOLD_SECONDS antes de cair. Sem dados novos por STALE_SECONDS (pausa, parada),
+ *   tudo desce até o piso
+ *
+ * Contrato de threads: push() apenas na thread de áudio; analyze() e os getters de barras
+ * apenas em uma thread consumidora; setSampleRate/setEnabled em qualquer thread.
+ */
+class SpectrumAnalyzer {
+public:
+    static constexpr size_t FFT_SIZE = 2048;          // ~46 ms em 44,1 kHz, bins de ~21,5 Hz
+    static constexpr size_t DEFAULT_BAR_COUNT = 32;
+    static constexpr double PUBLISH_HZ = 60.0;        // Cópias do histórico por segundo
+    static constexpr double MIN_FREQUENCY = 30.0;
+    static constexpr double MAX_FREQUENCY = 16000.0;
+    static constexpr double FLOOR_DB = -72.0;         // Nível 0 das barras
+    static constexpr double FALL_DB_PER_SECOND = 60.0;
+    static constexpr double PEAK_HOLD_SECONDS = 0.5;
+    static constexpr double STALE_SECONDS = 0.1;
+
+private:
+    struct Snapshot {
+        std::array<float, FFT_SIZE> samples{};        // Da mais antiga para a mais recente
+        int sampleRate = 0;
+        uint64_t serial = 0;                          // 0 = nada publicado ainda
+    };
+
+    // Controle -> áudio
+    std::atomic<bool> enabled;
+    std::atomic<int> sampleRate;
+
+    // Estado da thread de áudio
+    std::array<float, FFT_SIZE> history;              // Mono, circular
+    size_t historyPosition;
+    uint64_t framesSincePublish;
+    uint64_t publishSerial;
+
+    TripleBuffer<Snapshot> snapshots;
+
+    // Estado da thread consumidora
+    Fft fft;
+    std::vector<float> window;
+    std::vector<float> windowed;
+    std::vector<float> real;
+    std::vector<float> imag;
+    size_t barCount;
+    std::vector<size_t> barFirstBin;
+    std::vector<size_t> barLastBin;
+    int mappedRate;                                   // Taxa das faixas de bins atuais
+    std::vector<float> targetDb;                      // Último espectro medido
+    std::vector<float> levelDb;                       // Exibido (com queda)
+    std::vector<float> peakDb;
+    std::vector<float> peakAge;
+    double staleSeconds;
+    double peakFrequency;
+    uint64_t analyzedSerial;
+    uint64_t analysisCount;
+
+    void mapBars(int rate);
+    void measure(const Snapshot& snapshot);
+
+public:
+    explicit SpectrumAnalyzer(size_t bars = DEFAULT_BAR_COUNT);
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    void setSampleRate(int rate) { sampleRate.store(rate, std::memory_order_relaxed); }
+    // Desativado, push() retorna na primeira instrução
+    void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Thread de áudio: sinal intercalado que vai para a saída
+    void push(const float* interleaved, size_t frames, int channels);
+
+    // Consumidor: adota o histórico mais recente (se houver), mede e avança a animação em
+    // elapsedSeconds; true se havia histórico novo
+    bool analyze(double elapsedSeconds);
+
+    size_t getBarCount() const { return barCount; }
+    // Nível exibido e pico retido da barra, de 0 (FLOOR_DB ou menos) a 1 (0 dB)
+    float getLevel(size_t bar) const;
+    float getPeak(size_t bar) const;
+    // Frequência central da barra (média geométrica das bordas)
+    double getBarFrequency(size_t bar) const;
+    // Frequência do bin mais forte da última medição (interpolada); 0 sem sinal
+    double getPeakFrequency() const { return peakFrequency; }
+    uint64_t getAnalysisCount() const { return analysisCount; }
+};
+
+#endif // SPECTRUMANALYZER_H
@@ -13,8 +13,20 @@
  * - Encapsulamento: Campos privados com acesso controlado
  * - Classes e Objetos: Modelo de domínio representando entidade do mundo real
  * - Sobrecarga de operadores: Operadores de comparação para ordenação
+ * - Valores opcionais: Loudness (EBU R128 / ReplayGain 2.0) só existe após a análise
  */
 class Track {
+public:
+    // Resultado da análise de loudness (LoudnessAnalyzer); ganhos relativos a -18 LUFS
+    struct Loudness {
+        double integratedLufs = 0.0;
+        double truePeakDb = 0.0;      // dBTP
+        double trackGainDb = 0.0;
+        double albumGainDb = 0.0;
+        double albumPeakDb = 0.0;
+        bool hasAlbumGain = false;
+    };
+
 private:
     std::string filePath;
     std::string title;
@@ -24,7 +36,8 @@ private:
     int year;
     std::chrono::seconds duration;
     size_t fileSize;
-    std::string format; // MP3, WAV, OGG
+    std::string format; // MP3, WAV, OGG, FLAC
+    std::optional<Loudness> loudness;
 
 public:
     // Construtores
@@ -52,6 +65,7 @@ public:
     std::chrono::seconds getDuration() const { return duration; }
     size_t getFileSize() const { return fileSize; }
     const std::string& getFormat() const { return format; }
+    const std::optional<Loudness>& getLoudness() const { return loudness; }
 
     // Setters com validação
     void setTitle(const std::string& newTitle);
@@ -61,6 +75,9 @@ public:
     void setYear(int newYear);
     void setDuration(std::chrono::seconds newDuration);
     void setFilePath(const std::string& path);
+    void setFormat(const std::string& newFormat) { format = newFormat; }
+    void setLoudness(const Loudness& newLoudness);
+    void clearLoudness() { loudness.reset(); }
 
     // Sobrecarga de operadores para comparação e ordenação
     bool operator==(const Track& other) const;
@@ -72,6 +89,9 @@ public:
     bool isValid() const;
     std::string getDisplayName() const;
     std::string getDurationString() const;
+    // Ganho de reprodução em dB (0 sem análise); modo álbum cai para o da faixa sem
+    // ganho de álbum; ganhos positivos limitados para o true peak não passar de 0 dBTP
+    double getReplayGainDb(bool albumMode) const;
 
     // Métodos factory estáticos
     static std::shared_ptr<Track> createFromFile(const std::string& filePath);
@@ -0,0 +1,63 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Publicação lock-free do valor mais recente de um escritor para um leitor
+ *
+ * Esta classe demonstra:
+ * - Concorrência sem locks: Buffer duplo com um terceiro slot de troca; escritor e leitor
+ *   trocam de slot com uma única operação atômica (exchange) e nunca esperam um pelo outro
+ * - Tempo real: Nenhuma alocação após a construção; update() é wait-free
+ * - Templates: Header-only, para qualquer T copiável
+ *
+ * Contrato de threads: getWriteBuffer()/publish() apenas no escritor, update()/getReadBuffer()
+ * apenas no leitor. Publicações intermediárias que o leitor não viu são descartadas; o leitor
+ * sempre obtém a mais recente.
+ */
+template <typename T>
+class TripleBuffer {
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH_BIT = 0x4;   // Slot do meio contém publicação ainda não lida
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    std::array<T, 3> slots;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> middle;   // Slot de troca + FRESH_BIT
+    alignas(CACHE_LINE_SIZE) uint8_t back;                  // Exclusivo do escritor
+    alignas(CACHE_LINE_SIZE) uint8_t front;                 // Exclusivo do leitor
+
+public:
+    TripleBuffer() : slots(), middle(1), back(0), front(2) {}
+
+    explicit TripleBuffer(const T& initial) : slots{initial, initial, initial}, middle(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Escritor: slot livre para montar o próximo valor
+    T& getWriteBuffer() { return slots[back]; }
+
+    // Escritor: torna o slot montado visível ao leitor e recebe outro slot livre
+    void publish() {
+        back = static_cast<uint8_t>(middle.exchange(static_cast<uint8_t>(back | FRESH_BIT),
+                                                    std::memory_order_acq_rel) & INDEX_MASK);
+    }
+
+    // Leitor: adota a publicação mais recente, se houver; true se o valor lido mudou
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        front = static_cast<uint8_t>(middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK);
+        return true;
+    }
+
+    // Leitor: valor adotado pelo último update()
+    const T& getReadBuffer() const { return slots[front]; }
+};
+
+#endif // TRIPLEBUFFER_H
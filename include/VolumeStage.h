@@ -0,0 +1,123 @@
+#ifndef VOLUMESTAGE_H
+#define VOLUMESTAGE_H
+
+#include "CpuFeatures.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Estágio de volume da cadeia de áudio: ganho com rampas e limitador com look-ahead
+ *
+ * Esta classe demonstra:
+ * - Processamento de sinais: Toda mudança de volume vira uma rampa (linear ou exponencial,
+ *   isto é, linear em dB) de RAMP_SECONDS, calculada quadro a quadro: sem cliques. O ganho
+ *   aplicado é volume x normalização (ReplayGain da faixa ou do álbum)
+ * - Desempenho: Multiplicação e rampas com kernels SSE2/AVX2; volume 1.0 sem rampa e sinal
+ *   abaixo do joelho do limitador custam apenas o atraso de look-ahead
+ * - Limitador: O sinal é atrasado LIMITER_LOOKAHEAD_SECONDS; o ganho necessário para cada
+ *   pico (curva de joelho suave até LIMITER_CEILING) é mantido por mínimo deslizante,
+ *   liberado exponencialmente e suavizado por média móvel, de modo que a redução já está
+ *   completa quando o pico sai do atraso. Reforços do equalizador somados ao volume nunca
+ *   passam do teto
+ * - Tempo real: A thread de controle só escreve atômicos (volume, forma da rampa, limitador,
+ *   taxa de amostragem); process() lê esses valores sem bloquear e todos os buffers são
+ *   alocados no construtor
+ *
+ * Contrato de threads: setVolume/setNormalizationGain/setRampShape/setLimiterEnabled/prepare
+ * em qualquer thread;
+ * process() apenas na thread de áudio.
+ */
+class VolumeStage {
+public:
+    enum class RampShape { LINEAR = 0, EXPONENTIAL = 1 };
+
+    static constexpr double RAMP_SECONDS = 0.02;
+    static constexpr float EXPONENTIAL_FLOOR = 1e-4f;   // -80 dB: início/fim de rampas exponenciais
+    static constexpr double LIMITER_LOOKAHEAD_SECONDS = 0.0015;
+    static constexpr double LIMITER_RELEASE_SECONDS = 0.15;
+    static constexpr float LIMITER_CEILING = 0.944f;    // -0.5 dBFS
+    static constexpr float LIMITER_KNEE = 0.75f;        // -2.5 dBFS: início da compressão suave
+    static constexpr size_t MAX_LOOKAHEAD_FRAMES = 512; // Suficiente até 192 kHz
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int DEFAULT_SAMPLE_RATE = 44100;
+    static constexpr double MAX_NORMALIZATION_DB = 12.0;
+
+private:
+    // Controle -> áudio
+    std::atomic<float> targetGain;
+    std::atomic<float> normalizationGain;
+    std::atomic<int> rampShape;
+    std::atomic<bool> limiterEnabled;
+    std::atomic<int> sampleRate;
+    std::atomic<uint32_t> prepareSerial; // Mudou: reconfigurar e zerar o limitador
+    static_assert(std::atomic<float>::is_always_lock_free, "Volume precisa de float atômico sem trava");
+
+    // Estado da thread de áudio: rampa de volume
+    CpuFeatures::SimdLevel level;
+    float currentGain;
+    float rampFrom;
+    float rampTo;
+    float rampStep;              // Incremento (linear) ou razão (exponencial) por quadro
+    RampShape activeShape;
+    size_t rampFrames;
+    size_t rampPosition;         // rampFrames = concluída
+    uint32_t appliedSerial;
+    int appliedChannels;
+
+    // Estado da thread de áudio: limitador
+    size_t lookaheadFrames;
+    float releaseCoefficient;
+    std::vector<float> delayLine;    // lookaheadFrames quadros intercalados, circular
+    size_t delayPosition;
+    std::vector<uint64_t> holdFrames; // Fila monotônica do mínimo deslizante (quadro, ganho)
+    std::vector<float> holdGains;
+    size_t holdHead;
+    size_t holdCount;
+    std::vector<float> smoothingWindow; // Últimos lookaheadFrames ganhos após a liberação
+    size_t smoothingPosition;
+    double smoothingSum;
+    float envelope;
+    uint64_t frameCounter;
+    size_t unityFrames;          // Ganhos 1.0 consecutivos na janela de suavização
+
+    void configure(int rate, int channels);
+    void startRamp(float target);
+    void applyGain(float* interleaved, size_t frames, int channels);
+    void limit(float* interleaved, size_t frames, int channels);
+    bool limiterIdle() const;
+    float rampGainAt(size_t position) const;
+
+public:
+    explicit VolumeStage(double initialVolume = 1.0);
+
+    VolumeStage(const VolumeStage&) = delete;
+    VolumeStage& operator=(const VolumeStage&) = delete;
+
+    // Ganho linear, limitado a [0.0, 1.0]; a thread de áudio chega ao novo valor por uma rampa
+    void setVolume(double volume);
+    double getVolume() const { return targetGain.load(std::memory_order_relaxed); }
+
+    // Normalização de loudness em dB (limitada a +-MAX_NORMALIZATION_DB), somada ao volume
+    void setNormalizationGain(double gainDb);
+    double getNormalizationGain() const;
+
+    void setRampShape(RampShape shape);
+    RampShape getRampShape() const { return static_cast<RampShape>(rampShape.load(std::memory_order_relaxed)); }
+
+    // Desativado, o atraso de look-ahead continua (latência constante, sem cliques ao alternar)
+    void setLimiterEnabled(bool enable);
+    bool isLimiterEnabled() const { return limiterEnabled.load(std::memory_order_relaxed); }
+
+    // Taxa do stream: define duração das rampas, look-ahead e liberação; o novo stream
+    // começa direto no ganho alvo (sem rampa) e com o limitador zerado
+    void prepare(int streamSampleRate);
+    size_t getLatencyFrames() const;
+
+    // Thread de áudio: aplica volume e limitador in-place (float intercalado); acima de
+    // MAX_CHANNELS canais só o volume é aplicado
+    void process(float* interleaved, size_t frames, int channels);
+};
+
+#endif // VOLUMESTAGE_H
@@ -0,0 +1,188 @@
+#ifndef VORBISDECODER_H
+#define VORBISDECODER_H
+
+#include "AudioDecoder.h"
+#include "Imdct.h"
+#include "OggDemuxer.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+class VorbisBitReader;
+
+/**
+ * @brief Decodificador Vorbis I sobre o OggDemuxer
+ *
+ * Esta classe demonstra:
+ * - Herança: Implementa a interface AudioDecoder, no mesmo pipeline de streaming do MP3
+ * - Algoritmos: Codebooks Huffman com tabela rápida de 10 bits, floor tipo 1, resíduos
+ *   tipos 0/1/2, acoplamento quadrado-polar e IMDCT de blocos curtos e longos
+ * - Desempenho: IMDCT e sobreposição com janela nos kernels SIMD da classe Imdct; os
+ *   pacotes vêm do arquivo mapeado sem cópia e decode() não aloca
+ *
+ * Pipeline por pacote: modo -> floors -> resíduos -> desacoplamento -> espectro * floor
+ * -> IMDCT -> sobreposição com a metade direita do bloco anterior.
+ *
+ * Seek exato por amostra: na primeira busca um índice de pacotes (página de início e
+ * granule final, reconstruídos pelos bits de modo e realinhados pelo granule de cada
+ * página) é construído em uma única passada; as buscas seguintes são uma bissecção nele,
+ * sem reler páginas. A decodificação recomeça na página do pacote anterior ao alvo, que
+ * só prepara a sobreposição; os que o antecedem na página são pulados sem IMDCT. O
+ * granule da página EOS corta o final.
+ *
+ * Limitações: floor tipo 0 (praticamente extinto desde 2002) é recusado, e em arquivos
+ * encadeados só o primeiro stream Vorbis é tocado. Canais saem na ordem WAV/SMPTE.
+ */
+class VorbisDecoder : public AudioDecoder {
+public:
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int FAST_BITS = 10;     // Bits da tabela de decodificação direta
+
+private:
+    struct Codebook {
+        int dimensions = 0;
+        int entries = 0;
+        std::vector<uint8_t> lengths;           // 0 = entrada sem palavra
+        std::vector<int32_t> fast;              // Entrada pelos próximos FAST_BITS bits (-1 = lenta)
+        std::vector<uint32_t> sortedCodes;      // Palavras invertidas, alinhadas à esquerda
+        std::vector<uint8_t> sortedLengths;
+        std::vector<int32_t> sortedEntries;
+        int lookupType = 0;
+        std::vector<float> vectors;             // entries * dimensions (VQ)
+    };
+
+    struct Floor1 {
+        std::vector<int> partitionClass;
+        std::array<int, 16> classDimensions{};
+        std::array<int, 16> classSubclasses{};
+        std::array<int, 16> classMasterbook{};
+        std::array<std::array<int, 8>, 16> subclassBooks{};
+        int multiplier = 1;
+        std::vector<int> xList;
+        std::vector<int> sortedOrder;           // Índices de xList em ordem crescente de x
+        std::vector<int> lowNeighbor;
+        std::vector<int> highNeighbor;
+    };
+
+    struct Residue {
+        int type = 0;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint32_t partitionSize = 1;
+        int classifications = 1;
+        int classbook = 0;
+        std::vector<std::array<int16_t, 8>> books; // Por classificação e passada (-1 = nenhum)
+    };
+
+    struct Mapping {
+        std::vector<std::pair<int, int>> coupling; // (magnitude, ângulo)
+        std::vector<int> mux;                      // Submapa de cada canal
+        std::vector<int> submapFloor;
+        std::vector<int> submapResidue;
+    };
+
+    struct Mode {
+        bool blockFlag = false;
+        int mapping = 0;
+    };
+
+    // Pacote de áudio no índice de seek
+    struct SeekPoint {
+        int64_t end;            // Granule da primeira amostra depois do pacote
+        uint32_t page;          // Página de início, em seekPages
+        uint32_t skip;          // Pacotes de áudio que começam antes dele na mesma página
+    };
+
+    OggDemuxer demuxer;
+    int channels;
+    int sampleRate;
+    std::array<int, 2> blockSizes;
+    std::array<int, MAX_CHANNELS> channelOrder; // Canal Vorbis de cada posição de saída
+
+    std::vector<Codebook> codebooks;
+    std::vector<Floor1> floors;
+    std::vector<Residue> residues;
+    std::vector<Mapping> mappings;
+    std::vector<Mode> modes;
+    int modeBits;
+
+    std::array<std::unique_ptr<Imdct>, 2> imdct;
+    std::array<std::vector<float>, 2> rise;    // Rampas da janela para L = blocksize/2
+    std::array<std::vector<float>, 2> fall;
+
+    // Estado por canal (tamanhos do bloco longo)
+    std::vector<std::vector<float>> spectrum;
+    std::vector<std::vector<float>> block;     // Saída da IMDCT
+    std::vector<std::vector<float>> saved;     // Metade direita do bloco anterior, sem janela
+    std::vector<std::vector<float>> planar;    // Quadros prontos de um pacote, por canal
+    std::vector<std::vector<int>> floorY;
+    std::vector<std::vector<uint8_t>> floorStep2;
+    std::vector<std::vector<float>> floorCurve;
+    std::vector<std::vector<uint8_t>> classifications;
+    std::vector<float> interleavedResidue;     // Resíduo tipo 2
+    std::vector<int> submapChannels;
+    std::array<bool, MAX_CHANNELS> hasFloor;
+    std::array<bool, MAX_CHANNELS> skipResidue;
+
+    std::vector<float> pending;                // PCM intercalado de um pacote
+    size_t pendingStart;
+    size_t pendingCount;
+    int previousBlockSize;                     // 0 = nenhum bloco para sobrepor
+    size_t skipPackets;                        // Pacotes de áudio pulados sem decodificar (seek)
+    std::vector<uint64_t> seekPages;           // Offsets das páginas em que algum pacote começa
+    std::vector<SeekPoint> seekPoints;         // Um por pacote de áudio, em ordem (lazy)
+    bool seekIndexBuilt;
+
+    uint64_t audioStart;                       // Primeira página de áudio
+    int64_t streamStart;                       // Granule da primeira amostra
+    int64_t streamEnd;                         // Último granule (-1 = desconhecido)
+    int64_t decodedEnd;                        // Granule da próxima amostra a ser gerada
+    int64_t discardBefore;                     // Amostras anteriores são descartadas (seek)
+    uint64_t position;
+
+    bool readHeaders();
+    bool readIdentification(const uint8_t* data, size_t size);
+    bool readSetup(const uint8_t* data, size_t size);
+    bool readCodebook(VorbisBitReader& bits, Codebook& book);
+    bool readFloor(VorbisBitReader& bits, Floor1& floor);
+    bool readResidue(VorbisBitReader& bits, Residue& residue);
+    bool readMapping(VorbisBitReader& bits, Mapping& mapping);
+    void allocateState();
+
+    int decodeEntry(const Codebook& book, VorbisBitReader& bits) const;
+    bool decodeFloor(const Floor1& floor, VorbisBitReader& bits, int channel);
+    void renderFloor(const Floor1& floor, int channel, int n);
+    void decodeResidue(const Residue& residue, VorbisBitReader& bits, const std::vector<int>& vectorChannels, int n);
+    int packetBlockSize(const OggDemuxer::Packet& packet) const;
+    bool decodePacket();
+    void emitFrames(int blockSize);
+
+    int64_t findStreamBase();
+    void buildSeekIndex();
+    void restartAt(uint64_t pageOffset, size_t skip, int64_t end, int64_t target);
+
+public:
+    VorbisDecoder();
+    ~VorbisDecoder() override;
+
+    VorbisDecoder(const VorbisDecoder&) = delete;
+    VorbisDecoder& operator=(const VorbisDecoder&) = delete;
+
+    // Implementação da interface AudioDecoder
+    void open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return demuxer.isOpen(); }
+    size_t decode(float* out, size_t maxFrames) override;
+    bool seek(uint64_t frame) override;
+    uint64_t getPosition() const override { return position; }
+    int getSampleRate() const override { return sampleRate; }
+    int getChannels() const override { return channels; }
+    uint64_t getTotalFrames() const override;
+    std::string getFormatName() const override { return "OGG"; }
+
+    int getShortBlockSize() const { return blockSizes[0]; }
+    int getLongBlockSize() const { return blockSizes[1]; }
+    const OggDemuxer::Statistics& getDemuxerStatistics() const { return demuxer.getStatistics(); }
+};
+
+#endif // VORBISDECODER_H
@@ -0,0 +1,40 @@
+#ifndef WAVDECODER_H
+#define WAVDECODER_H
+
+#include "AudioDecoder.h"
+#include "WavReader.h"
+
+/**
+ * @brief Decodificador de WAV para reprodução, sobre o WavReader
+ *
+ * Esta classe demonstra:
+ * - Herança: Implementa a interface AudioDecoder com o WavReader como backend
+ * - Desempenho: decode() converte direto do arquivo mapeado para o buffer da engine; a
+ *   única cópia possível é a do modo pread, usado em sistemas de arquivos lentos para mmap
+ * - Observabilidade: As estatísticas de E/S do leitor ficam expostas para diagnóstico
+ */
+class WavDecoder : public AudioDecoder {
+private:
+    WavReader reader;
+    WavReader::AccessMode accessMode;
+
+public:
+    explicit WavDecoder(WavReader::AccessMode access = WavReader::AccessMode::AUTO);
+
+    void open(const std::string& filePath) override;
+    void close() override { reader.close(); }
+    bool isOpen() const override { return reader.isOpen(); }
+    size_t decode(float* out, size_t maxFrames) override { return reader.read(out, maxFrames); }
+    bool seek(uint64_t frame) override { return reader.seek(frame); }
+    uint64_t getPosition() const override { return reader.getPosition(); }
+    int getSampleRate() const override { return reader.getFormat().sampleRate; }
+    int getChannels() const override { return reader.getFormat().channels; }
+    uint64_t getTotalFrames() const override { return reader.getFormat().totalFrames; }
+    std::string getFormatName() const override { return "WAV"; }
+
+    // Modo efetivo (mmap ou pread) e custo de E/S desde open()
+    WavReader::AccessMode getAccessMode() const { return reader.getAccessMode(); }
+    const WavReader::Statistics& getStatistics() const { return reader.getStatistics(); }
+};
+
+#endif // WAVDECODER_H
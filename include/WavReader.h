@@ -0,0 +1,119 @@
+#ifndef WAVREADER_H
+#define WAVREADER_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Leitor de arquivos WAV (RIFF) mapeados em memória, convertendo para float
+ *
+ * Esta classe demonstra:
+ * - Parsing binário: Chunks "fmt " e "data", inclusive WAVE_FORMAT_EXTENSIBLE
+ * - Desempenho: As amostras são convertidas direto das páginas mapeadas para o buffer do
+ *   chamador, sem cópia intermediária; o kernel recebe MADV_SEQUENTIAL/POSIX_FADV_SEQUENTIAL
+ *   e, à frente da posição de leitura, uma janela de READAHEAD_BYTES com WILLNEED
+ * - Estratégia de E/S: Em sistemas de arquivos de rede ou FUSE (onde cada falta de página
+ *   vira uma ida ao servidor) o modo AUTO usa pread em blocos de BUFFER_BYTES com
+ *   POSIX_FADV_WILLNEED; a cópia extra fica registrada nas estatísticas
+ * - Tratamento de exceções: loadFile() lança WavException; open() retorna false
+ *
+ * Formatos aceitos: PCM inteiro de 8, 16, 24 e 32 bits e ponto flutuante de 32 e 64 bits.
+ * A saída é PCM float intercalado, inteiros normalizados para [-1.0, 1.0).
+ */
+class WavReader {
+public:
+    static constexpr int MAX_CHANNELS = 8;
+
+    static constexpr size_t BUFFER_BYTES = 64 * 1024;            // Bloco de pread
+    static constexpr size_t READAHEAD_BYTES = 2 * 1024 * 1024;   // Janela de WILLNEED (~12 s em 44,1 kHz/16 bits)
+
+    enum class AccessMode {
+        AUTO,       // MAPPED, exceto em sistemas de arquivos lentos para mmap
+        MAPPED,     // Conversão direto das páginas mapeadas
+        BUFFERED    // pread para um buffer interno e conversão a partir dele
+    };
+
+    // Custo de E/S desde open(); as faltas de página são as da thread que chama read()
+    struct Statistics {
+        uint64_t framesRead = 0;
+        uint64_t bytesRead = 0;       // PCM consumido do arquivo
+        uint64_t bytesCopied = 0;     // Bytes copiados para o buffer interno (blocos de pread)
+        uint64_t readCalls = 0;       // Chamadas a pread
+        uint64_t readaheadHints = 0;  // madvise/posix_fadvise WILLNEED emitidos
+        uint64_t minorFaults = 0;     // Páginas já no cache do sistema
+        uint64_t majorFaults = 0;     // Páginas que exigiram E/S
+    };
+
+    struct Format {
+        int sampleRate = 0;
+        int channels = 0;
+        int bitsPerSample = 0;
+        bool floatingPoint = false;
+        uint64_t totalFrames = 0;
+    };
+
+private:
+    MappedFile file;
+    int descriptor;             // Apenas no modo BUFFERED
+    std::vector<uint8_t> buffer;
+    AccessMode mode;            // Modo efetivo (nunca AUTO depois de open)
+    Format format;
+    const uint8_t* samples;     // Início do chunk "data" (modo MAPPED)
+    uint64_t fileBytes;
+    uint64_t dataOffset;        // Início do chunk "data" no arquivo
+    size_t bytesPerFrame;
+    uint64_t position;
+    uint64_t readaheadEnd;      // Byte (relativo a "data") até onde já foi pedido readahead
+    uint64_t bufferStart;       // Trecho de "data" presente em 'buffer' (modo BUFFERED)
+    size_t bufferFill;
+    Statistics statistics;
+
+    bool fetch(uint64_t offset, void* destination, size_t count);
+    bool parseHeader();
+    bool openBuffered(const std::string& path);
+    void requestReadahead(uint64_t byteOffset);
+    void convert(const uint8_t* in, size_t count, float* out) const;
+
+public:
+    WavReader();
+    ~WavReader();
+
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    // Falha se o arquivo não existir ou não for um WAV em formato suportado
+    bool open(const std::string& path, AccessMode access = AccessMode::AUTO);
+    void close();
+    bool isOpen() const { return bytesPerFrame != 0; }
+
+    const Format& getFormat() const { return format; }
+    AccessMode getAccessMode() const { return mode; }
+    const Statistics& getStatistics() const { return statistics; }
+
+    // Converte até maxFrames quadros para out (intercalado); retorna 0 no fim dos dados
+    size_t read(float* out, size_t maxFrames);
+    bool seek(uint64_t frame);
+    uint64_t getPosition() const { return position; }
+
+    // Lê o arquivo inteiro (respostas ao impulso, efeitos curtos)
+    static std::vector<float> loadFile(const std::string& path, Format& format);
+
+    // NFS, SMB/CIFS, FUSE, 9p e afins: mmap paga uma ida ao servidor por falta de página
+    static bool prefersBufferedAccess(const std::string& path);
+    static const char* getAccessModeName(AccessMode mode);
+
+    // Classe de exceção para arquivos ausentes ou formatos não suportados
+    class WavException : public std::exception {
+    private:
+        std::string message;
+    public:
+        explicit WavException(const std::string& msg) : message(msg) {}
+        const char* what() const noexcept override { return message.c_str(); }
+    };
+};
+
+#endif // WAVREADER_H
@@ -0,0 +1,107 @@
+#ifndef WAVEFORMCACHE_H
+#define WAVEFORMCACHE_H
+
+#include "FrameIndexCache.h"
+#include "WaveformOverview.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Cache em disco das pirâmides de picos (WaveformOverview) da biblioteca
+ *
+ * Esta classe demonstra:
+ * - Persistência: Um arquivo binário compacto por mídia, escrito de forma atômica (tmp +
+ *   rename) e lido por mmap, sem cópia; invalidação por identidade do arquivo, como no
+ *   FrameIndexCache
+ * - Concorrência: Um pool fixo de threads consome uma fila de trabalhos; arquivos longos são
+ *   divididos em segmentos de SEGMENT_FRAMES decodificados em paralelo (seek exato) sobre o
+ *   mesmo Builder, e quem termina o último segmento monta a pirâmide e grava a entrada
+ * - Geração incremental em segundo plano: startGeneration() roda em uma thread própria; só
+ *   arquivos ausentes ou alterados são decodificados, e cada arquivo concluído é gravado na
+ *   hora, então um cancelamento preserva tudo o que já terminou
+ */
+class WaveformCache {
+public:
+    static constexpr uint64_t SEGMENT_FRAMES = WaveformOverview::BASE_FRAMES * 4096; // ~95 s em 44,1 kHz
+    static constexpr size_t DECODE_FRAMES = 4096;
+
+    // Contadores de uso do cache
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;     // Sem entrada para o arquivo
+        uint64_t stale = 0;      // Entrada existente mas a mídia mudou
+        uint64_t stores = 0;
+    };
+
+    struct Summary {
+        size_t files = 0;           // Arquivos distintos
+        size_t generated = 0;       // Decodificados nesta execução
+        size_t cached = 0;          // Já válidos no cache
+        size_t failed = 0;
+        size_t segments = 0;        // Trabalhos decodificados (>= generated em arquivos longos)
+        uint64_t framesDecoded = 0;
+        unsigned threads = 0;
+        bool cancelled = false;
+        double seconds = 0.0;
+    };
+
+    // (concluídos, total, arquivo); chamado serializado, a partir das threads do pool
+    using ProgressCallback = std::function<void(size_t, size_t, const std::string&)>;
+
+private:
+    std::string directory;
+    unsigned threadCount;
+    mutable std::mutex statsMutex;   // load/store podem vir de várias threads
+    Statistics statistics;
+
+    std::atomic<bool> cancelRequested;
+    std::atomic<bool> generating;
+    std::thread generationThread;    // startGeneration()
+    Summary lastSummary;             // Escrito pela generationThread antes de terminar
+
+    void count(uint64_t Statistics::*counter);
+    std::string entryPath(const FrameIndexCache::FileIdentity& identity) const;
+    Summary runGeneration(const std::vector<std::string>& mediaPaths, const ProgressCallback& progress);
+
+public:
+    explicit WaveformCache(const std::string& cacheDirectory = getDefaultDirectory(), unsigned threads = 0);
+    ~WaveformCache();
+
+    WaveformCache(const WaveformCache&) = delete;
+    WaveformCache& operator=(const WaveformCache&) = delete;
+
+    // Pirâmide mapeada em memória, ou nullptr se ausente/obsoleta
+    std::shared_ptr<const WaveformOverview> load(const std::string& mediaPath);
+    bool store(const std::string& mediaPath, const WaveformOverview& overview);
+    bool remove(const std::string& mediaPath);
+
+    // Gera as entradas ausentes ou obsoletas; bloqueia até terminar ou até cancel()
+    Summary generate(const std::vector<std::string>& mediaPaths, ProgressCallback progress = nullptr);
+    // O mesmo em segundo plano; false se uma geração já estiver em andamento
+    bool startGeneration(const std::vector<std::string>& mediaPaths, ProgressCallback progress = nullptr);
+    // Aguarda a geração em segundo plano e retorna o resumo dela
+    Summary waitForGeneration();
+    bool isGenerating() const { return generating.load(); }
+    // Qualquer thread: as threads do pool terminam o bloco atual e param
+    void cancel() { cancelRequested.store(true); }
+
+    // Cache ou, na falta dele, decodificação imediata (lança AudioDecoder::DecoderException)
+    std::shared_ptr<const WaveformOverview> getOrBuild(const std::string& mediaPath);
+
+    const std::string& getDirectory() const { return directory; }
+    unsigned getThreadCount() const { return threadCount; }
+    Statistics getStatistics() const;
+
+    // Pirâmide de um arquivo em uma única thread (lança AudioDecoder::DecoderException)
+    static std::unique_ptr<WaveformOverview> buildFile(const std::string& mediaPath);
+    // $XDG_CACHE_HOME/mp3player/waveform, ~/.cache/... ou o diretório temporário
+    static std::string getDefaultDirectory();
+};
+
+#endif // WAVEFORMCACHE_H
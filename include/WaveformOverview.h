@@ -0,0 +1,111 @@
+#ifndef WAVEFORMOVERVIEW_H
+#define WAVEFORMOVERVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Pirâmide de picos (mín/máx/RMS) de uma faixa, para desenhar e navegar a forma de onda
+ *
+ * Esta classe demonstra:
+ * - Mipmaps: O nível 0 resume cada BASE_FRAMES quadros; cada nível seguinte agrega FANOUT
+ *   picos do anterior, até restar um. Uma consulta usa o nível mais grosso cujo pico ainda
+ *   cabe em uma coluna, então custa O(colunas) para qualquer zoom e qualquer duração
+ * - Eficiência de memória: 6 bytes por pico (mín/máx em 16 bits arredondados para fora, RMS
+ *   em 16 bits); a pirâmide inteira ocupa ~1,33x o nível 0, ~2,5 MB para 2 horas em 44,1 kHz
+ * - Flexibilidade de armazenamento: Os dados podem ser próprios (Builder) ou uma visão de
+ *   memória mapeada de um arquivo de cache (WaveformCache), como em Mp3FrameIndex
+ *
+ * Os picos combinam todos os canais: mín/máx sobre todas as amostras e RMS da energia média.
+ */
+class WaveformOverview {
+public:
+    static constexpr size_t BASE_FRAMES = 1024;  // Quadros por pico no nível 0 (~23 ms em 44,1 kHz)
+    static constexpr size_t FANOUT = 4;          // Picos de um nível agregados em cada pico do seguinte
+    static constexpr size_t MAX_LEVELS = 24;
+
+    // Formato compacto (e de disco); amplitude 1,0 = 32767
+    struct Peak {
+        int16_t min;
+        int16_t max;
+        uint16_t rms;
+    };
+
+    // Resultado de uma consulta, em amplitude linear
+    struct Column {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+    };
+
+    // Visão somente leitura dos níveis (do mais fino para o mais grosso)
+    struct View {
+        const Peak* levels[MAX_LEVELS] = {};
+        size_t counts[MAX_LEVELS] = {};
+        size_t levelCount = 0;
+    };
+
+    /**
+     * Acumula o nível 0 em precisão total; aceita trechos em qualquer ordem e, desde que cada
+     * thread escreva trechos que começam em múltiplos de BASE_FRAMES, de várias threads ao
+     * mesmo tempo. build() gera os níveis superiores e quantiza.
+     */
+    class Builder {
+    private:
+        int channels;
+        std::vector<float> minimum;
+        std::vector<float> maximum;
+        std::vector<double> energy;     // Soma dos quadrados de cada pico
+
+    public:
+        // totalFrames = 0: duração desconhecida; o nível 0 cresce (apenas uma thread)
+        Builder(uint64_t totalFrames, int channels);
+
+        void addFrames(uint64_t startFrame, const float* interleaved, size_t frames);
+        std::unique_ptr<WaveformOverview> build(int sampleRate, uint64_t totalFrames) const;
+    };
+
+private:
+    std::vector<Peak> peaks;              // Todos os níveis, em sequência
+    int sampleRate;
+    int channels;
+    uint64_t totalFrames;
+
+    // Dados externos (arquivo mapeado); 'mappingOwner' mantém o mapeamento vivo
+    View levelView;
+    std::shared_ptr<const void> mappingOwner;
+
+public:
+    WaveformOverview(int sampleRate, int channels, uint64_t totalFrames);
+    // Pirâmide sobre memória externa; 'owner' é liberado junto com a visão
+    WaveformOverview(int sampleRate, int channels, uint64_t totalFrames, const View& external,
+                     std::shared_ptr<const void> owner);
+
+    WaveformOverview(const WaveformOverview&) = delete;
+    WaveformOverview& operator=(const WaveformOverview&) = delete;
+
+    // Divide [startFrame, endFrame) em 'count' colunas iguais; retorna quantas foram
+    // preenchidas (0 para intervalo vazio ou fora da faixa)
+    size_t query(uint64_t startFrame, uint64_t endFrame, Column* columns, size_t count) const;
+    // Nível mais grosso com no máximo framesPerColumn quadros por pico
+    size_t selectLevel(double framesPerColumn) const;
+
+    size_t getLevelCount() const { return levelView.levelCount; }
+    size_t getPeakCount(size_t level) const { return level < levelView.levelCount ? levelView.counts[level] : 0; }
+    static uint64_t getFramesPerPeak(size_t level);
+    int getSampleRate() const { return sampleRate; }
+    int getChannels() const { return channels; }
+    uint64_t getTotalFrames() const { return totalFrames; }
+    size_t getMemoryUsage() const;
+    bool isMapped() const { return mappingOwner != nullptr; }
+
+    // Níveis brutos para serialização
+    const View& getView() const { return levelView; }
+
+    // Número de níveis para uma faixa de totalFrames quadros
+    static size_t getLevelCountFor(uint64_t totalFrames);
+};
+
+#endif // WAVEFORMOVERVIEW_H
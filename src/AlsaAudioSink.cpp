@@ -0,0 +1,154 @@
+#include "AlsaAudioSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+
+#if defined(MP3PLAYER_HAVE_ALSA)
+#include <alsa/asoundlib.h>
+#endif
+
+AlsaAudioSink::AlsaAudioSink(const std::string& deviceName, unsigned latencyUs)
+    : device(deviceName.empty() ? "default" : deviceName), requestedLatencyUs(latencyUs), pcm(nullptr),
+      floatSamples(true), periodFrames(0), xruns(0) {}
+
+AlsaAudioSink::~AlsaAudioSink() {
+    close();
+}
+
+bool AlsaAudioSink::isAvailable() {
+#if defined(MP3PLAYER_HAVE_ALSA)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(MP3PLAYER_HAVE_ALSA)
+
+bool AlsaAudioSink::open(int rate, int channelCount) {
+    close();
+    if (rate <= 0 || channelCount <= 0) {
+        lastError = "formato inválido";
+        return false;
+    }
+
+    snd_pcm_t* handle = nullptr;
+    int err = snd_pcm_open(&handle, device.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0) {
+        lastError = snd_strerror(err);
+        return false;
+    }
+
+    // Float32 evita conversão no nosso lado; hardware que só aceita inteiros recebe int16
+    // (soft_resample = 1 deixa o plugin "plug" converter taxas que o dispositivo não tem)
+    floatSamples = true;
+    err = snd_pcm_set_params(handle, SND_PCM_FORMAT_FLOAT_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+                             static_cast<unsigned>(channelCount), static_cast<unsigned>(rate), 1,
+                             requestedLatencyUs);
+    if (err < 0) {
+        floatSamples = false;
+        err = snd_pcm_set_params(handle, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+                                 static_cast<unsigned>(channelCount), static_cast<unsigned>(rate), 1,
+                                 requestedLatencyUs);
+    }
+    if (err < 0) {
+        lastError = snd_strerror(err);
+        snd_pcm_close(handle);
+        return false;
+    }
+
+    snd_pcm_uframes_t buffer = 0;
+    snd_pcm_uframes_t period = 0;
+    if (snd_pcm_get_params(handle, &buffer, &period) == 0) {
+        bufferFrames = static_cast<size_t>(buffer);
+        periodFrames = static_cast<size_t>(period);
+    }
+
+    pcm = handle;
+    sampleRate = rate;
+    channels = channelCount;
+    xruns = 0;
+    reportLatency(0);
+    lastError.clear();
+    return true;
+}
+
+void AlsaAudioSink::close() {
+    if (!pcm) {
+        return;
+    }
+    auto* handle = static_cast<snd_pcm_t*>(pcm);
+    snd_pcm_drain(handle); // Tocar o que já está no buffer antes de fechar
+    snd_pcm_close(handle);
+    pcm = nullptr;
+    reportLatency(0);
+}
+
+size_t AlsaAudioSink::write(const float* interleaved, size_t frames) {
+    if (!pcm) {
+        return 0;
+    }
+    auto* handle = static_cast<snd_pcm_t*>(pcm);
+    const size_t channelCount = static_cast<size_t>(channels);
+
+    const void* data = interleaved;
+    if (!floatSamples) {
+        const size_t samples = frames * channelCount;
+        conversionBuffer.resize(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            float scaled = std::round(interleaved[i] * 32768.0f);
+            conversionBuffer[i] = static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+        }
+        data = conversionBuffer.data();
+    }
+    const size_t bytesPerFrame = channelCount * (floatSamples ? sizeof(float) : sizeof(int16_t));
+
+    size_t written = 0;
+    while (written < frames) {
+        const auto* chunk = static_cast<const unsigned char*>(data) + written * bytesPerFrame;
+        snd_pcm_sframes_t result = snd_pcm_writei(handle, chunk, frames - written);
+        if (result == -EAGAIN) {
+            continue;
+        }
+        if (result < 0) {
+            // -EPIPE (underrun) e -ESTRPIPE (suspensão) são recuperáveis: reprepara e tenta de novo
+            if (result == -EPIPE) {
+                ++xruns;
+            }
+            const int err = snd_pcm_recover(handle, static_cast<int>(result), 1);
+            if (err < 0) {
+                lastError = snd_strerror(err);
+                break;
+            }
+            continue;
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    snd_pcm_sframes_t delay = 0;
+    if (snd_pcm_delay(handle, &delay) == 0 && delay > 0) {
+        reportLatency(static_cast<uint64_t>(delay));
+    }
+    return written;
+}
+
+#else // Sem ALSA no build: a saída existe, mas nunca abre
+
+bool AlsaAudioSink::open(int rate, int channelCount) {
+    (void)rate;
+    (void)channelCount;
+    lastError = "suporte a ALSA não compilado (instale libasound2-dev e reconfigure)";
+    return false;
+}
+
+void AlsaAudioSink::close() {
+    pcm = nullptr;
+}
+
+size_t AlsaAudioSink::write(const float* interleaved, size_t frames) {
+    (void)interleaved;
+    (void)frames;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#include "AudioDecoder.h"
+#include "FlacDecoder.h"
+#include "Mp3Decoder.h"
+#include "VorbisDecoder.h"
+#include "WavDecoder.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+std::unique_ptr<AudioDecoder> AudioDecoder::createForFile(const std::string& filePath) {
+    std::string extension = std::filesystem::path(filePath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    std::unique_ptr<AudioDecoder> decoder;
+    if (extension == ".MP3") {
+        decoder = std::make_unique<Mp3Decoder>();
+    } else if (extension == ".WAV") {
+        decoder = std::make_unique<WavDecoder>();
+    } else if (extension == ".OGG") {
+        decoder = std::make_unique<VorbisDecoder>();
+    } else if (extension == ".FLAC") {
+        decoder = std::make_unique<FlacDecoder>();
+    } else {
+        throw DecoderException("Nenhum decodificador disponível para: " + filePath);
+    }
+
+    decoder->open(filePath);
+    return decoder;
+}
+
+bool AudioDecoder::hasDecoderFor(const std::string& format) {
+    return format == "MP3" || format == "WAV" || format == "OGG" || format == "FLAC";
+}
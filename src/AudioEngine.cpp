@@ -0,0 +1,660 @@
+#include "AudioEngine.h"
+#include "RealtimeGuard.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+AudioEngine::AudioEngine(std::unique_ptr<AudioSink> outputSink)
+    : sink(std::move(outputSink)), bufferFrames(DEFAULT_BUFFER_FRAMES),
+      stopRequested(false), paused(false), decoderFinished(false),
+      running(false), finished(false), framesRendered(0), pendingSeekFrame(-1),
+      positionBase(0), seekSerial(0), renderedSerial(0), underruns(0), trackBoundary(NO_BOUNDARY),
+      trackTransitions(0), sourceRequests(0), boundarySource(0), playingSource(0), finishedSeconds(0.0), crossfadeSeconds(0.0), crossfadeCurve(Crossfader::Curve::EQUAL_POWER),
+      firstSampleLatencyMs(-1.0), realtimeViolationBase(0), events(EVENT_QUEUE_CAPACITY),
+      positionSlot(0), positionPending(false), positionUpdates(0), transitionsDelivered(0), finishedDelivered(false),
+      positionUpdateHz(DEFAULT_POSITION_UPDATE_HZ), positionIntervalFrames(0), sampleRate(0), channels(0) {}
+
+AudioEngine::Event AudioEngine::Event::position(double seconds) {
+    Event event;
+    event.type = Type::POSITION;
+    event.seconds = seconds;
+    return event;
+}
+
+AudioEngine::Event AudioEngine::Event::finished(double seconds) {
+    Event event;
+    event.type = Type::FINISHED;
+    event.seconds = seconds;
+    return event;
+}
+
+AudioEngine::Event AudioEngine::Event::error(const std::string& text) {
+    Event event;
+    event.type = Type::ERROR_MESSAGE;
+    const size_t length = std::min(text.size(), MESSAGE_CAPACITY - 1);
+    std::memcpy(event.message, text.data(), length);
+    event.message[length] = '\0';
+    return event;
+}
+
+AudioEngine::Event AudioEngine::Event::trackChanged() {
+    Event event;
+    event.type = Type::TRACK_CHANGED;
+    return event;
+}
+
+AudioEngine::~AudioEngine() {
+    stop();
+}
+
+void AudioEngine::setSink(std::unique_ptr<AudioSink> outputSink) {
+    if (!outputSink) {
+        return;
+    }
+    stop();
+    sink = std::move(outputSink);
+}
+
+void AudioEngine::setProcessor(Processor blockProcessor) {
+    // Só alterado com as threads paradas ou antes de start()
+    stop();
+    processor = std::move(blockProcessor);
+}
+
+void AudioEngine::setNextSourceProvider(SourceProvider provider) {
+    std::lock_guard<std::mutex> lock(providerMutex);
+    nextSourceProvider = std::move(provider);
+}
+
+void AudioEngine::setCrossfade(double seconds, Crossfader::Curve curve) {
+    crossfadeCurve.store(curve);
+    crossfadeSeconds.store(std::min(std::max(seconds, 0.0), Crossfader::MAX_SECONDS));
+}
+
+void AudioEngine::setBufferFrames(size_t frames) {
+    bufferFrames = std::max(frames, PERIOD_FRAMES * 2);
+}
+
+void AudioEngine::setPositionUpdateRate(double hz) {
+    positionUpdateHz = std::max(hz, 0.0);
+    const int rate = sampleRate.load();
+    uint64_t interval = 0;
+    if (positionUpdateHz > 0.0 && rate > 0) {
+        interval = std::max<uint64_t>(1, static_cast<uint64_t>(rate / positionUpdateHz));
+    }
+    positionIntervalFrames.store(interval, std::memory_order_relaxed);
+}
+
+bool AudioEngine::start(std::unique_ptr<AudioDecoder> source) {
+    stop();
+    if (!source || !source->isOpen() || !sink) {
+        return false;
+    }
+
+    if (!sink->open(source->getSampleRate(), source->getChannels())) {
+        return false;
+    }
+
+    decoder = std::move(source);
+    sampleRate = decoder->getSampleRate();
+    channels = decoder->getChannels();
+    setPositionUpdateRate(positionUpdateHz);
+
+    // Toda alocação acontece aqui, fora das threads de áudio
+    const int channelCount = channels.load();
+    if (!ringBuffer || ringBuffer->getChannels() != channelCount ||
+        ringBuffer->getCapacity() < bufferFrames) {
+        ringBuffer = std::make_unique<PcmRingBuffer>(bufferFrames, channelCount);
+    } else {
+        ringBuffer->reset();
+    }
+    decodeBuffer.assign(BLOCK_FRAMES * static_cast<size_t>(channelCount), 0.0f);
+    outputBuffer.assign(PERIOD_FRAMES * static_cast<size_t>(channelCount), 0.0f);
+    lookaheadBuffer.assign(BLOCK_FRAMES * static_cast<size_t>(channelCount), 0.0f);
+    incomingBuffer.assign(BLOCK_FRAMES * static_cast<size_t>(channelCount), 0.0f);
+    crossfader.prepare(BLOCK_FRAMES, channelCount);
+
+    framesRendered = decoder->getPosition();
+    pendingSeekFrame = -1;
+    positionBase = decoder->getPosition();
+    seekSerial = 0;
+    renderedSerial = 0;
+    underruns = 0;
+    trackBoundary = NO_BOUNDARY;
+    trackTransitions = 0;
+    sourceRequests = 0;
+    boundarySource = 0;
+    playingSource = 0;
+    finishedSeconds = 0.0;
+    positionPending = false;
+    positionUpdates = 0;
+    transitionsDelivered = 0;  // Trocas e fim de uma reprodução anterior não valem mais
+    finishedDelivered = false;
+    firstSampleLatencyMs = -1.0;
+    realtimeViolationBase = RealtimeGuard::getStatistics().total;
+    stopRequested = false;
+    paused = false;
+    decoderFinished = false;
+    finished = false;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        statistics = Statistics();
+    }
+
+    startTime = std::chrono::steady_clock::now();
+    running = true;
+    decodeThread = std::thread(&AudioEngine::decodeLoop, this);
+    outputThread = std::thread(&AudioEngine::outputLoop, this);
+    return true;
+}
+
+void AudioEngine::pause() {
+    // O conteúdo do buffer é preservado: retomar não exige nova decodificação
+    paused = true;
+}
+
+void AudioEngine::resume() {
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        paused = false;
+    }
+    pauseChanged.notify_all();
+}
+
+void AudioEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        stopRequested = true;
+    }
+    pauseChanged.notify_all();
+    if (ringBuffer) {
+        ringBuffer->requestFlush(); // O(1): o consumidor descarta o restante
+    }
+    joinThreads();
+
+    if (sink && sink->isOpen()) {
+        sink->close();
+    }
+    decoder.reset();
+}
+
+bool AudioEngine::seek(double seconds) {
+    if (!running.load() || seconds < 0.0) {
+        return false;
+    }
+    pendingSeekFrame.store(static_cast<int64_t>(seconds * sampleRate.load()));
+    return true;
+}
+
+void AudioEngine::publishPosition(double seconds) {
+    const uint64_t micros = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e6 + 0.5);
+    const uint64_t track = trackTransitions.load(std::memory_order_relaxed) & 0xFFFF;
+    positionSlot.store(track << POSITION_TRACK_SHIFT | (micros & ((uint64_t(1) << POSITION_TRACK_SHIFT) - 1)),
+                       std::memory_order_relaxed);
+    positionPending.store(true, std::memory_order_release);
+}
+
+size_t AudioEngine::drainEvents(Event* output, size_t maxEvents) {
+    size_t count = events.popBatch(output, maxEvents);
+
+    // Fim lido antes das trocas: com ele visível, todas as trocas anteriores também estão
+    const bool ended = finished.load(std::memory_order_acquire);
+    const uint64_t transitions = trackTransitions.load(std::memory_order_acquire);
+    for (; count < maxEvents && transitionsDelivered < transitions; ++transitionsDelivered) {
+        output[count++] = Event::trackChanged();
+    }
+    if (count < maxEvents && ended && !finishedDelivered && transitionsDelivered == transitions) {
+        output[count++] = Event::finished(finishedSeconds.load());
+        finishedDelivered = true;
+        positionPending = false; // A posição final é a do fim
+    }
+
+    if (count < maxEvents && positionPending.exchange(false, std::memory_order_acquire)) {
+        const uint64_t slot = positionSlot.load(std::memory_order_relaxed);
+        const uint64_t track = slot >> POSITION_TRACK_SHIFT;
+        const uint64_t delivered = transitionsDelivered & 0xFFFF;
+        if (track == delivered) {
+            const uint64_t micros = slot & ((uint64_t(1) << POSITION_TRACK_SHIFT) - 1);
+            output[count++] = Event::position(static_cast<double>(micros) / 1e6);
+        } else if (((track - delivered) & 0xFFFF) < 0x8000) {
+            positionPending = true; // Fonte cujo TRACK_CHANGED ainda não saiu: fica para depois
+        }
+    }
+    return count;
+}
+
+void AudioEngine::waitUntilFinished() {
+    joinThreads();
+}
+
+void AudioEngine::joinThreads() {
+    const bool wasRunning = decodeThread.joinable() || outputThread.joinable();
+    if (decodeThread.joinable()) {
+        decodeThread.join();
+    }
+    if (outputThread.joinable()) {
+        outputThread.join();
+    }
+    running = false;
+
+    // Modo de depuração: o que a thread de saída alocou ou bloqueou nesta reprodução
+    if (wasRunning && RealtimeGuard::getStatistics().total > realtimeViolationBase) {
+        std::cerr << RealtimeGuard::formatReport();
+    }
+}
+
+double AudioEngine::getPositionSeconds() const {
+    int rate = sampleRate.load();
+    if (rate <= 0) {
+        return 0.0;
+    }
+    // Seek pendente ou ainda não tocado: reportar o destino, não o áudio antigo
+    int64_t pending = pendingSeekFrame.load();
+    if (pending >= 0) {
+        return static_cast<double>(pending) / rate;
+    }
+    if (seekSerial.load() != renderedSerial.load()) {
+        return static_cast<double>(positionBase.load()) / rate;
+    }
+    return static_cast<double>(framesRendered.load()) / rate;
+}
+
+AudioEngine::Statistics AudioEngine::getStatistics() const {
+    Statistics result;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        result = statistics;
+    }
+    if (ringBuffer) {
+        auto buffer = ringBuffer->getStatistics();
+        result.bufferCapacityFrames = buffer.capacityFrames;
+        result.bufferFillFrames = buffer.fillFrames;
+        result.bufferPeakFrames = buffer.peakFillFrames;
+    }
+    result.underruns = underruns.load();
+    result.timeToFirstSampleMs = firstSampleLatencyMs.load();
+    result.eventsDropped = events.getDroppedCount();
+    result.trackTransitions = trackTransitions.load();
+    result.positionUpdates = positionUpdates.load();
+    const uint64_t violations = RealtimeGuard::getStatistics().total;
+    result.realtimeViolations = violations > realtimeViolationBase ? violations - realtimeViolationBase : 0;
+    if (sink) {
+        result.sinkBufferFrames = sink->getBufferFrames();
+        result.outputLatencyMs = sink->getLatencyMs();
+    }
+    return result;
+}
+
+std::unique_ptr<AudioDecoder> AudioEngine::openNextSource(size_t& headFrames) {
+    using Clock = std::chrono::steady_clock;
+    headFrames = 0;
+    SourceProvider provider;
+    {
+        std::lock_guard<std::mutex> lock(providerMutex);
+        provider = nextSourceProvider;
+    }
+    if (!provider) {
+        return nullptr;
+    }
+
+    const auto begin = Clock::now();
+    std::unique_ptr<AudioDecoder> next;
+    ++sourceRequests; // Numera a fonte mesmo que ela seja descartada abaixo
+    try {
+        next = provider();
+        // Sem reabrir a saída só dá para continuar no mesmo formato
+        if (next && (!next->isOpen() || next->getSampleRate() != sampleRate.load() ||
+                     next->getChannels() != channels.load())) {
+            next.reset();
+        }
+        if (next) {
+            headFrames = next->decode(lookaheadBuffer.data(), BLOCK_FRAMES);
+        }
+    } catch (const std::exception& e) {
+        next.reset();
+        postEvent(Event::error(std::string("Falha ao abrir a próxima faixa: ") + e.what()));
+    }
+    if (next) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        statistics.lookaheadMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+    return next;
+}
+
+void AudioEngine::decodeLoop() {
+    using Clock = std::chrono::steady_clock;
+    const int channelCount = channels.load();
+    const size_t channelStride = static_cast<size_t>(channelCount);
+    const int rate = sampleRate.load();
+    const bool realtime = sink->isRealtime();
+    // Com o buffer cheio, dormir meio período (saída de tempo real) ou apenas ceder a CPU
+    const auto fullWait = std::chrono::microseconds(
+        static_cast<int64_t>(PERIOD_FRAMES * 500000.0 / rate));
+    const uint64_t lookaheadFrames = static_cast<uint64_t>(LOOKAHEAD_SECONDS * rate);
+
+    // Reprodução sem lacunas: a próxima fonte já aberta (com headFrames pré-decodificados) e a
+    // anterior, mantida até a saída cruzar a fronteira para que um seek ainda possa voltar a ela.
+    // Depois de uma troca, o que sobrou do bloco pré-decodificado pertence à fonte atual.
+    std::unique_ptr<AudioDecoder> nextDecoder;
+    std::unique_ptr<AudioDecoder> previousDecoder;
+    uint64_t nextSource = 0;             // Chamada ao provider que abriu nextDecoder
+    size_t headFrames = 0;
+    size_t headOffset = 0;               // Quadros de lookaheadBuffer já usados
+    bool lookaheadDone = false;          // Provider já consultado para a fonte atual
+    bool fading = false;                 // Crossfade em andamento: decoder sai, nextDecoder entra
+    uint64_t streamWritten = 0;          // Quadros escritos no buffer desde o último seek
+
+    // Seek que desfaz uma troca ainda não ouvida: a próxima fonte volta ao início
+    auto rewindNext = [&]() {
+        try {
+            headFrames = nextDecoder->seek(0) ? nextDecoder->decode(lookaheadBuffer.data(), BLOCK_FRAMES) : 0;
+        } catch (const std::exception&) {
+            headFrames = 0;
+        }
+        headOffset = 0;
+        lookaheadDone = headFrames > 0;
+        if (headFrames == 0) {
+            nextDecoder.reset(); // Sem o início pré-decodificado: perguntar de novo ao provider
+        }
+    };
+    // Próxima fonte em sequência: primeiro o bloco pré-decodificado, depois o decodificador
+    auto readNext = [&](float* out, size_t frames) {
+        const size_t fromHead = std::min(frames, headFrames - headOffset);
+        std::copy_n(lookaheadBuffer.begin() + static_cast<std::ptrdiff_t>(headOffset * channelStride),
+                    fromHead * channelStride, out);
+        headOffset += fromHead;
+        return fromHead + (fromHead < frames ? nextDecoder->decode(out + fromHead * channelStride, frames - fromHead)
+                                             : 0);
+    };
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (previousDecoder && trackBoundary.load(std::memory_order_acquire) == NO_BOUNDARY) {
+            previousDecoder.reset(); // A saída já toca a fonte nova
+        }
+
+        if (pendingSeekFrame.load() >= 0) {
+            // decoderFinished é limpo antes de consumir o pedido (ver outputLoop)
+            decoderFinished.store(false);
+            int64_t seekTarget = pendingSeekFrame.exchange(-1);
+            if (fading) {
+                fading = false;
+                crossfader.reset();
+                if (trackBoundary.exchange(NO_BOUNDARY) != NO_BOUNDARY) {
+                    rewindNext(); // Crossfade ainda não ouvido: o seek vale para a fonte que sai
+                } else {
+                    // Já se ouve a fonte que entra: ela assume sozinha
+                    decoder = std::move(nextDecoder);
+                    headFrames = headOffset = 0;
+                    lookaheadDone = false;
+                }
+            } else if (previousDecoder && trackBoundary.exchange(NO_BOUNDARY) != NO_BOUNDARY) {
+                // Fronteira ainda não tocada: o seek vale para a fonte que está soando
+                nextDecoder = std::move(decoder);
+                nextSource = boundarySource.load(std::memory_order_relaxed);
+                decoder = std::move(previousDecoder);
+                rewindNext();
+            } else if (!nextDecoder) {
+                headOffset = headFrames; // Resto do início da fonte atual: descartado pelo seek
+            }
+            try {
+                decoder->seek(static_cast<uint64_t>(seekTarget));
+            } catch (const std::exception& e) {
+                // Falha no seek: continuar de onde o decodificador estiver
+                postEvent(Event::error(std::string("Falha ao reposicionar: ") + e.what()));
+            }
+            // Descartar o áudio antigo antes de publicar o novo; a thread de saída
+            // vê o novo serial antes de qualquer quadro escrito depois dele
+            ringBuffer->requestFlush();
+            streamWritten = 0;
+            positionBase.store(decoder->getPosition(), std::memory_order_relaxed);
+            seekSerial.fetch_add(1, std::memory_order_release);
+        }
+
+        if (decoderFinished.load(std::memory_order_relaxed)) {
+            // Fim do stream: aguardar um seek, a parada ou o esvaziamento pela saída
+            if (finished.load()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+
+        // Perto do fim (antes do crossfade, se houver): abrir e pré-decodificar a próxima fonte
+        const uint64_t fadeFrames = static_cast<uint64_t>(crossfadeSeconds.load(std::memory_order_relaxed) * rate);
+        const bool headPending = !nextDecoder && headOffset < headFrames;
+        const uint64_t total = decoder->getTotalFrames();
+        if (!lookaheadDone && !nextDecoder && !headPending && total > 0 &&
+            decoder->getPosition() + lookaheadFrames + fadeFrames >= total) {
+            lookaheadDone = true;
+            nextDecoder = openNextSource(headFrames);
+            nextSource = sourceRequests;
+            headOffset = 0;
+        }
+
+        // Crossfade: começa exatamente fadeLength quadros antes do fim da fonte atual
+        size_t request = BLOCK_FRAMES;
+        if (!fading && nextDecoder && fadeFrames > 0 && total > 0) {
+            const uint64_t nextTotal = nextDecoder->getTotalFrames();
+            const uint64_t fadeLength = std::min({fadeFrames, total / 2, nextTotal > 0 ? nextTotal / 2 : fadeFrames});
+            const uint64_t fadeStart = total - fadeLength;
+            const uint64_t position = decoder->getPosition();
+            if (position < fadeStart) {
+                request = static_cast<size_t>(std::min<uint64_t>(request, fadeStart - position));
+            } else if (trackBoundary.load(std::memory_order_acquire) != NO_BOUNDARY) {
+                // Uma fronteira pendente por vez (fonte mais curta que o buffer)
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            } else if (position < total) {
+                fading = true;
+                crossfader.begin(crossfadeCurve.load(std::memory_order_relaxed), total - position);
+                boundarySource.store(nextSource, std::memory_order_relaxed);
+                trackBoundary.store(streamWritten, std::memory_order_release);
+            }
+        }
+
+        size_t frames = 0;
+        auto decodeBegin = Clock::now();
+        try {
+            if (headPending) {
+                // Continuação exata da fonte que acabou de assumir
+                frames = std::min(BLOCK_FRAMES, headFrames - headOffset);
+                std::copy_n(lookaheadBuffer.begin() + static_cast<std::ptrdiff_t>(headOffset * channelStride),
+                            frames * channelStride, decodeBuffer.begin());
+                headOffset += frames;
+            } else if (fading) {
+                // As duas fontes lado a lado; a que acabar antes completa com silêncio
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(BLOCK_FRAMES, crossfader.getRemaining()));
+                const size_t outgoing = decoder->decode(decodeBuffer.data(), count);
+                std::fill(decodeBuffer.begin() + static_cast<std::ptrdiff_t>(outgoing * channelStride),
+                          decodeBuffer.begin() + static_cast<std::ptrdiff_t>(count * channelStride), 0.0f);
+                const size_t incoming = readNext(incomingBuffer.data(), count);
+                std::fill(incomingBuffer.begin() + static_cast<std::ptrdiff_t>(incoming * channelStride),
+                          incomingBuffer.begin() + static_cast<std::ptrdiff_t>(count * channelStride), 0.0f);
+                frames = crossfader.process(decodeBuffer.data(), incomingBuffer.data(), count, channelCount);
+            } else {
+                frames = decoder->decode(decodeBuffer.data(), request);
+            }
+        } catch (const std::exception& e) {
+            frames = 0; // Stream corrompido: encerrar como fim de arquivo
+            postEvent(Event::error(std::string("Erro de decodificação: ") + e.what()));
+        }
+        auto decodeEnd = Clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            statistics.decodeSeconds += std::chrono::duration<double>(decodeEnd - decodeBegin).count();
+            statistics.framesDecoded += frames;
+            statistics.audioSeconds = static_cast<double>(statistics.framesDecoded) / rate;
+            if (statistics.decodeSeconds > 0.0) {
+                statistics.decodeSpeedFactor = statistics.audioSeconds / statistics.decodeSeconds;
+            }
+        }
+
+        if (fading && (frames == 0 || !crossfader.isActive())) {
+            // Fim do crossfade: a fonte que entrou segue sozinha
+            fading = false;
+            crossfader.reset();
+            previousDecoder = std::move(decoder);
+            decoder = std::move(nextDecoder);
+            lookaheadDone = false;
+        } else if (frames == 0) {
+            if (!lookaheadDone && !nextDecoder) {
+                lookaheadDone = true; // Duração desconhecida: só agora
+                nextDecoder = openNextSource(headFrames);
+                nextSource = sourceRequests;
+                headOffset = 0;
+            }
+            if (!nextDecoder) {
+                decoderFinished.store(true, std::memory_order_release);
+                continue;
+            }
+            if (trackBoundary.load(std::memory_order_acquire) != NO_BOUNDARY) {
+                // Uma fronteira pendente por vez (fonte mais curta que o buffer)
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+
+            // Fim exato desta fonte: a próxima continua no quadro seguinte do buffer, a
+            // começar pelo bloco pré-decodificado
+            previousDecoder = std::move(decoder);
+            decoder = std::move(nextDecoder);
+            lookaheadDone = false;
+            boundarySource.store(nextSource, std::memory_order_relaxed);
+            trackBoundary.store(streamWritten, std::memory_order_release);
+            continue;
+        }
+
+        size_t offset = 0;
+        while (offset < frames && !stopRequested.load(std::memory_order_relaxed) &&
+               pendingSeekFrame.load(std::memory_order_relaxed) < 0) {
+            size_t written = ringBuffer->write(decodeBuffer.data() + offset * channelStride, frames - offset);
+            offset += written;
+            streamWritten += written;
+            if (written == 0) {
+                if (realtime) {
+                    std::this_thread::sleep_for(fullWait);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+}
+
+void AudioEngine::outputLoop() {
+    using Clock = std::chrono::steady_clock;
+    const int channelCount = channels.load();
+    const size_t samples = PERIOD_FRAMES * static_cast<size_t>(channelCount);
+    const bool realtime = sink->isRealtime();
+    const int rate = sampleRate.load();
+    bool firstBlock = true;
+    uint32_t serial = 0;
+    uint64_t nextPositionEvent = 0;
+    bool positionReset = true;          // Início ou seek: publicar no próximo período
+    uint64_t streamRead = 0;            // Quadros lidos do buffer desde o último seek
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (paused.load(std::memory_order_relaxed)) {
+            std::unique_lock<std::mutex> lock(pauseMutex);
+            pauseChanged.wait(lock, [this] { return !paused.load() || stopRequested.load(); });
+            continue;
+        }
+
+        // Seek concluído pelo produtor: a posição recomeça no destino
+        uint32_t currentSerial = seekSerial.load(std::memory_order_acquire);
+        if (currentSerial != serial) {
+            serial = currentSerial;
+            framesRendered.store(positionBase.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            renderedSerial.store(serial, std::memory_order_relaxed);
+            positionReset = true;
+            streamRead = 0;
+        }
+
+        // Leitura e processamento do período: nada aqui pode alocar nem bloquear
+        // (verificado pelo RealtimeGuard nos builds de depuração; a escrita no sink bloqueia
+        // por projeto e fica de fora)
+        size_t frames = 0;
+        {
+            RealtimeGuard::Scope guard;
+            frames = ringBuffer->read(outputBuffer.data(), PERIOD_FRAMES);
+            if (frames > 0 && processor) {
+                processor(outputBuffer.data(), frames, channelCount);
+            }
+        }
+
+        // Fronteira entre fontes dentro deste período: a posição recomeça na primeira
+        // amostra da nova (antes do teste de fim, que só vale depois da última fonte)
+        streamRead += frames;
+        bool trackChanged = false;
+        uint64_t boundary = trackBoundary.load(std::memory_order_acquire);
+        // Lida antes da troca: depois dela a decodificação já pode anunciar a fonte seguinte
+        const uint64_t entering = boundarySource.load(std::memory_order_relaxed);
+        if (boundary != NO_BOUNDARY && streamRead >= boundary &&
+            trackBoundary.compare_exchange_strong(boundary, NO_BOUNDARY, std::memory_order_acq_rel)) {
+            trackChanged = true;
+            if (frames == 0) {
+                framesRendered.store(0, std::memory_order_relaxed);
+            }
+            playingSource.store(entering, std::memory_order_release);
+            trackTransitions.fetch_add(1, std::memory_order_release); // Entregue por drainEvents()
+        }
+
+        if (frames == 0) {
+            // Fim real: produtor terminou, nada no buffer e nenhum seek em andamento.
+            // A segunda leitura de decoderFinished fecha a janela em que o produtor
+            // acabou de aceitar um seek (ele limpa a flag antes de zerar o pedido).
+            if (decoderFinished.load() && ringBuffer->availableToRead() == 0 &&
+                pendingSeekFrame.load() < 0 && decoderFinished.load()) {
+                finishedSeconds = static_cast<double>(framesRendered.load()) / rate;
+                finished = true;
+                break;
+            }
+            if (realtime && !firstBlock) {
+                // Underrun: manter o relógio do dispositivo andando com silêncio
+                std::fill(outputBuffer.begin(), outputBuffer.begin() + samples, 0.0f);
+                sink->write(outputBuffer.data(), PERIOD_FRAMES);
+                underruns.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield(); // Pré-buffer inicial ou saída sem relógio
+            }
+            continue;
+        }
+
+        if (sink->write(outputBuffer.data(), frames) < frames && sink->isConsumerClosed()) {
+            // Fim da saída, não do stream: avisa a aplicação e encerra as duas threads
+            postEvent(Event::error("Saída encerrada pelo consumidor (" + sink->getName() + ")"));
+            stopRequested = true;
+            finishedSeconds = static_cast<double>(framesRendered.load()) / rate;
+            finished = true;
+            break;
+        }
+        uint64_t rendered = 0;
+        if (trackChanged) {
+            rendered = streamRead - boundary; // Quadros da nova fonte neste período
+            framesRendered.store(rendered, std::memory_order_relaxed);
+            positionReset = true;
+        } else {
+            rendered = framesRendered.fetch_add(frames, std::memory_order_relaxed) + frames;
+        }
+
+        // Posição para a aplicação, no máximo positionUpdateHz vezes por segundo de áudio
+        const uint64_t interval = positionIntervalFrames.load(std::memory_order_relaxed);
+        if (interval > 0 && (positionReset || rendered >= nextPositionEvent)) {
+            RealtimeGuard::Scope guard; // Publicar também não pode alocar nem bloquear
+            publishPosition(static_cast<double>(rendered) / rate);
+            positionUpdates.fetch_add(1, std::memory_order_relaxed);
+            // Grade fixa: a taxa média fica exata mesmo quando o intervalo não é múltiplo do período
+            const bool restart = positionReset || rendered >= nextPositionEvent + interval;
+            nextPositionEvent = restart ? rendered + interval : nextPositionEvent + interval;
+            positionReset = false;
+        }
+
+        if (firstBlock) {
+            firstBlock = false;
+            firstSampleLatencyMs.store(
+                std::chrono::duration<double, std::milli>(Clock::now() - startTime).count());
+        }
+    }
+
+    running = false;
+}
@@ -0,0 +1,327 @@
+#include "AudioSink.h"
+#include "AlsaAudioSink.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+void convertToInt16(const float* input, size_t samples, std::vector<int16_t>& output) {
+    output.resize(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        float scaled = std::round(input[i] * 32768.0f);
+        output[i] = static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+    }
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    if (text.size() < suffix.size()) {
+        return false;
+    }
+    return std::equal(suffix.rbegin(), suffix.rend(), text.rbegin(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+} // namespace
+
+// ===================== AudioSink =====================
+
+std::unique_ptr<AudioSink> AudioSink::createFromSpec(const std::string& spec) {
+    const size_t colon = spec.find(':');
+    const std::string kind = spec.substr(0, colon);
+    const std::string argument = colon == std::string::npos ? std::string() : spec.substr(colon + 1);
+
+    if (kind == "null") {
+        if (argument.empty() || argument == "paced") {
+            return std::make_unique<NullAudioSink>(true);
+        }
+        return argument == "fast" ? std::make_unique<NullAudioSink>(false) : nullptr;
+    }
+    if (kind == "alsa") {
+        if (!AlsaAudioSink::isAvailable()) {
+            return nullptr;
+        }
+        return std::make_unique<AlsaAudioSink>(argument.empty() ? "default" : argument);
+    }
+    if (kind == "stdout" || spec == "-") {
+        if (argument.empty() || argument == "s16") {
+            return std::make_unique<StdoutAudioSink>(StdoutAudioSink::SampleFormat::INT16);
+        }
+        return argument == "f32" ? std::make_unique<StdoutAudioSink>(StdoutAudioSink::SampleFormat::FLOAT32) : nullptr;
+    }
+    if (kind == "wav") {
+        // O caminho pode conter ':' (unidades no Windows); só um sufixo ":f32" é opção
+        std::string path = argument;
+        auto format = WavFileSink::SampleFormat::INT16;
+        if (endsWith(path, ":f32")) {
+            path.resize(path.size() - 4);
+            format = WavFileSink::SampleFormat::FLOAT32;
+        }
+        return path.empty() ? nullptr : std::make_unique<WavFileSink>(path, format);
+    }
+    if (endsWith(spec, ".wav")) {
+        return std::make_unique<WavFileSink>(spec);
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<std::string, std::string>> AudioSink::getAvailableSinks() {
+    std::vector<std::pair<std::string, std::string>> sinks;
+    if (AlsaAudioSink::isAvailable()) {
+        sinks.emplace_back("alsa[:dispositivo]", "placa de som via ALSA (padrão: default)");
+    }
+    sinks.emplace_back("null[:fast]", "descarta o áudio no ritmo do relógio (fast: sem ritmo)");
+    sinks.emplace_back("wav:arquivo[:f32]", "grava um arquivo WAV 16 bits (f32: float)");
+    sinks.emplace_back("stdout[:s16|f32]", "PCM cru na saída padrão, para encadear com aplay/sox");
+    return sinks;
+}
+
+// ===================== NullAudioSink =====================
+
+NullAudioSink::NullAudioSink(bool pacing, size_t simulatedBuffer)
+    : realtimePacing(pacing), simulatedBufferFrames(simulatedBuffer), opened(false), framesWritten(0) {}
+
+bool NullAudioSink::open(int rate, int channelCount) {
+    if (rate <= 0 || channelCount <= 0) {
+        return false;
+    }
+    sampleRate = rate;
+    channels = channelCount;
+    framesWritten = 0;
+    bufferFrames = realtimePacing ? simulatedBufferFrames : 0;
+    reportLatency(0);
+    startTime = std::chrono::steady_clock::now();
+    opened = true;
+    return true;
+}
+
+void NullAudioSink::close() {
+    opened = false;
+}
+
+size_t NullAudioSink::write(const float* interleaved, size_t frames) {
+    (void)interleaved;
+    if (!opened) {
+        return 0;
+    }
+    framesWritten += frames;
+
+    if (realtimePacing) {
+        // Bloquear até o instante em que um dispositivo real teria espaço no buffer
+        const uint64_t mustConsume = framesWritten > bufferFrames ? framesWritten - bufferFrames : 0;
+        auto due = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(mustConsume) / sampleRate));
+        std::this_thread::sleep_until(due);
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        const auto consumed = static_cast<uint64_t>(elapsed * sampleRate);
+        reportLatency(framesWritten > consumed ? framesWritten - consumed : 0);
+    }
+    return frames;
+}
+
+// ===================== WavFileSink =====================
+
+namespace {
+
+void writeLittleEndian(std::FILE* file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        std::fputc(static_cast<int>((value >> (8 * i)) & 0xFF), file);
+    }
+}
+
+} // namespace
+
+WavFileSink::WavFileSink(const std::string& path, SampleFormat sampleFormat)
+    : filePath(path), format(sampleFormat), file(nullptr), dataBytes(0) {}
+
+WavFileSink::~WavFileSink() {
+    close();
+}
+
+bool WavFileSink::open(int rate, int channelCount) {
+    close();
+    if (rate <= 0 || channelCount <= 0) {
+        return false;
+    }
+
+    file = std::fopen(filePath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    sampleRate = rate;
+    channels = channelCount;
+    dataBytes = 0;
+    writeHeader(); // Cabeçalho provisório; tamanhos corrigidos no close()
+    return true;
+}
+
+void WavFileSink::writeHeader() {
+    const uint32_t bytesPerSample = format == SampleFormat::INT16 ? 2 : 4;
+    const uint32_t formatTag = format == SampleFormat::INT16 ? 1 : 3; // PCM / IEEE float
+    const uint32_t blockAlign = bytesPerSample * static_cast<uint32_t>(channels);
+    const uint32_t dataSize = static_cast<uint32_t>(std::min<uint64_t>(dataBytes, 0xFFFFFFFFu - 36));
+
+    std::fwrite("RIFF", 1, 4, file);
+    writeLittleEndian(file, 36 + dataSize, 4);
+    std::fwrite("WAVE", 1, 4, file);
+    std::fwrite("fmt ", 1, 4, file);
+    writeLittleEndian(file, 16, 4);
+    writeLittleEndian(file, formatTag, 2);
+    writeLittleEndian(file, static_cast<uint32_t>(channels), 2);
+    writeLittleEndian(file, static_cast<uint32_t>(sampleRate), 4);
+    writeLittleEndian(file, static_cast<uint32_t>(sampleRate) * blockAlign, 4);
+    writeLittleEndian(file, blockAlign, 2);
+    writeLittleEndian(file, bytesPerSample * 8, 2);
+    std::fwrite("data", 1, 4, file);
+    writeLittleEndian(file, dataSize, 4);
+}
+
+void WavFileSink::close() {
+    if (!file) {
+        return;
+    }
+    std::fseek(file, 0, SEEK_SET);
+    writeHeader();
+    std::fclose(file);
+    file = nullptr;
+}
+
+size_t WavFileSink::write(const float* interleaved, size_t frames) {
+    if (!file) {
+        return 0;
+    }
+
+    const size_t samples = frames * static_cast<size_t>(channels);
+    size_t written = 0;
+
+    if (format == SampleFormat::FLOAT32) {
+        written = std::fwrite(interleaved, sizeof(float), samples, file);
+        dataBytes += written * sizeof(float);
+    } else {
+        convertToInt16(interleaved, samples, conversionBuffer);
+        written = std::fwrite(conversionBuffer.data(), sizeof(int16_t), samples, file);
+        dataBytes += written * sizeof(int16_t);
+    }
+    return written / static_cast<size_t>(channels);
+}
+
+// ===================== StdoutAudioSink =====================
+
+StdoutAudioSink::StdoutAudioSink(SampleFormat sampleFormat)
+    : format(sampleFormat), descriptor(-1), opened(false), consumerClosed(false) {
+    std::fflush(stdout);
+#ifndef _WIN32
+    descriptor = ::dup(STDOUT_FILENO);
+#else
+    descriptor = _dup(_fileno(stdout));
+    if (descriptor >= 0) {
+        _setmode(descriptor, _O_BINARY);
+    }
+#endif
+}
+
+StdoutAudioSink::~StdoutAudioSink() {
+    close();
+    if (descriptor >= 0) {
+#ifndef _WIN32
+        ::close(descriptor);
+#else
+        _close(descriptor);
+#endif
+    }
+}
+
+bool StdoutAudioSink::open(int rate, int channelCount) {
+    if (descriptor < 0 || rate <= 0 || channelCount <= 0) {
+        return false;
+    }
+#ifndef _WIN32
+    // Sem isto, escrever num pipe cujo leitor saiu (mp3player --sink stdout | head -c N)
+    // mata o processo com SIGPIPE; ignorado, o write() falha com EPIPE e a engine avisa
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    sampleRate = rate;
+    channels = channelCount;
+    const size_t bytesPerFrame =
+        static_cast<size_t>(channelCount) * (format == SampleFormat::INT16 ? sizeof(int16_t) : sizeof(float));
+    bufferFrames = 0;
+#if defined(F_GETPIPE_SZ)
+    // Pipe: a capacidade do kernel é o buffer entre nós e o consumidor
+    const int pipeBytes = ::fcntl(descriptor, F_GETPIPE_SZ);
+    if (pipeBytes > 0) {
+        bufferFrames = static_cast<size_t>(pipeBytes) / bytesPerFrame;
+    }
+#else
+    (void)bytesPerFrame;
+#endif
+    reportLatency(0);
+    opened = true;
+    return true;
+}
+
+void StdoutAudioSink::close() {
+    opened = false;
+}
+
+size_t StdoutAudioSink::writeBytes(const void* data, size_t bytes) {
+    const auto* cursor = static_cast<const char*>(data);
+    size_t done = 0;
+    while (done < bytes) {
+#ifndef _WIN32
+        const ssize_t result = ::write(descriptor, cursor + done, bytes - done);
+#else
+        const int result = _write(descriptor, cursor + done, static_cast<unsigned>(bytes - done));
+#endif
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EPIPE) {
+                consumerClosed.store(true, std::memory_order_relaxed);
+            }
+            break; // Consumidor fechou o pipe ou disco cheio
+        }
+        done += static_cast<size_t>(result);
+    }
+    return done;
+}
+
+size_t StdoutAudioSink::write(const float* interleaved, size_t frames) {
+    if (!opened) {
+        return 0;
+    }
+    const size_t samples = frames * static_cast<size_t>(channels);
+    size_t sampleBytes = sizeof(float);
+    size_t written = 0;
+    if (format == SampleFormat::FLOAT32) {
+        written = writeBytes(interleaved, samples * sizeof(float));
+    } else {
+        convertToInt16(interleaved, samples, conversionBuffer);
+        sampleBytes = sizeof(int16_t);
+        written = writeBytes(conversionBuffer.data(), samples * sizeof(int16_t));
+    }
+
+#if defined(FIONREAD)
+    // Em um pipe, FIONREAD conta os bytes que o consumidor ainda não leu
+    int pending = 0;
+    if (::ioctl(descriptor, FIONREAD, &pending) == 0 && pending >= 0) {
+        reportLatency(static_cast<uint64_t>(pending) / (sampleBytes * static_cast<size_t>(channels)));
+    }
+#endif
+    return written / (sampleBytes * static_cast<size_t>(channels));
+}
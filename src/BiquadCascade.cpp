@@ -0,0 +1,489 @@
+#include "BiquadCascade.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr float DENORMAL_THRESHOLD = 1e-20f; // Estado abaixo disso é zerado ao fim do bloco
+
+BiquadCoefficients normalize(double b0, double b1, double b2, double a0, double a1, double a2) {
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>(b0 / a0);
+    c.b1 = static_cast<float>(b1 / a0);
+    c.b2 = static_cast<float>(b2 / a0);
+    c.a1 = static_cast<float>(a1 / a0);
+    c.a2 = static_cast<float>(a2 / a0);
+    return c;
+}
+
+// Frequência angular normalizada, limitada abaixo de Nyquist
+double angularFrequency(double sampleRate, double frequency) {
+    return 2.0 * PI * std::min(frequency, 0.45 * sampleRate) / sampleRate;
+}
+
+} // namespace
+
+// ===================== Projeto dos filtros (RBJ Audio EQ Cookbook) =====================
+
+BiquadCoefficients BiquadCoefficients::lowShelf(double sampleRate, double frequency, double gainDb,
+                                                double slope) {
+    if (gainDb == 0.0) {
+        return BiquadCoefficients();
+    }
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double w0 = angularFrequency(sampleRate, frequency);
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / 2.0 * std::sqrt((A + 1.0 / A) * (1.0 / slope - 1.0) + 2.0);
+    const double k = 2.0 * std::sqrt(A) * alpha;
+    return normalize(A * ((A + 1.0) - (A - 1.0) * cosW + k),
+                     2.0 * A * ((A - 1.0) - (A + 1.0) * cosW),
+                     A * ((A + 1.0) - (A - 1.0) * cosW - k),
+                     (A + 1.0) + (A - 1.0) * cosW + k,
+                     -2.0 * ((A - 1.0) + (A + 1.0) * cosW),
+                     (A + 1.0) + (A - 1.0) * cosW - k);
+}
+
+BiquadCoefficients BiquadCoefficients::highShelf(double sampleRate, double frequency, double gainDb,
+                                                 double slope) {
+    if (gainDb == 0.0) {
+        return BiquadCoefficients();
+    }
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double w0 = angularFrequency(sampleRate, frequency);
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / 2.0 * std::sqrt((A + 1.0 / A) * (1.0 / slope - 1.0) + 2.0);
+    const double k = 2.0 * std::sqrt(A) * alpha;
+    return normalize(A * ((A + 1.0) + (A - 1.0) * cosW + k),
+                     -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW),
+                     A * ((A + 1.0) + (A - 1.0) * cosW - k),
+                     (A + 1.0) - (A - 1.0) * cosW + k,
+                     2.0 * ((A - 1.0) - (A + 1.0) * cosW),
+                     (A + 1.0) - (A - 1.0) * cosW - k);
+}
+
+BiquadCoefficients BiquadCoefficients::peaking(double sampleRate, double frequency, double gainDb,
+                                               double q) {
+    if (gainDb == 0.0) {
+        return BiquadCoefficients();
+    }
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double w0 = angularFrequency(sampleRate, frequency);
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    return normalize(1.0 + alpha * A, -2.0 * cosW, 1.0 - alpha * A,
+                     1.0 + alpha / A, -2.0 * cosW, 1.0 - alpha / A);
+}
+
+double BiquadCoefficients::magnitudeDb(double sampleRate, double frequency) const {
+    // |H(e^jw)|² = |b0 + b1 e^-jw + b2 e^-2jw|² / |1 + a1 e^-jw + a2 e^-2jw|²
+    const double w = 2.0 * PI * frequency / sampleRate;
+    const double c1 = std::cos(w), s1 = std::sin(w), c2 = std::cos(2.0 * w), s2 = std::sin(2.0 * w);
+    const double numRe = b0 + b1 * c1 + b2 * c2, numIm = -(b1 * s1 + b2 * s2);
+    const double denRe = 1.0 + a1 * c1 + a2 * c2, denIm = -(a1 * s1 + a2 * s2);
+    return 10.0 * std::log10((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+// ===================== Cascata =====================
+
+template <size_t Sections>
+BiquadCascade<Sections>::BiquadCascade() : preparedChannels(0), coefficientsDirty(true) {
+    laneB0.fill(0.0f);
+    laneB1.fill(0.0f);
+    laneB2.fill(0.0f);
+    laneA1.fill(0.0f);
+    laneA2.fill(0.0f);
+    reset();
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::setSection(size_t index, const Coefficients& coefficients) {
+    if (index < Sections) {
+        sections[index] = coefficients;
+        coefficientsDirty = true;
+    }
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::reset() {
+    stateZ1.fill(0.0f);
+    stateZ2.fill(0.0f);
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::prepareLanes(int channels) {
+    if (channels != preparedChannels) {
+        reset(); // O layout do estado depende do número de canais
+        preparedChannels = channels;
+    }
+    for (size_t s = 0; s < Sections; ++s) {
+        for (int c = 0; c < channels; ++c) {
+            const size_t lane = s * static_cast<size_t>(channels) + static_cast<size_t>(c);
+            laneB0[lane] = sections[s].b0;
+            laneB1[lane] = sections[s].b1;
+            laneB2[lane] = sections[s].b2;
+            laneA1[lane] = sections[s].a1;
+            laneA2[lane] = sections[s].a2;
+        }
+    }
+    coefficientsDirty = false;
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::flushDenormals(int channels) {
+    // Caudas de IIR decaindo para denormais custariam ~100x por operação
+    const size_t lanes = Sections * static_cast<size_t>(channels);
+    for (size_t i = 0; i < lanes; ++i) {
+        if (std::fabs(stateZ1[i]) < DENORMAL_THRESHOLD) stateZ1[i] = 0.0f;
+        if (std::fabs(stateZ2[i]) < DENORMAL_THRESHOLD) stateZ2[i] = 0.0f;
+    }
+}
+
+template <size_t Sections>
+CpuFeatures::SimdLevel BiquadCascade<Sections>::getKernelLevel(int channels, CpuFeatures::SimdLevel level) {
+    switch (level) {
+        case CpuFeatures::SimdLevel::AVX2:
+            // 5 a 7 canais deixam o último grupo de 8 lanes incompleto e ficam atrás do escalar
+            return (channels >= 5 && channels <= 7) ? CpuFeatures::SimdLevel::Scalar : level;
+        case CpuFeatures::SimdLevel::SSE2:
+            // Quatro lanes: sem espaço para mais de quatro canais; cascatas curtas não compensam
+            return (channels > 4 || Sections < SSE2_MIN_SECTIONS) ? CpuFeatures::SimdLevel::Scalar : level;
+        default:
+            return CpuFeatures::SimdLevel::Scalar;
+    }
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::process(float* interleaved, size_t frames, int channels) {
+    process(interleaved, frames, channels, CpuFeatures::getSimdLevel());
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::process(float* interleaved, size_t frames, int channels,
+                                      CpuFeatures::SimdLevel level) {
+    if (!interleaved || frames == 0 || channels <= 0 || channels > MAX_CHANNELS) {
+        return;
+    }
+    if (coefficientsDirty || channels != preparedChannels) {
+        prepareLanes(channels);
+    }
+
+    switch (getKernelLevel(channels, level)) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            runAvx2(interleaved, frames, channels);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            runSse2(interleaved, frames, channels);
+            break;
+#endif
+        default:
+            runScalar(interleaved, frames, channels);
+            break;
+    }
+    flushDenormals(channels);
+}
+
+// Referência: y = b0*x + z1; z1 = (b1*x + z2) - a1*y; z2 = b2*x - a2*y.
+// Os kernels vetoriais repetem exatamente esta ordem, então o resultado é idêntico bit a bit.
+template <size_t Sections>
+void BiquadCascade<Sections>::runScalar(float* interleaved, size_t frames, int channels) {
+    const size_t stride = static_cast<size_t>(channels);
+    for (size_t t = 0; t < frames; ++t) {
+        float* frame = interleaved + t * stride;
+        for (size_t c = 0; c < stride; ++c) {
+            float x = frame[c];
+            for (size_t s = 0; s < Sections; ++s) {
+                const size_t lane = s * stride + c;
+                const float y = laneB0[lane] * x + stateZ1[lane];
+                stateZ1[lane] = (laneB1[lane] * x + stateZ2[lane]) - laneA1[lane] * y;
+                stateZ2[lane] = laneB2[lane] * x - laneA2[lane] * y;
+                x = y;
+            }
+            frame[c] = x;
+        }
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+namespace {
+
+// Lanes 0..count-1 de um quadro intercalado (sem ler além do quadro)
+inline __m128 loadFrameSse(const float* frame, int count) {
+    switch (count) {
+        case 1: return _mm_load_ss(frame);
+        case 2: return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(frame)));
+        case 3: return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(frame))),
+                                     _mm_load_ss(frame + 2));
+        default: return _mm_loadu_ps(frame);
+    }
+}
+
+inline void storeFrameSse(float* frame, __m128 value, int count) {
+    switch (count) {
+        case 1: _mm_store_ss(frame, value); break;
+        case 2: _mm_store_sd(reinterpret_cast<double*>(frame), _mm_castps_pd(value)); break;
+        case 3:
+            _mm_store_sd(reinterpret_cast<double*>(frame), _mm_castps_pd(value));
+            _mm_store_ss(frame + 2, _mm_movehl_ps(value, value));
+            break;
+        default: _mm_storeu_ps(frame, value); break;
+    }
+}
+
+// Desloca lanes para cima (seção s recebe a saída da seção s-1); C é constante de compilação
+template <int C>
+inline __m128 shiftUpSse(__m128 value) {
+    return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(value), 4 * C));
+}
+
+template <int C>
+inline __m128 shiftDownSse(__m128 value, int sections) {
+    // Saída da última seção do grupo para as lanes 0..C-1
+    switch (sections) {
+        case 2: return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(value), 4 * C));
+        case 3: return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(value), 8 * C));
+        case 4: return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(value), 12 * C));
+        default: return value;
+    }
+}
+
+// Pipeline de 'group' seções a partir de 'first', com C canais em 4 lanes (group * C <= 4)
+template <int C>
+void runGroupSse2(float* interleaved, size_t frames, size_t first, int group,
+                  const float* b0p, const float* b1p, const float* b2p, const float* a1p, const float* a2p,
+                  float* z1p, float* z2p) {
+    const size_t base = first * C;
+    const int lanes = group * C;
+    alignas(16) int32_t laneMask[4];
+    alignas(16) int32_t laneSection[4];
+    for (int i = 0; i < 4; ++i) {
+        laneMask[i] = i < lanes ? -1 : 0;
+        laneSection[i] = i / C;
+    }
+    const __m128 valid = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(laneMask)));
+    const __m128i section = _mm_load_si128(reinterpret_cast<const __m128i*>(laneSection));
+
+    const __m128 b0 = _mm_loadu_ps(b0p + base);
+    const __m128 b1 = _mm_loadu_ps(b1p + base);
+    const __m128 b2 = _mm_loadu_ps(b2p + base);
+    const __m128 a1 = _mm_loadu_ps(a1p + base);
+    const __m128 a2 = _mm_loadu_ps(a2p + base);
+    __m128 z1 = _mm_and_ps(_mm_loadu_ps(z1p + base), valid);
+    __m128 z2 = _mm_and_ps(_mm_loadu_ps(z2p + base), valid);
+    __m128 y = _mm_setzero_ps();
+
+    const size_t latency = static_cast<size_t>(group - 1);
+    const size_t steps = frames + latency;
+    for (size_t t = 0; t < steps; ++t) {
+        const __m128 input = t < frames ? loadFrameSse(interleaved + t * C, C) : _mm_setzero_ps();
+        const __m128 x = _mm_or_ps(shiftUpSse<C>(y), input);
+        const __m128 out = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+        const __m128 nextZ1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, x), z2), _mm_mul_ps(a1, out));
+        const __m128 nextZ2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, out));
+
+        if (t < latency || t >= frames) {
+            // Início/fim do pipeline: só avançam as seções com amostra t - s dentro do bloco
+            const __m128i step = _mm_set1_epi32(static_cast<int32_t>(t));
+            const __m128i started = _mm_cmpgt_epi32(_mm_add_epi32(step, _mm_set1_epi32(1)), section);
+            const __m128i pending = _mm_cmpgt_epi32(_mm_add_epi32(section, _mm_set1_epi32(static_cast<int32_t>(frames))), step);
+            const __m128 active = _mm_and_ps(_mm_castsi128_ps(_mm_and_si128(started, pending)), valid);
+            z1 = _mm_or_ps(_mm_and_ps(active, nextZ1), _mm_andnot_ps(active, z1));
+            z2 = _mm_or_ps(_mm_and_ps(active, nextZ2), _mm_andnot_ps(active, z2));
+        } else {
+            z1 = nextZ1;
+            z2 = nextZ2;
+        }
+        y = out;
+
+        if (t >= latency) {
+            storeFrameSse(interleaved + (t - latency) * C, shiftDownSse<C>(y, group), C);
+        }
+    }
+
+    // Grava apenas as lanes do grupo (as seguintes pertencem ao próximo grupo)
+    alignas(16) float z1Out[4];
+    alignas(16) float z2Out[4];
+    _mm_store_ps(z1Out, z1);
+    _mm_store_ps(z2Out, z2);
+    for (int i = 0; i < lanes; ++i) {
+        z1p[base + static_cast<size_t>(i)] = z1Out[i];
+        z2p[base + static_cast<size_t>(i)] = z2Out[i];
+    }
+}
+
+// Grupos de seções que cabem nas lanes; com S constante o laço é desenrolado
+template <int C, size_t S>
+void runAllSse2(float* interleaved, size_t frames,
+                const float* b0, const float* b1, const float* b2, const float* a1, const float* a2,
+                float* z1, float* z2) {
+    constexpr size_t perGroup = 4 / C;
+    for (size_t first = 0; first < S; first += perGroup) {
+        const int group = static_cast<int>(std::min(perGroup, S - first));
+        runGroupSse2<C>(interleaved, frames, first, group, b0, b1, b2, a1, a2, z1, z2);
+    }
+}
+
+// Lanes 0..C-1 de um quadro; acima de 4 canais, acesso mascarado
+template <int C>
+MP3PLAYER_TARGET_AVX2 inline __m256 loadFrameAvx(const float* frame, __m256i mask) {
+    if constexpr (C <= 4) {
+        (void)mask;
+        return _mm256_castps128_ps256(loadFrameSse(frame, C)); // Lanes altas ignoradas pelo blend
+    } else if constexpr (C == 8) {
+        (void)mask;
+        return _mm256_loadu_ps(frame);
+    } else {
+        return _mm256_maskload_ps(frame, mask);
+    }
+}
+
+template <int C>
+MP3PLAYER_TARGET_AVX2 inline void storeFrameAvx(float* frame, __m256 value, __m256i mask) {
+    if constexpr (C <= 4) {
+        (void)mask;
+        storeFrameSse(frame, _mm256_castps256_ps128(value), C);
+    } else if constexpr (C == 8) {
+        (void)mask;
+        _mm256_storeu_ps(frame, value);
+    } else {
+        _mm256_maskstore_ps(frame, mask, value);
+    }
+}
+
+// Mesmo pipeline em 8 lanes; deslocamentos entre metades de 128 bits via permutação
+template <int C>
+MP3PLAYER_TARGET_AVX2
+void runGroupAvx2(float* interleaved, size_t frames, size_t first, int group,
+                  const float* b0p, const float* b1p, const float* b2p, const float* a1p, const float* a2p,
+                  float* z1p, float* z2p) {
+    const size_t base = first * C;
+    const int lanes = group * C;
+    alignas(32) int32_t laneMask[8];
+    alignas(32) int32_t inputMask[8];
+    alignas(32) int32_t laneSection[8];
+    alignas(32) int32_t shiftUp[8];
+    alignas(32) int32_t shiftDown[8];
+    for (int i = 0; i < 8; ++i) {
+        laneMask[i] = i < lanes ? -1 : 0;
+        inputMask[i] = i < C ? -1 : 0;
+        laneSection[i] = i / C;
+        shiftUp[i] = i >= C ? i - C : 0;
+        shiftDown[i] = std::min(i + (group - 1) * C, 7);
+    }
+    const __m256i valid = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneMask));
+    const __m256i inputLanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputMask));
+    const __m256i section = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneSection));
+    const __m256i upIndex = _mm256_load_si256(reinterpret_cast<const __m256i*>(shiftUp));
+    const __m256i downIndex = _mm256_load_si256(reinterpret_cast<const __m256i*>(shiftDown));
+    const __m256 inputBlend = _mm256_castsi256_ps(inputLanes);
+
+    const __m256 b0 = _mm256_loadu_ps(b0p + base);
+    const __m256 b1 = _mm256_loadu_ps(b1p + base);
+    const __m256 b2 = _mm256_loadu_ps(b2p + base);
+    const __m256 a1 = _mm256_loadu_ps(a1p + base);
+    const __m256 a2 = _mm256_loadu_ps(a2p + base);
+    __m256 z1 = _mm256_maskload_ps(z1p + base, valid);
+    __m256 z2 = _mm256_maskload_ps(z2p + base, valid);
+    __m256 y = _mm256_setzero_ps();
+
+    const size_t latency = static_cast<size_t>(group - 1);
+    const size_t steps = frames + latency;
+    for (size_t t = 0; t < steps; ++t) {
+        const __m256 input = t < frames ? loadFrameAvx<C>(interleaved + t * C, inputLanes) : _mm256_setzero_ps();
+        const __m256 x = _mm256_blendv_ps(_mm256_permutevar8x32_ps(y, upIndex), input, inputBlend);
+        const __m256 out = _mm256_add_ps(_mm256_mul_ps(b0, x), z1);
+        const __m256 nextZ1 = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(b1, x), z2), _mm256_mul_ps(a1, out));
+        const __m256 nextZ2 = _mm256_sub_ps(_mm256_mul_ps(b2, x), _mm256_mul_ps(a2, out));
+
+        if (t < latency || t >= frames) {
+            const __m256i step = _mm256_set1_epi32(static_cast<int32_t>(t));
+            const __m256i started = _mm256_cmpgt_epi32(_mm256_add_epi32(step, _mm256_set1_epi32(1)), section);
+            const __m256i pending = _mm256_cmpgt_epi32(
+                _mm256_add_epi32(section, _mm256_set1_epi32(static_cast<int32_t>(frames))), step);
+            const __m256 active = _mm256_castsi256_ps(_mm256_and_si256(_mm256_and_si256(started, pending), valid));
+            z1 = _mm256_blendv_ps(z1, nextZ1, active);
+            z2 = _mm256_blendv_ps(z2, nextZ2, active);
+        } else {
+            z1 = nextZ1;
+            z2 = nextZ2;
+        }
+        y = out;
+
+        if (t >= latency) {
+            storeFrameAvx<C>(interleaved + (t - latency) * C, _mm256_permutevar8x32_ps(y, downIndex), inputLanes);
+        }
+    }
+
+    _mm256_maskstore_ps(z1p + base, valid, z1);
+    _mm256_maskstore_ps(z2p + base, valid, z2);
+}
+
+template <int C, size_t S>
+void runAllAvx2(float* interleaved, size_t frames,
+                const float* b0, const float* b1, const float* b2, const float* a1, const float* a2,
+                float* z1, float* z2) {
+    constexpr size_t perGroup = 8 / C;
+    for (size_t first = 0; first < S; first += perGroup) {
+        const int group = static_cast<int>(std::min(perGroup, S - first));
+        runGroupAvx2<C>(interleaved, frames, first, group, b0, b1, b2, a1, a2, z1, z2);
+    }
+}
+
+} // namespace
+
+// Instancia o kernel para o número de canais (constante de compilação)
+#define BIQUAD_DISPATCH(KERNEL, C)                                                                 \
+    KERNEL<C, Sections>(interleaved, frames, laneB0.data(), laneB1.data(), laneB2.data(),         \
+                        laneA1.data(), laneA2.data(), stateZ1.data(), stateZ2.data())
+
+template <size_t Sections>
+void BiquadCascade<Sections>::runSse2(float* interleaved, size_t frames, int channels) {
+    switch (channels) {
+        case 1: BIQUAD_DISPATCH(runAllSse2, 1); break;
+        case 2: BIQUAD_DISPATCH(runAllSse2, 2); break;
+        case 3: BIQUAD_DISPATCH(runAllSse2, 3); break;
+        default: BIQUAD_DISPATCH(runAllSse2, 4); break;
+    }
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::runAvx2(float* interleaved, size_t frames, int channels) {
+    switch (channels) {
+        case 1: BIQUAD_DISPATCH(runAllAvx2, 1); break;
+        case 2: BIQUAD_DISPATCH(runAllAvx2, 2); break;
+        case 3: BIQUAD_DISPATCH(runAllAvx2, 3); break;
+        case 4: BIQUAD_DISPATCH(runAllAvx2, 4); break;
+        case 5: BIQUAD_DISPATCH(runAllAvx2, 5); break;
+        case 6: BIQUAD_DISPATCH(runAllAvx2, 6); break;
+        case 7: BIQUAD_DISPATCH(runAllAvx2, 7); break;
+        default: BIQUAD_DISPATCH(runAllAvx2, 8); break;
+    }
+}
+
+#undef BIQUAD_DISPATCH
+
+#else
+
+template <size_t Sections>
+void BiquadCascade<Sections>::runSse2(float* interleaved, size_t frames, int channels) {
+    runScalar(interleaved, frames, channels);
+}
+
+template <size_t Sections>
+void BiquadCascade<Sections>::runAvx2(float* interleaved, size_t frames, int channels) {
+    runScalar(interleaved, frames, channels);
+}
+
+#endif
+
+// Tamanhos usados pela ponderação K (LoudnessMeter) e pelo equalizador (BasicEqualizer<N>)
+template class BiquadCascade<2>;
+template class BiquadCascade<3>;
+template class BiquadCascade<10>;
+template class BiquadCascade<31>;
@@ -1,50 +1,75 @@
 #include "CLI.h"
+#include "OfflineRenderer.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <chrono>
+#include <thread>
 
-CLI::CLI() : app(std::make_unique<MP3PlayerApp>()) {}
+namespace {
 
-CLI::~CLI() = default;
+const char* const LEVEL_BLOCKS[] = {" ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+// Uma linha com uma barra de 8 alturas por banda do analisador
+std::string spectrumLine(const SpectrumAnalyzer& analyzer) {
+    std::string line;
+    for (size_t bar = 0; bar < analyzer.getBarCount(); ++bar) {
+        line += LEVEL_BLOCKS[std::lround(analyzer.getLevel(bar) * 8.0f)];
+    }
+    return line;
+}
+
+std::string formatFrequency(double hertz) {
+    std::ostringstream text;
+    if (hertz >= 1000.0) {
+        text << std::fixed << std::setprecision(hertz >= 10000.0 ? 0 : 1) << hertz / 1000.0 << " kHz";
+    } else {
+        text << std::fixed << std::setprecision(0) << hertz << " Hz";
+    }
+    return text.str();
+}
+
+} // namespace
+
+CLI::CLI() : app(std::make_unique<MP3PlayerApp>()), running(false), prompt("> ") {}
+
+CLI::CLI(std::unique_ptr<MP3PlayerApp> application)
+    : app(application ? std::move(application) : std::make_unique<MP3PlayerApp>()), running(false), prompt("> ") {}
 
 void CLI::run() {
     try {
-        showWelcome();
-        app->inicializar();
+        displayWelcome();
+        if (!app->initialize()) {
+            printError("Falha ao inicializar a aplicação.");
+            return;
+        }
         
-        bool running = true;
+        running = true;
+        std::string input;
         while (running) {
-            try {
-                showPrompt();
-                std::string input = readInput();
-                
-                if (input.empty()) continue;
-                
-                auto command = parseCommand(input);
-                if (command.empty()) continue;
-                
-                if (command[0] == "quit" || command[0] == "exit" || command[0] == "q") {
-                    running = false;
-                    continue;
-                }
-                
-                executeCommand(command);
-                
-            } catch (const std::exception& e) {
-                showError("Erro na execução do comando: " + std::string(e.what()));
+            std::cout << "\n" << prompt << std::flush;
+            if (!std::getline(std::cin, input)) {
+                break; // Fim da entrada (Ctrl+D ou comandos vindos de um pipe)
             }
+            processCommand(input);
         }
         
-        app->finalizar();
-        showGoodbye();
+        shutdown();
         
     } catch (const std::exception& e) {
-        showError("Erro crítico: " + std::string(e.what()));
+        printError("Erro crítico: " + std::string(e.what()));
     }
 }
 
-void CLI::showWelcome() {
+void CLI::shutdown() {
+    running = false;
+    app->shutdown();
+    displayGoodbye();
+}
+
+void CLI::displayWelcome() {
     std::cout << "\n";
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                      MP3 PLAYER CLI                         ║\n";
@@ -55,7 +80,7 @@ void CLI::showWelcome() {
     std::cout << "Digite 'quit' para sair.\n\n";
 }
 
-void CLI::showGoodbye() {
+void CLI::displayGoodbye() {
     std::cout << "\n";
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                     Obrigado por usar o                     ║\n";
@@ -64,16 +89,6 @@ void CLI::showGoodbye() {
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n\n";
 }
 
-void CLI::showPrompt() {
-    std::cout << "\n> ";
-}
-
-std::string CLI::readInput() {
-    std::string input;
-    std::getline(std::cin, input);
-    return input;
-}
-
 std::vector<std::string> CLI::parseCommand(const std::string& input) {
     std::vector<std::string> tokens;
     std::istringstream iss(input);
@@ -86,82 +101,111 @@ std::vector<std::string> CLI::parseCommand(const std::string& input) {
     return tokens;
 }
 
-void CLI::executeCommand(const std::vector<std::string>& command) {
-    if (command.empty()) return;
-    
-    const std::string& cmd = command[0];
-    
-    // Comandos de controle de reprodução
-    if (cmd == "play") {
-        cmdPlay(command);
-    }
-    else if (cmd == "pause") {
-        cmdPause();
-    }
-    else if (cmd == "stop") {
-        cmdStop();
-    }
-    else if (cmd == "next") {
-        cmdNext();
-    }
-    else if (cmd == "prev" || cmd == "previous") {
-        cmdPrevious();
-    }
-    else if (cmd == "volume" || cmd == "vol") {
-        cmdVolume(command);
-    }
-    else if (cmd == "seek") {
-        cmdSeek(command);
-    }
-    
-    // Comandos de playlist
-    else if (cmd == "playlist" || cmd == "pl") {
-        cmdPlaylist(command);
-    }
-    else if (cmd == "add") {
-        cmdAdd(command);
-    }
-    else if (cmd == "remove" || cmd == "rm") {
-        cmdRemove(command);
-    }
-    else if (cmd == "list" || cmd == "ls") {
-        cmdList(command);
-    }
+void CLI::processCommand(const std::string& commandLine) {
+    try {
+        auto command = parseCommand(commandLine);
+        if (command.empty()) {
+            return;
+        }
+        
+        // Trocas de faixa e fim do stream ocorridos enquanto o prompt esperava
+        app->getPlayer()->processEvents();
+        
+        const std::string& cmd = command[0];
+        if (cmd == "quit" || cmd == "exit" || cmd == "q") {
+            cmdQuit(command);
+            return;
+        }
+        
+        // Comandos de controle de reprodução
+        if (cmd == "play") {
+            cmdPlay(command);
+        }
+        else if (cmd == "pause") {
+            cmdPause(command);
+        }
+        else if (cmd == "stop") {
+            cmdStop(command);
+        }
+        else if (cmd == "next") {
+            cmdNext(command);
+        }
+        else if (cmd == "prev" || cmd == "previous") {
+            cmdPrevious(command);
+        }
+        else if (cmd == "volume" || cmd == "vol") {
+            cmdVolume(command);
+        }
+        else if (cmd == "seek") {
+            cmdSeek(command);
+        }
     
-    // Comandos de biblioteca
-    else if (cmd == "scan") {
-        cmdScan(command);
-    }
-    else if (cmd == "search" || cmd == "find") {
-        cmdSearch(command);
-    }
+        // Comandos de playlist
+        else if (cmd == "playlist" || cmd == "pl") {
+            cmdPlaylist(command);
+        }
+        else if (cmd == "add") {
+            cmdAdd(command);
+        }
+        else if (cmd == "remove" || cmd == "rm") {
+            cmdRemove(command);
+        }
+        else if (cmd == "list" || cmd == "ls") {
+            cmdList(command);
+        }
     
-    // Comandos de configuração
-    else if (cmd == "equalizer" || cmd == "eq") {
-        cmdEqualizer(command);
-    }
+        // Comandos de biblioteca
+        else if (cmd == "scan") {
+            cmdScan(command);
+        }
+        else if (cmd == "search" || cmd == "find") {
+            cmdSearch(command);
+        }
     
-    // Comandos de informação
-    else if (cmd == "status" || cmd == "info") {
-        cmdStatus();
-    }
-    else if (cmd == "current" || cmd == "now") {
-        cmdCurrent();
-    }
-    else if (cmd == "help" || cmd == "h") {
-        cmdHelp(command);
-    }
+        // Comandos de configuração
+        else if (cmd == "equalizer" || cmd == "eq") {
+            cmdEqualizer(command);
+        }
+        else if (cmd == "crossfade" || cmd == "xfade") {
+            cmdCrossfade(command);
+        }
     
-    // Comandos de arquivo
-    else if (cmd == "save") {
-        cmdSave(command);
-    }
-    else if (cmd == "load") {
-        cmdLoad(command);
-    }
+        // Comandos de informação
+        else if (cmd == "status" || cmd == "info") {
+            cmdStatus(command);
+        }
+        else if (cmd == "current" || cmd == "now") {
+            cmdCurrent(command);
+        }
+        else if (cmd == "waveform" || cmd == "wave") {
+            cmdWaveform(command);
+        }
+        else if (cmd == "spectrum" || cmd == "spec") {
+            cmdSpectrum(command);
+        }
+        else if (cmd == "help" || cmd == "h") {
+            cmdHelp(command);
+        }
     
-    else {
-        showError("Comando desconhecido: " + cmd + ". Digite 'help' para ver os comandos disponíveis.");
+        // Comandos de arquivo
+        else if (cmd == "save") {
+            cmdSave(command);
+        }
+        else if (cmd == "render") {
+            cmdRender(command);
+        }
+        else if (cmd == "load") {
+            cmdLoad(command);
+        }
+        
+        else {
+            printError("Comando desconhecido: " + cmd + ". Digite 'help' para ver os comandos disponíveis.");
+        }
+        
+        // Erros e eventos provocados pelo próprio comando
+        app->getPlayer()->processEvents();
+    } catch (const std::exception& e) {
+        printError("Erro na execução do comando: " + std::string(e.what()));
     }
 }
 
@@ -174,56 +218,64 @@ void CLI::cmdPlay(const std::vector<std::string>& args) {
             int index = std::stoi(args[1]) - 1; // Converter para índice base 0
             auto playlist = player->getCurrentPlaylist();
             if (playlist && index >= 0 && index < static_cast<int>(playlist->size())) {
-                const auto& tracks = playlist->getTracks();
-                player->loadTrack(tracks[index]);
-                player->play();
-                showSuccess("Reproduzindo: " + tracks[index]->getTitle());
+                const auto& tracks = playlist->getAllTracks();
+                // Posicionar a playlist para que next/gapless sigam a partir daqui
+                playlist->setCurrentIndex(static_cast<size_t>(index));
+                if (player->loadTrack(tracks[index]) && player->play()) {
+                    printSuccess("Reproduzindo: " + tracks[index]->getTitle());
+                }
             } else {
-                showError("Índice de música inválido.");
+                printError("Índice de música inválido.");
             }
         } catch (const std::exception&) {
-            showError("Índice inválido. Use: play [número]");
+            printError("Índice inválido. Use: play [número]");
         }
     } else {
         // Play/resume música atual
-        player->play();
+        if (!player->play()) {
+            return; // Erro já reportado pelo callback do player
+        }
         if (auto track = player->getCurrentTrack()) {
-            showSuccess("Reproduzindo: " + track->getTitle());
+            printSuccess("Reproduzindo: " + track->getTitle());
         } else {
-            showInfo("Reprodução iniciada (nenhuma música selecionada).");
+            printInfo("Reprodução iniciada (nenhuma música selecionada).");
         }
     }
 }
 
-void CLI::cmdPause() {
+void CLI::cmdPause(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     player->pause();
-    showInfo("Reprodução pausada.");
+    printInfo("Reprodução pausada.");
 }
 
-void CLI::cmdStop() {
+void CLI::cmdStop(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     player->stop();
-    showInfo("Reprodução parada.");
+    printInfo("Reprodução parada.");
 }
 
-void CLI::cmdNext() {
+void CLI::cmdNext(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     player->next();
     if (auto track = player->getCurrentTrack()) {
-        showInfo("Próxima música: " + track->getTitle());
+        printInfo("Próxima música: " + track->getTitle());
     } else {
-        showInfo("Próxima música (lista vazia).");
+        printInfo("Próxima música (lista vazia).");
     }
 }
 
-void CLI::cmdPrevious() {
+void CLI::cmdPrevious(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     player->previous();
     if (auto track = player->getCurrentTrack()) {
-        showInfo("Música anterior: " + track->getTitle());
+        printInfo("Música anterior: " + track->getTitle());
     } else {
-        showInfo("Música anterior (lista vazia).");
+        printInfo("Música anterior (lista vazia).");
     }
 }
 
@@ -234,22 +286,22 @@ void CLI::cmdVolume(const std::vector<std::string>& args) {
         try {
             float volume = std::stof(args[1]);
             if (volume < 0 || volume > 100) {
-                showError("Volume deve estar entre 0 e 100.");
+                printError("Volume deve estar entre 0 e 100.");
                 return;
             }
-            player->setVolume(volume);
-            showSuccess("Volume ajustado para " + std::to_string(static_cast<int>(volume)) + "%");
+            player->setVolume(volume / 100.0);
+            printSuccess("Volume ajustado para " + std::to_string(static_cast<int>(volume)) + "%");
         } catch (const std::exception&) {
-            showError("Volume inválido. Use: volume [0-100]");
+            printError("Volume inválido. Use: volume [0-100]");
         }
     } else {
-        showInfo("Volume atual: " + std::to_string(static_cast<int>(player->getVolume())) + "%");
+        printInfo("Volume atual: " + std::to_string(static_cast<int>(std::lround(player->getVolume() * 100.0))) + "%");
     }
 }
 
 void CLI::cmdSeek(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: seek [posição em segundos]");
+        printError("Use: seek [posição em segundos]");
         return;
     }
     
@@ -257,9 +309,9 @@ void CLI::cmdSeek(const std::vector<std::string>& args) {
         double position = std::stod(args[1]);
         auto player = app->getPlayer();
         player->seek(position);
-        showSuccess("Posição ajustada para " + std::to_string(static_cast<int>(position)) + " segundos");
+        printSuccess("Posição ajustada para " + std::to_string(static_cast<int>(position)) + " segundos");
     } catch (const std::exception&) {
-        showError("Posição inválida. Use: seek [segundos]");
+        printError("Posição inválida. Use: seek [segundos]");
     }
 }
 
@@ -270,14 +322,14 @@ void CLI::cmdPlaylist(const std::vector<std::string>& args) {
         const auto& playlists = player->getPlaylists();
         
         if (playlists.empty()) {
-            showInfo("Nenhuma playlist encontrada.");
+            printInfo("Nenhuma playlist encontrada.");
             return;
         }
         
         std::cout << "\n--- PLAYLISTS DISPONÍVEIS ---\n";
         for (size_t i = 0; i < playlists.size(); ++i) {
             const auto& playlist = playlists[i];
-            std::cout << std::setw(3) << (i + 1) << ". " << playlist->getName() 
+            std::cout << std::right << std::setw(3) << (i + 1) << ". " << playlist->getName() 
                       << " (" << playlist->size() << " músicas)\n";
         }
         return;
@@ -287,7 +339,7 @@ void CLI::cmdPlaylist(const std::vector<std::string>& args) {
     
     if (action == "create" || action == "new") {
         if (args.size() < 3) {
-            showError("Use: playlist create [nome]");
+            printError("Use: playlist create [nome]");
             return;
         }
         
@@ -299,11 +351,11 @@ void CLI::cmdPlaylist(const std::vector<std::string>& args) {
         auto player = app->getPlayer();
         auto playlist = std::make_shared<Playlist>(name);
         player->addPlaylist(playlist);
-        showSuccess("Playlist '" + name + "' criada.");
+        printSuccess("Playlist '" + name + "' criada.");
     }
     else if (action == "select" || action == "use") {
         if (args.size() < 3) {
-            showError("Use: playlist select [número ou nome]");
+            printError("Use: playlist select [número ou nome]");
             return;
         }
         
@@ -314,9 +366,9 @@ void CLI::cmdPlaylist(const std::vector<std::string>& args) {
             int index = std::stoi(args[2]) - 1;
             if (index >= 0 && index < static_cast<int>(playlists.size())) {
                 player->setCurrentPlaylist(playlists[index]);
-                showSuccess("Playlist selecionada: " + playlists[index]->getName());
+                printSuccess("Playlist selecionada: " + playlists[index]->getName());
             } else {
-                showError("Índice de playlist inválido.");
+                printError("Índice de playlist inválido.");
             }
         } catch (const std::exception&) {
             // Tentar buscar por nome
@@ -328,21 +380,21 @@ void CLI::cmdPlaylist(const std::vector<std::string>& args) {
             for (const auto& playlist : playlists) {
                 if (playlist->getName() == name) {
                     player->setCurrentPlaylist(playlist);
-                    showSuccess("Playlist selecionada: " + name);
+                    printSuccess("Playlist selecionada: " + name);
                     return;
                 }
             }
-            showError("Playlist não encontrada: " + name);
+            printError("Playlist não encontrada: " + name);
         }
     }
     else {
-        showError("Ação inválida. Use: playlist [create|select] [parâmetros]");
+        printError("Ação inválida. Use: playlist [create|select] [parâmetros]");
     }
 }
 
 void CLI::cmdAdd(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: add [caminho do arquivo]");
+        printError("Use: add [caminho do arquivo]");
         return;
     }
     
@@ -354,7 +406,7 @@ void CLI::cmdAdd(const std::vector<std::string>& args) {
     try {
         auto track = Track::createFromFile(filePath);
         if (!track) {
-            showError("Não foi possível carregar a música.");
+            printError("Não foi possível carregar a música.");
             return;
         }
         
@@ -370,15 +422,15 @@ void CLI::cmdAdd(const std::vector<std::string>& args) {
         }
         
         currentPlaylist->addTrack(track);
-        showSuccess("Música adicionada: " + track->getTitle());
+        printSuccess("Música adicionada: " + track->getTitle());
     } catch (const std::exception& e) {
-        showError("Erro ao adicionar música: " + std::string(e.what()));
+        printError("Erro ao adicionar música: " + std::string(e.what()));
     }
 }
 
 void CLI::cmdRemove(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: remove [índice da música]");
+        printError("Use: remove [índice da música]");
         return;
     }
     
@@ -389,57 +441,58 @@ void CLI::cmdRemove(const std::vector<std::string>& args) {
         auto currentPlaylist = player->getCurrentPlaylist();
         
         if (!currentPlaylist) {
-            showError("Nenhuma playlist selecionada.");
+            printError("Nenhuma playlist selecionada.");
             return;
         }
         
         if (index < 0 || index >= static_cast<int>(currentPlaylist->size())) {
-            showError("Índice inválido.");
+            printError("Índice inválido.");
             return;
         }
         
-        const auto& tracks = currentPlaylist->getTracks();
+        const auto& tracks = currentPlaylist->getAllTracks();
         std::string title = tracks[index]->getTitle();
         
         currentPlaylist->removeTrack(index);
-        showSuccess("Música removida: " + title);
+        printSuccess("Música removida: " + title);
     } catch (const std::exception&) {
-        showError("Índice inválido. Use: remove [número]");
+        printError("Índice inválido. Use: remove [número]");
     }
 }
 
 void CLI::cmdList(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     auto currentPlaylist = player->getCurrentPlaylist();
     
     if (!currentPlaylist) {
-        showError("Nenhuma playlist selecionada.");
+        printError("Nenhuma playlist selecionada.");
         return;
     }
     
-    const auto& tracks = currentPlaylist->getTracks();
+    const auto& tracks = currentPlaylist->getAllTracks();
     
     if (tracks.empty()) {
-        showInfo("Playlist vazia.");
+        printInfo("Playlist vazia.");
         return;
     }
     
     std::cout << "\n--- MÚSICAS NA PLAYLIST: " << currentPlaylist->getName() << " ---\n";
     for (size_t i = 0; i < tracks.size(); ++i) {
         const auto& track = tracks[i];
-        std::cout << std::setw(3) << (i + 1) << ". " 
+        std::cout << std::right << std::setw(3) << (i + 1) << ". " 
                   << std::setw(30) << std::left << track->getTitle()
                   << " - " << std::setw(20) << track->getArtist()
-                  << " (" << track->getDurationFormatted() << ")\n";
+                  << " (" << track->getDurationString() << ")\n";
     }
     
     std::cout << "\nTotal: " << tracks.size() << " músicas, " 
-              << currentPlaylist->getTotalDurationFormatted() << "\n";
+              << currentPlaylist->getTotalDurationString() << "\n";
 }
 
 void CLI::cmdScan(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: scan [caminho do diretório]");
+        printError("Use: scan [caminho do diretório]");
         return;
     }
     
@@ -449,13 +502,13 @@ void CLI::cmdScan(const std::vector<std::string>& args) {
     }
     
     try {
-        showInfo("Escaneando diretório: " + directoryPath);
+        printInfo("Escaneando diretório: " + directoryPath);
         
         auto scanner = createAudioScanner();
         auto tracks = scanner->scanForTracks(directoryPath);
         
         if (tracks.empty()) {
-            showInfo("Nenhuma música encontrada.");
+            printInfo("Nenhuma música encontrada.");
             return;
         }
         
@@ -473,15 +526,15 @@ void CLI::cmdScan(const std::vector<std::string>& args) {
             currentPlaylist->addTrack(track);
         }
         
-        showSuccess("Adicionadas " + std::to_string(tracks.size()) + " músicas à biblioteca.");
+        printSuccess("Adicionadas " + std::to_string(tracks.size()) + " músicas à biblioteca.");
     } catch (const std::exception& e) {
-        showError("Erro ao escanear: " + std::string(e.what()));
+        printError("Erro ao escanear: " + std::string(e.what()));
     }
 }
 
 void CLI::cmdSearch(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: search [termo de busca]");
+        printError("Use: search [termo de busca]");
         return;
     }
     
@@ -494,11 +547,11 @@ void CLI::cmdSearch(const std::vector<std::string>& args) {
     auto currentPlaylist = player->getCurrentPlaylist();
     
     if (!currentPlaylist) {
-        showError("Nenhuma playlist selecionada.");
+        printError("Nenhuma playlist selecionada.");
         return;
     }
     
-    const auto& tracks = currentPlaylist->getTracks();
+    const auto& tracks = currentPlaylist->getAllTracks();
     std::vector<std::pair<size_t, std::shared_ptr<Track>>> results;
     
     std::string lowerTerm = searchTerm;
@@ -519,14 +572,14 @@ void CLI::cmdSearch(const std::vector<std::string>& args) {
     }
     
     if (results.empty()) {
-        showInfo("Nenhuma música encontrada para: " + searchTerm);
+        printInfo("Nenhuma música encontrada para: " + searchTerm);
         return;
     }
     
     std::cout << "\n--- RESULTADOS DA BUSCA: \"" << searchTerm << "\" ---\n";
     for (const auto& result : results) {
         const auto& track = result.second;
-        std::cout << std::setw(3) << (result.first + 1) << ". "
+        std::cout << std::right << std::setw(3) << (result.first + 1) << ". "
                   << std::setw(30) << std::left << track->getTitle()
                   << " - " << track->getArtist() << "\n";
     }
@@ -539,7 +592,7 @@ void CLI::cmdEqualizer(const std::vector<std::string>& args) {
     auto equalizer = player->getEqualizer();
     
     if (!equalizer) {
-        showError("Equalizador não disponível.");
+        printError("Equalizador não disponível.");
         return;
     }
     
@@ -557,24 +610,43 @@ void CLI::cmdEqualizer(const std::vector<std::string>& args) {
     const std::string& preset = args[1];
     
     try {
-        equalizer->setPreset(preset);
-        showSuccess("Preset aplicado: " + preset);
+        equalizer->applyPreset(preset);
+        printSuccess("Preset aplicado: " + preset);
     } catch (const std::exception& e) {
-        showError("Preset inválido: " + preset);
+        printError("Preset inválido: " + preset);
     }
 }
 
-void CLI::cmdStatus() {
+void CLI::displayStatus() {
     auto player = app->getPlayer();
     
     std::cout << "\n--- STATUS DO PLAYER ---\n";
-    std::cout << "Estado: " << (player->isPlaying() ? "Reproduzindo" : "Parado") << "\n";
-    std::cout << "Volume: " << static_cast<int>(player->getVolume()) << "%\n";
+    std::cout << "Estado: " << (player->getIsPlaying() ? "Reproduzindo" : "Parado") << "\n";
+    std::cout << "Volume: " << std::lround(player->getVolume() * 100.0) << "%\n";
     
     if (auto equalizer = player->getEqualizer()) {
         std::cout << "Equalizador: " << equalizer->getCurrentPreset() << "\n";
     }
     
+    if (auto sink = player->getAudioSink()) {
+        std::ostringstream output;
+        output << "Saída de áudio: " << sink->getName();
+        if (sink->isOpen()) {
+            output << " (buffer " << sink->getBufferFrames() << " quadros, latência " << std::fixed
+                   << std::setprecision(1) << sink->getLatencyMs() << " ms)";
+        }
+        std::cout << output.str() << "\n";
+    }
+    
+    if (auto analyzer = player->getSpectrumAnalyzer(); analyzer && player->getIsPlaying()) {
+        analyzer->analyze(0.0);
+        std::cout << "Espectro: |" << spectrumLine(*analyzer) << "|";
+        if (analyzer->getPeakFrequency() > 0.0) {
+            std::cout << " pico em " << formatFrequency(analyzer->getPeakFrequency());
+        }
+        std::cout << "\n";
+    }
+    
     if (auto playlist = player->getCurrentPlaylist()) {
         std::cout << "Playlist atual: " << playlist->getName() 
                   << " (" << playlist->size() << " músicas)\n";
@@ -582,10 +654,16 @@ void CLI::cmdStatus() {
         std::cout << "Playlist atual: Nenhuma\n";
     }
     
-    std::cout << "Total de playlists: " << player->getPlaylists().size() << "\n";
+    std::cout << "Total de playlists: " << app->getAvailablePlaylists().size() << "\n";
 }
 
-void CLI::cmdCurrent() {
+void CLI::cmdStatus(const std::vector<std::string>& args) {
+    (void)args;
+    displayStatus();
+}
+
+void CLI::cmdCurrent(const std::vector<std::string>& args) {
+    (void)args;
     auto player = app->getPlayer();
     
     if (auto track = player->getCurrentTrack()) {
@@ -593,10 +671,10 @@ void CLI::cmdCurrent() {
         std::cout << "Título: " << track->getTitle() << "\n";
         std::cout << "Artista: " << track->getArtist() << "\n";
         std::cout << "Álbum: " << track->getAlbum() << "\n";
-        std::cout << "Duração: " << track->getDurationFormatted() << "\n";
+        std::cout << "Duração: " << track->getDurationString() << "\n";
         std::cout << "Arquivo: " << track->getFilePath() << "\n";
     } else {
-        showInfo("Nenhuma música sendo reproduzida.");
+        printInfo("Nenhuma música sendo reproduzida.");
     }
 }
 
@@ -605,7 +683,7 @@ void CLI::cmdSave(const std::vector<std::string>& args) {
     auto currentPlaylist = player->getCurrentPlaylist();
     
     if (!currentPlaylist) {
-        showError("Nenhuma playlist selecionada.");
+        printError("Nenhuma playlist selecionada.");
         return;
     }
     
@@ -619,15 +697,242 @@ void CLI::cmdSave(const std::vector<std::string>& args) {
     try {
         auto persistence = std::make_unique<JsonPlaylistPersistence>();
         persistence->savePlaylist(*currentPlaylist, filename);
-        showSuccess("Playlist salva em: " + filename);
+        printSuccess("Playlist salva em: " + filename);
     } catch (const std::exception& e) {
-        showError("Erro ao salvar: " + std::string(e.what()));
+        printError("Erro ao salvar: " + std::string(e.what()));
+    }
+}
+
+void CLI::cmdRender(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        printError("Use: render [arquivo.wav] [threads] [float]");
+        return;
+    }
+    
+    // A playlist selecionada é a do player (a mesma de next/previous e da reprodução)
+    auto player = app->getPlayer();
+    auto playlist = player->getCurrentPlaylist();
+    if (!playlist || playlist->empty()) {
+        printError("Nenhuma playlist selecionada ou playlist vazia.");
+        return;
+    }
+    
+    // Mesmo som da reprodução: taxa de saída, equalizador, volume e ReplayGain do player
+    OfflineRenderer::Options options;
+    options.sampleRate = player->getOutputSampleRate();
+    options.quality = player->getResamplerQuality();
+    options.volume = player->getVolume();
+    options.replayGain = player->getReplayGainMode();
+    options.limiter = player->getVolumeStage()->isLimiterEnabled();
+    if (auto equalizer = player->getEqualizer()) {
+        options.equalizer = std::make_shared<Equalizer>(*equalizer);
+    }
+    for (size_t i = 2; i < args.size(); ++i) {
+        if (args[i] == "float") {
+            options.format = WavFileSink::SampleFormat::FLOAT32;
+        } else {
+            try {
+                options.threads = static_cast<unsigned>(std::stoul(args[i]));
+            } catch (const std::exception&) {
+                printError("Argumento inválido: " + args[i]);
+                return;
+            }
+        }
+    }
+    
+    try {
+        OfflineRenderer renderer(options);
+        auto result = renderer.render(*playlist, args[1], [](size_t done, size_t total, const std::string& path) {
+            std::cout << "  [" << done << "/" << total << "] " << path << "\n";
+        });
+        for (const auto& error : result.errors) {
+            printError("Faixa pulada: " + error);
+        }
+        
+        std::ostringstream summary;
+        summary << std::fixed << std::setprecision(1) << result.rendered << " de " << result.tracks
+                << " músicas, " << result.audioSeconds << " s de áudio (" << result.sampleRate << " Hz, "
+                << result.channels << " canais) em " << result.seconds << " s: " << result.speedFactor
+                << "x tempo real com " << result.threads << " thread(s)";
+        printSuccess("Playlist renderizada em " + args[1]);
+        printInfo(summary.str());
+    } catch (const OfflineRenderer::RenderException& e) {
+        printError("Erro ao renderizar: " + std::string(e.what()));
+    }
+}
+
+void CLI::cmdCrossfade(const std::vector<std::string>& args) {
+    auto player = app->getPlayer();
+    if (args.size() < 2) {
+        std::ostringstream current;
+        current << std::fixed << std::setprecision(1) << "Crossfade: " << player->getCrossfadeSeconds() << " s ("
+                << Crossfader::getCurveName(player->getCrossfadeCurve()) << ")";
+        printInfo(current.str());
+        return;
+    }
+    
+    double seconds = 0.0;
+    try {
+        seconds = std::stod(args[1]);
+    } catch (const std::exception&) {
+        printError("Use: crossfade [segundos] [linear|potencia]");
+        return;
+    }
+    if (seconds < 0.0 || seconds > Crossfader::MAX_SECONDS) {
+        printError("Duração fora do intervalo (0 a 30 segundos)");
+        return;
+    }
+    Crossfader::Curve curve = player->getCrossfadeCurve();
+    if (args.size() > 2 && !Crossfader::parseCurve(args[2], curve)) {
+        printError("Curva desconhecida: " + args[2] + " (use linear ou potencia)");
+        return;
+    }
+    
+    player->setCrossfade(seconds, curve);
+    if (seconds == 0.0) {
+        printSuccess("Crossfade desativado: faixas emendadas sem lacuna");
+    } else {
+        printSuccess("Crossfade de " + args[1] + " s (" + Crossfader::getCurveName(curve) + ") a partir da próxima troca");
+    }
+}
+
+void CLI::cmdWaveform(const std::vector<std::string>& args) {
+    auto player = app->getPlayer();
+    
+    // Geração em segundo plano para toda a playlist atual
+    if (args.size() > 1 && args[1] == "scan") {
+        auto playlist = player->getCurrentPlaylist();
+        if (!playlist || playlist->empty()) {
+            printError("Nenhuma playlist selecionada ou playlist vazia.");
+            return;
+        }
+        std::vector<std::string> paths;
+        for (const auto& track : *playlist) {
+            paths.push_back(track->getFilePath());
+        }
+        if (player->getWaveformCache()->startGeneration(paths)) {
+            printSuccess("Gerando formas de onda de " + std::to_string(paths.size()) + " músicas em segundo plano.");
+        } else {
+            printInfo("Geração de formas de onda já em andamento.");
+        }
+        return;
+    }
+    
+    auto overview = player->getCurrentWaveform();
+    if (!overview || overview->getTotalFrames() == 0) {
+        printError("Nenhuma música carregada.");
+        return;
+    }
+    
+    // Trecho opcional em segundos (zoom); padrão: a faixa inteira
+    const double rate = overview->getSampleRate();
+    uint64_t start = 0;
+    uint64_t end = overview->getTotalFrames();
+    if (args.size() > 2) {
+        try {
+            start = static_cast<uint64_t>(std::max(std::stod(args[1]), 0.0) * rate);
+            end = std::min(end, static_cast<uint64_t>(std::max(std::stod(args[2]), 0.0) * rate));
+        } catch (const std::exception&) {
+            printError("Use: waveform [início fim] | waveform scan");
+            return;
+        }
+    }
+    
+    const size_t width = 64;
+    std::vector<WaveformOverview::Column> columns(width);
+    if (overview->query(start, end, columns.data(), width) == 0) {
+        printError("Trecho fora da música.");
+        return;
+    }
+    
+    // Pico por coluna em 8 alturas, arredondado para cima para que trechos baixos
+    // não pareçam silêncio; '^' marca a posição atual quando ela está no trecho
+    static const char* const bars[] = {" ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    std::string line;
+    for (const auto& column : columns) {
+        const float peak = std::min(std::max(-column.min, column.max), 1.0f);
+        line += bars[static_cast<int>(std::ceil(peak * 8.0f))];
+    }
+    const uint64_t position = static_cast<uint64_t>(player->getCurrentPosition() * rate);
+    std::string marker(width, ' ');
+    if (position >= start && position < end) {
+        marker[static_cast<size_t>((position - start) * width / (end - start))] = '^';
+    }
+    
+    std::ostringstream range;
+    range << std::fixed << std::setprecision(1) << start / rate << " s - " << end / rate << " s";
+    std::cout << "\n" << range.str() << "\n|" << line << "|\n " << marker << "\n";
+}
+
+void CLI::cmdSpectrum(const std::vector<std::string>& args) {
+    auto player = app->getPlayer();
+    auto analyzer = player->getSpectrumAnalyzer();
+    if (!analyzer || !player->getIsPlaying()) {
+        printError("Nenhuma música sendo reproduzida.");
+        return;
+    }
+    
+    double seconds = 10.0;
+    if (args.size() > 1) {
+        try {
+            seconds = std::min(std::max(std::stod(args[1]), 0.1), 600.0);
+        } catch (const std::exception&) {
+            printError("Use: spectrum [segundos]");
+            return;
+        }
+    }
+    
+    // Quadros a taxa fixa; a FFT roda aqui, a thread de áudio só publica o histórico
+    constexpr int FRAMES_PER_SECOND = 30;
+    constexpr int ROWS = 8;
+    const auto frameInterval = std::chrono::microseconds(1000000 / FRAMES_PER_SECOND);
+    const size_t bars = analyzer->getBarCount();
+    const int frames = static_cast<int>(std::lround(seconds * FRAMES_PER_SECOND));
+    
+    std::string axis = formatFrequency(analyzer->getBarFrequency(0));
+    const std::string topLabel = formatFrequency(analyzer->getBarFrequency(bars - 1));
+    axis += std::string(std::max<size_t>(bars * 2, axis.size() + topLabel.size() + 1) - axis.size() - topLabel.size(), ' ');
+    axis += topLabel;
+    
+    auto next = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames && player->getIsPlaying(); ++frame) {
+        analyzer->analyze(1.0 / FRAMES_PER_SECOND);
+        
+        std::ostringstream screen;
+        if (frame > 0) {
+            screen << "\033[" << ROWS + 2 << "A"; // Sobrescreve o quadro anterior
+        }
+        for (int row = ROWS - 1; row >= 0; --row) {
+            screen << "\r ";
+            for (size_t bar = 0; bar < bars; ++bar) {
+                const float height = analyzer->getLevel(bar) * ROWS - static_cast<float>(row);
+                const float peak = analyzer->getPeak(bar) * ROWS - static_cast<float>(row);
+                if (height > 0.0f) {
+                    screen << LEVEL_BLOCKS[std::lround(std::min(height, 1.0f) * 8.0f)];
+                } else if (peak > 0.0f && peak <= 1.0f) {
+                    screen << "▔";
+                } else {
+                    screen << " ";
+                }
+                screen << " ";
+            }
+            screen << "\n";
+        }
+        screen << "\r " << axis << "\n";
+        screen << "\r pico: " << std::left << std::setw(12)
+               << (analyzer->getPeakFrequency() > 0.0 ? formatFrequency(analyzer->getPeakFrequency()) : "-")
+               << std::right << "\n";
+        std::cout << screen.str() << std::flush;
+        
+        player->processEvents();
+        next += frameInterval;
+        std::this_thread::sleep_until(next);
     }
 }
 
 void CLI::cmdLoad(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Use: load [nome do arquivo]");
+        printError("Use: load [nome do arquivo]");
         return;
     }
     
@@ -642,18 +947,18 @@ void CLI::cmdLoad(const std::vector<std::string>& args) {
             auto playlist = std::make_shared<Playlist>(*playlistOpt);
             player->addPlaylist(playlist);
             
-            showSuccess("Playlist carregada: " + playlist->getName());
+            printSuccess("Playlist carregada: " + playlist->getName());
         } else {
-            showError("Não foi possível carregar a playlist.");
+            printError("Não foi possível carregar a playlist.");
         }
     } catch (const std::exception& e) {
-        showError("Erro ao carregar: " + std::string(e.what()));
+        printError("Erro ao carregar: " + std::string(e.what()));
     }
 }
 
 void CLI::cmdHelp(const std::vector<std::string>& args) {
     if (args.size() > 1) {
-        showDetailedHelp(args[1]);
+        displayCommandHelp(args[1]);
         return;
     }
     
@@ -681,14 +986,18 @@ void CLI::cmdHelp(const std::vector<std::string>& args) {
     std::cout << "  search [termo]    - Buscar músicas\n\n";
     
     std::cout << "CONFIGURAÇÃO:\n";
-    std::cout << "  equalizer [preset] - Configurar equalizador\n\n";
+    std::cout << "  equalizer [preset] - Configurar equalizador\n";
+    std::cout << "  crossfade [s] [curva] - Sobrepor faixas (linear|potencia; 0 = desligado)\n\n";
     
     std::cout << "INFORMAÇÕES:\n";
     std::cout << "  status            - Status do player\n";
+    std::cout << "  waveform [início fim] - Forma de onda da música atual (scan: gerar da playlist)\n";
+    std::cout << "  spectrum [segundos] - Analisador de espectro ao vivo\n";
     std::cout << "  current           - Música atual\n\n";
     
     std::cout << "ARQUIVOS:\n";
     std::cout << "  save [arquivo]    - Salvar playlist\n";
+    std::cout << "  render [arquivo.wav] [threads] [float] - Renderizar playlist em WAV\n";
     std::cout << "  load [arquivo]    - Carregar playlist\n\n";
     
     std::cout << "SISTEMA:\n";
@@ -698,7 +1007,7 @@ void CLI::cmdHelp(const std::vector<std::string>& args) {
     std::cout << "Digite 'help [comando]' para ajuda detalhada sobre um comando específico.\n";
 }
 
-void CLI::showDetailedHelp(const std::string& command) {
+void CLI::displayCommandHelp(const std::string& command) {
     std::cout << "\n=== AJUDA DETALHADA: " << command << " ===\n\n";
     
     if (command == "play") {
@@ -719,24 +1028,65 @@ void CLI::showDetailedHelp(const std::string& command) {
     else if (command == "scan") {
         std::cout << "COMANDO: scan [diretório]\n";
         std::cout << "DESCRIÇÃO: Escaneia um diretório em busca de arquivos de música\n";
-        std::cout << "FORMATOS: MP3, WAV, OGG\n";
+        std::cout << "FORMATOS: MP3, WAV, OGG, FLAC\n";
         std::cout << "EXEMPLO:\n";
         std::cout << "  scan C:\\Music  - Escanear pasta C:\\Music\n";
     }
+    else if (command == "render") {
+        std::cout << "COMANDO: render [arquivo.wav] [threads] [float]\n";
+        std::cout << "DESCRIÇÃO: Renderiza a playlist atual em um WAV, sem dispositivo de áudio e\n";
+        std::cout << "           mais rápido que o tempo real, com o equalizador, o volume e o\n";
+        std::cout << "           ReplayGain do player; faixas em paralelo, gravadas em ordem\n";
+        std::cout << "EXEMPLOS:\n";
+        std::cout << "  render mix.wav          - WAV 16 bits, uma thread por núcleo\n";
+        std::cout << "  render mix.wav 4 float  - 4 threads, float de 32 bits\n";
+    }
+    else if (command == "waveform") {
+        std::cout << "COMANDO: waveform [início fim] | waveform scan\n";
+        std::cout << "DESCRIÇÃO: Mostra os picos da música atual e a posição de reprodução; os\n";
+        std::cout << "           picos ficam em cache e qualquer zoom é instantâneo\n";
+        std::cout << "EXEMPLOS:\n";
+        std::cout << "  waveform              - Música inteira\n";
+        std::cout << "  waveform 60 90        - Trecho de 1:00 a 1:30\n";
+        std::cout << "  waveform scan         - Gerar o cache da playlist em segundo plano\n";
+    }
+    else if (command == "spectrum") {
+        std::cout << "COMANDO: spectrum [segundos]\n";
+        std::cout << "DESCRIÇÃO: Barras de frequência (escala logarítmica) do som que sai, depois do\n";
+        std::cout << "           equalizador e do volume, atualizadas 30 vezes por segundo\n";
+        std::cout << "EXEMPLOS:\n";
+        std::cout << "  spectrum              - 10 segundos\n";
+        std::cout << "  spectrum 60           - Um minuto\n";
+    }
+    else if (command == "crossfade") {
+        std::cout << "COMANDO: crossfade [segundos] [linear|potencia]\n";
+        std::cout << "DESCRIÇÃO: Sobrepõe o fim de cada faixa ao início da seguinte na playlist;\n";
+        std::cout << "           potencia mantém a energia constante, linear a amplitude\n";
+        std::cout << "EXEMPLOS:\n";
+        std::cout << "  crossfade             - Mostrar a configuração atual\n";
+        std::cout << "  crossfade 4           - 4 segundos, curva de potência constante\n";
+        std::cout << "  crossfade 2 linear    - 2 segundos, curva linear\n";
+        std::cout << "  crossfade 0           - Desligar (troca sem lacuna)\n";
+    }
     else {
         std::cout << "Comando não encontrado ou sem ajuda detalhada disponível.\n";
         std::cout << "Digite 'help' para ver todos os comandos.\n";
     }
 }
 
-void CLI::showSuccess(const std::string& message) {
+void CLI::cmdQuit(const std::vector<std::string>& args) {
+    (void)args;
+    running = false;
+}
+
+void CLI::printSuccess(const std::string& message) {
     std::cout << "[OK] " << message << "\n";
 }
 
-void CLI::showError(const std::string& message) {
+void CLI::printError(const std::string& message) {
     std::cout << "[ERROR] " << message << "\n";
 }
 
-void CLI::showInfo(const std::string& message) {
+void CLI::printInfo(const std::string& message) {
     std::cout << "ℹ " << message << "\n";
 }
\ No newline at end of file
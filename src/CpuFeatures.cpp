@@ -0,0 +1,138 @@
+#include "CpuFeatures.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#if defined(MP3PLAYER_ARCH_X86) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr int NO_OVERRIDE = -1;
+std::atomic<int> simdOverride{NO_OVERRIDE};
+
+CpuFeatures detect() {
+    CpuFeatures features;
+#if defined(MP3PLAYER_ARCH_X86)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.sse41 = __builtin_cpu_supports("sse4.1");
+    // Inclui a verificação de suporte do sistema operacional (XCR0)
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.fma = __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    features.sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    // Registradores YMM precisam ser salvos pelo sistema operacional
+    const bool ymmEnabled = osxsave && (_xgetbv(0) & 6) == 6;
+    if (maxLeaf >= 7 && avx && ymmEnabled) {
+        __cpuidex(info, 7, 0);
+        features.avx2 = (info[1] & (1 << 5)) != 0;
+        features.fma = fma;
+    }
+#endif
+#endif
+#if defined(MP3PLAYER_ARCH_NEON)
+    features.neon = true; // Obrigatório em AArch64
+#endif
+    return features;
+}
+
+CpuFeatures::SimdLevel levelFromEnvironment() {
+    const char* value = std::getenv("MP3PLAYER_SIMD");
+    if (!value) {
+        return static_cast<CpuFeatures::SimdLevel>(NO_OVERRIDE);
+    }
+    if (std::strcmp(value, "scalar") == 0) return CpuFeatures::SimdLevel::Scalar;
+    if (std::strcmp(value, "sse2") == 0) return CpuFeatures::SimdLevel::SSE2;
+    if (std::strcmp(value, "avx2") == 0) return CpuFeatures::SimdLevel::AVX2;
+    if (std::strcmp(value, "neon") == 0) return CpuFeatures::SimdLevel::NEON;
+    return static_cast<CpuFeatures::SimdLevel>(NO_OVERRIDE);
+}
+
+} // namespace
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = [] {
+        CpuFeatures detected = detect();
+        SimdLevel forced = levelFromEnvironment();
+        if (static_cast<int>(forced) != NO_OVERRIDE) {
+            simdOverride.store(static_cast<int>(forced), std::memory_order_relaxed);
+        }
+        return detected;
+    }();
+    return features;
+}
+
+CpuFeatures::SimdLevel CpuFeatures::getDetectedSimdLevel() {
+    const CpuFeatures& features = get();
+    if (features.avx2) return SimdLevel::AVX2;
+    if (features.sse2) return SimdLevel::SSE2;
+    if (features.neon) return SimdLevel::NEON;
+    return SimdLevel::Scalar;
+}
+
+bool CpuFeatures::isSupported(SimdLevel level) {
+    const CpuFeatures& features = get();
+    switch (level) {
+        case SimdLevel::Scalar: return true;
+        case SimdLevel::SSE2: return features.sse2;
+        case SimdLevel::AVX2: return features.avx2;
+        case SimdLevel::NEON: return features.neon;
+    }
+    return false;
+}
+
+CpuFeatures::SimdLevel CpuFeatures::getSimdLevel() {
+    get(); // Garante que a variável de ambiente já foi lida
+    int forced = simdOverride.load(std::memory_order_relaxed);
+    if (forced != NO_OVERRIDE && isSupported(static_cast<SimdLevel>(forced))) {
+        return static_cast<SimdLevel>(forced);
+    }
+    return getDetectedSimdLevel();
+}
+
+void CpuFeatures::setSimdLevelOverride(SimdLevel level) {
+    get();
+    simdOverride.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void CpuFeatures::clearSimdLevelOverride() {
+    get();
+    simdOverride.store(NO_OVERRIDE, std::memory_order_relaxed);
+}
+
+std::string CpuFeatures::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "escalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+    }
+    return "desconhecido";
+}
+
+std::string CpuFeatures::describe() const {
+    std::string text;
+    auto append = [&text](bool present, const char* name) {
+        if (present) {
+            text += text.empty() ? "" : " ";
+            text += name;
+        }
+    };
+    append(sse2, "SSE2");
+    append(sse41, "SSE4.1");
+    append(avx2, "AVX2");
+    append(fma, "FMA");
+    append(neon, "NEON");
+    return text.empty() ? "nenhuma" : text;
+}
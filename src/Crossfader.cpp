@@ -0,0 +1,143 @@
+#include "Crossfader.h"
+#include <algorithm>
+#include <cmath>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double HALF_PI = 1.57079632679489661923;
+
+// Referência: os kernels vetoriais repetem mul, mul, add nesta ordem
+void mixScalar(float* outgoing, const float* incoming, const float* gainOut, const float* gainIn, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        outgoing[i] = outgoing[i] * gainOut[i] + incoming[i] * gainIn[i];
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+void mixSse2(float* outgoing, const float* incoming, const float* gainOut, const float* gainIn, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 out = _mm_mul_ps(_mm_loadu_ps(outgoing + i), _mm_loadu_ps(gainOut + i));
+        const __m128 in = _mm_mul_ps(_mm_loadu_ps(incoming + i), _mm_loadu_ps(gainIn + i));
+        _mm_storeu_ps(outgoing + i, _mm_add_ps(out, in));
+    }
+    mixScalar(outgoing + i, incoming + i, gainOut + i, gainIn + i, count - i);
+}
+
+MP3PLAYER_TARGET_AVX2 void mixAvx2(float* outgoing, const float* incoming, const float* gainOut, const float* gainIn,
+                                   size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 out = _mm256_mul_ps(_mm256_loadu_ps(outgoing + i), _mm256_loadu_ps(gainOut + i));
+        const __m256 in = _mm256_mul_ps(_mm256_loadu_ps(incoming + i), _mm256_loadu_ps(gainIn + i));
+        _mm256_storeu_ps(outgoing + i, _mm256_add_ps(out, in));
+    }
+    mixScalar(outgoing + i, incoming + i, gainOut + i, gainIn + i, count - i);
+}
+
+#endif
+
+} // namespace
+
+Crossfader::Crossfader() : curve(Curve::EQUAL_POWER), length(0), position(0), maxFrames(0) {}
+
+void Crossfader::prepare(size_t frames, int channels) {
+    maxFrames = frames;
+    gainOut.assign(frames * static_cast<size_t>(std::max(channels, 1)), 0.0f);
+    gainIn.assign(gainOut.size(), 0.0f);
+    reset();
+}
+
+void Crossfader::begin(Curve fadeCurve, uint64_t fadeFrames) {
+    curve = fadeCurve;
+    length = fadeFrames;
+    position = 0;
+}
+
+void Crossfader::reset() {
+    length = 0;
+    position = 0;
+}
+
+void Crossfader::getGains(Curve curve, double t, float& outgoing, float& incoming) {
+    t = std::min(std::max(t, 0.0), 1.0);
+    if (curve == Curve::LINEAR) {
+        outgoing = static_cast<float>(1.0 - t);
+        incoming = static_cast<float>(t);
+    } else {
+        outgoing = static_cast<float>(std::cos(t * HALF_PI));
+        incoming = static_cast<float>(std::sin(t * HALF_PI));
+    }
+}
+
+void Crossfader::computeGains(size_t frames, int channels) {
+    // Centro de cada quadro: o fade é simétrico e nunca toca exatamente 0 ou 1
+    const double scale = 1.0 / static_cast<double>(length);
+    size_t sample = 0;
+    for (size_t f = 0; f < frames; ++f) {
+        float out = 0.0f;
+        float in = 0.0f;
+        getGains(curve, (static_cast<double>(position + f) + 0.5) * scale, out, in);
+        for (int c = 0; c < channels; ++c, ++sample) {
+            gainOut[sample] = out;
+            gainIn[sample] = in;
+        }
+    }
+}
+
+size_t Crossfader::process(float* outgoing, const float* incoming, size_t frames, int channels) {
+    return process(outgoing, incoming, frames, channels, CpuFeatures::getSimdLevel());
+}
+
+size_t Crossfader::process(float* outgoing, const float* incoming, size_t frames, int channels,
+                           CpuFeatures::SimdLevel level) {
+    if (!outgoing || !incoming || channels <= 0 || maxFrames == 0 ||
+        gainOut.size() < maxFrames * static_cast<size_t>(channels)) {
+        return 0;
+    }
+    frames = static_cast<size_t>(std::min<uint64_t>(frames, getRemaining()));
+
+    size_t done = 0;
+    while (done < frames) {
+        const size_t chunk = std::min(frames - done, maxFrames);
+        computeGains(chunk, channels);
+        const size_t offset = done * static_cast<size_t>(channels);
+        const size_t count = chunk * static_cast<size_t>(channels);
+        switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+            case CpuFeatures::SimdLevel::AVX2:
+                mixAvx2(outgoing + offset, incoming + offset, gainOut.data(), gainIn.data(), count);
+                break;
+            case CpuFeatures::SimdLevel::SSE2:
+                mixSse2(outgoing + offset, incoming + offset, gainOut.data(), gainIn.data(), count);
+                break;
+#endif
+            default:
+                mixScalar(outgoing + offset, incoming + offset, gainOut.data(), gainIn.data(), count);
+                break;
+        }
+        position += chunk;
+        done += chunk;
+    }
+    return frames;
+}
+
+std::string Crossfader::getCurveName(Curve curve) {
+    return curve == Curve::LINEAR ? "linear" : "potencia";
+}
+
+bool Crossfader::parseCurve(const std::string& name, Curve& curve) {
+    if (name == "linear") {
+        curve = Curve::LINEAR;
+        return true;
+    }
+    if (name == "potencia" || name == "equal-power" || name == "equal") {
+        curve = Curve::EQUAL_POWER;
+        return true;
+    }
+    return false;
+}
@@ -6,7 +6,7 @@
 template<typename FileFilter>
 DirectoryScanner<FileFilter>::DirectoryScanner() 
     : recursive(false), maxDepth(10) {
-    supportedExtensions = {".mp3", ".wav", ".ogg"};
+    supportedExtensions = {".mp3", ".wav", ".ogg", ".flac"};
 }
 
 template<typename FileFilter>
@@ -181,7 +181,7 @@ std::unique_ptr<MediaScanner> createMP3Scanner() {
 }
 
 std::unique_ptr<MediaScanner> createAudioScanner() {
-    return std::make_unique<MediaScanner>(std::set<std::string>{".mp3", ".wav", ".ogg"});
+    return std::make_unique<MediaScanner>(std::set<std::string>{".mp3", ".wav", ".ogg", ".flac"});
 }
 
 std::unique_ptr<CustomMediaScanner> createCustomScanner(
@@ -0,0 +1,409 @@
+#include "DurationScanner.h"
+#include "CpuFeatures.h"
+#include "MappedFile.h"
+#include "Mp3Decoder.h"
+#include <algorithm>
+#include <cstring>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr uint8_t SYNC_SECOND_MASK = 0xE0;
+
+uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint32_t readLittleEndian32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readLittleEndian16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint64_t readLittleEndian64(const uint8_t* p) {
+    return static_cast<uint64_t>(readLittleEndian32(p)) |
+           (static_cast<uint64_t>(readLittleEndian32(p + 4)) << 32);
+}
+
+// Posição do marcador "fLaC", no início ou depois de uma etiqueta ID3v2; size se não houver
+size_t findFlacMarker(const uint8_t* data, size_t size) {
+    size_t pos = 0;
+    if (size >= 10 && std::memcmp(data, "ID3", 3) == 0) {
+        pos = 10 + ((static_cast<size_t>(data[6] & 0x7f) << 21) | (static_cast<size_t>(data[7] & 0x7f) << 14) |
+                    (static_cast<size_t>(data[8] & 0x7f) << 7) | static_cast<size_t>(data[9] & 0x7f));
+        if (data[5] & 0x10) {
+            pos += 10; // Rodapé
+        }
+    }
+    return pos + 4 <= size && std::memcmp(data + pos, "fLaC", 4) == 0 ? pos : size;
+}
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Referência escalar: memchr localiza candidatos 0xFF, o segundo byte confirma
+size_t findSyncScalar(const uint8_t* data, size_t from, size_t size) {
+    while (from + 1 < size) {
+        const void* hit = std::memchr(data + from, 0xFF, size - 1 - from);
+        if (!hit) {
+            break;
+        }
+        size_t i = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+        if ((data[i + 1] & SYNC_SECOND_MASK) == SYNC_SECOND_MASK) {
+            return i;
+        }
+        from = i + 1;
+    }
+    return size;
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+// 16 posições por iteração: bytes [i, i+16) e [i+1, i+17) comparados de uma vez
+size_t findSyncSse2(const uint8_t* data, size_t from, size_t size) {
+    const __m128i allOnes = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i syncMask = _mm_set1_epi8(static_cast<char>(SYNC_SECOND_MASK));
+    size_t i = from;
+    for (; i + 17 <= size; i += 16) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        __m128i match = _mm_and_si128(_mm_cmpeq_epi8(first, allOnes),
+                                      _mm_cmpeq_epi8(_mm_and_si128(second, syncMask), syncMask));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+        if (mask != 0) {
+            return i + countTrailingZeros(mask);
+        }
+    }
+    return findSyncScalar(data, i, size);
+}
+
+MP3PLAYER_TARGET_AVX2
+size_t findSyncAvx2(const uint8_t* data, size_t from, size_t size) {
+    const __m256i allOnes = _mm256_set1_epi8(static_cast<char>(0xFF));
+    const __m256i syncMask = _mm256_set1_epi8(static_cast<char>(SYNC_SECOND_MASK));
+    size_t i = from;
+    for (; i + 33 <= size; i += 32) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        __m256i match = _mm256_and_si256(_mm256_cmpeq_epi8(first, allOnes),
+                                         _mm256_cmpeq_epi8(_mm256_and_si256(second, syncMask), syncMask));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+        if (mask != 0) {
+            return i + countTrailingZeros(mask);
+        }
+    }
+    return findSyncScalar(data, i, size);
+}
+#endif
+
+// Quadros declarados no cabeçalho Xing/Info ou VBRI do primeiro quadro, e o atraso e o
+// preenchimento da extensão LAME (-1 se ausente), lidos como no Mp3Decoder
+bool readInfoFrameCount(const Mp3Decoder::FrameHeader& header, const uint8_t* frame, bool& isInfoFrame,
+                        uint64_t& frames, DurationScanner::Method& method, int& encoderDelay, int& encoderPadding) {
+    const size_t sideInfoSize = header.lsf ? (header.channels == 1 ? 9 : 17)
+                                           : (header.channels == 1 ? 17 : 32);
+    const size_t offset = 4 + (header.hasCrc ? 2 : 0) + sideInfoSize;
+    isInfoFrame = false;
+    encoderDelay = encoderPadding = -1;
+
+    if (offset + 8 <= header.frameBytes &&
+        (std::memcmp(frame + offset, "Xing", 4) == 0 || std::memcmp(frame + offset, "Info", 4) == 0)) {
+        isInfoFrame = true;
+        const uint32_t flags = readBigEndian32(frame + offset + 4);
+        frames = 0;
+        if ((flags & 1) && offset + 12 <= header.frameBytes) {
+            frames = readBigEndian32(frame + offset + 8);
+            method = DurationScanner::Method::XingHeader;
+        }
+        // Campos opcionais (quadros, bytes, TOC, qualidade) antes da extensão LAME
+        const size_t lame = offset + 8 + ((flags & 1) ? 4 : 0) + ((flags & 2) ? 4 : 0) + ((flags & 4) ? 100 : 0) +
+                            ((flags & 8) ? 4 : 0);
+        if (lame + 24 <= header.frameBytes &&
+            (std::memcmp(frame + lame, "LAME", 4) == 0 || std::memcmp(frame + lame, "Lavc", 4) == 0 ||
+             std::memcmp(frame + lame, "Lavf", 4) == 0)) {
+            const uint8_t* gapless = frame + lame + 21;
+            encoderDelay = (gapless[0] << 4) | (gapless[1] >> 4);
+            encoderPadding = ((gapless[1] & 0x0F) << 8) | gapless[2];
+        }
+        return frames > 0;
+    }
+
+    const size_t vbri = 36;
+    if (vbri + 18 <= header.frameBytes && std::memcmp(frame + vbri, "VBRI", 4) == 0) {
+        isInfoFrame = true;
+        frames = readBigEndian32(frame + vbri + 14);
+        method = DurationScanner::Method::VbriHeader;
+        return frames > 0;
+    }
+    return false;
+}
+
+// Amostras que a decodificação entrega: descontados o atraso do codificador e da síntese no
+// início e o preenchimento no fim, com as mesmas contas de Mp3Decoder::getTotalFrames
+uint64_t trimGapless(uint64_t totalFrames, int encoderDelay, int encoderPadding) {
+    if (encoderDelay < 0 || totalFrames == 0) {
+        return totalFrames;
+    }
+    const uint64_t leadingSkip = static_cast<uint64_t>(encoderDelay) + Mp3Decoder::DECODER_DELAY;
+    const uint64_t padding = static_cast<uint64_t>(encoderPadding);
+    const uint64_t trailing = padding > Mp3Decoder::DECODER_DELAY ? padding - Mp3Decoder::DECODER_DELAY : 0;
+    const uint64_t end = totalFrames > trailing + leadingSkip ? totalFrames - trailing : leadingSkip;
+    return end > leadingSkip ? end - leadingSkip : 0;
+}
+
+} // namespace
+
+size_t DurationScanner::findFrameSync(const uint8_t* data, size_t from, size_t size) {
+    switch (CpuFeatures::getSimdLevel()) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            return findSyncAvx2(data, from, size);
+        case CpuFeatures::SimdLevel::SSE2:
+            return findSyncSse2(data, from, size);
+#endif
+        default:
+            return findSyncScalar(data, from, size);
+    }
+}
+
+bool DurationScanner::scanMp3(const uint8_t* data, size_t size, Result& result) {
+    result = Result();
+    result.format = "MP3";
+
+    // Tag ID3v2 no início: mesmo cálculo de tamanho do decodificador
+    size_t pos = 0;
+    if (size >= 10 && data[0] == 'I' && data[1] == 'D' && data[2] == '3') {
+        size_t tagSize = (static_cast<size_t>(data[6] & 0x7F) << 21) | (static_cast<size_t>(data[7] & 0x7F) << 14) |
+                         (static_cast<size_t>(data[8] & 0x7F) << 7) | static_cast<size_t>(data[9] & 0x7F);
+        pos = tagSize + 10 + ((data[5] & 0x10) ? 10 : 0);
+    }
+
+    Mp3Decoder::FrameHeader stream{};
+    bool firstFrame = true;
+    bool searching = false;
+    uint64_t frames = 0;
+    int encoderDelay = -1;
+    int encoderPadding = -1;
+
+    while (pos + 4 <= size) {
+        Mp3Decoder::FrameHeader header;
+        bool valid = Mp3Decoder::parseHeader(data + pos, header);
+
+        if (valid && !firstFrame &&
+            (header.sampleRateIndex != stream.sampleRateIndex || header.channels != stream.channels)) {
+            valid = false;
+        }
+        if (valid) {
+            if (pos + header.frameBytes > size) {
+                break; // Quadro truncado no fim do arquivo
+            }
+            // Ao sincronizar, exigir um segundo cabeçalho coerente logo em seguida
+            Mp3Decoder::FrameHeader following;
+            if ((firstFrame || searching) && pos + header.frameBytes + 4 <= size &&
+                (!Mp3Decoder::parseHeader(data + pos + header.frameBytes, following) ||
+                 following.sampleRateIndex != header.sampleRateIndex)) {
+                valid = false;
+            }
+        }
+
+        if (!valid) {
+            searching = true;
+            pos = findFrameSync(data, pos + 1, size);
+            continue;
+        }
+
+        if (firstFrame) {
+            stream = header;
+            firstFrame = false;
+            result.sampleRate = header.sampleRate;
+            result.channels = header.channels;
+
+            bool isInfoFrame = false;
+            uint64_t declared = 0;
+            if (readInfoFrameCount(header, data + pos, isInfoFrame, declared, result.method, encoderDelay,
+                                   encoderPadding)) {
+                // Contagem declarada: nenhum outro quadro precisa ser lido
+                result.totalFrames = trimGapless(declared * static_cast<uint64_t>(header.samplesPerFrame),
+                                                 encoderDelay, encoderPadding);
+                result.bytesScanned = pos + header.frameBytes;
+                return true;
+            }
+            if (!isInfoFrame) {
+                ++frames; // Quadro de áudio comum
+            }
+        } else {
+            ++frames;
+        }
+        searching = false;
+        pos += header.frameBytes;
+    }
+
+    if (firstFrame) {
+        return false; // Nenhum quadro MPEG Layer III
+    }
+    result.method = Method::FrameScan;
+    result.totalFrames = trimGapless(frames * static_cast<uint64_t>(stream.samplesPerFrame), encoderDelay,
+                                     encoderPadding);
+    result.bytesScanned = std::min(pos, size);
+    return true;
+}
+
+bool DurationScanner::scanWav(const uint8_t* data, size_t size, Result& result) {
+    result = Result();
+    result.format = "WAV";
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    unsigned blockAlign = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        uint64_t chunkSize = readLittleEndian32(chunk + 4);
+        pos += 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && pos + 16 <= size) {
+            result.channels = readLittleEndian16(data + pos + 2);
+            result.sampleRate = static_cast<int>(readLittleEndian32(data + pos + 4));
+            blockAlign = readLittleEndian16(data + pos + 12);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (blockAlign == 0 || result.sampleRate <= 0) {
+                return false; // "data" antes de "fmt " ou formato inválido
+            }
+            // Tamanho 0xFFFFFFFF (gravação em streaming) ou maior que o arquivo: usar o restante
+            const uint64_t available = size - pos;
+            if (chunkSize == 0xFFFFFFFFu || chunkSize > available) {
+                chunkSize = available;
+            }
+            result.totalFrames = chunkSize / blockAlign;
+            result.method = Method::RiffHeader;
+            result.bytesScanned = pos;
+            return true;
+        }
+        pos += chunkSize + (chunkSize & 1); // Chunks são alinhados em 2 bytes
+    }
+    return false;
+}
+
+bool DurationScanner::scanOgg(const uint8_t* data, size_t size, Result& result) {
+    result = Result();
+    result.format = "OGG";
+    const size_t pageHeaderSize = 27;
+    if (size < pageHeaderSize || std::memcmp(data, "OggS", 4) != 0) {
+        return false;
+    }
+
+    // Primeira página: pacote de identificação do codec
+    const uint32_t serial = readLittleEndian32(data + 14);
+    const size_t segments = data[26];
+    const size_t packet = pageHeaderSize + segments;
+    uint64_t preSkip = 0;
+    if (packet + 16 <= size && data[packet] == 0x01 && std::memcmp(data + packet + 1, "vorbis", 6) == 0) {
+        result.channels = data[packet + 11];
+        result.sampleRate = static_cast<int>(readLittleEndian32(data + packet + 12));
+    } else if (packet + 19 <= size && std::memcmp(data + packet, "OpusHead", 8) == 0) {
+        result.channels = data[packet + 9];
+        preSkip = readLittleEndian16(data + packet + 10);
+        result.sampleRate = 48000; // Granules Opus são sempre em 48 kHz
+    } else {
+        return false;
+    }
+    if (result.sampleRate <= 0) {
+        return false;
+    }
+
+    // Última página do mesmo stream com granule definido, procurando de trás para frente
+    size_t pos = size - pageHeaderSize;
+    for (;;) {
+        const uint8_t* page = data + pos;
+        if (page[0] == 'O' && std::memcmp(page, "OggS", 4) == 0 && page[4] == 0 &&
+            readLittleEndian32(page + 14) == serial) {
+            const uint64_t granule = readLittleEndian64(page + 6);
+            if (granule != ~0ULL) {
+                result.totalFrames = granule > preSkip ? granule - preSkip : 0;
+                result.method = Method::OggGranule;
+                result.bytesScanned = size - pos;
+                return true;
+            }
+        }
+        if (pos == 0) {
+            return false;
+        }
+        --pos;
+    }
+}
+
+bool DurationScanner::scanFlac(const uint8_t* data, size_t size, Result& result) {
+    result = Result();
+    result.format = "FLAC";
+    const size_t marker = findFlacMarker(data, size);
+    // STREAMINFO é sempre o primeiro bloco: 4 bytes de cabeçalho + 34 de conteúdo
+    const size_t block = marker + 4;
+    if (marker >= size || block + 4 + 34 > size || (data[block] & 0x7f) != 0) {
+        return false;
+    }
+    // 20 bits de taxa, 3 de canais - 1, 5 de bits - 1 e 36 de amostras a partir do byte 10
+    const uint8_t* info = data + block + 4 + 10;
+    const uint64_t packed = (static_cast<uint64_t>(readBigEndian32(info)) << 32) | readBigEndian32(info + 4);
+    result.sampleRate = static_cast<int>(packed >> 44);
+    result.channels = static_cast<int>((packed >> 41) & 0x7) + 1;
+    result.totalFrames = packed & 0xFFFFFFFFFULL;
+    result.bytesScanned = block + 4 + 34;
+    if (result.sampleRate <= 0 || result.totalFrames == 0) {
+        return false; // Total 0 = desconhecido (codificação em streaming)
+    }
+    result.method = Method::FlacStreamInfo;
+    return true;
+}
+
+bool DurationScanner::scanFile(const std::string& path, Result& result) {
+    result = Result();
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    if (size >= 12 && std::memcmp(data, "RIFF", 4) == 0) {
+        return scanWav(data, size, result);
+    }
+    if (size >= 4 && std::memcmp(data, "OggS", 4) == 0) {
+        return scanOgg(data, size, result);
+    }
+    if (findFlacMarker(data, size) < size) {
+        return scanFlac(data, size, result);
+    }
+    // Varredura completa só se o primeiro quadro não trouxer a contagem; o kernel
+    // recebe a dica de leitura sequencial antes de percorrer o arquivo inteiro
+    file.adviseSequential();
+    return scanMp3(data, size, result);
+}
+
+std::string DurationScanner::getMethodName(Method method) {
+    switch (method) {
+        case Method::XingHeader: return "Xing/Info";
+        case Method::VbriHeader: return "VBRI";
+        case Method::FrameScan: return "varredura de quadros";
+        case Method::RiffHeader: return "RIFF";
+        case Method::OggGranule: return "granule Ogg";
+        case Method::FlacStreamInfo: return "STREAMINFO FLAC";
+        case Method::None: break;
+    }
+    return "nenhum";
+}
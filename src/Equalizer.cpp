@@ -1,11 +1,14 @@
 #include "Equalizer.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <sstream>
 #include <map>
 #include <vector>
 
 // Inicialização dos presets estáticos
-const std::map<std::string, std::array<double, Equalizer::NUM_BANDS>> Equalizer::presets = {
+template <size_t N>
+const std::map<std::string, std::array<double, 3>> BasicEqualizer<N>::presets = {
     {"flat", {0.0, 0.0, 0.0}},
     {"rock", {4.0, 2.0, 6.0}},
     {"jazz", {2.0, 0.0, 3.0}},
@@ -15,18 +18,81 @@ const std::map<std::string, std::array<double, Equalizer::NUM_BANDS>> Equalizer:
     {"treble", {0.0, 0.0, 8.0}}
 };
 
-Equalizer::Equalizer() : bandGains{0.0, 0.0, 0.0}, presetName("flat"), enabled(true) {}
+namespace {
 
-Equalizer::Equalizer(double lowGain, double midGain, double highGain) 
-    : presetName("custom"), enabled(true) {
-    setBands(lowGain, midGain, highGain);
+// Ganho de uma curva de preset (3 pontos) em uma frequência: interpolação linear
+// em log2(f) entre as âncoras, constante fora delas
+double presetGainAt(const std::array<double, 3>& curve, double frequency) {
+    const double anchors[3] = {Equalizer::LOW_SHELF_FREQUENCY, Equalizer::MID_PEAK_FREQUENCY,
+                               Equalizer::HIGH_SHELF_FREQUENCY};
+    if (frequency <= anchors[0]) {
+        return curve[0];
+    }
+    if (frequency >= anchors[2]) {
+        return curve[2];
+    }
+    const size_t segment = frequency < anchors[1] ? 0 : 1;
+    const double position = std::log2(frequency / anchors[segment]) /
+                            std::log2(anchors[segment + 1] / anchors[segment]);
+    return curve[segment] + (curve[segment + 1] - curve[segment]) * position;
+}
+
+// Interpolação linear de coeficientes. O triângulo de estabilidade em (a1, a2) é convexo,
+// portanto todo ponto intermediário entre dois filtros estáveis também é estável.
+BiquadCoefficients interpolate(const BiquadCoefficients& from, const BiquadCoefficients& to, float t) {
+    if (t >= 1.0f) {
+        return to; // Fim da transição exatamente no alvo (identidade reconhecível)
+    }
+    const float s = 1.0f - t;
+    BiquadCoefficients result;
+    result.b0 = from.b0 * s + to.b0 * t;
+    result.b1 = from.b1 * s + to.b1 * t;
+    result.b2 = from.b2 * s + to.b2 * t;
+    result.a1 = from.a1 * s + to.a1 * t;
+    result.a2 = from.a2 * s + to.a2 * t;
+    return result;
 }
 
-Equalizer::Equalizer(const std::string& presetName) : enabled(true) {
+} // namespace
+
+template <size_t N>
+BasicEqualizer<N>::BasicEqualizer()
+    : presetName("flat"), enabled(true), sampleRate(DEFAULT_SAMPLE_RATE), flat(true),
+      resetSerial(1), // O primeiro conjunto publicado é aplicado sem transição
+      rampPosition(RAMP_FRAMES), appliedResetSerial(0), targetIdentity(true), processing(false) {
+    bandGains.fill(DEFAULT_GAIN);
+    updateGainCorrection();
+    updateFilters();
+}
+
+template <size_t N>
+BasicEqualizer<N>::BasicEqualizer(const BasicEqualizer& other) : BasicEqualizer() {
+    copySettings(other);
+}
+
+template <size_t N>
+BasicEqualizer<N>& BasicEqualizer<N>::operator=(const BasicEqualizer& other) {
+    if (this != &other) {
+        copySettings(other);
+    }
+    return *this;
+}
+
+template <size_t N>
+void BasicEqualizer<N>::copySettings(const BasicEqualizer& other) {
+    bandGains = other.bandGains;
+    presetName = other.presetName;
+    enabled = other.enabled;
+    updateFilters();
+}
+
+template <size_t N>
+BasicEqualizer<N>::BasicEqualizer(const std::string& presetName) : BasicEqualizer() {
     applyPreset(presetName);
 }
 
-void Equalizer::validateGain(double& gain) {
+template <size_t N>
+void BasicEqualizer<N>::validateGain(double& gain) {
     if (gain < MIN_GAIN) {
         gain = MIN_GAIN;
     } else if (gain > MAX_GAIN) {
@@ -34,39 +100,69 @@ void Equalizer::validateGain(double& gain) {
     }
 }
 
-void Equalizer::setBandGain(Band band, double gain) {
+template <size_t N>
+double BasicEqualizer<N>::getBandFrequency(size_t band) {
+    const double index = static_cast<double>(band);
+    if constexpr (N == 3) {
+        const double centers[3] = {LOW_SHELF_FREQUENCY, MID_PEAK_FREQUENCY, HIGH_SHELF_FREQUENCY};
+        return centers[band];
+    } else if constexpr (N == 10) {
+        return 31.25 * std::pow(2.0, index);                 // Oitavas ISO: 31 Hz .. 16 kHz
+    } else if constexpr (N == 31) {
+        return 1000.0 * std::pow(2.0, (index - 17.0) / 3.0); // Terços de oitava ISO: 20 Hz .. 20 kHz
+    } else {
+        return 31.25 * std::pow(512.0, index / static_cast<double>(N - 1));
+    }
+}
+
+template <size_t N>
+void BasicEqualizer<N>::setBandGain(size_t band, double gain) {
+    if (band >= N) {
+        throw std::out_of_range("Banda inexistente no equalizador");
+    }
     validateGain(gain);
-    bandGains[static_cast<size_t>(band)] = gain;
+    bandGains[band] = gain;
     presetName = "custom"; // Mudança manual quebra preset
+    updateFilters();
 }
 
-double Equalizer::getBandGain(Band band) const {
-    return bandGains[static_cast<size_t>(band)];
+template <size_t N>
+double BasicEqualizer<N>::getBandGain(size_t band) const {
+    if (band >= N) {
+        throw std::out_of_range("Banda inexistente no equalizador");
+    }
+    return bandGains[band];
 }
 
-void Equalizer::setBands(double lowGain, double midGain, double highGain) {
-    validateGain(lowGain);
-    validateGain(midGain);
-    validateGain(highGain);
-    
-    bandGains[static_cast<size_t>(Band::LOW)] = lowGain;
-    bandGains[static_cast<size_t>(Band::MID)] = midGain;
-    bandGains[static_cast<size_t>(Band::HIGH)] = highGain;
-    
+template <size_t N>
+void BasicEqualizer<N>::setGains(const std::array<double, N>& gains) {
+    for (size_t band = 0; band < N; ++band) {
+        double gain = gains[band];
+        validateGain(gain);
+        bandGains[band] = gain;
+    }
     presetName = "custom";
+    updateFilters();
 }
 
-void Equalizer::applyPreset(const std::string& preset) {
+template <size_t N>
+void BasicEqualizer<N>::applyPreset(const std::string& preset) {
     auto it = presets.find(preset);
     if (it == presets.end()) {
         throw std::invalid_argument("Preset não encontrado: " + preset);
     }
-    
-    bandGains = it->second;
+
+    for (size_t band = 0; band < N; ++band) {
+        double gain = presetGainAt(it->second, getBandFrequency(band));
+        validateGain(gain);
+        bandGains[band] = gain;
+    }
     presetName = preset;
+    updateFilters();
 }
 
-std::vector<std::string> Equalizer::getAvailablePresets() {
+template <size_t N>
+std::vector<std::string> BasicEqualizer<N>::getAvailablePresets() {
     std::vector<std::string> result;
     for (const auto& pair : presets) {
         result.push_back(pair.first);
@@ -74,56 +170,261 @@ std::vector<std::string> Equalizer::getAvailablePresets() {
     return result;
 }
 
-void Equalizer::reset() {
-    bandGains = {0.0, 0.0, 0.0};
+template <size_t N>
+void BasicEqualizer<N>::reset() {
+    bandGains.fill(DEFAULT_GAIN);
     presetName = "flat";
+    updateFilters();
+}
+
+template <size_t N>
+void BasicEqualizer<N>::setEnabled(bool enable) {
+    if (enable != enabled) {
+        enabled = enable;
+        updateFilters(); // Desativar é uma transição suave até a identidade
+    }
+}
+
+template <size_t N>
+void BasicEqualizer<N>::setSampleRate(double rate) {
+    if (rate <= 0.0) {
+        throw std::invalid_argument("Taxa de amostragem inválida");
+    }
+    if (rate != sampleRate) {
+        sampleRate = rate;
+        ++resetSerial; // Histórico em outra taxa não vale para os novos filtros
+        updateGainCorrection();
+        updateFilters();
+    }
+}
+
+template <size_t N>
+void BasicEqualizer<N>::resetState() {
+    ++resetSerial;
+    updateFilters();
 }
 
-std::string Equalizer::toString() const {
+template <size_t N>
+BiquadCoefficients BasicEqualizer<N>::designBand(size_t band, double gainDb) const {
+    if constexpr (N == 3) {
+        switch (static_cast<Band>(band)) {
+            case Band::LOW: return BiquadCoefficients::lowShelf(sampleRate, LOW_SHELF_FREQUENCY, gainDb);
+            case Band::MID: return BiquadCoefficients::peaking(sampleRate, MID_PEAK_FREQUENCY, gainDb, MID_PEAK_Q);
+            default: return BiquadCoefficients::highShelf(sampleRate, HIGH_SHELF_FREQUENCY, gainDb);
+        }
+    } else {
+        // Bandas igualmente espaçadas em log: peakings com a largura do espaçamento e
+        // shelves nas extremidades, com transição na borda da primeira/última banda
+        const double ratio = getBandFrequency(1) / getBandFrequency(0);
+        const double edge = std::sqrt(ratio);
+        if (band == 0) {
+            return BiquadCoefficients::lowShelf(sampleRate, getBandFrequency(0) * edge, gainDb);
+        }
+        if (band == N - 1) {
+            return BiquadCoefficients::highShelf(sampleRate, getBandFrequency(N - 1) / edge, gainDb);
+        }
+        return BiquadCoefficients::peaking(sampleRate, getBandFrequency(band), gainDb, edge / (ratio - 1.0));
+    }
+}
+
+template <size_t N>
+void BasicEqualizer<N>::updateGainCorrection() {
+    for (auto& row : gainCorrection) {
+        row.fill(0.0);
+    }
+    if constexpr (N == 3) {
+        for (size_t band = 0; band < N; ++band) {
+            gainCorrection[band][band] = 1.0; // Três bandas largas: ganhos aplicados diretamente
+        }
+    } else {
+        // Interação: resposta (dB por dB de ganho) do filtro j no centro da banda i.
+        // Em ganhos moderados a resposta em dB é quase linear no ganho do filtro.
+        const double referenceGain = 6.0;
+        std::array<std::array<double, N>, N> interaction;
+        for (size_t j = 0; j < N; ++j) {
+            const BiquadCoefficients filter = designBand(j, referenceGain);
+            for (size_t i = 0; i < N; ++i) {
+                const double frequency = std::min(getBandFrequency(i), 0.45 * sampleRate);
+                interaction[i][j] = filter.magnitudeDb(sampleRate, frequency) / referenceGain;
+            }
+            gainCorrection[j][j] = 1.0;
+        }
+
+        // Gauss-Jordan com pivotamento parcial: gainCorrection = interaction^-1
+        for (size_t column = 0; column < N; ++column) {
+            size_t pivot = column;
+            for (size_t row = column + 1; row < N; ++row) {
+                if (std::fabs(interaction[row][column]) > std::fabs(interaction[pivot][column])) {
+                    pivot = row;
+                }
+            }
+            if (std::fabs(interaction[pivot][column]) < 1e-9) {
+                // Bandas acima de Nyquist não se distinguem: sem correção
+                for (size_t band = 0; band < N; ++band) {
+                    gainCorrection[band].fill(0.0);
+                    gainCorrection[band][band] = 1.0;
+                }
+                return;
+            }
+            std::swap(interaction[pivot], interaction[column]);
+            std::swap(gainCorrection[pivot], gainCorrection[column]);
+            const double scale = 1.0 / interaction[column][column];
+            for (size_t k = 0; k < N; ++k) {
+                interaction[column][k] *= scale;
+                gainCorrection[column][k] *= scale;
+            }
+            for (size_t row = 0; row < N; ++row) {
+                if (row != column && interaction[row][column] != 0.0) {
+                    const double factor = interaction[row][column];
+                    for (size_t k = 0; k < N; ++k) {
+                        interaction[row][k] -= factor * interaction[column][k];
+                        gainCorrection[row][k] -= factor * gainCorrection[column][k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <size_t N>
+void BasicEqualizer<N>::updateFilters() {
+    flat = true;
+    for (size_t band = 0; band < N; ++band) {
+        flat = flat && bandGains[band] == 0.0;
+    }
+
+    // Coeficientes calculados aqui, fora da thread de áudio, e publicados de uma vez
+    CoefficientSet& next = coefficientExchange.getWriteBuffer();
+    next.identity = isBypassed();
+    next.resetSerial = resetSerial;
+    for (size_t band = 0; band < N; ++band) {
+        double filterGain = 0.0;
+        for (size_t i = 0; i < N; ++i) {
+            filterGain += gainCorrection[band][i] * bandGains[i];
+        }
+        // Ganho nulo exato mantém a seção como identidade
+        next.sections[band] = designBand(band, next.identity ? 0.0 : filterGain);
+    }
+    coefficientExchange.publish();
+}
+
+template <size_t N>
+void BasicEqualizer<N>::process(float* interleaved, size_t frames, int channels) {
+    if (coefficientExchange.update()) {
+        const CoefficientSet& next = coefficientExchange.getReadBuffer();
+        targetIdentity = next.identity;
+        if (next.resetSerial != appliedResetSerial) {
+            // Novo stream ou nova taxa: aplicar diretamente, sem histórico
+            appliedResetSerial = next.resetSerial;
+            for (size_t band = 0; band < N; ++band) {
+                filters.setSection(band, next.sections[band]);
+            }
+            filters.reset();
+            rampPosition = RAMP_FRAMES;
+        } else {
+            // Transição parte dos coeficientes em uso (inclusive no meio de outra transição)
+            for (size_t band = 0; band < N; ++band) {
+                rampStart[band] = filters.getSection(band);
+            }
+            rampPosition = 0;
+        }
+    }
+
+    if (rampPosition >= RAMP_FRAMES && targetIdentity) {
+        processing = false;
+        return;
+    }
+    if (!processing) {
+        // Histórico de antes do bypass descreve outro trecho do sinal
+        filters.reset();
+        processing = true;
+    }
+
+    const CoefficientSet& target = coefficientExchange.getReadBuffer();
+    while (rampPosition < RAMP_FRAMES && frames > 0) {
+        const size_t offset = rampPosition % RAMP_STEP_FRAMES;
+        if (offset == 0) {
+            const float t = static_cast<float>(rampPosition + RAMP_STEP_FRAMES) / static_cast<float>(RAMP_FRAMES);
+            for (size_t band = 0; band < N; ++band) {
+                filters.setSection(band, interpolate(rampStart[band], target.sections[band], t));
+            }
+        }
+        const size_t chunk = std::min(frames, RAMP_STEP_FRAMES - offset);
+        filters.process(interleaved, chunk, channels);
+        interleaved += chunk * static_cast<size_t>(channels);
+        frames -= chunk;
+        rampPosition += chunk;
+    }
+    if (frames > 0) {
+        filters.process(interleaved, frames, channels);
+    }
+}
+
+template <size_t N>
+std::string BasicEqualizer<N>::toString() const {
     std::stringstream ss;
-    ss << "Equalizer [" << presetName << "] - ";
-    ss << "Graves: " << getBandGain(Band::LOW) << "dB, ";
-    ss << "Médios: " << getBandGain(Band::MID) << "dB, ";
-    ss << "Agudos: " << getBandGain(Band::HIGH) << "dB";
+    if constexpr (N == 3) {
+        ss << "Equalizer [" << presetName << "] - ";
+        ss << "Graves: " << getBandGain(Band::LOW) << "dB, ";
+        ss << "Médios: " << getBandGain(Band::MID) << "dB, ";
+        ss << "Agudos: " << getBandGain(Band::HIGH) << "dB";
+    } else {
+        ss << "Equalizer " << N << " bandas [" << presetName << "] - ";
+        for (size_t band = 0; band < N; ++band) {
+            ss << (band > 0 ? ", " : "") << std::lround(getBandFrequency(band)) << "Hz: " << bandGains[band] << "dB";
+        }
+    }
     ss << " (" << (enabled ? "Ativo" : "Inativo") << ")";
     return ss.str();
 }
 
-bool Equalizer::operator==(const Equalizer& other) const {
+template <size_t N>
+bool BasicEqualizer<N>::operator==(const BasicEqualizer& other) const {
     return bandGains == other.bandGains && enabled == other.enabled;
 }
 
-bool Equalizer::operator!=(const Equalizer& other) const {
+template <size_t N>
+bool BasicEqualizer<N>::operator!=(const BasicEqualizer& other) const {
     return !(*this == other);
 }
 
-std::unique_ptr<Equalizer> Equalizer::createFlat() {
-    return std::make_unique<Equalizer>();
+template <size_t N>
+std::unique_ptr<BasicEqualizer<N>> BasicEqualizer<N>::createFlat() {
+    return std::make_unique<BasicEqualizer>();
 }
 
-std::unique_ptr<Equalizer> Equalizer::createRock() {
-    auto eq = std::make_unique<Equalizer>();
+template <size_t N>
+std::unique_ptr<BasicEqualizer<N>> BasicEqualizer<N>::createRock() {
+    auto eq = std::make_unique<BasicEqualizer>();
     eq->applyPreset("rock");
     return eq;
 }
 
-std::unique_ptr<Equalizer> Equalizer::createJazz() {
-    auto eq = std::make_unique<Equalizer>();
+template <size_t N>
+std::unique_ptr<BasicEqualizer<N>> BasicEqualizer<N>::createJazz() {
+    auto eq = std::make_unique<BasicEqualizer>();
     eq->applyPreset("jazz");
     return eq;
 }
 
-std::unique_ptr<Equalizer> Equalizer::createClassical() {
-    auto eq = std::make_unique<Equalizer>();
+template <size_t N>
+std::unique_ptr<BasicEqualizer<N>> BasicEqualizer<N>::createClassical() {
+    auto eq = std::make_unique<BasicEqualizer>();
     eq->applyPreset("classical");
     return eq;
 }
 
-std::string Equalizer::bandToString(Band band) {
+template <size_t N>
+std::string BasicEqualizer<N>::bandToString(Band band) {
     switch (band) {
         case Band::LOW: return "Graves";
-        case Band::MID: return "Médios";  
+        case Band::MID: return "Médios";
         case Band::HIGH: return "Agudos";
         default: return "Desconhecido";
     }
-}
\ No newline at end of file
+}
+
+// Tamanhos suportados: 3 bandas (player), oitavas e terços de oitava
+template class BasicEqualizer<3>;
+template class BasicEqualizer<10>;
+template class BasicEqualizer<31>;
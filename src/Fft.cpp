@@ -0,0 +1,461 @@
+#include "Fft.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Twiddles de um estágio: w1r, w1i, w2r, w2i, w3r, w3i, cada um com m pontos
+struct StageTwiddles {
+    const float* w1r;
+    const float* w1i;
+    const float* w2r;
+    const float* w2i;
+    const float* w3r;
+    const float* w3i;
+
+    StageTwiddles(const float* base, size_t m)
+        : w1r(base), w1i(base + m), w2r(base + 2 * m), w2i(base + 3 * m), w3r(base + 4 * m), w3i(base + 5 * m) {}
+};
+
+// Butterfly radix-4 (Stockham, DIF):
+//   y[4p+0] = (a+c) + (b+d)          y[4p+2] = w2 * ((a+c) - (b+d))
+//   y[4p+1] = w1 * ((a-c) - j(b-d))   y[4p+3] = w3 * ((a-c) + j(b-d))
+void radix4Scalar(size_t m, size_t s, const float* xr, const float* xi, float* yr, float* yi,
+                  const StageTwiddles& w, size_t pBegin) {
+    for (size_t p = pBegin; p < m; ++p) {
+        const float w1r = w.w1r[p], w1i = w.w1i[p];
+        const float w2r = w.w2r[p], w2i = w.w2i[p];
+        const float w3r = w.w3r[p], w3i = w.w3i[p];
+        for (size_t q = 0; q < s; ++q) {
+            const size_t ia = q + s * p, ib = ia + s * m, ic = ib + s * m, id = ic + s * m;
+            const float apcR = xr[ia] + xr[ic], apcI = xi[ia] + xi[ic];
+            const float amcR = xr[ia] - xr[ic], amcI = xi[ia] - xi[ic];
+            const float bpdR = xr[ib] + xr[id], bpdI = xi[ib] + xi[id];
+            const float bmdR = xr[ib] - xr[id], bmdI = xi[ib] - xi[id];
+            // j(b-d) = (-bmdI, bmdR)
+            const float t1R = amcR + bmdI, t1I = amcI - bmdR;
+            const float t2R = apcR - bpdR, t2I = apcI - bpdI;
+            const float t3R = amcR - bmdI, t3I = amcI + bmdR;
+            const size_t o = q + s * 4 * p;
+            yr[o] = apcR + bpdR;
+            yi[o] = apcI + bpdI;
+            yr[o + s] = w1r * t1R - w1i * t1I;
+            yi[o + s] = w1r * t1I + w1i * t1R;
+            yr[o + 2 * s] = w2r * t2R - w2i * t2I;
+            yi[o + 2 * s] = w2r * t2I + w2i * t2R;
+            yr[o + 3 * s] = w3r * t3R - w3i * t3I;
+            yi[o + 3 * s] = w3r * t3I + w3i * t3R;
+        }
+    }
+}
+
+void radix2Scalar(size_t s, const float* xr, const float* xi, float* yr, float* yi, size_t qBegin) {
+    for (size_t q = qBegin; q < s; ++q) {
+        const float aR = xr[q], aI = xi[q], bR = xr[q + s], bI = xi[q + s];
+        yr[q] = aR + bR;
+        yi[q] = aI + bI;
+        yr[q + s] = aR - bR;
+        yi[q + s] = aI - bI;
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+// Produto complexo em formato dividido: (ar + j ai) * (br + j bi)
+inline void complexMulSse(__m128 ar, __m128 ai, __m128 br, __m128 bi, __m128& outR, __m128& outI) {
+    outR = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+    outI = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+}
+
+// Núcleo da butterfly para quatro pontos independentes
+inline void butterflySse(__m128 aR, __m128 aI, __m128 bR, __m128 bI, __m128 cR, __m128 cI, __m128 dR, __m128 dI,
+                         __m128 w1r, __m128 w1i, __m128 w2r, __m128 w2i, __m128 w3r, __m128 w3i,
+                         __m128 (&outR)[4], __m128 (&outI)[4]) {
+    const __m128 apcR = _mm_add_ps(aR, cR), apcI = _mm_add_ps(aI, cI);
+    const __m128 amcR = _mm_sub_ps(aR, cR), amcI = _mm_sub_ps(aI, cI);
+    const __m128 bpdR = _mm_add_ps(bR, dR), bpdI = _mm_add_ps(bI, dI);
+    const __m128 bmdR = _mm_sub_ps(bR, dR), bmdI = _mm_sub_ps(bI, dI);
+    outR[0] = _mm_add_ps(apcR, bpdR);
+    outI[0] = _mm_add_ps(apcI, bpdI);
+    complexMulSse(_mm_add_ps(amcR, bmdI), _mm_sub_ps(amcI, bmdR), w1r, w1i, outR[1], outI[1]);
+    complexMulSse(_mm_sub_ps(apcR, bpdR), _mm_sub_ps(apcI, bpdI), w2r, w2i, outR[2], outI[2]);
+    complexMulSse(_mm_sub_ps(amcR, bmdI), _mm_add_ps(amcI, bmdR), w3r, w3i, outR[3], outI[3]);
+}
+
+// stride >= 4: vetoriza sobre q, twiddle constante por p
+void radix4StridedSse2(size_t m, size_t s, const float* xr, const float* xi, float* yr, float* yi,
+                       const StageTwiddles& w) {
+    for (size_t p = 0; p < m; ++p) {
+        const __m128 w1r = _mm_set1_ps(w.w1r[p]), w1i = _mm_set1_ps(w.w1i[p]);
+        const __m128 w2r = _mm_set1_ps(w.w2r[p]), w2i = _mm_set1_ps(w.w2i[p]);
+        const __m128 w3r = _mm_set1_ps(w.w3r[p]), w3i = _mm_set1_ps(w.w3i[p]);
+        for (size_t q = 0; q < s; q += 4) {
+            const size_t ia = q + s * p, ib = ia + s * m, ic = ib + s * m, id = ic + s * m;
+            __m128 outR[4], outI[4];
+            butterflySse(_mm_loadu_ps(xr + ia), _mm_loadu_ps(xi + ia), _mm_loadu_ps(xr + ib), _mm_loadu_ps(xi + ib),
+                         _mm_loadu_ps(xr + ic), _mm_loadu_ps(xi + ic), _mm_loadu_ps(xr + id), _mm_loadu_ps(xi + id),
+                         w1r, w1i, w2r, w2i, w3r, w3i, outR, outI);
+            const size_t o = q + s * 4 * p;
+            for (size_t k = 0; k < 4; ++k) {
+                _mm_storeu_ps(yr + o + k * s, outR[k]);
+                _mm_storeu_ps(yi + o + k * s, outI[k]);
+            }
+        }
+    }
+}
+
+// stride == 1 (primeiro estágio): vetoriza sobre p; as saídas 4p..4p+3 são transpostas
+void radix4UnitStrideSse2(size_t m, const float* xr, const float* xi, float* yr, float* yi,
+                          const StageTwiddles& w) {
+    size_t p = 0;
+    for (; p + 4 <= m; p += 4) {
+        __m128 outR[4], outI[4];
+        butterflySse(_mm_loadu_ps(xr + p), _mm_loadu_ps(xi + p), _mm_loadu_ps(xr + p + m),
+                     _mm_loadu_ps(xi + p + m), _mm_loadu_ps(xr + p + 2 * m), _mm_loadu_ps(xi + p + 2 * m),
+                     _mm_loadu_ps(xr + p + 3 * m), _mm_loadu_ps(xi + p + 3 * m),
+                     _mm_loadu_ps(w.w1r + p), _mm_loadu_ps(w.w1i + p), _mm_loadu_ps(w.w2r + p),
+                     _mm_loadu_ps(w.w2i + p), _mm_loadu_ps(w.w3r + p), _mm_loadu_ps(w.w3i + p), outR, outI);
+        _MM_TRANSPOSE4_PS(outR[0], outR[1], outR[2], outR[3]);
+        _MM_TRANSPOSE4_PS(outI[0], outI[1], outI[2], outI[3]);
+        for (size_t k = 0; k < 4; ++k) {
+            _mm_storeu_ps(yr + 4 * (p + k), outR[k]);
+            _mm_storeu_ps(yi + 4 * (p + k), outI[k]);
+        }
+    }
+    radix4Scalar(m, 1, xr, xi, yr, yi, w, p);
+}
+
+void radix2Sse2(size_t s, const float* xr, const float* xi, float* yr, float* yi) {
+    size_t q = 0;
+    for (; q + 4 <= s; q += 4) {
+        const __m128 aR = _mm_loadu_ps(xr + q), aI = _mm_loadu_ps(xi + q);
+        const __m128 bR = _mm_loadu_ps(xr + q + s), bI = _mm_loadu_ps(xi + q + s);
+        _mm_storeu_ps(yr + q, _mm_add_ps(aR, bR));
+        _mm_storeu_ps(yi + q, _mm_add_ps(aI, bI));
+        _mm_storeu_ps(yr + q + s, _mm_sub_ps(aR, bR));
+        _mm_storeu_ps(yi + q + s, _mm_sub_ps(aI, bI));
+    }
+    radix2Scalar(s, xr, xi, yr, yi, q);
+}
+
+MP3PLAYER_TARGET_AVX2 inline void complexMulAvx(__m256 ar, __m256 ai, __m256 br, __m256 bi, __m256& outR,
+                                                __m256& outI) {
+    outR = _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi));
+    outI = _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br));
+}
+
+// stride >= 8: oito valores de q por iteração
+MP3PLAYER_TARGET_AVX2 void radix4StridedAvx2(size_t m, size_t s, const float* xr, const float* xi, float* yr,
+                                             float* yi, const StageTwiddles& w) {
+    for (size_t p = 0; p < m; ++p) {
+        const __m256 w1r = _mm256_set1_ps(w.w1r[p]), w1i = _mm256_set1_ps(w.w1i[p]);
+        const __m256 w2r = _mm256_set1_ps(w.w2r[p]), w2i = _mm256_set1_ps(w.w2i[p]);
+        const __m256 w3r = _mm256_set1_ps(w.w3r[p]), w3i = _mm256_set1_ps(w.w3i[p]);
+        for (size_t q = 0; q < s; q += 8) {
+            const size_t ia = q + s * p, ib = ia + s * m, ic = ib + s * m, id = ic + s * m;
+            const __m256 aR = _mm256_loadu_ps(xr + ia), aI = _mm256_loadu_ps(xi + ia);
+            const __m256 bR = _mm256_loadu_ps(xr + ib), bI = _mm256_loadu_ps(xi + ib);
+            const __m256 cR = _mm256_loadu_ps(xr + ic), cI = _mm256_loadu_ps(xi + ic);
+            const __m256 dR = _mm256_loadu_ps(xr + id), dI = _mm256_loadu_ps(xi + id);
+            const __m256 apcR = _mm256_add_ps(aR, cR), apcI = _mm256_add_ps(aI, cI);
+            const __m256 amcR = _mm256_sub_ps(aR, cR), amcI = _mm256_sub_ps(aI, cI);
+            const __m256 bpdR = _mm256_add_ps(bR, dR), bpdI = _mm256_add_ps(bI, dI);
+            const __m256 bmdR = _mm256_sub_ps(bR, dR), bmdI = _mm256_sub_ps(bI, dI);
+            __m256 outR, outI;
+            const size_t o = q + s * 4 * p;
+            _mm256_storeu_ps(yr + o, _mm256_add_ps(apcR, bpdR));
+            _mm256_storeu_ps(yi + o, _mm256_add_ps(apcI, bpdI));
+            complexMulAvx(_mm256_add_ps(amcR, bmdI), _mm256_sub_ps(amcI, bmdR), w1r, w1i, outR, outI);
+            _mm256_storeu_ps(yr + o + s, outR);
+            _mm256_storeu_ps(yi + o + s, outI);
+            complexMulAvx(_mm256_sub_ps(apcR, bpdR), _mm256_sub_ps(apcI, bpdI), w2r, w2i, outR, outI);
+            _mm256_storeu_ps(yr + o + 2 * s, outR);
+            _mm256_storeu_ps(yi + o + 2 * s, outI);
+            complexMulAvx(_mm256_sub_ps(amcR, bmdI), _mm256_add_ps(amcI, bmdR), w3r, w3i, outR, outI);
+            _mm256_storeu_ps(yr + o + 3 * s, outR);
+            _mm256_storeu_ps(yi + o + 3 * s, outI);
+        }
+    }
+}
+
+MP3PLAYER_TARGET_AVX2 void radix2Avx2(size_t s, const float* xr, const float* xi, float* yr, float* yi) {
+    size_t q = 0;
+    for (; q + 8 <= s; q += 8) {
+        const __m256 aR = _mm256_loadu_ps(xr + q), aI = _mm256_loadu_ps(xi + q);
+        const __m256 bR = _mm256_loadu_ps(xr + q + s), bI = _mm256_loadu_ps(xi + q + s);
+        _mm256_storeu_ps(yr + q, _mm256_add_ps(aR, bR));
+        _mm256_storeu_ps(yi + q, _mm256_add_ps(aI, bI));
+        _mm256_storeu_ps(yr + q + s, _mm256_sub_ps(aR, bR));
+        _mm256_storeu_ps(yi + q + s, _mm256_sub_ps(aI, bI));
+    }
+    radix2Scalar(s, xr, xi, yr, yi, q);
+}
+
+
+// Pós-processamento da FFT real, quatro bins por iteração: os índices M-k são lidos
+// de trás para frente e invertidos no registrador
+inline __m128 reverseSse(__m128 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+size_t splitSpectrumSse2(size_t half, const float* zr, const float* zi, const float* twR, const float* twI,
+                         float* real, float* imag) {
+    const __m128 halfV = _mm_set1_ps(0.5f);
+    size_t k = 1;
+    for (; k + 4 <= half; k += 4) {
+        const __m128 aR = _mm_loadu_ps(zr + k), aI = _mm_loadu_ps(zi + k);
+        const __m128 bR = reverseSse(_mm_loadu_ps(zr + half - k - 3));
+        const __m128 bI = _mm_sub_ps(_mm_setzero_ps(), reverseSse(_mm_loadu_ps(zi + half - k - 3)));
+        const __m128 feR = _mm_mul_ps(halfV, _mm_add_ps(aR, bR)), feI = _mm_mul_ps(halfV, _mm_add_ps(aI, bI));
+        const __m128 foR = _mm_mul_ps(halfV, _mm_sub_ps(aI, bI)), foI = _mm_mul_ps(halfV, _mm_sub_ps(bR, aR));
+        __m128 prodR, prodI;
+        complexMulSse(foR, foI, _mm_loadu_ps(twR + k), _mm_loadu_ps(twI + k), prodR, prodI);
+        _mm_storeu_ps(real + k, _mm_add_ps(feR, prodR));
+        _mm_storeu_ps(imag + k, _mm_add_ps(feI, prodI));
+    }
+    return k;
+}
+
+size_t mergeSpectrumSse2(size_t half, const float* real, const float* imag, const float* twR, const float* twI,
+                         float* zr, float* zi) {
+    const __m128 halfV = _mm_set1_ps(0.5f);
+    size_t k = 0;
+    for (; k + 4 <= half; k += 4) {
+        const __m128 aR = _mm_loadu_ps(real + k), aI = _mm_loadu_ps(imag + k);
+        const __m128 bR = reverseSse(_mm_loadu_ps(real + half - k - 3));
+        const __m128 bI = _mm_sub_ps(_mm_setzero_ps(), reverseSse(_mm_loadu_ps(imag + half - k - 3)));
+        const __m128 feR = _mm_mul_ps(halfV, _mm_add_ps(aR, bR)), feI = _mm_mul_ps(halfV, _mm_add_ps(aI, bI));
+        const __m128 dR = _mm_mul_ps(halfV, _mm_sub_ps(aR, bR)), dI = _mm_mul_ps(halfV, _mm_sub_ps(aI, bI));
+        __m128 foR, foI;
+        complexMulSse(dR, dI, _mm_loadu_ps(twR + k), _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(twI + k)), foR, foI);
+        _mm_storeu_ps(zr + k, _mm_sub_ps(feR, foI));
+        _mm_storeu_ps(zi + k, _mm_add_ps(feI, foR));
+    }
+    return k;
+}
+
+void deinterleaveSse2(size_t half, const float* input, float* even, float* odd) {
+    size_t n = 0;
+    for (; n + 4 <= half; n += 4) {
+        const __m128 lo = _mm_loadu_ps(input + 2 * n), hi = _mm_loadu_ps(input + 2 * n + 4);
+        _mm_storeu_ps(even + n, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(odd + n, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+}
+
+void interleaveSse2(size_t half, const float* even, const float* odd, float scale, float* output) {
+    const __m128 scaleV = _mm_set1_ps(scale);
+    size_t n = 0;
+    for (; n + 4 <= half; n += 4) {
+        const __m128 e = _mm_mul_ps(_mm_loadu_ps(even + n), scaleV), o = _mm_mul_ps(_mm_loadu_ps(odd + n), scaleV);
+        _mm_storeu_ps(output + 2 * n, _mm_unpacklo_ps(e, o));
+        _mm_storeu_ps(output + 2 * n + 4, _mm_unpackhi_ps(e, o));
+    }
+}
+
+#endif
+
+} // namespace
+
+Fft::Fft(size_t transformSize) : size(transformSize), half(transformSize / 2), finalRadix2(false) {
+    if (!isPowerOfTwo(transformSize) || transformSize < MIN_SIZE) {
+        throw std::invalid_argument("Tamanho de FFT deve ser potência de 2 e >= 16");
+    }
+
+    // Plano: estágios radix-4 de half até 4 pontos; sobra um radix-2 se log2(half) for ímpar
+    size_t length = half;
+    size_t stride = 1;
+    while (length >= 4) {
+        const size_t m = length / 4;
+        stages.push_back({length, stride, twiddles.size()});
+        for (size_t k = 1; k <= 3; ++k) {
+            for (size_t p = 0; p < m; ++p) {
+                twiddles.push_back(static_cast<float>(std::cos(2.0 * PI * static_cast<double>(k * p) / length)));
+            }
+            for (size_t p = 0; p < m; ++p) {
+                twiddles.push_back(static_cast<float>(-std::sin(2.0 * PI * static_cast<double>(k * p) / length)));
+            }
+        }
+        length /= 4;
+        stride *= 4;
+    }
+    finalRadix2 = length == 2;
+
+    realTwiddleRe.resize(half + 1);
+    realTwiddleIm.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k) {
+        realTwiddleRe[k] = static_cast<float>(std::cos(2.0 * PI * static_cast<double>(k) / size));
+        realTwiddleIm[k] = static_cast<float>(-std::sin(2.0 * PI * static_cast<double>(k) / size));
+    }
+
+    workRe.resize(half);
+    workIm.resize(half);
+    scratchRe.resize(half);
+    scratchIm.resize(half);
+}
+
+void Fft::transform(float* xr, float* xi, float* yr, float* yi, CpuFeatures::SimdLevel level) {
+    float* srcR = xr;
+    float* srcI = xi;
+    float* dstR = yr;
+    float* dstI = yi;
+
+    for (const Stage& stage : stages) {
+        const size_t m = stage.length / 4;
+        const size_t s = stage.stride;
+        const StageTwiddles w(twiddles.data() + stage.twiddleOffset, m);
+        switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+            case CpuFeatures::SimdLevel::AVX2:
+                if (s >= 8) {
+                    radix4StridedAvx2(m, s, srcR, srcI, dstR, dstI, w);
+                    break;
+                }
+                [[fallthrough]]; // Estágios iniciais (stride 1 e 4) usam os kernels SSE2
+            case CpuFeatures::SimdLevel::SSE2:
+                if (s >= 4) {
+                    radix4StridedSse2(m, s, srcR, srcI, dstR, dstI, w);
+                } else if (s == 1) {
+                    radix4UnitStrideSse2(m, srcR, srcI, dstR, dstI, w);
+                } else {
+                    radix4Scalar(m, s, srcR, srcI, dstR, dstI, w, 0);
+                }
+                break;
+#endif
+            default:
+                radix4Scalar(m, s, srcR, srcI, dstR, dstI, w, 0);
+                break;
+        }
+        std::swap(srcR, dstR);
+        std::swap(srcI, dstI);
+    }
+
+    if (finalRadix2) {
+        const size_t s = half / 2;
+        switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+            case CpuFeatures::SimdLevel::AVX2:
+                radix2Avx2(s, srcR, srcI, dstR, dstI);
+                break;
+            case CpuFeatures::SimdLevel::SSE2:
+                radix2Sse2(s, srcR, srcI, dstR, dstI);
+                break;
+#endif
+            default:
+                radix2Scalar(s, srcR, srcI, dstR, dstI, 0);
+                break;
+        }
+        std::swap(srcR, dstR);
+        std::swap(srcI, dstI);
+    }
+
+    if (srcR != xr) {
+        std::copy(srcR, srcR + half, xr);
+        std::copy(srcI, srcI + half, xi);
+    }
+}
+
+void Fft::forward(const float* input, float* real, float* imag) {
+    forward(input, real, imag, CpuFeatures::getSimdLevel());
+}
+
+void Fft::inverse(const float* real, const float* imag, float* output) {
+    inverse(real, imag, output, CpuFeatures::getSimdLevel());
+}
+
+void Fft::forwardComplex(float* real, float* imag) {
+    transform(real, imag, scratchRe.data(), scratchIm.data(), CpuFeatures::getSimdLevel());
+}
+
+void Fft::forwardComplex(float* real, float* imag, CpuFeatures::SimdLevel level) {
+    transform(real, imag, scratchRe.data(), scratchIm.data(), level);
+}
+
+void Fft::forward(const float* input, float* real, float* imag, CpuFeatures::SimdLevel level) {
+#if defined(MP3PLAYER_ARCH_X86)
+    const bool vector = level == CpuFeatures::SimdLevel::SSE2 || level == CpuFeatures::SimdLevel::AVX2;
+#else
+    const bool vector = false;
+#endif
+    // Amostras pares/ímpares como partes real/imaginária de um sinal complexo de N/2 pontos
+    // (half é múltiplo de 8, então o caminho vetorial não deixa resto)
+    if (vector) {
+#if defined(MP3PLAYER_ARCH_X86)
+        deinterleaveSse2(half, input, workRe.data(), workIm.data());
+#endif
+    } else {
+        for (size_t n = 0; n < half; ++n) {
+            workRe[n] = input[2 * n];
+            workIm[n] = input[2 * n + 1];
+        }
+    }
+    transform(workRe.data(), workIm.data(), scratchRe.data(), scratchIm.data(), level);
+
+    // X[k] = Fe[k] + W^k Fo[k], com Fe = (Z[k] + Z*[M-k]) / 2 e Fo = -j (Z[k] - Z*[M-k]) / 2
+    real[0] = workRe[0] + workIm[0];
+    imag[0] = 0.0f;
+    real[half] = workRe[0] - workIm[0];
+    imag[half] = 0.0f;
+    size_t k = 1;
+#if defined(MP3PLAYER_ARCH_X86)
+    if (vector) {
+        k = splitSpectrumSse2(half, workRe.data(), workIm.data(), realTwiddleRe.data(), realTwiddleIm.data(),
+                              real, imag);
+    }
+#endif
+    for (; k < half; ++k) {
+        const float aR = workRe[k], aI = workIm[k];
+        const float bR = workRe[half - k], bI = -workIm[half - k];
+        const float feR = 0.5f * (aR + bR), feI = 0.5f * (aI + bI);
+        const float foR = 0.5f * (aI - bI), foI = 0.5f * (bR - aR);
+        const float wR = realTwiddleRe[k], wI = realTwiddleIm[k];
+        real[k] = feR + (foR * wR - foI * wI);
+        imag[k] = feI + (foR * wI + foI * wR);
+    }
+}
+
+void Fft::inverse(const float* real, const float* imag, float* output, CpuFeatures::SimdLevel level) {
+#if defined(MP3PLAYER_ARCH_X86)
+    const bool vector = level == CpuFeatures::SimdLevel::SSE2 || level == CpuFeatures::SimdLevel::AVX2;
+#else
+    const bool vector = false;
+#endif
+    // Z[k] = Fe[k] + j Fo[k], com Fe = (X[k] + X*[M-k]) / 2 e Fo = W^-k (X[k] - X*[M-k]) / 2
+    size_t k = 0;
+#if defined(MP3PLAYER_ARCH_X86)
+    if (vector) {
+        k = mergeSpectrumSse2(half, real, imag, realTwiddleRe.data(), realTwiddleIm.data(), workRe.data(),
+                              workIm.data());
+    }
+#endif
+    for (; k < half; ++k) {
+        const float aR = real[k], aI = imag[k];
+        const float bR = real[half - k], bI = -imag[half - k];
+        const float feR = 0.5f * (aR + bR), feI = 0.5f * (aI + bI);
+        const float dR = 0.5f * (aR - bR), dI = 0.5f * (aI - bI);
+        const float wR = realTwiddleRe[k], wI = -realTwiddleIm[k];
+        const float foR = dR * wR - dI * wI, foI = dR * wI + dI * wR;
+        workRe[k] = feR - foI;
+        workIm[k] = feI + foR;
+    }
+
+    // IFFT(Z) = troca(FFT(troca(Z))), trocando real <-> imaginário
+    transform(workIm.data(), workRe.data(), scratchIm.data(), scratchRe.data(), level);
+
+    const float scale = 1.0f / static_cast<float>(half);
+    if (vector) {
+#if defined(MP3PLAYER_ARCH_X86)
+        interleaveSse2(half, workRe.data(), workIm.data(), scale, output);
+#endif
+    } else {
+        for (size_t n = 0; n < half; ++n) {
+            output[2 * n] = workRe[n] * scale;
+            output[2 * n + 1] = workIm[n] * scale;
+        }
+    }
+}
@@ -0,0 +1,1040 @@
+#include "FlacDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t SEEK_POINT_BYTES = 18;
+constexpr uint64_t SEEK_PLACEHOLDER = ~0ULL;
+constexpr size_t TAIL_CHUNK_BYTES = 64 * 1024;
+constexpr size_t MAX_HEADER_BYTES = 16;     // 4 fixos + 7 do número + 2 + 2 + CRC-8
+
+// Abaixo destas ordens o triângulo serial do bloco custa o que a parte vetorizada economiza:
+// a reconstrução fica limitada pela latência de uma amostra para a seguinte nos dois casos.
+// Valores medidos (blocos de 4096, sinal tonal): a partir deles o kernel ganha 1,3x ou mais
+// do escalar; nas ordens baixas mais comuns (2 a 8) o escalar empata ou vence
+constexpr int MIN_AVX2_ORDER = 10;
+constexpr int MIN_AVX2_WIDE_ORDER = 9;
+constexpr int MIN_SSE41_ORDER = 14;
+
+// CRC-8 dos cabeçalhos de quadro: polinômio 0x07, valor inicial 0
+constexpr std::array<uint8_t, 256> makeCrc8Table() {
+    std::array<uint8_t, 256> table{};
+    for (unsigned i = 0; i < 256; ++i) {
+        unsigned r = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            r = (r & 0x80) ? ((r << 1) ^ 0x07) : (r << 1);
+        }
+        table[i] = static_cast<uint8_t>(r);
+    }
+    return table;
+}
+
+// Zeros à esquerda de cada byte (8 para o byte zero)
+constexpr std::array<uint8_t, 256> makeLeadingZeroTable() {
+    std::array<uint8_t, 256> table{};
+    for (unsigned i = 0; i < 256; ++i) {
+        uint8_t count = 0;
+        while (count < 8 && !(i & (0x80u >> count))) {
+            ++count;
+        }
+        table[i] = count;
+    }
+    return table;
+}
+
+// CRC-16 dos quadros (polinômio 0x8005) fatiado em 8: a tabela k é o CRC de um byte
+// seguido de k bytes zero, e cada passo consome 8 bytes com 8 consultas independentes
+constexpr std::array<std::array<uint16_t, 256>, 8> makeCrc16Tables() {
+    std::array<std::array<uint16_t, 256>, 8> tables{};
+    for (unsigned i = 0; i < 256; ++i) {
+        unsigned r = i << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            r = (r & 0x8000) ? ((r << 1) ^ 0x8005) : (r << 1);
+        }
+        tables[0][i] = static_cast<uint16_t>(r);
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (unsigned i = 0; i < 256; ++i) {
+            const uint16_t previous = tables[k - 1][i];
+            tables[k][i] = static_cast<uint16_t>((previous << 8) ^ tables[0][previous >> 8]);
+        }
+    }
+    return tables;
+}
+
+constexpr std::array<uint8_t, 256> CRC8_TABLE = makeCrc8Table();
+constexpr std::array<std::array<uint16_t, 256>, 8> CRC16_TABLES = makeCrc16Tables();
+constexpr std::array<uint8_t, 256> LEADING_ZEROS = makeLeadingZeroTable();
+
+// Preditores fixos de ordem 0 a 4 como coeficientes LPC com shift 0
+constexpr int32_t FIXED_COEFFICIENTS[5][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 0}, {2, -1, 0, 0}, {3, -3, 1, 0}, {4, -6, 4, -1}};
+
+constexpr int FRAME_SAMPLE_RATES[12] = {0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000};
+constexpr int FRAME_SAMPLE_SIZES[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+
+// Palavra não nula
+inline unsigned countLeadingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clzll(word));
+#else
+    unsigned count = 0;
+    while ((word >> 56) == 0) {
+        word <<= 8;
+        count += 8;
+    }
+    return count + LEADING_ZEROS[word >> 56];
+#endif
+}
+
+inline uint64_t readBigEndian64(const uint8_t* p) {
+    return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+           (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+           (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+           (static_cast<uint64_t>(p[6]) << 8) | static_cast<uint64_t>(p[7]);
+}
+
+inline uint32_t readBigEndian24(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+}
+
+int floorLog2(int value) {
+    int result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+// Termos da amostra mais antiga para a mais recente: a dependência de s[i-1], que acabou de
+// ser calculada, entra por último na soma
+void restoreLpcScalar(const int32_t* c, int order, int shift, int32_t* s, size_t count, bool wide, size_t begin) {
+    if (wide) {
+        for (size_t i = begin; i < count; ++i) {
+            int64_t sum = 0;
+            for (int j = order - 1; j >= 0; --j) {
+                sum += static_cast<int64_t>(c[j]) * s[i - 1 - static_cast<size_t>(j)];
+            }
+            s[i] += static_cast<int32_t>(sum >> shift);
+        }
+        return;
+    }
+    // Aritmética sem sinal: o transbordo de 32 bits segue o complemento de dois, sem UB
+    for (size_t i = begin; i < count; ++i) {
+        uint32_t sum = 0;
+        for (int j = order - 1; j >= 0; --j) {
+            sum += static_cast<uint32_t>(c[j]) * static_cast<uint32_t>(s[i - 1 - static_cast<size_t>(j)]);
+        }
+        s[i] = static_cast<int32_t>(static_cast<uint32_t>(s[i]) +
+                                    static_cast<uint32_t>(static_cast<int32_t>(sum) >> shift));
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+// Blocos de W amostras s[i..i+W): a contribuição de s[i-j] para j >= W é conhecida em
+// todas as posições do bloco e vai para o vetor; para j < W, os coeficientes mascarados
+// zeram as posições t >= j, que ainda contêm resíduo. Resta o triângulo j <= t, serial.
+//
+// No triângulo os coeficientes vêm com zeros depois da ordem, então o tamanho é fixo e a
+// recursão de templates o desenrola por completo, com as amostras novas em registradores.
+// Os termos entram do mais antigo para o mais recente (y[t-1] por último).
+template <int T, int J, typename Sum>
+inline void addTriangleTerms(const int32_t* c, const int32_t* y, Sum& sum) {
+    if constexpr (J >= 1) {
+        using Unsigned = typename std::make_unsigned<Sum>::type;
+        sum = static_cast<Sum>(static_cast<Unsigned>(sum) +
+                               static_cast<Unsigned>(static_cast<Sum>(c[J - 1]) * static_cast<Sum>(y[T - J])));
+        addTriangleTerms<T, J - 1>(c, y, sum);
+    }
+}
+
+template <int W, int T = 0, typename Sum>
+inline void finishBlock(const int32_t* c, int shift, const Sum* partial, int32_t* s, int32_t* y) {
+    if constexpr (T < W) {
+        Sum sum = partial[T];
+        addTriangleTerms<T, T>(c, y, sum);
+        y[T] = static_cast<int32_t>(static_cast<uint32_t>(s[T]) + static_cast<uint32_t>(sum >> shift));
+        s[T] = y[T];
+        finishBlock<W, T + 1>(c, shift, partial, s, y);
+    }
+}
+
+struct PaddedCoefficients {
+    alignas(32) int32_t values[FlacDecoder::MAX_LPC_ORDER + 8] = {};
+
+    PaddedCoefficients(const int32_t* c, int order) { std::copy_n(c, order, values); }
+};
+
+MP3PLAYER_TARGET_SSE41 size_t restoreLpc32Sse41(const int32_t* coefficients, int order, int shift, int32_t* s,
+                                                size_t count) {
+    const PaddedCoefficients padded(coefficients, order);
+    const int32_t* c = padded.values;
+    __m128i taps[FlacDecoder::MAX_LPC_ORDER];
+    for (int j = 0; j < order; ++j) {
+        taps[j] = _mm_set1_epi32(c[j]);
+    }
+    const __m128i masked[3] = {_mm_setr_epi32(c[0], 0, 0, 0), _mm_setr_epi32(c[1], c[1], 0, 0),
+                               _mm_setr_epi32(c[2], c[2], c[2], 0)};
+    size_t i = static_cast<size_t>(order);
+    for (; i + 4 <= count; i += 4) {
+        __m128i acc = _mm_setzero_si128();
+        for (int j = order; j >= 4; --j) {
+            const __m128i history = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i - j));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(taps[j - 1], history));
+        }
+        for (int j = 3; j >= 1; --j) {
+            const __m128i history = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i - j));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(masked[j - 1], history));
+        }
+        alignas(16) int32_t partial[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(partial), acc);
+        int32_t y[4];
+        finishBlock<4>(c, shift, partial, s + i, y);
+    }
+    return i;
+}
+
+// Os dois últimos blocos ficam em registradores: ler de volta da memória amostras que
+// acabaram de ser gravadas uma a uma faria cada carga vetorial esperar as gravações
+MP3PLAYER_TARGET_AVX2 size_t restoreLpc32Avx2(const int32_t* coefficients, int order, int shift, int32_t* s,
+                                              size_t count) {
+    const PaddedCoefficients padded(coefficients, order);
+    const int32_t* c = padded.values;
+    __m256i taps[FlacDecoder::MAX_LPC_ORDER];
+    for (int j = 0; j < order; ++j) {
+        taps[j] = _mm256_set1_epi32(c[j]);
+    }
+    // Atraso j < 16: posição t vem de s[i - j + t] = (anterior ao anterior, anterior)[16 - j + t]
+    __m256i rotations[16];
+    __m256i fromPrevious[16];
+    for (int j = 1; j < 16; ++j) {
+        alignas(32) int32_t index[8];
+        alignas(32) int32_t select[8];
+        alignas(32) int32_t lanes[8];
+        for (int t = 0; t < 8; ++t) {
+            index[t] = (16 - j + t) & 7;
+            select[t] = 16 - j + t >= 8 ? -1 : 0;
+            lanes[t] = t < j ? c[j - 1] : 0; // Posições t >= j ainda contêm resíduo
+        }
+        rotations[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(index));
+        fromPrevious[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(select));
+        if (j < 8) {
+            taps[j - 1] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+        }
+    }
+
+    size_t i = static_cast<size_t>(order);
+    alignas(32) int32_t history[16] = {};
+    for (int k = 0; k < 16; ++k) {
+        if (i + static_cast<size_t>(k) >= 16) {
+            history[k] = s[i + k - 16];
+        }
+    }
+    __m256i older = _mm256_load_si256(reinterpret_cast<const __m256i*>(history));
+    __m256i previous = _mm256_load_si256(reinterpret_cast<const __m256i*>(history + 8));
+
+    const int nearest = std::min(order, 15);
+    for (; i + 8 <= count; i += 8) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int j = order; j >= 16; --j) {
+            const __m256i past = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i - j));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(taps[j - 1], past));
+        }
+        for (int j = nearest; j >= 1; --j) {
+            const __m256i past = _mm256_blendv_epi8(_mm256_permutevar8x32_epi32(older, rotations[j]),
+                                                    _mm256_permutevar8x32_epi32(previous, rotations[j]),
+                                                    fromPrevious[j]);
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(taps[j - 1], past));
+        }
+        alignas(32) int32_t partial[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(partial), acc);
+        int32_t y[8];
+        finishBlock<8>(c, shift, partial, s + i, y);
+        older = previous;
+        previous = _mm256_setr_epi32(y[0], y[1], y[2], y[3], y[4], y[5], y[6], y[7]);
+    }
+    return i;
+}
+
+// Soma em 64 bits: blocos de 8 em dois acumuladores de 4 posições, produtos de 32x32 com
+// sinal (vpmuldq) sobre as amostras estendidas para 64 bits
+MP3PLAYER_TARGET_AVX2 size_t restoreLpc64Avx2(const int32_t* coefficients, int order, int shift, int32_t* s,
+                                              size_t count) {
+    const PaddedCoefficients padded(coefficients, order);
+    const int32_t* c = padded.values;
+    __m256i taps[FlacDecoder::MAX_LPC_ORDER];
+    for (int j = 0; j < order; ++j) {
+        taps[j] = _mm256_set1_epi64x(c[j]);
+    }
+    __m256i maskedLow[7];
+    __m256i maskedHigh[7];
+    for (int j = 1; j <= 7; ++j) {
+        alignas(32) int64_t lanes[8];
+        for (int t = 0; t < 8; ++t) {
+            lanes[t] = t < j ? c[j - 1] : 0;
+        }
+        maskedLow[j - 1] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+        maskedHigh[j - 1] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes + 4));
+    }
+    size_t i = static_cast<size_t>(order);
+    for (; i + 8 <= count; i += 8) {
+        __m256i low = _mm256_setzero_si256();
+        __m256i high = _mm256_setzero_si256();
+        for (int j = order; j >= 1; --j) {
+            const int32_t* past = s + i - j;
+            const __m256i pastLow = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(past)));
+            const __m256i pastHigh =
+                _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(past + 4)));
+            const __m256i tapLow = j >= 8 ? taps[j - 1] : maskedLow[j - 1];
+            const __m256i tapHigh = j >= 8 ? taps[j - 1] : maskedHigh[j - 1];
+            low = _mm256_add_epi64(low, _mm256_mul_epi32(tapLow, pastLow));
+            high = _mm256_add_epi64(high, _mm256_mul_epi32(tapHigh, pastHigh));
+        }
+        alignas(32) int64_t partial[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(partial), low);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(partial + 4), high);
+        int32_t y[8];
+        finishBlock<8>(c, shift, partial, s + i, y);
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+/**
+ * @brief Leitor de bits do FLAC: MSB primeiro, janela de 64 bits lida direto do buffer
+ *
+ * Cada leitura monta os 8 bytes a partir da posição atual (uma carga com troca de bytes);
+ * bits além do fim do quadro são lidos como zero e marcam o leitor como esgotado.
+ */
+class FlacBitReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bitPos;
+
+public:
+    FlacBitReader(const uint8_t* bytes, size_t length) : data(bytes), size(length), bitPos(0) {}
+
+    // Pelo menos 57 bits válidos alinhados à esquerda
+    uint64_t peek() const {
+        const size_t byte = bitPos >> 3;
+        uint64_t word;
+        if (byte + 8 <= size) {
+            word = readBigEndian64(data + byte);
+        } else {
+            word = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                word = (word << 8) | (byte + i < size ? data[byte + i] : 0);
+            }
+        }
+        return word << (bitPos & 7);
+    }
+
+    // n <= 32
+    uint32_t read(int n) {
+        if (n == 0) {
+            return 0;
+        }
+        const uint32_t value = static_cast<uint32_t>(peek() >> (64 - n));
+        bitPos += static_cast<size_t>(n);
+        return value;
+    }
+
+    int32_t readSigned(int n) {
+        if (n == 0) {
+            return 0;
+        }
+        const int unused = 32 - n;
+        return static_cast<int32_t>(read(n) << unused) >> unused;
+    }
+
+    // Zeros antes do próximo bit 1, que também é consumido
+    uint32_t readUnary() {
+        uint32_t count = 0;
+        while (!hasOverrun()) {
+            const uint64_t word = peek();
+            if (word != 0) {
+                const unsigned zeros = countLeadingZeros(word);
+                if (zeros < 57) {
+                    bitPos += zeros + 1;
+                    return count + zeros;
+                }
+            }
+            count += 56;
+            bitPos += 56;
+        }
+        return count;
+    }
+
+    // Partição Rice: quociente unário + 'parameter' bits, mapeamento zigue-zague para o sinal.
+    // Estado em variáveis locais: as gravações em 'out' não forçam recarregar o leitor
+    void readRice(int32_t* out, size_t count, int parameter) {
+        const uint8_t* bytes = data;
+        const size_t length = size;
+        const unsigned k = static_cast<unsigned>(parameter);
+        size_t pos = bitPos;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t value;
+            const size_t byte = pos >> 3;
+            const uint64_t word = byte + 8 <= length ? readBigEndian64(bytes + byte) << (pos & 7) : 0;
+            const unsigned zeros = word != 0 ? countLeadingZeros(word) : 64;
+            if (zeros + 1 + k <= 57) {
+                // Palavra inteira dentro da janela: o deslocamento traz o bit de parada junto,
+                // (1 << k) | resto, que o quociente menos 1 compensa (sem deslocar por 64)
+                value = ((zeros - 1) << k) + static_cast<uint32_t>((word << zeros) >> (63 - k));
+                pos += zeros + 1 + k;
+            } else {
+                bitPos = pos;
+                const uint32_t quotient = readUnary();
+                value = (quotient << k) | read(parameter);
+                pos = bitPos;
+            }
+            out[i] = static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+        }
+        bitPos = pos;
+    }
+
+    void alignToByte() { bitPos = (bitPos + 7) & ~static_cast<size_t>(7); }
+    size_t getBytePosition() const { return bitPos >> 3; }
+    bool hasOverrun() const { return bitPos > size * 8; }
+};
+
+uint8_t FlacDecoder::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; ++i) {
+        crc = CRC8_TABLE[crc ^ data[i]];
+    }
+    return crc;
+}
+
+uint16_t FlacDecoder::crc16(const uint8_t* data, size_t length) {
+    const auto& t = CRC16_TABLES;
+    unsigned crc = 0;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        const uint8_t* p = data + i;
+        crc = t[7][p[0] ^ (crc >> 8)] ^ t[6][p[1] ^ (crc & 0xff)] ^ t[5][p[2]] ^ t[4][p[3]] ^ t[3][p[4]] ^
+              t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+    for (; i < length; ++i) {
+        crc = ((crc << 8) & 0xffff) ^ t[0][(crc >> 8) ^ data[i]];
+    }
+    return static_cast<uint16_t>(crc);
+}
+
+CpuFeatures::SimdLevel FlacDecoder::getLpcKernelLevel(int order, bool wide, CpuFeatures::SimdLevel level) {
+    if (level == CpuFeatures::SimdLevel::AVX2 && order >= (wide ? MIN_AVX2_WIDE_ORDER : MIN_AVX2_ORDER)) {
+        return level;
+    }
+    // _mm_mullo_epi32 é SSE4.1; sem ele (ou na soma de 64 bits) fica o escalar
+    if (level == CpuFeatures::SimdLevel::SSE2 && order >= MIN_SSE41_ORDER && !wide && CpuFeatures::get().sse41) {
+        return level;
+    }
+    return CpuFeatures::SimdLevel::Scalar;
+}
+
+void FlacDecoder::restoreLpc(const int32_t* coefficients, int order, int shift, int32_t* samples, size_t count,
+                             bool wide) {
+    restoreLpc(coefficients, order, shift, samples, count, wide, CpuFeatures::getSimdLevel());
+}
+
+void FlacDecoder::restoreLpc(const int32_t* coefficients, int order, int shift, int32_t* samples, size_t count,
+                             bool wide, CpuFeatures::SimdLevel level) {
+    if (count <= static_cast<size_t>(order)) {
+        return;
+    }
+    size_t i = static_cast<size_t>(order);
+#if defined(MP3PLAYER_ARCH_X86)
+    switch (getLpcKernelLevel(order, wide, level)) {
+        case CpuFeatures::SimdLevel::AVX2:
+            i = wide ? restoreLpc64Avx2(coefficients, order, shift, samples, count)
+                     : restoreLpc32Avx2(coefficients, order, shift, samples, count);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            i = restoreLpc32Sse41(coefficients, order, shift, samples, count);
+            break;
+        default:
+            break;
+    }
+#else
+    (void)level;
+#endif
+    restoreLpcScalar(coefficients, order, shift, samples, count, wide, i);
+}
+
+FlacDecoder::FlacDecoder()
+    : firstFrameOffset(0), sampleRate(0), channels(0), bitsPerSample(0), minBlockSize(0), maxBlockSize(0),
+      minFrameSize(0), maxFrameSize(0), totalFrames(0), streamStart(0), pendingStart(0), pendingCount(0),
+      frameOffset(0), discardBefore(0), position(0) {}
+
+FlacDecoder::~FlacDecoder() = default;
+
+void FlacDecoder::open(const std::string& filePath) {
+    close();
+    if (!file.open(filePath, true)) {
+        throw DecoderException("Não foi possível abrir o arquivo FLAC: " + filePath);
+    }
+    try {
+        if (!readMetadata()) {
+            throw DecoderException("Cabeçalho FLAC inválido em: " + filePath);
+        }
+    } catch (const DecoderException&) {
+        close();
+        throw;
+    }
+
+    for (int ch = 0; ch < channels; ++ch) {
+        samples[static_cast<size_t>(ch)].assign(static_cast<size_t>(maxBlockSize), 0);
+    }
+    pending.assign(static_cast<size_t>(maxBlockSize) * static_cast<size_t>(channels), 0.0f);
+
+    // Streams cortados podem não começar na amostra 0
+    FrameHeader header;
+    if (findFrame(firstFrameOffset, file.size(), header) < file.size()) {
+        streamStart = header.firstSample;
+    }
+    if (totalFrames == 0) {
+        const uint64_t end = findLastSample();
+        totalFrames = end > streamStart ? end - streamStart : 0;
+    }
+    frameOffset = firstFrameOffset;
+    discardBefore = streamStart;
+    position = 0;
+}
+
+void FlacDecoder::close() {
+    file.close();
+    firstFrameOffset = 0;
+    sampleRate = 0;
+    channels = 0;
+    bitsPerSample = 0;
+    minBlockSize = maxBlockSize = 0;
+    minFrameSize = maxFrameSize = 0;
+    totalFrames = 0;
+    streamStart = 0;
+    seekTable.clear();
+    pendingStart = pendingCount = 0;
+    frameOffset = 0;
+    discardBefore = 0;
+    position = 0;
+    statistics = Statistics();
+}
+
+bool FlacDecoder::readMetadata() {
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    size_t pos = 0;
+
+    // Etiqueta ID3v2 antes do marcador (alguns programas a gravam)
+    if (size >= 10 && std::memcmp(data, "ID3", 3) == 0) {
+        pos = 10 + ((static_cast<size_t>(data[6] & 0x7f) << 21) | (static_cast<size_t>(data[7] & 0x7f) << 14) |
+                    (static_cast<size_t>(data[8] & 0x7f) << 7) | static_cast<size_t>(data[9] & 0x7f));
+        if (data[5] & 0x10) {
+            pos += 10; // Rodapé
+        }
+    }
+    if (pos + 4 > size || std::memcmp(data + pos, "fLaC", 4) != 0) {
+        return false;
+    }
+    pos += 4;
+
+    bool hasStreamInfo = false;
+    bool last = false;
+    while (!last) {
+        if (pos + 4 > size) {
+            return false;
+        }
+        last = (data[pos] & 0x80) != 0;
+        const int type = data[pos] & 0x7f;
+        const size_t length = readBigEndian24(data + pos + 1);
+        pos += 4;
+        if (pos + length > size) {
+            return false;
+        }
+        const uint8_t* block = data + pos;
+
+        if (type == 0 && length >= 34) {
+            minBlockSize = (block[0] << 8) | block[1];
+            maxBlockSize = (block[2] << 8) | block[3];
+            minFrameSize = readBigEndian24(block + 4);
+            maxFrameSize = readBigEndian24(block + 7);
+            // 20 bits de taxa, 3 de canais - 1, 5 de bits - 1, 36 de amostras totais
+            const uint64_t packed = readBigEndian64(block + 10);
+            sampleRate = static_cast<int>(packed >> 44);
+            channels = static_cast<int>((packed >> 41) & 0x7) + 1;
+            bitsPerSample = static_cast<int>((packed >> 36) & 0x1f) + 1;
+            totalFrames = packed & 0xFFFFFFFFFULL;
+            hasStreamInfo = true;
+        } else if (type == 3) {
+            // Pontos em ordem crescente; marcadores reservados (amostra ~0) ficam no fim
+            for (size_t p = 0; p + SEEK_POINT_BYTES <= length; p += SEEK_POINT_BYTES) {
+                const uint64_t sample = readBigEndian64(block + p);
+                if (sample == SEEK_PLACEHOLDER) {
+                    break;
+                }
+                if (seekTable.empty() || sample > seekTable.back().sample) {
+                    seekTable.push_back({sample, readBigEndian64(block + p + 8)});
+                }
+            }
+        }
+        pos += length;
+    }
+
+    if (!hasStreamInfo || sampleRate <= 0 || maxBlockSize < 16 || minBlockSize > maxBlockSize) {
+        return false;
+    }
+    if (bitsPerSample > MAX_BITS_PER_SAMPLE) {
+        throw DecoderException("FLAC com mais de 24 bits por amostra não é suportado");
+    }
+    firstFrameOffset = pos;
+    return true;
+}
+
+bool FlacDecoder::parseFrameHeader(size_t offset, FrameHeader& header) const {
+    const size_t size = file.size();
+    if (offset + 6 > size) {
+        return false;
+    }
+    const uint8_t* p = file.data() + offset;
+    const size_t available = std::min(size - offset, MAX_HEADER_BYTES);
+    if (p[0] != 0xFF || (p[1] & 0xFE) != 0xF8) {
+        return false;
+    }
+    const bool variableBlocks = (p[1] & 0x01) != 0;
+    const int blockCode = p[2] >> 4;
+    const int rateCode = p[2] & 0x0F;
+    const int assignment = p[3] >> 4;
+    const int sizeCode = (p[3] >> 1) & 0x07;
+    if (blockCode == 0 || rateCode == 15 || assignment > 10 || sizeCode == 3 || (p[3] & 0x01)) {
+        return false;
+    }
+
+    // Número do quadro (blocos fixos) ou da amostra (variáveis) em UTF-8 estendido
+    size_t pos = 4;
+    uint64_t number = p[pos++];
+    int extra = 0;
+    if (number >= 0x80) {
+        if ((number & 0xE0) == 0xC0) {
+            extra = 1;
+            number &= 0x1F;
+        } else if ((number & 0xF0) == 0xE0) {
+            extra = 2;
+            number &= 0x0F;
+        } else if ((number & 0xF8) == 0xF0) {
+            extra = 3;
+            number &= 0x07;
+        } else if ((number & 0xFC) == 0xF8) {
+            extra = 4;
+            number &= 0x03;
+        } else if ((number & 0xFE) == 0xFC) {
+            extra = 5;
+            number &= 0x01;
+        } else if (number == 0xFE) {
+            extra = 6;
+            number = 0;
+        } else {
+            return false;
+        }
+    }
+    if (pos + static_cast<size_t>(extra) + 5 > available) {
+        return false;
+    }
+    for (int i = 0; i < extra; ++i) {
+        const uint8_t byte = p[pos++];
+        if ((byte & 0xC0) != 0x80) {
+            return false;
+        }
+        number = (number << 6) | (byte & 0x3F);
+    }
+
+    int blockSize;
+    if (blockCode == 1) {
+        blockSize = 192;
+    } else if (blockCode <= 5) {
+        blockSize = 576 << (blockCode - 2);
+    } else if (blockCode == 6) {
+        blockSize = p[pos++] + 1;
+    } else if (blockCode == 7) {
+        blockSize = ((p[pos] << 8) | p[pos + 1]) + 1;
+        pos += 2;
+    } else {
+        blockSize = 256 << (blockCode - 8);
+    }
+
+    int rate;
+    if (rateCode == 0) {
+        rate = sampleRate;
+    } else if (rateCode < 12) {
+        rate = FRAME_SAMPLE_RATES[rateCode];
+    } else if (rateCode == 12) {
+        rate = p[pos++] * 1000;
+    } else {
+        rate = (p[pos] << 8) | p[pos + 1];
+        rate *= rateCode == 14 ? 10 : 1;
+        pos += 2;
+    }
+
+    if (pos >= available || crc8(p, pos) != p[pos]) {
+        return false;
+    }
+
+    // Parâmetros diferentes dos do STREAMINFO: falso sincronismo ou stream que o decodificador
+    // não acompanha
+    const int frameChannels = assignment < 8 ? assignment + 1 : 2;
+    const int bps = sizeCode == 0 ? bitsPerSample : FRAME_SAMPLE_SIZES[sizeCode];
+    if (frameChannels != channels || bps != bitsPerSample || rate != sampleRate || blockSize > maxBlockSize) {
+        return false;
+    }
+
+    header.firstSample = variableBlocks ? number : number * static_cast<uint64_t>(maxBlockSize);
+    header.blockSize = blockSize;
+    header.sampleRate = rate;
+    header.channels = frameChannels;
+    header.channelAssignment = assignment;
+    header.bitsPerSample = bps;
+    header.headerBytes = pos + 1;
+    return true;
+}
+
+size_t FlacDecoder::findFrame(size_t from, size_t limit, FrameHeader& header) const {
+    const uint8_t* data = file.data();
+    limit = std::min(limit, file.size());
+    while (from + 1 < limit) {
+        const void* hit = std::memchr(data + from, 0xFF, limit - 1 - from);
+        if (!hit) {
+            break;
+        }
+        from = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+        if ((data[from + 1] & 0xFE) == 0xF8 && parseFrameHeader(from, header)) {
+            return from;
+        }
+        ++from;
+    }
+    return limit;
+}
+
+uint64_t FlacDecoder::findLastSample() const {
+    // Blocos cada vez maiores a partir do fim até achar um cabeçalho válido
+    const size_t size = file.size();
+    size_t chunk = std::max<size_t>(TAIL_CHUNK_BYTES, static_cast<size_t>(maxFrameSize) * 2);
+    for (;;) {
+        const size_t begin = size - firstFrameOffset > chunk ? size - chunk : firstFrameOffset;
+        FrameHeader header;
+        uint64_t end = 0;
+        bool found = false;
+        for (size_t offset = findFrame(begin, size, header); offset < size;
+             offset = findFrame(offset + 1, size, header)) {
+            end = header.firstSample + static_cast<uint64_t>(header.blockSize);
+            found = true;
+        }
+        if (found || begin == firstFrameOffset) {
+            return end;
+        }
+        chunk *= 2;
+    }
+}
+
+bool FlacDecoder::decodeSubframe(FlacBitReader& bits, int32_t* out, int blockSize, int bps) {
+    if (bits.read(1) != 0) {
+        return false;
+    }
+    const uint32_t type = bits.read(6);
+    int wasted = 0;
+    if (bits.read(1)) {
+        wasted = static_cast<int>(bits.readUnary()) + 1;
+        if (wasted >= bps) {
+            return false;
+        }
+        bps -= wasted;
+    }
+    const size_t count = static_cast<size_t>(blockSize);
+
+    if (type == 0) {
+        std::fill_n(out, count, bits.readSigned(bps));
+        ++statistics.otherSubframes;
+    } else if (type == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = bits.readSigned(bps);
+        }
+        ++statistics.otherSubframes;
+    } else if (type >= 8 && type <= 12) {
+        const int order = static_cast<int>(type) - 8;
+        if (order > blockSize) {
+            return false;
+        }
+        for (int i = 0; i < order; ++i) {
+            out[i] = bits.readSigned(bps);
+        }
+        if (!decodeResidual(bits, out, blockSize, order)) {
+            return false;
+        }
+        // Coeficientes somam no máximo 16 em módulo: 32 bits bastam até 28 bits por amostra
+        restoreLpc(FIXED_COEFFICIENTS[order], order, 0, out, count, false);
+        ++statistics.fixedSubframes;
+    } else if (type >= 32) {
+        const int order = static_cast<int>(type) - 31;
+        if (order > blockSize) {
+            return false;
+        }
+        for (int i = 0; i < order; ++i) {
+            out[i] = bits.readSigned(bps);
+        }
+        const int precision = static_cast<int>(bits.read(4)) + 1;
+        const int shift = bits.readSigned(5);
+        if (precision == 16 || shift < 0) {
+            return false;
+        }
+        int32_t coefficients[MAX_LPC_ORDER];
+        for (int j = 0; j < order; ++j) {
+            coefficients[j] = bits.readSigned(precision);
+        }
+        if (!decodeResidual(bits, out, blockSize, order)) {
+            return false;
+        }
+        const bool wide = bps + precision + floorLog2(order) > 32;
+        restoreLpc(coefficients, order, shift, out, count, wide);
+        ++statistics.lpcSubframes;
+    } else {
+        return false; // Tipos reservados
+    }
+
+    if (wasted > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<int32_t>(static_cast<uint32_t>(out[i]) << wasted);
+        }
+    }
+    return !bits.hasOverrun();
+}
+
+bool FlacDecoder::decodeResidual(FlacBitReader& bits, int32_t* out, int blockSize, int order) {
+    const uint32_t method = bits.read(2);
+    if (method > 1) {
+        return false;
+    }
+    const int parameterBits = method == 0 ? 4 : 5;
+    const uint32_t escape = method == 0 ? 15 : 31;
+    const int partitionOrder = static_cast<int>(bits.read(4));
+    const int partitionSize = blockSize >> partitionOrder;
+    if ((partitionSize << partitionOrder) != blockSize || partitionSize < order) {
+        return false;
+    }
+
+    int32_t* target = out + order;
+    const int partitions = 1 << partitionOrder;
+    for (int p = 0; p < partitions; ++p) {
+        const size_t count = static_cast<size_t>(partitionSize - (p == 0 ? order : 0));
+        const uint32_t parameter = bits.read(parameterBits);
+        if (parameter == escape) {
+            // Partição sem Rice: amostras com largura fixa
+            const int width = static_cast<int>(bits.read(5));
+            for (size_t i = 0; i < count; ++i) {
+                target[i] = bits.readSigned(width);
+            }
+        } else {
+            bits.readRice(target, count, static_cast<int>(parameter));
+        }
+        target += count;
+        if (bits.hasOverrun()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FlacDecoder::decodeFrame() {
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    FrameHeader header;
+
+    while (frameOffset < size) {
+        if (!parseFrameHeader(frameOffset, header)) {
+            // Lixo entre quadros ou cabeçalho corrompido: próximo cabeçalho válido
+            const size_t next = findFrame(frameOffset + 1, size, header);
+            if (next < size) {
+                ++statistics.resyncs;
+            }
+            frameOffset = next;
+            continue;
+        }
+
+        FlacBitReader bits(data + frameOffset + header.headerBytes, size - frameOffset - header.headerBytes);
+        bool valid = true;
+        for (int ch = 0; ch < header.channels && valid; ++ch) {
+            // O canal lateral tem um bit a mais
+            const int assignment = header.channelAssignment;
+            const bool side = (ch == 1 && (assignment == 8 || assignment == 10)) || (ch == 0 && assignment == 9);
+            valid = decodeSubframe(bits, samples[static_cast<size_t>(ch)].data(), header.blockSize,
+                                   header.bitsPerSample + (side ? 1 : 0));
+        }
+        size_t frameEnd = 0;
+        if (valid) {
+            bits.alignToByte();
+            frameEnd = frameOffset + header.headerBytes + bits.getBytePosition() + 2;
+            valid = frameEnd <= size && crc16(data + frameOffset, frameEnd - 2 - frameOffset) ==
+                                            ((data[frameEnd - 2] << 8) | data[frameEnd - 1]);
+        }
+        if (valid) {
+            frameOffset = frameEnd;
+            ++statistics.frames;
+        } else {
+            // Cabeçalho íntegro e conteúdo não: silêncio com a duração do quadro mantém a posição
+            for (int ch = 0; ch < header.channels; ++ch) {
+                std::fill_n(samples[static_cast<size_t>(ch)].data(), header.blockSize, 0);
+            }
+            header.channelAssignment = 0;
+            FrameHeader next;
+            frameOffset = findFrame(frameOffset + 1, size, next);
+            ++statistics.crcFailures;
+        }
+
+        const size_t count = static_cast<size_t>(header.blockSize);
+        int32_t* a = samples[0].data();
+        int32_t* b = channels > 1 ? samples[1].data() : nullptr;
+        switch (header.channelAssignment) {
+            case 8: // Esquerda, lateral
+                for (size_t i = 0; i < count; ++i) {
+                    b[i] = a[i] - b[i];
+                }
+                break;
+            case 9: // Lateral, direita
+                for (size_t i = 0; i < count; ++i) {
+                    a[i] += b[i];
+                }
+                break;
+            case 10: // Média, lateral
+                for (size_t i = 0; i < count; ++i) {
+                    const int32_t mid = static_cast<int32_t>((static_cast<uint32_t>(a[i]) << 1) | (b[i] & 1));
+                    const int32_t side = b[i];
+                    a[i] = (mid + side) >> 1;
+                    b[i] = (mid - side) >> 1;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // Quadro que contém o alvo de um seek: as amostras anteriores são descartadas
+        const size_t skip = discardBefore > header.firstSample
+                                ? static_cast<size_t>(std::min<uint64_t>(discardBefore - header.firstSample, count))
+                                : 0;
+        const size_t stride = static_cast<size_t>(channels);
+        const float scale = 1.0f / static_cast<float>(1u << (header.bitsPerSample - 1));
+        float* dst = pending.data();
+        if (channels == 2) {
+            for (size_t i = skip; i < count; ++i) {
+                dst[0] = static_cast<float>(a[i]) * scale;
+                dst[1] = static_cast<float>(b[i]) * scale;
+                dst += 2;
+            }
+        } else {
+            for (size_t ch = 0; ch < stride; ++ch) {
+                const int32_t* src = samples[ch].data();
+                for (size_t i = skip; i < count; ++i) {
+                    dst[(i - skip) * stride + ch] = static_cast<float>(src[i]) * scale;
+                }
+            }
+        }
+        pendingStart = 0;
+        pendingCount = count - skip;
+        return true;
+    }
+    return false;
+}
+
+size_t FlacDecoder::decode(float* out, size_t maxFrames) {
+    if (!isOpen()) {
+        return 0;
+    }
+    const size_t stride = static_cast<size_t>(channels);
+    size_t done = 0;
+    while (done < maxFrames) {
+        if (pendingCount == 0) {
+            if (!decodeFrame()) {
+                break;
+            }
+            continue;
+        }
+        const size_t count = std::min(pendingCount, maxFrames - done);
+        std::copy_n(pending.data() + pendingStart * stride, count * stride, out + done * stride);
+        pendingStart += count;
+        pendingCount -= count;
+        done += count;
+    }
+    position += done;
+    return done;
+}
+
+bool FlacDecoder::seek(uint64_t frame) {
+    if (!isOpen()) {
+        return false;
+    }
+    const size_t size = file.size();
+    pendingStart = pendingCount = 0;
+    if (frame >= totalFrames) {
+        // Além do fim: o próximo decode() retorna 0
+        frameOffset = size;
+        position = totalFrames;
+        return true;
+    }
+    const uint64_t target = streamStart + frame;
+
+    // Região inicial: os pontos da SEEKTABLE que cercam o alvo
+    size_t low = firstFrameOffset;
+    size_t high = size;
+    auto it = std::upper_bound(seekTable.begin(), seekTable.end(), target,
+                               [](uint64_t value, const SeekPoint& point) { return value < point.sample; });
+    if (it != seekTable.begin() && std::prev(it)->offset < size - firstFrameOffset) {
+        low = firstFrameOffset + static_cast<size_t>(std::prev(it)->offset);
+    }
+    if (it != seekTable.end() && it->offset < size - firstFrameOffset) {
+        high = std::max(low, firstFrameOffset + static_cast<size_t>(it->offset));
+    }
+
+    // Bisseção pelos números de amostra dos cabeçalhos até restarem poucos quadros
+    FrameHeader header;
+    const size_t span = std::max<size_t>(static_cast<size_t>(maxFrameSize), TAIL_CHUNK_BYTES / 4) * 2;
+    while (high - low > span) {
+        const size_t middle = low + (high - low) / 2;
+        const size_t found = findFrame(middle, high, header);
+        if (found < high && header.firstSample <= target) {
+            low = found;
+        } else {
+            high = middle;
+        }
+    }
+
+    // Saltos de quadro em quadro: o próximo sincronismo válido cuja amostra inicial continua a
+    // do quadro atual (descarta falsos sincronismos dentro dos subquadros)
+    size_t offset = findFrame(low, size, header);
+    if (offset < size && header.firstSample > target && low != firstFrameOffset) {
+        offset = findFrame(firstFrameOffset, size, header); // SEEKTABLE inconsistente
+    }
+    const size_t minimumStep = std::max<size_t>(minFrameSize, 1);
+    while (offset < size && header.firstSample + static_cast<uint64_t>(header.blockSize) <= target) {
+        const uint64_t expected = header.firstSample + static_cast<uint64_t>(header.blockSize);
+        FrameHeader candidate;
+        size_t next = findFrame(offset + minimumStep, size, candidate);
+        while (next < size && candidate.firstSample != expected) {
+            next = findFrame(next + 1, size, candidate);
+        }
+        offset = next;
+        header = candidate;
+        ++statistics.seekHops;
+    }
+
+    frameOffset = offset;
+    discardBefore = target;
+    position = frame;
+    return true;
+}
@@ -0,0 +1,241 @@
+#include "FrameIndexCache.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'M', 'P', '3', 'F', 'I', 'D', 'X', '1'};
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint32_t ENDIAN_MARK = 0x01020304; // Rejeita caches gerados em outra arquitetura
+
+// Layout do arquivo: cabeçalho | checkpoints (u64) | saltos longos (2 x u64) | spans (u16)
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianMark;
+    uint64_t mediaDevice;
+    uint64_t mediaInode;
+    uint64_t mediaSize;
+    int64_t mediaMtimeNs;
+    uint32_t samplesPerFrame;
+    uint32_t checkpointInterval;
+    uint64_t frameCount;
+    uint64_t checkpointCount;
+    uint64_t longSpanCount;
+};
+static_assert(sizeof(CacheHeader) % 8 == 0, "Seções seguintes precisam de alinhamento de 8 bytes");
+static_assert(sizeof(Mp3FrameIndex::LongSpan) == 16, "Layout em disco de LongSpan");
+
+} // namespace
+
+FrameIndexCache::FrameIndexCache(const std::string& cacheDirectory) : directory(cacheDirectory) {}
+
+void FrameIndexCache::count(uint64_t Statistics::*counter) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ++(statistics.*counter);
+}
+
+FrameIndexCache::Statistics FrameIndexCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return statistics;
+}
+
+bool FrameIndexCache::getFileIdentity(const std::string& path, FileIdentity& identity) {
+    std::error_code error;
+    auto mtime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    identity.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+
+#ifndef _WIN32
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    identity.device = static_cast<uint64_t>(info.st_dev);
+    identity.inode = static_cast<uint64_t>(info.st_ino);
+    identity.size = static_cast<uint64_t>(info.st_size);
+#else
+    // Sem inode confiável: o caminho absoluto faz o papel da identidade
+    identity.device = 0;
+    identity.inode = std::hash<std::string>{}(std::filesystem::absolute(path).string());
+    identity.size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+std::string FrameIndexCache::getDefaultDirectory() {
+    std::filesystem::path base;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        base = std::filesystem::path(home) / ".cache";
+    } else {
+        std::error_code error;
+        base = std::filesystem::temp_directory_path(error);
+    }
+    return (base / "mp3player" / "frame-index").string();
+}
+
+std::string FrameIndexCache::entryPath(const FileIdentity& identity) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.idx",
+                  static_cast<unsigned long long>(identity.device),
+                  static_cast<unsigned long long>(identity.inode));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::shared_ptr<const Mp3FrameIndex> FrameIndexCache::load(const std::string& mediaPath) {
+    FileIdentity identity;
+    if (!getFileIdentity(mediaPath, identity)) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    const std::string path = entryPath(identity);
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path) || mapping->size() < sizeof(CacheHeader)) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.endianMark != ENDIAN_MARK ||
+        header.checkpointInterval != Mp3FrameIndex::CHECKPOINT_INTERVAL) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    // Mídia alterada desde a gravação: a entrada é descartada e será reconstruída
+    if (header.mediaSize != identity.size || header.mediaMtimeNs != identity.mtimeNs ||
+        header.mediaInode != identity.inode || header.mediaDevice != identity.device) {
+        count(&Statistics::stale);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return nullptr;
+    }
+
+    // Contagens vêm do disco: cada seção é limitada pelo que resta do mapeamento antes de
+    // qualquer multiplicação, para que um cabeçalho forjado não estoure o cálculo do tamanho
+    uint64_t remaining = mapping->size() - sizeof(CacheHeader);
+    auto takeSection = [&remaining](uint64_t count, uint64_t elementSize) {
+        if (count > remaining / elementSize) {
+            return false;
+        }
+        remaining -= count * elementSize;
+        return true;
+    };
+    if (header.samplesPerFrame == 0 || !takeSection(header.checkpointCount, sizeof(uint64_t)) ||
+        !takeSection(header.longSpanCount, sizeof(Mp3FrameIndex::LongSpan)) ||
+        !takeSection(header.frameCount, sizeof(uint16_t))) {
+        count(&Statistics::misses); // Arquivo truncado ou corrompido
+        return nullptr;
+    }
+    const uint64_t expectedCheckpoints =
+        (header.frameCount + Mp3FrameIndex::CHECKPOINT_INTERVAL - 1) / Mp3FrameIndex::CHECKPOINT_INTERVAL;
+    if (header.checkpointCount != expectedCheckpoints) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    const uint8_t* cursor = mapping->data() + sizeof(CacheHeader);
+    Mp3FrameIndex::View view;
+    view.checkpoints = reinterpret_cast<const uint64_t*>(cursor);
+    view.checkpointCount = static_cast<size_t>(header.checkpointCount);
+    cursor += header.checkpointCount * sizeof(uint64_t);
+    view.longSpans = reinterpret_cast<const Mp3FrameIndex::LongSpan*>(cursor);
+    view.longSpanCount = static_cast<size_t>(header.longSpanCount);
+    cursor += header.longSpanCount * sizeof(Mp3FrameIndex::LongSpan);
+    view.frameSpans = reinterpret_cast<const uint16_t*>(cursor);
+    view.frameCount = static_cast<size_t>(header.frameCount);
+
+    // A busca binária dos saltos longos exige quadros crescentes e dentro do índice
+    for (size_t i = 0; i < view.longSpanCount; ++i) {
+        if (view.longSpans[i].frame >= header.frameCount ||
+            (i > 0 && view.longSpans[i].frame <= view.longSpans[i - 1].frame)) {
+            count(&Statistics::misses);
+            return nullptr;
+        }
+    }
+
+    count(&Statistics::hits);
+    return std::make_shared<Mp3FrameIndex>(static_cast<int>(header.samplesPerFrame), view, mapping);
+}
+
+bool FrameIndexCache::store(const std::string& mediaPath, const Mp3FrameIndex& index) {
+    FileIdentity identity;
+    if (!getFileIdentity(mediaPath, identity)) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return false;
+    }
+
+    const Mp3FrameIndex::View view = index.getView();
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.endianMark = ENDIAN_MARK;
+    header.mediaDevice = identity.device;
+    header.mediaInode = identity.inode;
+    header.mediaSize = identity.size;
+    header.mediaMtimeNs = identity.mtimeNs;
+    header.samplesPerFrame = static_cast<uint32_t>(index.getSamplesPerFrame());
+    header.checkpointInterval = static_cast<uint32_t>(Mp3FrameIndex::CHECKPOINT_INTERVAL);
+    header.frameCount = view.frameCount;
+    header.checkpointCount = view.checkpointCount;
+    header.longSpanCount = view.longSpanCount;
+
+    // Escrita em arquivo temporário + rename: leitores nunca veem uma entrada parcial
+    const std::string path = entryPath(identity);
+    const std::string temporary = path + ".tmp" + std::to_string(std::hash<std::string>{}(mediaPath));
+    {
+        std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            return false;
+        }
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(view.checkpoints),
+                     static_cast<std::streamsize>(view.checkpointCount * sizeof(uint64_t)));
+        output.write(reinterpret_cast<const char*>(view.longSpans),
+                     static_cast<std::streamsize>(view.longSpanCount * sizeof(Mp3FrameIndex::LongSpan)));
+        output.write(reinterpret_cast<const char*>(view.frameSpans),
+                     static_cast<std::streamsize>(view.frameCount * sizeof(uint16_t)));
+        if (!output) {
+            output.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    count(&Statistics::stores);
+    return true;
+}
+
+bool FrameIndexCache::remove(const std::string& mediaPath) {
+    FileIdentity identity;
+    if (!getFileIdentity(mediaPath, identity)) {
+        return false;
+    }
+    std::error_code error;
+    return std::filesystem::remove(entryPath(identity), error);
+}
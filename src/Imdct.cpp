@@ -0,0 +1,229 @@
+#include "Imdct.h"
+#include <cmath>
+#include <stdexcept>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// z[k] = (X[2k] + j X[M-1-2k]) * w[k], k < M/2
+void preRotateScalar(size_t m, const float* x, const float* wRe, const float* wIm, float* zRe, float* zIm,
+                     size_t kBegin) {
+    for (size_t k = kBegin; k < m / 2; ++k) {
+        const float re = x[2 * k];
+        const float im = x[m - 1 - 2 * k];
+        zRe[k] = re * wRe[k] - im * wIm[k];
+        zIm[k] = re * wIm[k] + im * wRe[k];
+    }
+}
+
+// V'[k] = V[k] * w[k]; em seguida (re, -im) = (u[2k], u[M-1-2k])
+void postRotateScalar(size_t count, float* vRe, float* vIm, const float* wRe, const float* wIm, size_t kBegin) {
+    for (size_t k = kBegin; k < count; ++k) {
+        const float re = vRe[k] * wRe[k] - vIm[k] * wIm[k];
+        const float im = vRe[k] * wIm[k] + vIm[k] * wRe[k];
+        vRe[k] = re;
+        vIm[k] = -im;
+    }
+}
+
+void overlapAddScalar(const float* previous, const float* fall, const float* current, const float* rise, float* out,
+                      size_t count, size_t iBegin) {
+    for (size_t i = iBegin; i < count; ++i) {
+        out[i] = previous[i] * fall[i] + current[i] * rise[i];
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+inline __m128 reverseSse(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+size_t preRotateSse2(size_t m, const float* x, const float* wRe, const float* wIm, float* zRe, float* zIm) {
+    size_t k = 0;
+    for (; k + 4 <= m / 2; k += 4) {
+        // Pares X[2k..2k+6] e ímpares de trás para a frente X[M-1-2k], X[M-3-2k], ...
+        const __m128 front0 = _mm_loadu_ps(x + 2 * k);
+        const __m128 front1 = _mm_loadu_ps(x + 2 * k + 4);
+        const __m128 back0 = _mm_loadu_ps(x + m - 4 - 2 * k);
+        const __m128 back1 = _mm_loadu_ps(x + m - 8 - 2 * k);
+        const __m128 re = _mm_shuffle_ps(front0, front1, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 im = _mm_shuffle_ps(back0, back1, _MM_SHUFFLE(1, 3, 1, 3));
+        const __m128 cr = _mm_loadu_ps(wRe + k);
+        const __m128 ci = _mm_loadu_ps(wIm + k);
+        _mm_storeu_ps(zRe + k, _mm_sub_ps(_mm_mul_ps(re, cr), _mm_mul_ps(im, ci)));
+        _mm_storeu_ps(zIm + k, _mm_add_ps(_mm_mul_ps(re, ci), _mm_mul_ps(im, cr)));
+    }
+    return k;
+}
+
+size_t postRotateSse2(size_t count, float* vRe, float* vIm, const float* wRe, const float* wIm) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        const __m128 ar = _mm_loadu_ps(vRe + k), ai = _mm_loadu_ps(vIm + k);
+        const __m128 cr = _mm_loadu_ps(wRe + k), ci = _mm_loadu_ps(wIm + k);
+        _mm_storeu_ps(vRe + k, _mm_sub_ps(_mm_mul_ps(ar, cr), _mm_mul_ps(ai, ci)));
+        _mm_storeu_ps(vIm + k, _mm_sub_ps(zero, _mm_add_ps(_mm_mul_ps(ar, ci), _mm_mul_ps(ai, cr))));
+    }
+    return k;
+}
+
+// u[2k] = e[k], u[2k+1] = o[M/2-1-k]
+size_t interleaveReversedSse2(size_t half, const float* even, const float* odd, float* u) {
+    size_t k = 0;
+    for (; k + 4 <= half; k += 4) {
+        const __m128 e = _mm_loadu_ps(even + k);
+        const __m128 o = reverseSse(_mm_loadu_ps(odd + half - 4 - k));
+        _mm_storeu_ps(u + 2 * k, _mm_unpacklo_ps(e, o));
+        _mm_storeu_ps(u + 2 * k + 4, _mm_unpackhi_ps(e, o));
+    }
+    return k;
+}
+
+size_t overlapAddSse2(const float* previous, const float* fall, const float* current, const float* rise, float* out,
+                      size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 a = _mm_mul_ps(_mm_loadu_ps(previous + i), _mm_loadu_ps(fall + i));
+        const __m128 b = _mm_mul_ps(_mm_loadu_ps(current + i), _mm_loadu_ps(rise + i));
+        _mm_storeu_ps(out + i, _mm_add_ps(a, b));
+    }
+    return i;
+}
+
+MP3PLAYER_TARGET_AVX2 size_t postRotateAvx2(size_t count, float* vRe, float* vIm, const float* wRe,
+                                            const float* wIm) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t k = 0;
+    for (; k + 8 <= count; k += 8) {
+        const __m256 ar = _mm256_loadu_ps(vRe + k), ai = _mm256_loadu_ps(vIm + k);
+        const __m256 cr = _mm256_loadu_ps(wRe + k), ci = _mm256_loadu_ps(wIm + k);
+        _mm256_storeu_ps(vRe + k, _mm256_sub_ps(_mm256_mul_ps(ar, cr), _mm256_mul_ps(ai, ci)));
+        _mm256_storeu_ps(vIm + k, _mm256_sub_ps(zero, _mm256_add_ps(_mm256_mul_ps(ar, ci), _mm256_mul_ps(ai, cr))));
+    }
+    return k;
+}
+
+MP3PLAYER_TARGET_AVX2 size_t overlapAddAvx2(const float* previous, const float* fall, const float* current,
+                                            const float* rise, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 a = _mm256_mul_ps(_mm256_loadu_ps(previous + i), _mm256_loadu_ps(fall + i));
+        const __m256 b = _mm256_mul_ps(_mm256_loadu_ps(current + i), _mm256_loadu_ps(rise + i));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(a, b));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+Imdct::Imdct(size_t outputSize) : size(outputSize), fft(outputSize >= MIN_SIZE ? outputSize / 2 : Fft::MIN_SIZE) {
+    if (!Fft::isPowerOfTwo(outputSize) || outputSize < MIN_SIZE) {
+        throw std::invalid_argument("Tamanho de IMDCT deve ser potência de 2 e >= 32");
+    }
+    const size_t m = size / 2;
+    const size_t quarter = size / 4;
+    preRe.resize(quarter);
+    preIm.resize(quarter);
+    postRe.resize(quarter);
+    postIm.resize(quarter);
+    for (size_t k = 0; k < quarter; ++k) {
+        const double pre = -PI * (static_cast<double>(k) + 0.25) / static_cast<double>(m);
+        const double post = -PI * static_cast<double>(k) / static_cast<double>(m);
+        preRe[k] = static_cast<float>(std::cos(pre));
+        preIm[k] = static_cast<float>(std::sin(pre));
+        postRe[k] = static_cast<float>(std::cos(post));
+        postIm[k] = static_cast<float>(std::sin(post));
+    }
+    workRe.resize(quarter);
+    workIm.resize(quarter);
+    dct.resize(m);
+}
+
+void Imdct::inverse(const float* coefficients, float* output) {
+    inverse(coefficients, output, CpuFeatures::getSimdLevel());
+}
+
+void Imdct::inverse(const float* coefficients, float* output, CpuFeatures::SimdLevel level) {
+    const size_t m = size / 2;
+    const size_t quarter = size / 4;
+#if defined(MP3PLAYER_ARCH_X86)
+    const bool vector = level == CpuFeatures::SimdLevel::SSE2 || level == CpuFeatures::SimdLevel::AVX2;
+#else
+    const bool vector = false;
+#endif
+
+    // DCT-IV de M = N/2 pontos sobre a FFT complexa de N/4 pontos
+    size_t k = 0;
+#if defined(MP3PLAYER_ARCH_X86)
+    if (vector) {
+        k = preRotateSse2(m, coefficients, preRe.data(), preIm.data(), workRe.data(), workIm.data());
+    }
+#endif
+    preRotateScalar(m, coefficients, preRe.data(), preIm.data(), workRe.data(), workIm.data(), k);
+
+    fft.forwardComplex(workRe.data(), workIm.data(), level);
+
+    k = 0;
+#if defined(MP3PLAYER_ARCH_X86)
+    if (level == CpuFeatures::SimdLevel::AVX2) {
+        k = postRotateAvx2(quarter, workRe.data(), workIm.data(), postRe.data(), postIm.data());
+    } else if (vector) {
+        k = postRotateSse2(quarter, workRe.data(), workIm.data(), postRe.data(), postIm.data());
+    }
+#endif
+    postRotateScalar(quarter, workRe.data(), workIm.data(), postRe.data(), postIm.data(), k);
+
+    k = 0;
+#if defined(MP3PLAYER_ARCH_X86)
+    if (vector) {
+        k = interleaveReversedSse2(quarter, workRe.data(), workIm.data(), dct.data());
+    }
+#endif
+    for (; k < quarter; ++k) {
+        dct[2 * k] = workRe[k];
+        dct[2 * k + 1] = workIm[quarter - 1 - k];
+    }
+
+    // Desdobramento: y = [u(M/2..M), -u(M-1..0) invertida, -u(0..M/2)]
+    const size_t halfM = m / 2;
+    for (size_t n = 0; n < halfM; ++n) {
+        output[n] = dct[halfM + n];
+    }
+    for (size_t n = 0; n < m; ++n) {
+        output[halfM + n] = -dct[m - 1 - n];
+    }
+    for (size_t n = 0; n < halfM; ++n) {
+        output[halfM + m + n] = -dct[n];
+    }
+}
+
+void Imdct::overlapAdd(const float* previous, const float* fall, const float* current, const float* rise, float* out,
+                       size_t count) {
+    overlapAdd(previous, fall, current, rise, out, count, CpuFeatures::getSimdLevel());
+}
+
+void Imdct::overlapAdd(const float* previous, const float* fall, const float* current, const float* rise, float* out,
+                       size_t count, CpuFeatures::SimdLevel level) {
+    size_t i = 0;
+    switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            i = overlapAddAvx2(previous, fall, current, rise, out, count);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            i = overlapAddSse2(previous, fall, current, rise, out, count);
+            break;
+#endif
+        default:
+            break;
+    }
+    overlapAddScalar(previous, fall, current, rise, out, count, i);
+}
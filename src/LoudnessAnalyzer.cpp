@@ -0,0 +1,314 @@
+#include "LoudnessAnalyzer.h"
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+constexpr const char* JOURNAL_HEADER = "MP3PLAYER-LOUDNESS 1";
+constexpr double MIN_PEAK_DB = -120.0;
+
+bool sameIdentity(const FrameIndexCache::FileIdentity& a, const FrameIndexCache::FileIdentity& b) {
+    return a.device == b.device && a.inode == b.inode && a.size == b.size && a.mtimeNs == b.mtimeNs;
+}
+
+// Faixas do mesmo álbum: mesmo nome de álbum no mesmo diretório (coletâneas incluídas)
+std::string albumKey(const Track& track) {
+    const std::string& album = track.getAlbum();
+    if (album.empty() || album == "Unknown Album") {
+        return "";
+    }
+    return album + '\n' + std::filesystem::path(track.getFilePath()).parent_path().string();
+}
+
+} // namespace
+
+LoudnessAnalyzer::LoudnessAnalyzer(const std::string& journalPath, unsigned threads)
+    : journalPath(journalPath), threadCount(threads), cancelRequested(false), journalLines(0),
+      journalFile(nullptr) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer() {
+    if (journalFile) {
+        std::fclose(journalFile);
+    }
+}
+
+std::string LoudnessAnalyzer::getDefaultJournalPath() {
+    return (std::filesystem::path(FrameIndexCache::getDefaultDirectory()).parent_path() / "loudness.journal")
+        .string();
+}
+
+bool LoudnessAnalyzer::loadJournal() {
+    journal.clear();
+    journalLines = 0;
+    std::ifstream file(journalPath);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != JOURNAL_HEADER) {
+        return false; // Ausente ou de outra versão: tudo será analisado de novo
+    }
+    while (std::getline(file, line)) {
+        ++journalLines;
+        const size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab + 1 >= line.size()) {
+            continue; // Linha truncada por uma interrupção durante a escrita
+        }
+        JournalEntry entry;
+        unsigned long long device = 0, inode = 0, size = 0, gatedBlocks = 0, frames = 0;
+        long long mtimeNs = 0;
+        int ok = 0;
+        Measurement& m = entry.measurement;
+        const std::string fields = line.substr(0, tab);
+        if (std::sscanf(fields.c_str(), "%llx %llx %llu %lld %d %lg %lg %lg %llu %llu", &device, &inode, &size,
+                        &mtimeNs, &ok, &m.integratedLufs, &m.truePeakDb, &m.gatedEnergy, &gatedBlocks,
+                        &frames) != 10) {
+            continue;
+        }
+        entry.identity.device = device;
+        entry.identity.inode = inode;
+        entry.identity.size = size;
+        entry.identity.mtimeNs = mtimeNs;
+        m.ok = ok != 0;
+        m.gatedBlocks = gatedBlocks;
+        m.frames = frames;
+        journal[line.substr(tab + 1)] = entry; // Linhas posteriores substituem as anteriores
+    }
+    return true;
+}
+
+void LoudnessAnalyzer::appendJournal(const std::string& path, const JournalEntry& entry) {
+    if (!journalFile || path.find('\n') != std::string::npos) {
+        return;
+    }
+    const Measurement& m = entry.measurement;
+    std::fprintf(journalFile, "%llx %llx %llu %lld %d %.17g %.17g %.17g %llu %llu\t%s\n",
+                 static_cast<unsigned long long>(entry.identity.device),
+                 static_cast<unsigned long long>(entry.identity.inode),
+                 static_cast<unsigned long long>(entry.identity.size), static_cast<long long>(entry.identity.mtimeNs),
+                 m.ok ? 1 : 0, m.integratedLufs, m.truePeakDb, m.gatedEnergy,
+                 static_cast<unsigned long long>(m.gatedBlocks), static_cast<unsigned long long>(m.frames),
+                 path.c_str());
+    std::fflush(journalFile); // Uma queda perde no máximo a linha em andamento
+    ++journalLines;
+}
+
+void LoudnessAnalyzer::rewriteJournal() {
+    // Compactação: uma linha por arquivo, escrita em arquivo temporário e renomeada
+    const std::string temporary = journalPath + ".tmp";
+    std::FILE* previous = journalFile;
+    journalFile = std::fopen(temporary.c_str(), "w");
+    if (!journalFile) {
+        journalFile = previous;
+        return;
+    }
+    std::fprintf(journalFile, "%s\n", JOURNAL_HEADER);
+    journalLines = 0;
+    for (const auto& item : journal) {
+        appendJournal(item.first, item.second);
+    }
+    std::fclose(journalFile);
+    journalFile = previous;
+    std::error_code error;
+    std::filesystem::rename(temporary, journalPath, error);
+}
+
+bool LoudnessAnalyzer::measure(AudioDecoder& decoder, Measurement& measurement, const std::atomic<bool>* cancel) {
+    measurement = Measurement();
+    LoudnessMeter meter(decoder.getSampleRate(), decoder.getChannels());
+    if (!meter.isSupported()) {
+        return true; // Registrado como falha: layout de canais sem pesos definidos
+    }
+    std::vector<float> buffer(DECODE_FRAMES * static_cast<size_t>(decoder.getChannels()));
+    try {
+        size_t frames;
+        while ((frames = decoder.decode(buffer.data(), DECODE_FRAMES)) > 0) {
+            meter.addFrames(buffer.data(), frames);
+            if (cancel && cancel->load(std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+    } catch (const AudioDecoder::DecoderException&) {
+        return true;
+    }
+
+    measurement.ok = true;
+    measurement.integratedLufs = meter.getIntegratedLoudness();
+    measurement.gatedEnergy = meter.getGatedEnergy(measurement.gatedBlocks);
+    const float peak = meter.getTruePeak();
+    measurement.truePeakDb = peak > 0.0f ? std::max(20.0 * std::log10(peak), MIN_PEAK_DB) : MIN_PEAK_DB;
+    measurement.frames = meter.getFramesMeasured();
+    return true;
+}
+
+LoudnessAnalyzer::Measurement LoudnessAnalyzer::measureFile(const std::string& path) {
+    auto decoder = AudioDecoder::createForFile(path);
+    Measurement measurement;
+    measure(*decoder, measurement, nullptr);
+    return measurement;
+}
+
+LoudnessAnalyzer::Summary LoudnessAnalyzer::analyze(const std::vector<std::shared_ptr<Track>>& tracks,
+                                                     ProgressCallback progress) {
+    using Clock = std::chrono::steady_clock;
+    const auto begin = Clock::now();
+    Summary summary;
+    cancelRequested.store(false);
+
+    // Arquivos distintos (a mesma mídia pode aparecer em várias playlists)
+    std::vector<std::string> paths;
+    std::vector<const Track*> owners;
+    std::unordered_map<std::string, size_t> indexOf;
+    for (const auto& track : tracks) {
+        if (track && indexOf.emplace(track->getFilePath(), paths.size()).second) {
+            paths.push_back(track->getFilePath());
+            owners.push_back(track.get());
+        }
+    }
+    summary.files = paths.size();
+
+    std::vector<Measurement> results(paths.size());
+    std::vector<FrameIndexCache::FileIdentity> identities(paths.size());
+    std::vector<char> identified(paths.size(), 0);
+    std::vector<char> completed(paths.size(), 0);
+    std::vector<size_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        const bool valid = loadJournal();
+        for (size_t i = 0; i < paths.size(); ++i) {
+            identified[i] = FrameIndexCache::getFileIdentity(paths[i], identities[i]);
+            auto found = identified[i] ? journal.find(paths[i]) : journal.end();
+            if (found != journal.end() && sameIdentity(found->second.identity, identities[i])) {
+                results[i] = found->second.measurement;
+                completed[i] = 1;
+                ++summary.resumed;
+            } else {
+                pending.push_back(i);
+            }
+        }
+
+        // Journal ausente ou inválido recomeça do zero; válido recebe as novas linhas no fim
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(journalPath).parent_path(), error);
+        journalFile = std::fopen(journalPath.c_str(), valid ? "a" : "w");
+        if (journalFile && !valid) {
+            std::fprintf(journalFile, "%s\n", JOURNAL_HEADER);
+        }
+    }
+
+    // Pool fixo: cada thread pega o próximo arquivo pendente até acabar ou ser cancelada
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> framesDecoded{0};
+    size_t done = summary.resumed;
+    auto worker = [&]() {
+        while (!cancelRequested.load(std::memory_order_relaxed)) {
+            const size_t k = next.fetch_add(1, std::memory_order_relaxed);
+            if (k >= pending.size()) {
+                return;
+            }
+            const size_t i = pending[k];
+            Measurement measurement;
+            try {
+                auto decoder = AudioDecoder::createForFile(paths[i]);
+                if (!measure(*decoder, measurement, &cancelRequested)) {
+                    return;
+                }
+            } catch (const AudioDecoder::DecoderException&) {
+                measurement = Measurement();
+            }
+            results[i] = measurement;
+            completed[i] = 1;
+            framesDecoded.fetch_add(measurement.frames, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(journalMutex);
+            if (identified[i]) {
+                JournalEntry entry{identities[i], measurement};
+                journal[paths[i]] = entry;
+                appendJournal(paths[i], entry);
+            }
+            ++done;
+            if (progress) {
+                progress(done, paths.size(), paths[i]);
+            }
+        }
+    };
+    summary.threads = static_cast<unsigned>(std::min<size_t>(threadCount, pending.size()));
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < summary.threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    summary.cancelled = cancelRequested.load();
+    summary.framesDecoded = framesDecoded.load();
+
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        if (journalFile) {
+            std::fclose(journalFile);
+            journalFile = nullptr;
+        }
+        // Entradas substituídas (arquivos alterados) acumulam: compactar quando passam da metade
+        if (journalLines > 2 * journal.size() + 64) {
+            rewriteJournal();
+        }
+    }
+
+    // Álbuns: energia dos blocos aprovados somada entre as faixas
+    struct AlbumTotals {
+        double energy = 0.0;
+        uint64_t blocks = 0;
+        double peakDb = MIN_PEAK_DB;
+    };
+    std::unordered_map<std::string, AlbumTotals> albums;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const std::string key = albumKey(*owners[i]);
+        if (completed[i] && results[i].ok && !key.empty()) {
+            AlbumTotals& album = albums[key];
+            album.energy += results[i].gatedEnergy * static_cast<double>(results[i].gatedBlocks);
+            album.blocks += results[i].gatedBlocks;
+            album.peakDb = std::max(album.peakDb, results[i].truePeakDb);
+        }
+    }
+    summary.albums = albums.size();
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (completed[i] && !results[i].ok) {
+            ++summary.failed;
+        }
+    }
+    summary.analyzed = static_cast<size_t>(std::count(completed.begin(), completed.end(), 1)) - summary.resumed;
+
+    for (const auto& track : tracks) {
+        if (!track) {
+            continue;
+        }
+        const size_t i = indexOf[track->getFilePath()];
+        if (!completed[i] || !results[i].ok) {
+            continue;
+        }
+        const Measurement& m = results[i];
+        Track::Loudness loudness;
+        loudness.integratedLufs = m.integratedLufs;
+        loudness.truePeakDb = m.truePeakDb;
+        loudness.trackGainDb = m.gatedBlocks > 0 ? REFERENCE_LUFS - m.integratedLufs : 0.0; // Silêncio: sem ganho
+        auto album = albums.find(albumKey(*track));
+        if (album != albums.end() && album->second.blocks > 0) {
+            const double energy = album->second.energy / static_cast<double>(album->second.blocks);
+            loudness.albumGainDb = REFERENCE_LUFS - LoudnessMeter::energyToLufs(energy);
+            loudness.albumPeakDb = album->second.peakDb;
+            loudness.hasAlbumGain = true;
+        }
+        track->setLoudness(loudness);
+    }
+
+    summary.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return summary;
+}
@@ -0,0 +1,240 @@
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double KAISER_BETA = 6.0;
+
+// Função de Bessel modificada de ordem zero (janela de Kaiser)
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Ponderação K do BS.1770 recalculada para a taxa do stream (mesma forma analógica
+// que os coeficientes tabelados em 48 kHz)
+BiquadCoefficients preFilter(double sampleRate) {
+    const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+    const double k = std::tan(PI * f0 / sampleRate);
+    const double vh = std::pow(10.0, gainDb / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+    c.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+    c.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+BiquadCoefficients rlbFilter(double sampleRate) {
+    const double f0 = 38.13547087602444, q = 0.5003270373238773;
+    const double k = std::tan(PI * f0 / sampleRate);
+    const double a0 = 1.0 + k / q + k * k;
+    BiquadCoefficients c;
+    c.b0 = 1.0f;
+    c.b1 = -2.0f;
+    c.b2 = 1.0f;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+    : sampleRate(sampleRate), channels(channels), channelWeights(), subBlockFrames(1), subBlockPosition(0),
+      subBlockSums(), recentSubBlocks(), subBlockCount(0), oversampling(sampleRate < 96000), phases(),
+      phaseGainBound(1.0f), samplePeak(0.0f), truePeak(0.0f), framesMeasured(0) {
+    if (!isSupported()) {
+        return;
+    }
+    weighting.setSection(0, preFilter(sampleRate));
+    weighting.setSection(1, rlbFilter(sampleRate));
+    weighted.resize(CHUNK_FRAMES * static_cast<size_t>(channels));
+    subBlockFrames = std::max<size_t>(static_cast<size_t>(std::lround(sampleRate * 0.1)), 1);
+
+    // 5.1: L R C LFE Ls Rs; demais layouts com peso 1 em todos os canais
+    channelWeights.fill(1.0);
+    if (channels == 6) {
+        channelWeights[3] = 0.0;
+        channelWeights[4] = channelWeights[5] = 1.41;
+    }
+
+    // Interpolador 4x: sinc janelado (Kaiser), fase p usa os taps p, p + 4, p + 8, ...
+    constexpr size_t totalTaps = TRUE_PEAK_PHASE_TAPS * TRUE_PEAK_OVERSAMPLING;
+    const double center = (totalTaps - 1) / 2.0;
+    phaseGainBound = 0.0f;
+    for (int p = 0; p < TRUE_PEAK_OVERSAMPLING; ++p) {
+        std::array<double, TRUE_PEAK_PHASE_TAPS> taps;
+        double sum = 0.0;
+        for (size_t k = 0; k < TRUE_PEAK_PHASE_TAPS; ++k) {
+            const double n = static_cast<double>(p + k * TRUE_PEAK_OVERSAMPLING);
+            const double t = (n - center) / TRUE_PEAK_OVERSAMPLING;
+            const double sinc = std::sin(PI * t) / (PI * t); // t nunca é inteiro: centro em meia amostra
+            const double r = (n - center) / center;
+            taps[k] = sinc * besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(KAISER_BETA);
+            sum += taps[k];
+        }
+        // Ganho DC exato em cada fase; invertidos para o produto escalar sobre o histórico
+        float bound = 0.0f;
+        for (size_t k = 0; k < TRUE_PEAK_PHASE_TAPS; ++k) {
+            phases[p][TRUE_PEAK_PHASE_TAPS - 1 - k] = static_cast<float>(taps[k] / sum);
+            bound += std::fabs(phases[p][TRUE_PEAK_PHASE_TAPS - 1 - k]);
+        }
+        phaseGainBound = std::max(phaseGainBound, bound);
+    }
+    history.assign(static_cast<size_t>(channels) * (TRUE_PEAK_PHASE_TAPS - 1 + CHUNK_FRAMES), 0.0f);
+}
+
+void LoudnessMeter::addFrames(const float* interleaved, size_t frames) {
+    if (!isSupported() || !interleaved) {
+        return;
+    }
+    const size_t stride = static_cast<size_t>(channels);
+    for (size_t done = 0; done < frames;) {
+        const size_t count = std::min(CHUNK_FRAMES, frames - done);
+        const float* chunk = interleaved + done * stride;
+        measurePeaks(chunk, count);
+        std::copy(chunk, chunk + count * stride, weighted.begin());
+        weighting.process(weighted.data(), count, channels);
+        accumulate(weighted.data(), count);
+        done += count;
+    }
+    framesMeasured += frames;
+}
+
+void LoudnessMeter::accumulate(const float* interleaved, size_t frames) {
+    const size_t stride = static_cast<size_t>(channels);
+    for (size_t done = 0; done < frames;) {
+        const size_t count = std::min(frames - done, subBlockFrames - subBlockPosition);
+        const float* samples = interleaved + done * stride;
+        for (size_t c = 0; c < stride; ++c) {
+            double sum = 0.0;
+            for (size_t f = 0; f < count; ++f) {
+                const double x = samples[f * stride + c];
+                sum += x * x;
+            }
+            subBlockSums[c] += sum;
+        }
+        subBlockPosition += count;
+        done += count;
+        if (subBlockPosition == subBlockFrames) {
+            finishSubBlock();
+        }
+    }
+}
+
+void LoudnessMeter::finishSubBlock() {
+    double energy = 0.0;
+    for (int c = 0; c < channels; ++c) {
+        energy += channelWeights[c] * subBlockSums[c];
+        subBlockSums[c] = 0.0;
+    }
+    recentSubBlocks[subBlockCount % SUB_BLOCKS_PER_BLOCK] = energy / static_cast<double>(subBlockFrames);
+    subBlockPosition = 0;
+    ++subBlockCount;
+    // Cada passo de 100 ms fecha um bloco de 400 ms (sobreposição de 75%)
+    if (subBlockCount >= SUB_BLOCKS_PER_BLOCK) {
+        double block = 0.0;
+        for (double subBlock : recentSubBlocks) {
+            block += subBlock;
+        }
+        blockEnergies.push_back(block / SUB_BLOCKS_PER_BLOCK);
+    }
+}
+
+void LoudnessMeter::measurePeaks(const float* interleaved, size_t frames) {
+    const size_t stride = static_cast<size_t>(channels);
+    const size_t keep = TRUE_PEAK_PHASE_TAPS - 1;
+    const size_t span = keep + CHUNK_FRAMES;
+
+    float chunkPeak = 0.0f;
+    for (size_t c = 0; c < stride; ++c) {
+        float* line = history.data() + c * span;
+        for (size_t f = 0; f < frames; ++f) {
+            line[keep + f] = interleaved[f * stride + c];
+            chunkPeak = std::max(chunkPeak, std::fabs(line[keep + f]));
+        }
+    }
+    samplePeak = std::max(samplePeak, chunkPeak);
+    truePeak = std::max(truePeak, chunkPeak);
+
+    // Limite superior da interpolação: histórico também entra na janela da FIR
+    float windowPeak = chunkPeak;
+    for (size_t c = 0; c < stride; ++c) {
+        const float* line = history.data() + c * span;
+        for (size_t i = 0; i < keep; ++i) {
+            windowPeak = std::max(windowPeak, std::fabs(line[i]));
+        }
+    }
+    if (oversampling && windowPeak * phaseGainBound > truePeak) {
+        for (size_t c = 0; c < stride; ++c) {
+            const float* line = history.data() + c * span;
+            float peak = truePeak;
+            for (size_t f = 0; f < frames; ++f) {
+                const float* window = line + f; // x[m - 11] ... x[m]
+                for (const auto& taps : phases) {
+                    float y = 0.0f;
+                    for (size_t k = 0; k < TRUE_PEAK_PHASE_TAPS; ++k) {
+                        y += taps[k] * window[k];
+                    }
+                    peak = std::max(peak, std::fabs(y));
+                }
+            }
+            truePeak = peak;
+        }
+    }
+
+    for (size_t c = 0; c < stride; ++c) {
+        float* line = history.data() + c * span;
+        std::copy(line + frames, line + frames + keep, line);
+    }
+}
+
+double LoudnessMeter::getGatedEnergy(uint64_t& blocks) const {
+    // Gate absoluto, depois gate relativo 10 LU abaixo da média dos blocos aprovados
+    const double absoluteGate = lufsToEnergy(ABSOLUTE_GATE_LUFS);
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (double energy : blockEnergies) {
+        if (energy > absoluteGate) {
+            sum += energy;
+            ++count;
+        }
+    }
+    blocks = 0;
+    if (count == 0) {
+        return 0.0;
+    }
+    const double relativeGate = std::max(absoluteGate, sum / count * std::pow(10.0, RELATIVE_GATE_LU / 10.0));
+    sum = 0.0;
+    for (double energy : blockEnergies) {
+        if (energy > relativeGate) {
+            sum += energy;
+            ++blocks;
+        }
+    }
+    return blocks > 0 ? sum / blocks : 0.0;
+}
+
+double LoudnessMeter::getIntegratedLoudness() const {
+    uint64_t blocks = 0;
+    const double energy = getGatedEnergy(blocks);
+    return blocks > 0 ? energyToLufs(energy) : SILENCE_LUFS;
+}
+
+double LoudnessMeter::energyToLufs(double energy) {
+    return energy > 0.0 ? std::max(-0.691 + 10.0 * std::log10(energy), SILENCE_LUFS) : SILENCE_LUFS;
+}
+
+double LoudnessMeter::lufsToEnergy(double lufs) {
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
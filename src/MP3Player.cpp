@@ -1,16 +1,25 @@
 #include "MP3Player.h"
+#include "AlsaAudioSink.h"
+#include "Mp3Decoder.h"
+#include "ResamplingDecoder.h"
+#include "WavReader.h"
 #include <iostream>
 #include <algorithm>
-#include <cstdlib>
-#include <filesystem>
+#include <stdexcept>
 
-MP3Player::MP3Player() : audioEngine(nullptr) {
+MP3Player::MP3Player()
+    : replayGainMode(ReplayGainMode::TRACK), outputSampleRate(0), resamplerQuality(Resampler::Quality::MEDIUM),
+      gaplessEnabled(true), upcomingRepeat(false), upcomingQuality(Resampler::Quality::MEDIUM), upcomingNext(0),
+      upcomingCalls(0), upcomingApplied(0), playingSourceApplied(0) {
     equalizer = Equalizer::createFlat();
     initializeAudioEngine();
 }
 
-MP3Player::MP3Player(std::unique_ptr<Equalizer> eq) : audioEngine(nullptr) {
-    equalizer = std::move(eq);
+MP3Player::MP3Player(std::unique_ptr<Equalizer> eq)
+    : replayGainMode(ReplayGainMode::TRACK), outputSampleRate(0), resamplerQuality(Resampler::Quality::MEDIUM),
+      gaplessEnabled(true), upcomingRepeat(false), upcomingQuality(Resampler::Quality::MEDIUM), upcomingNext(0),
+      upcomingCalls(0), upcomingApplied(0), playingSourceApplied(0) {
+    equalizer = eq ? std::move(eq) : Equalizer::createFlat();
     initializeAudioEngine();
 }
 
@@ -19,15 +28,37 @@ MP3Player::~MP3Player() {
 }
 
 bool MP3Player::initializeAudioEngine() {
-    // Simulação de inicialização de engine de áudio
-    audioEngine = reinterpret_cast<void*>(0x12345678); // Mock pointer
+    // Saída padrão: descarte no ritmo do relógio (substituível via setAudioSink)
+    audioEngine = std::make_unique<AudioEngine>(std::make_unique<NullAudioSink>(true));
+    convolver = std::make_unique<PartitionedConvolver>();
+    volumeStage = std::make_unique<VolumeStage>(volume);
+    waveformCache = std::make_unique<WaveformCache>();
+    spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>();
+    // Equalizador, convolução e volume na thread de saída; os objetos vivem tanto quanto o
+    // player (setEqualizer copia as configurações) e process() adota novos parâmetros sem bloquear
+    Equalizer* outputEqualizer = equalizer.get();
+    PartitionedConvolver* outputConvolver = convolver.get();
+    VolumeStage* outputVolume = volumeStage.get();
+    SpectrumAnalyzer* outputSpectrum = spectrumAnalyzer.get();
+    audioEngine->setProcessor([outputEqualizer, outputConvolver, outputVolume, outputSpectrum](
+                                  float* interleaved, size_t frames, int channels) {
+        outputEqualizer->process(interleaved, frames, channels);
+        outputConvolver->process(interleaved, frames, channels);
+        outputVolume->process(interleaved, frames, channels); // Por último: o limitador vê o sinal final
+        outputSpectrum->push(interleaved, frames, channels);  // Só copia; a FFT roda na interface
+    });
+    audioEngine->setNextSourceProvider([this]() { return openUpcomingTrack(); });
+    // Índices de quadros persistidos: seek imediato ao reabrir arquivos já vistos
+    if (!Mp3Decoder::getFrameIndexCache()) {
+        Mp3Decoder::setFrameIndexCache(std::make_shared<FrameIndexCache>());
+    }
     return audioEngine != nullptr;
 }
 
 void MP3Player::cleanupAudioEngine() {
     if (audioEngine) {
-        // Simulação de limpeza
-        audioEngine = nullptr;
+        audioEngine->stop();
+        audioEngine.reset();
     }
 }
 
@@ -62,37 +93,67 @@ bool MP3Player::play() {
         return false;
     }
     
+    // Retomar de onde parou se a reprodução estava apenas pausada
+    if (isPaused && audioEngine->isRunning()) {
+        audioEngine->resume();
+        isPlaying = true;
+        isPaused = false;
+        std::cout << "[PLAY] Retomando: " << currentTrack->getDisplayName() << std::endl;
+        return true;
+    }
+    
+    if (audioEngine->isFinished()) {
+        currentPosition = 0.0; // Tocar de novo após o fim da track
+    }
+    
+    try {
+        std::unique_ptr<AudioDecoder> decoder = AudioDecoder::createForFile(currentTrack->getFilePath());
+        if (outputSampleRate > 0 && decoder->getSampleRate() != outputSampleRate) {
+            // Entre o decodificador e o equalizador: daqui em diante só existe a taxa de saída
+            decoder = std::make_unique<ResamplingDecoder>(std::move(decoder), outputSampleRate, resamplerQuality);
+        }
+        equalizer->setSampleRate(decoder->getSampleRate());
+        equalizer->resetState(); // Histórico da track anterior não vale para a nova
+        if (!convolver->prepare(decoder->getSampleRate(), decoder->getChannels())) {
+            notifyError("Resposta ao impulso em " + std::to_string(convolver->getImpulseResponse()->sampleRate) +
+                        " Hz não se aplica a um stream em " + std::to_string(decoder->getSampleRate()) +
+                        " Hz: correção de sala desativada");
+        }
+        applyReplayGain();
+        volumeStage->prepare(decoder->getSampleRate());
+        spectrumAnalyzer->setSampleRate(decoder->getSampleRate());
+        // Engine parada antes de zerar: as chamadas ao provider passam a ser contadas daqui,
+        // como a engine as conta a partir de start()
+        audioEngine->stop();
+        {
+            std::lock_guard<std::mutex> lock(upcomingMutex);
+            upcomingCalls = 0;
+        }
+        playingSourceApplied = 0;
+        refreshUpcomingTracks(); // Antes de start(): a engine pode pedir a seguinte logo
+        if (currentPosition > 0.0) {
+            // Posição definida por seek() antes do play: posicionar antes de iniciar
+            decoder->seek(static_cast<uint64_t>(currentPosition * decoder->getSampleRate()));
+        }
+        if (!audioEngine->start(std::move(decoder))) {
+            std::string message = "Falha ao abrir a saída de áudio: " + audioEngine->getSink()->getName();
+            if (auto* alsa = dynamic_cast<const AlsaAudioSink*>(audioEngine->getSink())) {
+                message += " (" + alsa->getLastError() + ")";
+            }
+            notifyError(message);
+            return false;
+        }
+    } catch (const AudioDecoder::DecoderException& e) {
+        notifyError(e.what());
+        return false;
+    }
+    
     isPlaying = true;
     isPaused = false;
     
     std::cout << "[PLAY] Reproduzindo: " << currentTrack->getDisplayName() 
               << " [" << currentTrack->getDurationString() << "]" << std::endl;
     
-    // Tentar tocar o arquivo MP3 real com Windows Media Player
-    std::string filePath = currentTrack->getFilePath();
-    
-    if (!filePath.empty() && std::filesystem::exists(filePath)) {
-        std::cout << "[INFO] Abrindo arquivo de audio: " << filePath << std::endl;
-        
-        // Construir comando para Windows Media Player
-        std::string command = "start wmplayer \"" + filePath + "\"";
-        
-        // Executar comando
-        int result = std::system(command.c_str());
-        
-        if (result == 0) {
-            std::cout << "[OK] Windows Media Player iniciado!\n";
-        } else {
-            std::cout << "[WARNING] Falha ao iniciar player. Tentando player padrao...\n";
-            // Tentar com player padrão do Windows
-            command = "start \"\" \"" + filePath + "\"";
-            std::system(command.c_str());
-        }
-    } else {
-        std::cout << "[SIMULATION] Arquivo nao encontrado, simulando reproducao...\n";
-    }
-    
-    // Simular progresso da reprodução
     notifyPositionChanged(currentPosition);
     
     return true;
@@ -103,6 +164,8 @@ bool MP3Player::pause() {
         return false;
     }
     
+    audioEngine->pause();
+    currentPosition = audioEngine->getPositionSeconds();
     isPaused = true;
     isPlaying = false;
     
@@ -115,6 +178,7 @@ bool MP3Player::stop() {
         return true;
     }
     
+    audioEngine->stop();
     isPlaying = false;
     isPaused = false;
     currentPosition = 0.0;
@@ -128,8 +192,14 @@ bool MP3Player::seek(double position) {
         return false;
     }
     
+    // Duração 0 = desconhecida: o decodificador limita a busca ao fim do stream
     double maxPosition = static_cast<double>(currentTrack->getDuration().count());
-    if (position < 0.0 || position > maxPosition) {
+    if (position < 0.0 || (maxPosition > 0.0 && position > maxPosition)) {
+        return false;
+    }
+    
+    if (audioEngine->isRunning() && !audioEngine->seek(position)) {
+        notifyError("Falha ao reposicionar o stream");
         return false;
     }
     
@@ -140,17 +210,218 @@ bool MP3Player::seek(double position) {
     return true;
 }
 
+double MP3Player::getCurrentPosition() const {
+    if (audioEngine && audioEngine->isRunning()) {
+        return audioEngine->getPositionSeconds();
+    }
+    return currentPosition;
+}
+
+void MP3Player::setCurrentPlaylist(std::shared_ptr<Playlist> playlist) {
+    currentPlaylist = std::move(playlist);
+    refreshUpcomingTracks();
+}
+
+void MP3Player::addPlaylist(std::shared_ptr<Playlist> playlist) {
+    if (playlist && std::find(playlists.begin(), playlists.end(), playlist) == playlists.end()) {
+        playlists.push_back(std::move(playlist));
+    }
+}
+
+bool MP3Player::next() {
+    processEvents(); // Trocas sem lacuna já tocadas avançam a playlist antes
+    return playNeighbour(true);
+}
+
+bool MP3Player::previous() {
+    processEvents();
+    return playNeighbour(false);
+}
+
+bool MP3Player::playNeighbour(bool forward) {
+    if (!currentPlaylist) {
+        notifyError("Nenhuma playlist selecionada");
+        return false;
+    }
+    auto track = forward ? currentPlaylist->next() : currentPlaylist->previous();
+    if (!track) {
+        notifyError("Fim da playlist");
+        return false;
+    }
+    return loadTrack(track) && play();
+}
+
+std::shared_ptr<const WaveformOverview> MP3Player::getCurrentWaveform() {
+    if (!currentTrack) {
+        return nullptr;
+    }
+    try {
+        return waveformCache->getOrBuild(currentTrack->getFilePath());
+    } catch (const AudioDecoder::DecoderException& e) {
+        notifyError(std::string("Falha ao gerar a forma de onda: ") + e.what());
+        return nullptr;
+    }
+}
+
+void MP3Player::setGaplessEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(upcomingMutex);
+    gaplessEnabled = enabled;
+}
+
+void MP3Player::refreshUpcomingTracks() {
+    std::lock_guard<std::mutex> lock(upcomingMutex);
+    upcomingTracks.clear();
+    upcomingStarted.clear();
+    upcomingNext = 0;
+    upcomingApplied = 0;
+    // Só quando a faixa atual é a da playlist; uma faixa avulsa não tem seguinte
+    if (currentPlaylist && currentTrack && currentPlaylist->getCurrentTrack() == currentTrack) {
+        upcomingTracks = currentPlaylist->getUpcomingTracks(currentPlaylist->size());
+        upcomingRepeat = currentPlaylist->getRepeatMode();
+    }
+    upcomingQuality = resamplerQuality;
+}
+
+std::unique_ptr<AudioDecoder> MP3Player::openUpcomingTrack() {
+    std::shared_ptr<Track> track;
+    size_t step = 0;
+    uint64_t call = 0;
+    Resampler::Quality quality;
+    {
+        std::lock_guard<std::mutex> lock(upcomingMutex);
+        call = ++upcomingCalls; // Toda chamada conta, inclusive as sem fonte
+        if (!gaplessEnabled || upcomingTracks.empty() || (!upcomingRepeat && upcomingNext >= upcomingTracks.size())) {
+            return nullptr;
+        }
+        step = upcomingNext;
+        track = upcomingTracks[step % upcomingTracks.size()];
+        quality = upcomingQuality;
+    }
+    if (!track || !track->isValid() || !isFormatSupported(track->getFormat())) {
+        return nullptr; // Fica para o fim do stream, que passa pelo caminho normal de next()
+    }
+
+    std::unique_ptr<AudioDecoder> decoder = AudioDecoder::createForFile(track->getFilePath());
+    if (decoder->getChannels() != audioEngine->getChannels()) {
+        return nullptr; // Outro layout de canais exige reabrir a saída
+    }
+    if (decoder->getSampleRate() != audioEngine->getSampleRate()) {
+        decoder = std::make_unique<ResamplingDecoder>(std::move(decoder), audioEngine->getSampleRate(), quality);
+    }
+
+    std::lock_guard<std::mutex> lock(upcomingMutex);
+    upcomingNext = step + 1;
+    upcomingStarted.emplace_back(call, step);
+    return decoder;
+}
+
+void MP3Player::syncPlayingTrack() {
+    const uint64_t source = audioEngine->getPlayingSource();
+    if (source == playingSourceApplied) {
+        return;
+    }
+    playingSourceApplied = source;
+    bool found = false;
+    size_t step = 0;
+    {
+        // Fontes abertas antes dela e nunca tocadas (seek, formato recusado) ficam para trás
+        std::lock_guard<std::mutex> lock(upcomingMutex);
+        while (!upcomingStarted.empty() && upcomingStarted.front().first <= source) {
+            found = upcomingStarted.front().first == source;
+            step = upcomingStarted.front().second;
+            upcomingStarted.pop_front();
+        }
+    }
+    if (!found || !currentPlaylist) {
+        return; // Fonte de um snapshot anterior (playlist trocada durante a reprodução)
+    }
+    // Mesma sequência de next() usada para montar o snapshot
+    for (; upcomingApplied <= step; ++upcomingApplied) {
+        currentPlaylist->next();
+    }
+    currentTrack = currentPlaylist->getCurrentTrack();
+    currentPosition = 0.0;
+    applyReplayGain(); // Chega à saída como rampa, logo depois da troca
+    if (currentTrack) {
+        std::cout << "[PLAY] Reproduzindo: " << currentTrack->getDisplayName()
+                  << " [" << currentTrack->getDurationString() << "]" << std::endl;
+    }
+}
+
+void MP3Player::setVolume(double vol) {
+    MediaPlayer::setVolume(vol); // Valida o intervalo
+    volumeStage->setVolume(volume); // A thread de saída faz a rampa até o novo ganho
+}
+
+void MP3Player::setOutputSampleRate(int rate) {
+    outputSampleRate = std::max(rate, 0);
+}
+
+void MP3Player::setReplayGainMode(ReplayGainMode mode) {
+    replayGainMode = mode;
+    applyReplayGain(); // Durante a reprodução, a mudança chega como rampa
+}
+
+void MP3Player::applyReplayGain() {
+    double gainDb = 0.0;
+    if (currentTrack && replayGainMode != ReplayGainMode::OFF) {
+        gainDb = currentTrack->getReplayGainDb(replayGainMode == ReplayGainMode::ALBUM);
+    }
+    volumeStage->setNormalizationGain(gainDb);
+}
+
 Equalizer* MP3Player::getEqualizer() const {
     return equalizer.get();
 }
 
 void MP3Player::setEqualizer(std::unique_ptr<Equalizer> newEqualizer) {
     if (newEqualizer) {
-        equalizer = std::move(newEqualizer);
+        // Copia as configurações para o equalizador em uso pela thread de saída: a troca
+        // é publicada sem bloquear e chega ao áudio como uma transição suave
+        *equalizer = *newEqualizer;
         std::cout << "[EQ] Equalizer atualizado: " << equalizer->toString() << std::endl;
     }
 }
 
+bool MP3Player::loadImpulseResponse(const std::string& path) {
+    try {
+        convolver->loadImpulseResponse(path);
+    } catch (const WavReader::WavException& e) {
+        notifyError(e.what());
+        return false;
+    } catch (const std::invalid_argument& e) {
+        notifyError(e.what());
+        return false;
+    }
+
+    auto impulse = convolver->getImpulseResponse();
+    std::cout << "[IR] Resposta ao impulso: " << path << " (" << impulse->frames << " amostras, "
+              << impulse->channels << " canais, " << impulse->sampleRate << " Hz, latência "
+              << convolver->getPartitionFrames() << " quadros)" << std::endl;
+    if (audioEngine->isRunning() && !convolver->isActive()) {
+        notifyError("Resposta ao impulso em " + std::to_string(impulse->sampleRate) +
+                    " Hz não se aplica ao stream atual: correção de sala desativada");
+    }
+    return true;
+}
+
+void MP3Player::clearImpulseResponse() {
+    convolver->clearImpulseResponse();
+}
+
+void MP3Player::setAudioSink(std::unique_ptr<AudioSink> sink) {
+    if (!sink) {
+        return;
+    }
+    stop(); // A troca de saída interrompe a reprodução atual
+    std::cout << "[AUDIO] Saída de áudio: " << sink->getName() << std::endl;
+    audioEngine->setSink(std::move(sink));
+}
+
+AudioEngine::Statistics MP3Player::getAudioStatistics() const {
+    return audioEngine->getStatistics();
+}
+
 void MP3Player::setErrorCallback(std::function<void(const std::string&)> callback) {
     errorCallback = callback;
 }
@@ -160,25 +431,87 @@ void MP3Player::setPositionCallback(std::function<void(double)> callback) {
 }
 
 bool MP3Player::isFormatSupported(const std::string& format) {
-    static const std::vector<std::string> supportedFormats = {"MP3", "WAV", "OGG"};
+    static const std::vector<std::string> supportedFormats = {"MP3", "WAV", "OGG", "FLAC"};
     return std::find(supportedFormats.begin(), supportedFormats.end(), format) 
            != supportedFormats.end();
 }
 
 std::vector<std::string> MP3Player::getSupportedFormats() {
-    return {"MP3", "WAV", "OGG"};
+    return {"MP3", "WAV", "OGG", "FLAC"};
 }
 
 void MP3Player::notifyError(const std::string& message) {
-    if (errorCallback) {
-        errorCallback(message);
-    } else {
-        std::cerr << "[ERROR] Erro: " << message << std::endl;
-    }
+    audioEngine->postEvent(AudioEngine::Event::error(message));
 }
 
 void MP3Player::notifyPositionChanged(double position) {
-    if (positionCallback) {
-        positionCallback(position);
+    audioEngine->publishPosition(position);
+}
+
+size_t MP3Player::processEvents(size_t maxEvents) {
+    syncPlayingTrack(); // Antes dos callbacks: TRACK_CHANGED já encontra a faixa nova
+    AudioEngine::Event batch[EVENT_BATCH_SIZE];
+    size_t total = 0;
+    while (total < maxEvents) {
+        const size_t count = audioEngine->drainEvents(batch, std::min(maxEvents - total, EVENT_BATCH_SIZE));
+        if (count == 0) {
+            break;
+        }
+        total += count;
+
+        // Só a última posição do lote interessa; erros e fim são entregues em ordem
+        size_t lastPosition = count;
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i].type == AudioEngine::Event::Type::POSITION) {
+                lastPosition = i;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const AudioEngine::Event& event = batch[i];
+            switch (event.type) {
+                case AudioEngine::Event::Type::POSITION:
+                    if (i == lastPosition && positionCallback) {
+                        positionCallback(event.seconds);
+                    }
+                    break;
+                case AudioEngine::Event::Type::FINISHED: {
+                    syncPlayingTrack();
+                    // Um fim antigo não pode parar a reprodução iniciada depois dele
+                    const bool ended = audioEngine->isFinished();
+                    if (ended) {
+                        isPlaying = false;
+                        isPaused = false;
+                        currentPosition = 0.0;
+                    }
+                    if (positionCallback) {
+                        positionCallback(event.seconds);
+                    }
+                    // Seguinte que não pôde entrar sem lacuna: carregar do jeito comum.
+                    // Se quem encerrou foi o consumidor da saída, não há para onde tocar.
+                    const AudioSink* sink = audioEngine->getSink();
+                    const bool outputClosed = sink && sink->isConsumerClosed();
+                    if (ended && !outputClosed && currentPlaylist &&
+                        currentTrack == currentPlaylist->getCurrentTrack() &&
+                        !currentPlaylist->getUpcomingTracks(1).empty()) {
+                        playNeighbour(true);
+                    }
+                    break;
+                }
+                case AudioEngine::Event::Type::TRACK_CHANGED:
+                    syncPlayingTrack(); // A troca pode ser posterior à do início desta chamada
+                    if (positionCallback) {
+                        positionCallback(0.0);
+                    }
+                    break;
+                case AudioEngine::Event::Type::ERROR_MESSAGE:
+                    if (errorCallback) {
+                        errorCallback(event.message);
+                    } else {
+                        std::cerr << "[ERROR] Erro: " << event.message << std::endl;
+                    }
+                    break;
+            }
+        }
     }
+    return total;
 }
\ No newline at end of file
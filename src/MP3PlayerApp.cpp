@@ -5,15 +5,15 @@
 
 MP3PlayerApp::MP3PlayerApp() 
     : player(std::make_unique<MP3Player>()),
-      scanner(createAudioScanner()),
       persistence(std::make_unique<JsonPlaylistPersistence>()),
+      scanner(createAudioScanner()),
       running(false) {}
 
 MP3PlayerApp::~MP3PlayerApp() = default;
 
-void MP3PlayerApp::inicializar() {
+bool MP3PlayerApp::initialize() {
     // Configurar player padrão
-    player->setVolume(70.0f);
+    player->setVolume(0.7);
     
     // Criar playlist padrão se não existir
     if (player->getPlaylists().empty()) {
@@ -26,6 +26,7 @@ void MP3PlayerApp::inicializar() {
     // (Simulação - em implementação real usaria observer pattern)
     
     std::cout << "MP3 Player inicializado com sucesso!\n";
+    return true;
 }
 
 void MP3PlayerApp::executar() {
@@ -38,6 +39,7 @@ void MP3PlayerApp::executar() {
             mostrarMenuPrincipal();
             int opcao = lerOpcao();
             processarOpcao(opcao);
+            player->processEvents(); // Callbacks do player rodam aqui, fora das threads de áudio
         } catch (const std::exception& e) {
             std::cerr << "Erro: " << e.what() << "\n";
             std::cout << "Pressione Enter para continuar...";
@@ -46,10 +48,10 @@ void MP3PlayerApp::executar() {
         }
     }
     
-    finalizar();
+    shutdown();
 }
 
-void MP3PlayerApp::finalizar() {
+void MP3PlayerApp::shutdown() {
     try {
         // Salvar playlists automaticamente
         for (const auto& playlist : player->getPlaylists()) {
@@ -63,6 +65,14 @@ void MP3PlayerApp::finalizar() {
     }
 }
 
+std::vector<std::string> MP3PlayerApp::getAvailablePlaylists() const {
+    std::vector<std::string> names;
+    for (const auto& playlist : player->getPlaylists()) {
+        names.push_back(playlist->getName());
+    }
+    return names;
+}
+
 void MP3PlayerApp::mostrarBoasVindas() {
     std::cout << "\n========================================\n";
     std::cout << "       BEM-VINDO AO MP3 PLAYER!        \n";
@@ -121,7 +131,7 @@ void MP3PlayerApp::processarOpcao(int opcao) {
 void MP3PlayerApp::menuReproducao() {
     while (true) {
         std::cout << "\n--- CONTROLES DE REPRODUÇÃO ---\n";
-        std::cout << "Status: " << (player->isPlaying() ? "Reproduzindo" : "Parado") << "\n";
+        std::cout << "Status: " << (player->getIsPlaying() ? "Reproduzindo" : "Parado") << "\n";
         
         if (auto track = player->getCurrentTrack()) {
             std::cout << "Música atual: " << track->getTitle() << " - " << track->getArtist() << "\n";
@@ -140,7 +150,7 @@ void MP3PlayerApp::menuReproducao() {
         
         switch (opcao) {
             case 1:
-                if (player->isPlaying()) {
+                if (player->getIsPlaying()) {
                     player->pause();
                     std::cout << "Pausado.\n";
                 } else {
@@ -263,7 +273,7 @@ void MP3PlayerApp::menuPlaylists() {
 void MP3PlayerApp::menuConfiguracao() {
     while (true) {
         std::cout << "\n--- CONFIGURAÇÕES DE ÁUDIO ---\n";
-        std::cout << "Volume atual: " << player->getVolume() << "%\n";
+        std::cout << "Volume atual: " << player->getVolume() * 100.0 << "%\n";
         
         auto equalizer = player->getEqualizer();
         if (equalizer) {
@@ -361,7 +371,7 @@ void MP3PlayerApp::listarMusicas() {
         return;
     }
     
-    const auto& tracks = currentPlaylist->getTracks();
+    const auto& tracks = currentPlaylist->getAllTracks();
     if (tracks.empty()) {
         std::cout << "Playlist vazia.\n";
         return;
@@ -372,12 +382,12 @@ void MP3PlayerApp::listarMusicas() {
         const auto& track = tracks[i];
         std::cout << (i + 1) << ". " << track->getTitle() 
                   << " - " << track->getArtist() << " (" 
-                  << track->getDurationFormatted() << ")\n";
+                  << track->getDurationString() << ")\n";
     }
 }
 
 void MP3PlayerApp::ajustarVolume() {
-    std::cout << "Volume atual: " << player->getVolume() << "%\n";
+    std::cout << "Volume atual: " << player->getVolume() * 100.0 << "%\n";
     std::cout << "Digite o novo volume (0-100): ";
     
     std::string input;
@@ -390,7 +400,7 @@ void MP3PlayerApp::ajustarVolume() {
             return;
         }
         
-        player->setVolume(volume);
+        player->setVolume(volume / 100.0); // Player em 0.0-1.0
         std::cout << "Volume ajustado para " << volume << "%\n";
     } catch (const std::exception&) {
         std::cout << "Valor inválido para volume.\n";
@@ -414,7 +424,7 @@ void MP3PlayerApp::configurarEqualizador() {
     int opcao = lerOpcao();
     
     if (opcao > 0 && opcao <= static_cast<int>(presets.size())) {
-        equalizer->setPreset(presets[opcao - 1]);
+        equalizer->applyPreset(presets[opcao - 1]);
         std::cout << "Preset aplicado: " << presets[opcao - 1] << "\n";
     }
 }
@@ -427,10 +437,10 @@ void MP3PlayerApp::mostrarEstatisticas() {
     
     if (currentPlaylist) {
         std::cout << "Músicas na playlist atual: " << currentPlaylist->size() << "\n";
-        std::cout << "Duração total: " << currentPlaylist->getTotalDurationFormatted() << "\n";
+        std::cout << "Duração total: " << currentPlaylist->getTotalDurationString() << "\n";
     }
     
-    std::cout << "Volume: " << player->getVolume() << "%\n";
+    std::cout << "Volume: " << player->getVolume() * 100.0 << "%\n";
     
     auto equalizer = player->getEqualizer();
     if (equalizer) {
@@ -453,7 +463,7 @@ void MP3PlayerApp::buscarMusica() {
         return;
     }
     
-    const auto& tracks = currentPlaylist->getTracks();
+    const auto& tracks = currentPlaylist->getAllTracks();
     std::vector<std::shared_ptr<Track>> resultados;
     
     for (const auto& track : tracks) {
@@ -551,7 +561,12 @@ void MP3PlayerApp::carregarPlaylist() {
     std::getline(std::cin, filename);
     
     try {
-        auto playlist = persistence->loadPlaylist(filename);
+        auto loaded = persistence->loadPlaylist(filename);
+        if (!loaded) {
+            std::cout << "Não foi possível carregar a playlist.\n";
+            return;
+        }
+        auto playlist = std::make_shared<Playlist>(std::move(*loaded));
         player->addPlaylist(playlist);
         std::cout << "Playlist carregada: " << playlist->getName() << "\n";
     } catch (const std::exception& e) {
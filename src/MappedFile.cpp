@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, bool sequential) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* region = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (sequential && region != MAP_FAILED) {
+        // O mapeamento guarda a mesma descrição de arquivo: o estado de readahead vale para as faltas
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        madvise(region, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    }
+    ::close(fd); // O mapeamento continua válido sem o descritor
+    if (region == MAP_FAILED) {
+        return false;
+    }
+    bytes = static_cast<const uint8_t*>(region);
+    length = static_cast<size_t>(info.st_size);
+    mapped = true;
+    return true;
+#else
+    (void)sequential;
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if (!input) {
+        return false;
+    }
+    const std::streamoff fileSize = input.tellg();
+    if (fileSize <= 0) {
+        return false;
+    }
+    storage.resize((static_cast<size_t>(fileSize) + 7) / 8);
+    input.seekg(0);
+    input.read(reinterpret_cast<char*>(storage.data()), fileSize);
+    if (!input) {
+        storage.clear();
+        return false;
+    }
+    bytes = reinterpret_cast<const uint8_t*>(storage.data());
+    length = static_cast<size_t>(fileSize);
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped && bytes) {
+        munmap(const_cast<uint8_t*>(bytes), length);
+    }
+#endif
+    storage.clear();
+    storage.shrink_to_fit();
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+void MappedFile::adviseSequential() const {
+#ifndef _WIN32
+    if (mapped) {
+        madvise(const_cast<uint8_t*>(bytes), length, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::adviseWillNeed(size_t offset, size_t count) const {
+#ifndef _WIN32
+    if (!mapped || offset >= length) {
+        return;
+    }
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset - offset % pageSize;
+    const size_t end = std::min(offset + count, length);
+    madvise(const_cast<uint8_t*>(bytes) + begin, end - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)count;
+#endif
+}
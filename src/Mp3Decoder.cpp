@@ -0,0 +1,1204 @@
+#include "Mp3Decoder.h"
+#include "Mp3LookupTables.h"
+#include "Mp3Tables.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr size_t INPUT_BUFFER_SIZE = 64 * 1024;
+constexpr size_t RESERVOIR_BYTES = 2048;
+
+inline uint64_t readBigEndian64(const uint8_t* p) {
+    return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+           (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+           (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+           (static_cast<uint64_t>(p[6]) << 8) | static_cast<uint64_t>(p[7]);
+}
+
+// Valor requantizado positivo com o bit de sinal lido do fluxo (0 ou 1), sem desvio
+inline float withSign(float magnitude, uint64_t negative) {
+    uint32_t bits;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    bits |= static_cast<uint32_t>(negative) << 31;
+    std::memcpy(&magnitude, &bits, sizeof(bits));
+    return magnitude;
+}
+
+// Decodifica um símbolo Huffman no início da janela (entrada folha de kMp3Huff)
+inline uint32_t lookupHuffman(const uint32_t* table, uint64_t window) {
+    uint32_t entry = table[window >> (64 - kMp3HuffPrimaryBits)];
+    if (entry & kMp3HuffLink) {
+        const int width = static_cast<int>((entry >> 16) & 15);
+        entry = kMp3Huff.entries[(entry & 0xFFFF) + ((window << kMp3HuffPrimaryBits) >> (64 - width))];
+    }
+    return entry;
+}
+
+} // namespace
+
+/**
+ * @brief Leitor de bits MSB-first sobre um buffer de bytes
+ *
+ * Leituras além do fim retornam zeros, o que torna quadros truncados inofensivos.
+ * peek() monta 8 bytes a partir da posição atual, de modo que um par de big_values
+ * inteiro (código, linbits e sinais: até 47 bits) sai de uma única janela.
+ */
+class Mp3BitReader {
+private:
+    const uint8_t* data;
+    size_t sizeBytes;
+    size_t pos;
+
+public:
+    Mp3BitReader(const uint8_t* bytes, size_t length)
+        : data(bytes), sizeBytes(length), pos(0) {}
+
+    // Pelo menos 57 bits válidos alinhados à esquerda
+    uint64_t peek() const {
+        const size_t byte = pos >> 3;
+        uint64_t word;
+        if (byte + 8 <= sizeBytes) {
+            word = readBigEndian64(data + byte);
+        } else {
+            word = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                word = (word << 8) | (byte + i < sizeBytes ? data[byte + i] : 0);
+            }
+        }
+        return word << (pos & 7);
+    }
+
+    // count <= 32
+    uint32_t read(int count) {
+        if (count == 0) {
+            return 0;
+        }
+        const uint32_t value = static_cast<uint32_t>(peek() >> (64 - count));
+        pos += static_cast<size_t>(count);
+        return value;
+    }
+
+    uint32_t readBit() { return read(1); }
+
+    void skip(int count) { pos += static_cast<size_t>(count); }
+    size_t position() const { return pos; }
+    void seek(size_t bitPosition) { pos = bitPosition; }
+};
+
+Mp3Decoder::Mp3Decoder()
+    : file(nullptr), inputPos(0), inputEnd(0), inputEof(true), inputOffset(0), streamHeader{},
+      totalFrames(0), firstFrame(true), resyncPending(false), position(0), encoderDelay(-1),
+      encoderPadding(-1), leadingSkip(0), spectrum{}, nonZeroLimit{}, pcmPos(0),
+      stageTiming(false) {}
+
+Mp3Decoder::~Mp3Decoder() {
+    close();
+}
+
+bool Mp3Decoder::parseHeader(const uint8_t* bytes, FrameHeader& header) {
+    if (bytes[0] != 0xFF || (bytes[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+
+    int versionBits = (bytes[1] >> 3) & 3;
+    int layerBits = (bytes[1] >> 1) & 3;
+    int bitrateIndex = bytes[2] >> 4;
+    int rateIndex = (bytes[2] >> 2) & 3;
+
+    // Apenas Layer III; bitrate livre, índices reservados e ênfase inválida são rejeitados
+    if (versionBits == 1 || layerBits != 1 || bitrateIndex == 0 || bitrateIndex == 15 ||
+        rateIndex == 3 || (bytes[3] & 3) == 2) {
+        return false;
+    }
+
+    header.version = versionBits == 3 ? 1 : (versionBits == 2 ? 2 : 3);
+    header.lsf = header.version != 1;
+    header.hasCrc = (bytes[1] & 1) == 0;
+    header.sampleRateIndex = rateIndex + (header.version == 1 ? 0 : (header.version == 2 ? 3 : 6));
+    header.sampleRate = kMp3SampleRates[header.sampleRateIndex];
+    header.bitrateKbps = kMp3Bitrates[header.lsf ? 1 : 0][bitrateIndex];
+    header.padding = ((bytes[2] >> 1) & 1) != 0;
+    header.mode = bytes[3] >> 6;
+    header.modeExtension = (bytes[3] >> 4) & 3;
+    header.channels = header.mode == 3 ? 1 : 2;
+    header.samplesPerFrame = header.lsf ? 576 : 1152;
+    header.frameBytes = static_cast<size_t>((header.lsf ? 72 : 144) * header.bitrateKbps * 1000 /
+                                            header.sampleRate) + (header.padding ? 1 : 0);
+    return true;
+}
+
+void Mp3Decoder::open(const std::string& filePath) {
+    close();
+
+    file = std::fopen(filePath.c_str(), "rb");
+    if (!file) {
+        throw DecoderException("Não foi possível abrir o arquivo: " + filePath);
+    }
+
+    path = filePath;
+    input.assign(INPUT_BUFFER_SIZE, 0);
+    inputPos = inputEnd = 0;
+    inputEof = false;
+    inputOffset = 0;
+    reservoir.clear();
+    channelState = {};
+    pcm.clear();
+    pcmPos = 0;
+    totalFrames = 0;
+    firstFrame = true;
+    resyncPending = false;
+    position = 0;
+    encoderDelay = encoderPadding = -1;
+    leadingSkip = 0;
+    frameIndex.reset();
+    tocPoints.clear();
+
+    skipId3Tag();
+
+    FrameHeader header;
+    const uint8_t* frame = nullptr;
+    if (!nextFrame(header, frame)) {
+        close();
+        throw DecoderException("Nenhum quadro MPEG Layer III válido em: " + filePath);
+    }
+
+    streamHeader = header;
+    const uint64_t frameOffset = inputOffset + static_cast<uint64_t>(frame - input.data());
+    if (!parseInfoFrame(header, frame, frameOffset)) {
+        // Quadro de áudio comum: devolvê-lo ao buffer para a primeira decodificação
+        inputPos -= header.frameBytes;
+    }
+    firstFrame = false;
+}
+
+void Mp3Decoder::close() {
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    pcm.clear();
+    pcmPos = 0;
+}
+
+bool Mp3Decoder::fillInput(size_t needed) {
+    if (inputEnd - inputPos >= needed) {
+        return true;
+    }
+    if (inputEof || !file) {
+        return false;
+    }
+
+    // Compactar o buffer e completar com dados do arquivo
+    std::memmove(input.data(), input.data() + inputPos, inputEnd - inputPos);
+    inputOffset += inputPos;
+    inputEnd -= inputPos;
+    inputPos = 0;
+    if (input.size() < needed) {
+        input.resize(needed);
+    }
+
+    while (inputEnd < input.size() && !inputEof) {
+        size_t got = std::fread(input.data() + inputEnd, 1, input.size() - inputEnd, file);
+        if (got == 0) {
+            inputEof = true;
+        }
+        inputEnd += got;
+    }
+    return inputEnd - inputPos >= needed;
+}
+
+void Mp3Decoder::skipBytes(size_t count) {
+    size_t buffered = inputEnd - inputPos;
+    if (count <= buffered) {
+        inputPos += count;
+        return;
+    }
+    count -= buffered;
+    inputOffset += inputEnd + count;
+    inputPos = inputEnd = 0;
+    if (file && std::fseek(file, static_cast<long>(count), SEEK_CUR) != 0) {
+        inputEof = true;
+    }
+}
+
+void Mp3Decoder::skipId3Tag() {
+    if (!fillInput(10)) {
+        return;
+    }
+    const uint8_t* tag = input.data() + inputPos;
+    if (tag[0] != 'I' || tag[1] != 'D' || tag[2] != '3') {
+        return;
+    }
+    size_t size = (static_cast<size_t>(tag[6] & 0x7F) << 21) | (static_cast<size_t>(tag[7] & 0x7F) << 14) |
+                  (static_cast<size_t>(tag[8] & 0x7F) << 7) | static_cast<size_t>(tag[9] & 0x7F);
+    size += 10;
+    if (tag[5] & 0x10) {
+        size += 10; // Rodapé presente
+    }
+    skipBytes(size);
+}
+
+bool Mp3Decoder::nextFrame(FrameHeader& header, const uint8_t*& frame) {
+    bool searching = false;
+    for (;;) {
+        if (!fillInput(4)) {
+            return false;
+        }
+        const uint8_t* bytes = input.data() + inputPos;
+        bool valid = parseHeader(bytes, header);
+
+        // Depois do primeiro quadro, exigir parâmetros consistentes com o stream
+        if (valid && !firstFrame &&
+            (header.sampleRateIndex != streamHeader.sampleRateIndex ||
+             header.channels != streamHeader.channels)) {
+            valid = false;
+        }
+
+        if (valid) {
+            if (!fillInput(header.frameBytes)) {
+                return false; // Quadro truncado no fim do arquivo
+            }
+            // Ao ressincronizar, confirmar que o próximo cabeçalho também é válido
+            if ((firstFrame || searching || resyncPending) && fillInput(header.frameBytes + 4)) {
+                FrameHeader following;
+                const uint8_t* next = input.data() + inputPos + header.frameBytes;
+                if (!parseHeader(next, following) ||
+                    following.sampleRateIndex != header.sampleRateIndex) {
+                    valid = false;
+                }
+            }
+        }
+
+        if (valid) {
+            frame = input.data() + inputPos;
+            inputPos += header.frameBytes;
+            resyncPending = false;
+            return true;
+        }
+
+        searching = true;
+        ++inputPos;
+    }
+}
+
+bool Mp3Decoder::parseInfoFrame(const FrameHeader& header, const uint8_t* frame, uint64_t frameOffset) {
+    size_t sideInfoSize = header.lsf ? (header.channels == 1 ? 9 : 17)
+                                     : (header.channels == 1 ? 17 : 32);
+    size_t offset = 4 + (header.hasCrc ? 2 : 0) + sideInfoSize;
+
+    auto readBigEndian32 = [](const uint8_t* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    };
+
+    if (offset + 8 <= header.frameBytes &&
+        (std::memcmp(frame + offset, "Xing", 4) == 0 || std::memcmp(frame + offset, "Info", 4) == 0)) {
+        uint32_t flags = readBigEndian32(frame + offset + 4);
+        size_t field = offset + 8;
+        if ((flags & 1) && field + 4 <= header.frameBytes) {
+            totalFrames = static_cast<uint64_t>(readBigEndian32(frame + field)) *
+                          static_cast<uint64_t>(header.samplesPerFrame);
+            field += 4;
+        }
+        uint64_t streamBytes = 0;
+        if ((flags & 2) && field + 4 <= header.frameBytes) {
+            streamBytes = readBigEndian32(frame + field);
+            field += 4;
+        }
+        if (streamBytes == 0) {
+            std::error_code error;
+            uint64_t fileSize = std::filesystem::file_size(path, error);
+            streamBytes = !error && fileSize > frameOffset ? fileSize - frameOffset : 0;
+        }
+
+        // TOC Xing: 100 entradas, posição (em 1/256 do stream) de cada 1% da duração
+        if (flags & 4) {
+            if (field + 100 <= header.frameBytes && totalFrames > 0 && streamBytes > 0) {
+                for (int percent = 0; percent < 100; ++percent) {
+                    tocPoints.emplace_back(totalFrames * static_cast<uint64_t>(percent) / 100,
+                                           frameOffset + streamBytes * frame[field + percent] / 256);
+                }
+            }
+            field += 100;
+        }
+        if (flags & 8) {
+            field += 4; // Indicador de qualidade
+        }
+        parseLameTag(header, frame, field);
+        return true;
+    }
+
+    // Cabeçalho VBRI (Fraunhofer) em posição fixa após 32 bytes
+    const size_t vbri = 36;
+    if (vbri + 26 <= header.frameBytes && std::memcmp(frame + vbri, "VBRI", 4) == 0) {
+        auto readBigEndian16 = [](const uint8_t* p) {
+            return static_cast<uint32_t>((p[0] << 8) | p[1]);
+        };
+        totalFrames = static_cast<uint64_t>(readBigEndian32(frame + vbri + 14)) *
+                      static_cast<uint64_t>(header.samplesPerFrame);
+
+        // TOC VBRI: tamanho em bytes de cada bloco de framesPerEntry quadros
+        const uint32_t entries = readBigEndian16(frame + vbri + 18);
+        const uint32_t scale = readBigEndian16(frame + vbri + 20);
+        const uint32_t entrySize = readBigEndian16(frame + vbri + 22);
+        const uint32_t framesPerEntry = readBigEndian16(frame + vbri + 24);
+        const size_t table = vbri + 26;
+        if (entrySize >= 1 && entrySize <= 4 && framesPerEntry > 0 &&
+            table + static_cast<size_t>(entries) * entrySize <= header.frameBytes) {
+            uint64_t entryOffset = frameOffset;
+            for (uint32_t i = 0; i < entries; ++i) {
+                tocPoints.emplace_back(static_cast<uint64_t>(i) * framesPerEntry * header.samplesPerFrame,
+                                       entryOffset);
+                uint32_t value = 0;
+                for (uint32_t b = 0; b < entrySize; ++b) {
+                    value = (value << 8) | frame[table + i * entrySize + b];
+                }
+                entryOffset += static_cast<uint64_t>(value) * scale;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void Mp3Decoder::parseLameTag(const FrameHeader& header, const uint8_t* frame, size_t offset) {
+    // Extensão LAME logo após os campos Xing: versão do codificador em 9 bytes e, no byte 21,
+    // atraso e preenchimento em 12 bits cada (o FFmpeg grava a mesma estrutura como Lavc/Lavf)
+    if (offset + 24 > header.frameBytes) {
+        return;
+    }
+    const uint8_t* tag = frame + offset;
+    if (std::memcmp(tag, "LAME", 4) != 0 && std::memcmp(tag, "Lavc", 4) != 0 &&
+        std::memcmp(tag, "Lavf", 4) != 0) {
+        return;
+    }
+    const uint8_t* gapless = tag + 21;
+    encoderDelay = (gapless[0] << 4) | (gapless[1] >> 4);
+    encoderPadding = ((gapless[1] & 0x0F) << 8) | gapless[2];
+    leadingSkip = static_cast<uint64_t>(encoderDelay) + DECODER_DELAY;
+}
+
+uint64_t Mp3Decoder::getStreamEnd() const {
+    if (encoderPadding < 0 || totalFrames == 0) {
+        return totalFrames; // Sem extensão LAME ou duração desconhecida: nada a cortar no fim
+    }
+    // O preenchimento inclui o atraso do decodificador, que já foi descontado no início
+    const uint64_t padding = static_cast<uint64_t>(encoderPadding);
+    const uint64_t trailing = padding > DECODER_DELAY ? padding - DECODER_DELAY : 0;
+    return totalFrames > trailing + leadingSkip ? totalFrames - trailing : leadingSkip;
+}
+
+uint64_t Mp3Decoder::getTotalFrames() const {
+    const uint64_t end = getStreamEnd();
+    return end > leadingSkip ? end - leadingSkip : 0;
+}
+
+size_t Mp3Decoder::decode(float* out, size_t maxFrames) {
+    if (!file) {
+        return 0;
+    }
+
+    // Atraso do codificador e da síntese: descartar sem copiar
+    const size_t channels = static_cast<size_t>(streamHeader.channels);
+    while (position < leadingSkip) {
+        if (pcmPos < pcm.size()) {
+            size_t available = (pcm.size() - pcmPos) / channels;
+            size_t count = static_cast<size_t>(std::min<uint64_t>(available, leadingSkip - position));
+            pcmPos += count * channels;
+            position += count;
+            continue;
+        }
+        if (!decodeNextFrame()) {
+            return 0;
+        }
+    }
+
+    // Preenchimento final: parar na última amostra original
+    const uint64_t end = getStreamEnd();
+    if (end > 0) {
+        if (position >= end) {
+            return 0;
+        }
+        maxFrames = static_cast<size_t>(std::min<uint64_t>(maxFrames, end - position));
+    }
+    return decodeRaw(out, maxFrames);
+}
+
+size_t Mp3Decoder::decodeRaw(float* out, size_t maxFrames) {
+    const size_t channels = static_cast<size_t>(streamHeader.channels);
+    size_t produced = 0;
+
+    while (produced < maxFrames) {
+        if (pcmPos < pcm.size()) {
+            size_t available = (pcm.size() - pcmPos) / channels;
+            size_t count = std::min(available, maxFrames - produced);
+            std::memcpy(out + produced * channels, pcm.data() + pcmPos,
+                        count * channels * sizeof(float));
+            pcmPos += count * channels;
+            produced += count;
+            continue;
+        }
+
+        if (!decodeNextFrame()) {
+            break;
+        }
+    }
+    position += produced;
+    return produced;
+}
+
+bool Mp3Decoder::decodeNextFrame() {
+    FrameHeader header;
+    const uint8_t* frame = nullptr;
+    if (!nextFrame(header, frame)) {
+        return false;
+    }
+
+    // Reservatório insuficiente deixa o quadro em silêncio: a contagem de amostras
+    // por quadro permanece fixa, o que mantém o seek exato
+    pcm.assign(static_cast<size_t>(header.samplesPerFrame) * streamHeader.channels, 0.0f);
+    pcmPos = 0;
+    decodeFrame(header, frame);
+    return true;
+}
+
+void Mp3Decoder::resetStream(uint64_t fileOffset) {
+    inputPos = inputEnd = 0;
+    inputOffset = fileOffset;
+    inputEof = std::fseek(file, static_cast<long>(fileOffset), SEEK_SET) != 0;
+    reservoir.clear();
+    channelState = {};
+    pcm.clear();
+    pcmPos = 0;
+}
+
+std::shared_ptr<FrameIndexCache> Mp3Decoder::indexCache;
+
+void Mp3Decoder::setStageTiming(bool enabled) {
+    stageTiming = enabled;
+    stageTimes = StageTimes();
+}
+
+void Mp3Decoder::setFrameIndexCache(std::shared_ptr<FrameIndexCache> cache) {
+    std::atomic_store(&indexCache, std::move(cache));
+}
+
+std::shared_ptr<FrameIndexCache> Mp3Decoder::getFrameIndexCache() {
+    return std::atomic_load(&indexCache);
+}
+
+bool Mp3Decoder::buildFrameIndex() {
+    if (!file) {
+        return false;
+    }
+
+    auto cache = getFrameIndexCache();
+    if (cache) {
+        auto cached = cache->load(path);
+        if (cached && cached->getSamplesPerFrame() == streamHeader.samplesPerFrame &&
+            cached->getFrameCount() > 0) {
+            frameIndex = std::move(cached);
+            totalFrames = frameIndex->getTotalSamples();
+            return true;
+        }
+    }
+
+    // Segunda instância sobre o mesmo arquivo: mesma lógica de sincronização,
+    // portanto os mesmos quadros que a decodificação sequencial produziria
+    Mp3Decoder scanner;
+    try {
+        scanner.open(path);
+    } catch (const DecoderException&) {
+        return false;
+    }
+
+    auto index = std::make_shared<Mp3FrameIndex>(streamHeader.samplesPerFrame);
+    if (totalFrames > 0) {
+        index->reserve(static_cast<size_t>(totalFrames / streamHeader.samplesPerFrame));
+    }
+
+    FrameHeader header;
+    const uint8_t* frame = nullptr;
+    while (scanner.nextFrame(header, frame)) {
+        index->addFrame(scanner.inputOffset + static_cast<uint64_t>(frame - scanner.input.data()),
+                        header.frameBytes);
+    }
+
+    if (cache) {
+        cache->store(path, *index); // Falha de escrita só custa uma nova varredura depois
+    }
+    frameIndex = std::move(index);
+    totalFrames = frameIndex->getTotalSamples(); // Contagem exata substitui a do cabeçalho Xing
+    return true;
+}
+
+size_t Mp3Decoder::prerollStartFrame(size_t frame) const {
+    // Os dois granules anteriores ao alvo precisam sair corretos (o buffer de síntese
+    // guarda amostras já somadas ao overlap da IMDCT): um quadro no MPEG-1, dois no
+    // MPEG-2/2.5. Os quadros antes deles devem cobrir o reservatório máximo.
+    const size_t exactFrames = streamHeader.lsf ? 2 : 1;
+    if (frame <= exactFrames) {
+        return 0;
+    }
+    const size_t sideInfoSize = streamHeader.lsf ? (streamHeader.channels == 1 ? 9 : 17)
+                                                 : (streamHeader.channels == 1 ? 17 : 32);
+    const uint64_t overhead = 4 + (streamHeader.hasCrc ? 2 : 0) + sideInfoSize;
+    const uint64_t maxReservoir = streamHeader.lsf ? 255 : 511;
+
+    size_t start = frame - exactFrames;
+    uint64_t covered = 0;
+    while (start > 0 && covered < maxReservoir) {
+        --start;
+        uint64_t span = frameIndex->getFrameSpan(start);
+        covered += span > overhead ? span - overhead : 0;
+    }
+    return start;
+}
+
+bool Mp3Decoder::seek(uint64_t sample) {
+    if (!file) {
+        return false;
+    }
+    // Daqui em diante, posições na contagem do decodificador (com o atraso inicial)
+    const uint64_t frame = sample + leadingSkip;
+    if (!frameIndex && !buildFrameIndex()) {
+        return seekApproximate(frame);
+    }
+
+    const Mp3FrameIndex& index = *frameIndex;
+    if (frame >= getStreamEnd()) {
+        // Além do fim: esvaziar os buffers para que o próximo decode() retorne 0
+        pcm.clear();
+        pcmPos = 0;
+        inputPos = inputEnd = 0;
+        inputEof = true;
+        position = getStreamEnd();
+        return true;
+    }
+
+    const size_t target = index.findFrameForSample(frame);
+    const size_t start = prerollStartFrame(target);
+    resetStream(index.getFrameOffset(start));
+
+    // Pré-rolagem: decodificar e descartar até o quadro que contém a amostra
+    for (size_t current = start; current <= target; ++current) {
+        if (!decodeNextFrame()) {
+            position = frame;
+            return false;
+        }
+    }
+
+    const uint64_t skip = frame - static_cast<uint64_t>(target) * index.getSamplesPerFrame();
+    pcmPos = static_cast<size_t>(skip) * static_cast<size_t>(streamHeader.channels);
+    position = frame;
+    return true;
+}
+
+bool Mp3Decoder::seekApproximate(uint64_t frame) {
+    if (tocPoints.empty()) {
+        return false;
+    }
+
+    // Último ponto da TOC antes do alvo (busca binária); o restante é decodificado e descartado
+    auto it = std::upper_bound(tocPoints.begin(), tocPoints.end(), frame,
+                               [](uint64_t value, const std::pair<uint64_t, uint64_t>& point) {
+                                   return value < point.first;
+                               });
+    if (it != tocPoints.begin()) {
+        --it;
+    }
+
+    resetStream(it->second);
+    resyncPending = true;
+    position = it->first;
+
+    std::vector<float> discard(1152 * static_cast<size_t>(streamHeader.channels));
+    while (position < frame) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(frame - position, 1152));
+        if (decodeRaw(discard.data(), count) == 0) {
+            break;
+        }
+    }
+    return true;
+}
+
+void Mp3Decoder::readSideInfo(const FrameHeader& header, const uint8_t* data, SideInfo& side) const {
+    Mp3BitReader bits(data, header.lsf ? 17 : 32);
+    const int channels = header.channels;
+
+    if (header.lsf) {
+        side.mainDataBegin = static_cast<int>(bits.read(8));
+        bits.read(channels == 1 ? 1 : 2);
+    } else {
+        side.mainDataBegin = static_cast<int>(bits.read(9));
+        bits.read(channels == 1 ? 5 : 3);
+        for (int ch = 0; ch < channels; ++ch) {
+            for (int band = 0; band < 4; ++band) {
+                side.scfsi[ch][band] = static_cast<int>(bits.readBit());
+            }
+        }
+    }
+
+    const int granules = header.lsf ? 1 : 2;
+    for (int gr = 0; gr < granules; ++gr) {
+        for (int ch = 0; ch < channels; ++ch) {
+            GranuleChannel& gc = side.granules[gr][ch];
+            gc.part23Length = static_cast<int>(bits.read(12));
+            gc.bigValues = std::min(static_cast<int>(bits.read(9)), 288);
+            gc.globalGain = static_cast<int>(bits.read(8));
+            gc.scalefacCompress = static_cast<int>(bits.read(header.lsf ? 9 : 4));
+            gc.windowSwitching = bits.readBit() != 0;
+            gc.subblockGain = {0, 0, 0};
+            if (gc.windowSwitching) {
+                gc.blockType = static_cast<int>(bits.read(2));
+                gc.mixedBlock = bits.readBit() != 0;
+                gc.tableSelect[0] = static_cast<int>(bits.read(5));
+                gc.tableSelect[1] = static_cast<int>(bits.read(5));
+                gc.tableSelect[2] = 0;
+                for (int w = 0; w < 3; ++w) {
+                    gc.subblockGain[w] = static_cast<int>(bits.read(3));
+                }
+                if (gc.blockType == 0) {
+                    gc.blockType = 1; // Combinação proibida pela norma; tratar como bloco de início
+                }
+                gc.region0Count = (gc.blockType == 2 && !gc.mixedBlock) ? 8 : 7;
+                gc.region1Count = 20 - gc.region0Count;
+            } else {
+                gc.blockType = 0;
+                gc.mixedBlock = false;
+                for (int r = 0; r < 3; ++r) {
+                    gc.tableSelect[r] = static_cast<int>(bits.read(5));
+                }
+                gc.region0Count = static_cast<int>(bits.read(4));
+                gc.region1Count = static_cast<int>(bits.read(3));
+            }
+            gc.preflag = header.lsf ? false : bits.readBit() != 0;
+            gc.scalefacScale = bits.readBit() != 0;
+            gc.count1Table = bits.readBit() != 0;
+        }
+    }
+}
+
+bool Mp3Decoder::decodeFrame(const FrameHeader& header, const uint8_t* frame) {
+    const int channels = header.channels;
+    const size_t dataStart = 4 + (header.hasCrc ? 2 : 0);
+    const size_t sideInfoSize = header.lsf ? (channels == 1 ? 9 : 17) : (channels == 1 ? 17 : 32);
+    if (dataStart + sideInfoSize > header.frameBytes) {
+        return false;
+    }
+
+    SideInfo side{};
+    readSideInfo(header, frame + dataStart, side);
+
+    const uint8_t* frameMain = frame + dataStart + sideInfoSize;
+    const size_t frameMainBytes = header.frameBytes - dataStart - sideInfoSize;
+    const size_t begin = static_cast<size_t>(side.mainDataBegin);
+    const bool enoughReservoir = begin <= reservoir.size();
+
+    if (enoughReservoir) {
+        mainData.assign(reservoir.end() - static_cast<std::ptrdiff_t>(begin), reservoir.end());
+        mainData.insert(mainData.end(), frameMain, frameMain + frameMainBytes);
+    }
+
+    // Atualizar o reservatório com os dados deste quadro (mantendo apenas o necessário)
+    reservoir.insert(reservoir.end(), frameMain, frameMain + frameMainBytes);
+    if (reservoir.size() > RESERVOIR_BYTES) {
+        reservoir.erase(reservoir.begin(),
+                        reservoir.end() - static_cast<std::ptrdiff_t>(RESERVOIR_BYTES));
+    }
+
+    if (!enoughReservoir) {
+        return false;
+    }
+
+    Mp3BitReader bits(mainData.data(), mainData.size());
+    const int granules = header.lsf ? 1 : 2;
+    float subbandSamples[18][32];
+
+    // Cronometragem opcional: um relógio entre etapas, desligada no caminho normal
+    StageClock::time_point last = stageTiming ? StageClock::now() : StageClock::time_point();
+    auto lap = [&](double StageTimes::*stage) {
+        if (stageTiming) {
+            const StageClock::time_point now = StageClock::now();
+            stageTimes.*stage += std::chrono::duration<double>(now - last).count();
+            last = now;
+        }
+    };
+
+    for (int gr = 0; gr < granules; ++gr) {
+        for (int ch = 0; ch < channels; ++ch) {
+            const GranuleChannel& gc = side.granules[gr][ch];
+            size_t start = bits.position();
+            if (header.lsf) {
+                readLsfScalefactors(header, bits, gc, ch);
+            } else {
+                readScalefactors(header, bits, side, gr, ch);
+            }
+            size_t endBit = start + static_cast<size_t>(gc.part23Length);
+            readHuffman(header, bits, gc, ch, endBit);
+            bits.seek(endBit);
+            lap(&StageTimes::huffman);
+            requantize(header, gc, ch);
+            lap(&StageTimes::requantize);
+        }
+
+        if (channels == 2 && header.mode == 1) {
+            processStereo(header, side.granules[gr][0], side.granules[gr][1]);
+            lap(&StageTimes::stereo);
+        }
+
+        for (int ch = 0; ch < channels; ++ch) {
+            const GranuleChannel& gc = side.granules[gr][ch];
+            reorder(header, gc, ch);
+            antialias(gc, ch);
+            lap(&StageTimes::antialias);
+            inverseMdct(gc, ch, subbandSamples);
+            lap(&StageTimes::imdct);
+            float* out = pcm.data() + static_cast<size_t>(gr) * SAMPLES_PER_GRANULE * channels + ch;
+            polyphaseSynthesis(ch, subbandSamples, out, channels);
+            lap(&StageTimes::synthesis);
+        }
+        stageTimes.granules += stageTiming ? static_cast<uint64_t>(channels) : 0;
+    }
+    return true;
+}
+
+void Mp3Decoder::readScalefactors(const FrameHeader& header, Mp3BitReader& bits,
+                                  const SideInfo& side, int granule, int channel) {
+    (void)header;
+    const GranuleChannel& gc = side.granules[granule][channel];
+    ChannelState& state = channelState[channel];
+    const int slen1 = kMp3Slen[gc.scalefacCompress][0];
+    const int slen2 = kMp3Slen[gc.scalefacCompress][1];
+
+    state.preflag = gc.preflag;
+
+    if (gc.windowSwitching && gc.blockType == 2) {
+        int firstShort = 0;
+        if (gc.mixedBlock) {
+            for (int sfb = 0; sfb < 8; ++sfb) {
+                state.sfLong[sfb] = static_cast<int>(bits.read(slen1));
+            }
+            firstShort = 3;
+        }
+        for (int sfb = firstShort; sfb < 12; ++sfb) {
+            int slen = sfb < 6 ? slen1 : slen2;
+            for (int w = 0; w < 3; ++w) {
+                state.sfShort[sfb][w] = static_cast<int>(bits.read(slen));
+            }
+        }
+        state.sfShort[12] = {0, 0, 0};
+        return;
+    }
+
+    static const int bandLimits[5] = {0, 6, 11, 16, 21};
+    for (int band = 0; band < 4; ++band) {
+        if (granule == 1 && side.scfsi[channel][band]) {
+            continue; // Fatores reutilizados do primeiro granule
+        }
+        int slen = band < 2 ? slen1 : slen2;
+        for (int sfb = bandLimits[band]; sfb < bandLimits[band + 1]; ++sfb) {
+            state.sfLong[sfb] = static_cast<int>(bits.read(slen));
+        }
+    }
+    state.sfLong[21] = 0;
+}
+
+void Mp3Decoder::readLsfScalefactors(const FrameHeader& header, Mp3BitReader& bits,
+                                     const GranuleChannel& gc, int channel) {
+    ChannelState& state = channelState[channel];
+    int slen[4] = {0, 0, 0, 0};
+    int table = 0;
+    int sfc = gc.scalefacCompress;
+    const bool intensityChannel = channel == 1 && header.mode == 1 && (header.modeExtension & 1);
+
+    state.preflag = false;
+    state.intensityScale = false;
+
+    if (!intensityChannel) {
+        if (sfc < 400) {
+            slen[0] = (sfc >> 4) / 5;
+            slen[1] = (sfc >> 4) % 5;
+            slen[2] = (sfc & 15) >> 2;
+            slen[3] = sfc & 3;
+            table = 0;
+        } else if (sfc < 500) {
+            sfc -= 400;
+            slen[0] = (sfc >> 2) / 5;
+            slen[1] = (sfc >> 2) % 5;
+            slen[2] = sfc & 3;
+            table = 1;
+        } else {
+            sfc -= 500;
+            slen[0] = sfc / 3;
+            slen[1] = sfc % 3;
+            table = 2;
+            state.preflag = true;
+        }
+    } else {
+        state.intensityScale = (sfc & 1) != 0;
+        sfc >>= 1;
+        if (sfc < 180) {
+            slen[0] = sfc / 36;
+            slen[1] = (sfc % 36) / 6;
+            slen[2] = (sfc % 36) % 6;
+            table = 3;
+        } else if (sfc < 244) {
+            sfc -= 180;
+            slen[0] = (sfc & 63) >> 4;
+            slen[1] = (sfc & 15) >> 2;
+            slen[2] = sfc & 3;
+            table = 4;
+        } else {
+            sfc -= 244;
+            slen[0] = sfc / 3;
+            slen[1] = sfc % 3;
+            table = 5;
+        }
+    }
+
+    const int blockIndex = (gc.windowSwitching && gc.blockType == 2) ? (gc.mixedBlock ? 2 : 1) : 0;
+    int values[40] = {};
+    int maxima[40] = {};
+    int count = 0;
+    for (int part = 0; part < 4; ++part) {
+        for (int i = 0; i < kMp3LsfSfbCount[table][blockIndex][part]; ++i) {
+            values[count] = static_cast<int>(bits.read(slen[part]));
+            maxima[count] = (1 << slen[part]) - 1;
+            ++count;
+        }
+    }
+
+    int k = 0;
+    if (blockIndex == 0) {
+        for (int sfb = 0; sfb < 21; ++sfb, ++k) {
+            state.sfLong[sfb] = values[k];
+            state.sfLongMax[sfb] = maxima[k];
+        }
+        state.sfLong[21] = 0;
+        state.sfLongMax[21] = state.sfLongMax[20];
+        return;
+    }
+
+    int firstShort = 0;
+    if (blockIndex == 2) {
+        for (int sfb = 0; sfb < 6; ++sfb, ++k) {
+            state.sfLong[sfb] = values[k];
+            state.sfLongMax[sfb] = maxima[k];
+        }
+        firstShort = 3;
+    }
+    for (int sfb = firstShort; sfb < 12; ++sfb) {
+        for (int w = 0; w < 3; ++w, ++k) {
+            state.sfShort[sfb][w] = values[k];
+            state.sfShortMax[sfb][w] = maxima[k];
+        }
+    }
+    state.sfShort[12] = {0, 0, 0};
+    state.sfShortMax[12] = state.sfShortMax[11];
+}
+
+void Mp3Decoder::readHuffman(const FrameHeader& header, Mp3BitReader& bits,
+                             const GranuleChannel& gc, int channel, size_t endBit) {
+    float* xr = spectrum[channel].data();
+    const uint16_t* sfbLong = kMp3SfbLong[header.sampleRateIndex];
+
+    size_t bigEnd = static_cast<size_t>(gc.bigValues) * 2;
+    size_t region1;
+    size_t region2;
+    if (gc.windowSwitching) {
+        region1 = gc.blockType == 2 ? (header.sampleRateIndex == 8 ? 72 : 36) : sfbLong[8];
+        region2 = SAMPLES_PER_GRANULE;
+    } else {
+        region1 = sfbLong[std::min(gc.region0Count + 1, 22)];
+        region2 = sfbLong[std::min(gc.region0Count + gc.region1Count + 2, 22)];
+    }
+    region1 = std::min(region1, bigEnd);
+    region2 = std::min(region2, bigEnd);
+
+    // Cada par sai de uma janela de 57 bits: código, linbits e sinais, sem ler bit a bit.
+    // O valor já é gravado requantizado (sinal * |x|^(4/3)); requantize() só aplica o ganho.
+    size_t i = 0;
+    for (int region = 0; region < 3; ++region) {
+        size_t regionEnd = region == 0 ? region1 : (region == 1 ? region2 : bigEnd);
+        const Mp3HuffTableInfo& info = kMp3HuffTables[gc.tableSelect[region]];
+        const uint32_t* table = kMp3Huff.entries + kMp3Huff.start[gc.tableSelect[region]];
+        const int linbits = info.linbits;
+
+        if (info.count == 0) {
+            for (; i < regionEnd; i += 2) {
+                xr[i] = xr[i + 1] = 0.0f;
+            }
+            continue;
+        }
+        for (; i < regionEnd; i += 2) {
+            uint64_t window = bits.peek();
+            const uint32_t entry = lookupHuffman(table, window);
+            int used = static_cast<int>((entry >> 8) & 31);
+            window <<= used;
+            int x = static_cast<int>((entry >> 4) & 15);
+            int y = static_cast<int>(entry & 15);
+
+            if (x == 15 && linbits) {
+                x += static_cast<int>(window >> (64 - linbits));
+                window <<= linbits;
+                used += linbits;
+            }
+            const int hasX = x != 0;
+            const uint64_t signX = (window >> 63) & static_cast<uint64_t>(hasX);
+            window <<= hasX;
+            used += hasX;
+
+            if (y == 15 && linbits) {
+                y += static_cast<int>(window >> (64 - linbits));
+                window <<= linbits;
+                used += linbits;
+            }
+            const int hasY = y != 0;
+            const uint64_t signY = (window >> 63) & static_cast<uint64_t>(hasY);
+            used += hasY;
+
+            bits.skip(used);
+            xr[i] = withSign(kMp3Requant.pow43[x], signX);
+            xr[i + 1] = withSign(kMp3Requant.pow43[y], signY);
+        }
+    }
+
+    // Região count1: quádruplas de valores em {-1, 0, 1}; a tabela B (4 bits fixos) também
+    // passa pela consulta
+    const uint32_t* count1 = kMp3Huff.entries + kMp3Huff.start[gc.count1Table ? kMp3HuffCount1B : kMp3HuffCount1A];
+    while (i + 4 <= SAMPLES_PER_GRANULE && bits.position() < endBit) {
+        uint64_t window = bits.peek();
+        const uint32_t entry = count1[window >> (64 - kMp3HuffPrimaryBits)];
+        int used = static_cast<int>((entry >> 8) & 31);
+        window <<= used;
+        for (int k = 0; k < 4; ++k) {
+            const uint64_t value = (entry >> (3 - k)) & 1;
+            const uint64_t sign = (window >> 63) & value;
+            window <<= value;
+            used += static_cast<int>(value);
+            xr[i + static_cast<size_t>(k)] = withSign(static_cast<float>(value), sign);
+        }
+        bits.skip(used);
+        i += 4;
+    }
+
+    // Leitura além de part2_3_length: a última quádrupla é descartada
+    if (bits.position() > endBit && i >= 4 && i > bigEnd) {
+        i -= 4;
+    }
+
+    nonZeroLimit[channel] = static_cast<int>(i);
+    std::fill(xr + i, xr + SAMPLES_PER_GRANULE, 0.0f);
+}
+
+void Mp3Decoder::requantize(const FrameHeader& header, const GranuleChannel& gc, int channel) {
+    const ChannelState& state = channelState[channel];
+    float* xr = spectrum[channel].data();
+    const size_t limit = static_cast<size_t>(nonZeroLimit[channel]);
+    const uint16_t* sfbLong = kMp3SfbLong[header.sampleRateIndex];
+    const uint16_t* sfbShort = kMp3SfbShort[header.sampleRateIndex];
+    // Ganho em quartos de potência de 2: cada fator de escala vale 2 (ou 4 com scalefac_scale)
+    const int scaleShift = gc.scalefacScale ? 2 : 1;
+    const int globalQuarters = gc.globalGain - 210;
+
+    // |x|^(4/3) já veio do Huffman: sobra uma multiplicação por banda, sem desvios
+    auto apply = [&](size_t begin, size_t end, int quarters) {
+        end = std::min(end, limit);
+        const float scale = kMp3Requant.gain[std::min(std::max(quarters, kMp3GainMin), kMp3GainMax) - kMp3GainMin];
+        for (size_t i = begin; i < end; ++i) {
+            xr[i] *= scale;
+        }
+    };
+
+    const bool shortBlock = gc.windowSwitching && gc.blockType == 2;
+    const int longBands = shortBlock ? (gc.mixedBlock ? (header.lsf ? 6 : 8) : 0) : 22;
+
+    for (int sfb = 0; sfb < longBands; ++sfb) {
+        int pretab = state.preflag ? kMp3Pretab[sfb] : 0;
+        apply(sfbLong[sfb], sfbLong[sfb + 1], globalQuarters - ((state.sfLong[sfb] + pretab) << scaleShift));
+    }
+
+    if (!shortBlock) {
+        return;
+    }
+
+    for (int sfb = gc.mixedBlock ? 3 : 0; sfb < 13; ++sfb) {
+        size_t width = static_cast<size_t>(sfbShort[sfb + 1] - sfbShort[sfb]);
+        size_t base = static_cast<size_t>(sfbShort[sfb]) * 3;
+        for (int w = 0; w < 3; ++w) {
+            size_t begin = base + static_cast<size_t>(w) * width;
+            apply(begin, begin + width,
+                  globalQuarters - 8 * gc.subblockGain[w] - (state.sfShort[sfb][w] << scaleShift));
+        }
+    }
+}
+
+void Mp3Decoder::processStereo(const FrameHeader& header, const GranuleChannel& left,
+                               const GranuleChannel& right) {
+    const Mp3RequantTables& t = kMp3Requant;
+    float* l = spectrum[0].data();
+    float* r = spectrum[1].data();
+    const bool msStereo = (header.modeExtension & 2) != 0;
+    const bool intensity = (header.modeExtension & 1) != 0;
+    const uint16_t* sfbLong = kMp3SfbLong[header.sampleRateIndex];
+    const uint16_t* sfbShort = kMp3SfbShort[header.sampleRateIndex];
+    const ChannelState& rightState = channelState[1];
+
+    std::array<bool, SAMPLES_PER_GRANULE> intensityLine{};
+
+    // Aplica intensity stereo a um intervalo de linhas com a posição dada
+    auto applyIntensity = [&](size_t begin, size_t end, int position, int maximum) {
+        if (header.lsf) {
+            if (position == maximum) return; // Posição ilegal: banda permanece M/S ou L/R
+            double base = rightState.intensityScale ? 0.70710678118654752 : 0.84089641525371454;
+            float kl = 1.0f;
+            float kr = 1.0f;
+            if (position & 1) {
+                kl = static_cast<float>(std::pow(base, (position + 1) / 2));
+            } else if (position != 0) {
+                kr = static_cast<float>(std::pow(base, position / 2));
+            }
+            for (size_t i = begin; i < end; ++i) {
+                float value = l[i];
+                l[i] = value * kl;
+                r[i] = value * kr;
+                intensityLine[i] = true;
+            }
+        } else {
+            if (position >= 7) return;
+            for (size_t i = begin; i < end; ++i) {
+                float value = l[i];
+                l[i] = value * t.intensityLeft[position];
+                r[i] = value * t.intensityRight[position];
+                intensityLine[i] = true;
+            }
+        }
+    };
+
+    if (intensity) {
+        const bool shortBlock = right.windowSwitching && right.blockType == 2;
+        bool longPartIntensity = !shortBlock;
+
+        if (shortBlock) {
+            int firstShort = right.mixedBlock ? 3 : 0;
+            bool shortPartSilent = true;
+            for (int w = 0; w < 3; ++w) {
+                // Última banda curta não nula do canal direito nesta janela
+                int start = firstShort;
+                for (int sfb = 12; sfb >= firstShort; --sfb) {
+                    size_t width = static_cast<size_t>(sfbShort[sfb + 1] - sfbShort[sfb]);
+                    size_t begin = static_cast<size_t>(sfbShort[sfb]) * 3 + static_cast<size_t>(w) * width;
+                    bool nonZero = false;
+                    for (size_t i = begin; i < begin + width; ++i) {
+                        if (r[i] != 0.0f) { nonZero = true; break; }
+                    }
+                    if (nonZero) { start = sfb + 1; break; }
+                }
+                if (start > firstShort) shortPartSilent = false;
+                for (int sfb = start; sfb < 13; ++sfb) {
+                    size_t width = static_cast<size_t>(sfbShort[sfb + 1] - sfbShort[sfb]);
+                    size_t begin = static_cast<size_t>(sfbShort[sfb]) * 3 + static_cast<size_t>(w) * width;
+                    int source = sfb == 12 ? 11 : sfb;
+                    applyIntensity(begin, begin + width, rightState.sfShort[source][w],
+                                   rightState.sfShortMax[source][w]);
+                }
+            }
+            longPartIntensity = right.mixedBlock && shortPartSilent;
+        }
+
+        if (longPartIntensity) {
+            const int longBands = shortBlock ? (header.lsf ? 6 : 8) : 22;
+            const int longEnd = std::min<int>(sfbLong[longBands], nonZeroLimit[1]);
+            int lastNonZero = -1;
+            for (int i = longEnd - 1; i >= 0; --i) {
+                if (r[i] != 0.0f) { lastNonZero = i; break; }
+            }
+            // Bandas acima da última linha não nula do canal direito usam intensity
+            int start = 0;
+            if (lastNonZero >= 0) {
+                while (start < longBands && sfbLong[start + 1] <= lastNonZero) {
+                    ++start;
+                }
+                ++start;
+            }
+            for (int sfb = start; sfb < longBands; ++sfb) {
+                int source = sfb == 21 ? 20 : sfb;
+                applyIntensity(sfbLong[sfb], sfbLong[sfb + 1], rightState.sfLong[source],
+                               rightState.sfLongMax[source]);
+            }
+        }
+    }
+
+    if (msStereo) {
+        const float invSqrt2 = 0.70710678118654752f;
+        size_t limit = static_cast<size_t>(std::max(nonZeroLimit[0], nonZeroLimit[1]));
+        for (size_t i = 0; i < limit; ++i) {
+            if (intensityLine[i]) continue;
+            float mid = l[i];
+            float side = r[i];
+            l[i] = (mid + side) * invSqrt2;
+            r[i] = (mid - side) * invSqrt2;
+        }
+    }
+
+    (void)left;
+    const int limit = std::max(nonZeroLimit[0], nonZeroLimit[1]);
+    nonZeroLimit[0] = nonZeroLimit[1] = limit;
+}
+
+void Mp3Decoder::reorder(const FrameHeader& header, const GranuleChannel& gc, int channel) {
+    if (!(gc.windowSwitching && gc.blockType == 2)) {
+        return;
+    }
+    const uint16_t* sfbShort = kMp3SfbShort[header.sampleRateIndex];
+    float* xr = spectrum[channel].data();
+    float reordered[SAMPLES_PER_GRANULE];
+
+    for (int sfb = gc.mixedBlock ? 3 : 0; sfb < 13; ++sfb) {
+        size_t width = static_cast<size_t>(sfbShort[sfb + 1] - sfbShort[sfb]);
+        size_t base = static_cast<size_t>(sfbShort[sfb]) * 3;
+        for (size_t w = 0; w < 3; ++w) {
+            for (size_t f = 0; f < width; ++f) {
+                reordered[base + 3 * f + w] = xr[base + w * width + f];
+            }
+        }
+        std::memcpy(xr + base, reordered + base, 3 * width * sizeof(float));
+    }
+}
+
+void Mp3Decoder::antialias(const GranuleChannel& gc, int channel) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    float* xr = spectrum[channel].data();
+    int subbands = 32;
+    if (gc.windowSwitching && gc.blockType == 2) {
+        if (!gc.mixedBlock) return;
+        subbands = 2;
+    }
+    for (int sb = 1; sb < subbands; ++sb) {
+        float* lower = xr + 18 * sb - 1;
+        float* upper = xr + 18 * sb;
+        for (int i = 0; i < 8; ++i) {
+            float a = lower[-i];
+            float b = upper[i];
+            lower[-i] = a * t.antialiasCs[i] - b * t.antialiasCa[i];
+            upper[i] = b * t.antialiasCs[i] + a * t.antialiasCa[i];
+        }
+    }
+}
+
+void Mp3Decoder::inverseMdct(const GranuleChannel& gc, int channel, float (*subbandSamples)[32]) {
+    const int blockType = gc.windowSwitching ? gc.blockType : 0;
+    const int activeSubbands = std::min(32, (nonZeroLimit[channel] + 17) / 18 + 1);
+    Mp3Filterbank::inverseMdct(spectrum[channel].data(), blockType, gc.windowSwitching && gc.mixedBlock,
+                               activeSubbands, channelState[channel].filterbank, subbandSamples);
+}
+
+void Mp3Decoder::polyphaseSynthesis(int channel, const float (*subbandSamples)[32], float* out, int stride) {
+    Mp3Filterbank::synthesize(subbandSamples, channelState[channel].filterbank, out, stride);
+}
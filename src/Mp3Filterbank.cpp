@@ -0,0 +1,413 @@
+#include "Mp3Filterbank.h"
+#include "Mp3LookupTables.h"
+#include <algorithm>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Samples = float (*)[Mp3Filterbank::SUBBANDS];
+using ConstSamples = const float (*)[Mp3Filterbank::SUBBANDS];
+
+// Referência direta: IMDCT de cada sub-banda em [sbBegin, 32)
+void inverseMdctScalar(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                       Mp3Filterbank::State& state, Samples samples, int sbBegin) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    for (int sb = sbBegin; sb < Mp3Filterbank::SUBBANDS; ++sb) {
+        float z[36] = {};
+        const float* x = spectrum + 18 * sb;
+
+        if (sb < activeSubbands) {
+            const int type = (blockType == 2 && mixedBlock && sb < 2) ? 0 : blockType;
+            if (type == 2) {
+                for (int w = 0; w < 3; ++w) {
+                    for (int i = 0; i < 12; ++i) {
+                        float sum = 0.0f;
+                        for (int k = 0; k < 6; ++k) {
+                            sum += x[3 * k + w] * t.imdctShort[i][k];
+                        }
+                        z[6 + 6 * w + i] += sum * t.windows[2][i];
+                    }
+                }
+            } else {
+                const float* window = t.windows[type];
+                for (int i = 0; i < 36; ++i) {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 18; ++k) {
+                        sum += x[k] * t.imdctLong[i][k];
+                    }
+                    z[i] = sum * window[i];
+                }
+            }
+        }
+
+        for (int i = 0; i < 18; ++i) {
+            float sample = z[i] + state.overlap[i][sb];
+            state.overlap[i][sb] = z[18 + i];
+            // Inversão de frequência nas sub-bandas ímpares
+            samples[i][sb] = ((sb & 1) && (i & 1)) ? -sample : sample;
+        }
+    }
+}
+
+// Referência direta: matriz de 64 x 32 e janela de 512 (ISO 11172-3, seção 2.4.3.2.2)
+void synthesizeScalar(ConstSamples samples, Mp3Filterbank::State& state, float* out, int stride, int slotBegin) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    for (int slot = slotBegin; slot < Mp3Filterbank::SLOTS; ++slot) {
+        state.offset = (state.offset - 64) & 1023;
+        float* v = state.v;
+        const float* s = samples[slot];
+        for (int i = 0; i < 64; ++i) {
+            float sum = 0.0f;
+            for (int k = 0; k < 32; ++k) {
+                sum += t.synthCos[i][k] * s[k];
+            }
+            v[(state.offset + i) & 1023] = sum;
+        }
+
+        for (int j = 0; j < 32; ++j) {
+            float sum = 0.0f;
+            for (int i = 0; i < 8; ++i) {
+                sum += v[(state.offset + 128 * i + j) & 1023] * t.synthWindow[64 * i + j];
+                sum += v[(state.offset + 128 * i + 96 + j) & 1023] * t.synthWindow[64 * i + 32 + j];
+            }
+            out[static_cast<size_t>(slot * 32 + j) * static_cast<size_t>(stride)] = sum;
+        }
+    }
+}
+
+// Espectro transposto para [linha][sub-banda], com zeros a partir de activeSubbands
+void transposeSpectrum(const float* spectrum, int activeSubbands, int end, float (*xt)[Mp3Filterbank::SUBBANDS]) {
+    for (int sb = 0; sb < end; ++sb) {
+        const float* x = spectrum + 18 * sb;
+        const bool active = sb < activeSubbands;
+        for (int k = 0; k < 18; ++k) {
+            xt[k][sb] = active ? x[k] : 0.0f;
+        }
+    }
+}
+
+void storeSlots(const float* pcm, float* out, int slot, int stride) {
+    for (int j = 0; j < 32; ++j) {
+        out[static_cast<size_t>(slot * 32 + j) * static_cast<size_t>(stride)] = pcm[j];
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+/*
+ * Os kernels vetoriais usam as simetrias exatas das tabelas: imdctLong[17 - i] = -imdctLong[i],
+ * imdctLong[53 - i] = imdctLong[i] (i >= 18), e o mesmo para imdctShort com 5 - i e 17 - i.
+ * Cada soma é acumulada na ordem de k a partir de zero, como na referência, e a linha
+ * espelhada recebe a soma negada: o resultado é o mesmo, a menos do sinal de zeros exatos.
+ */
+
+size_t inverseMdctSse2(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                       Mp3Filterbank::State& state, Samples samples) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    alignas(16) float xt[18][Mp3Filterbank::SUBBANDS];
+    const int end = std::min(Mp3Filterbank::SUBBANDS, (activeSubbands + 3) & ~3);
+    transposeSpectrum(spectrum, activeSubbands, end, xt);
+
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 oddLanes = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const __m128 longLanes = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, 0, 0));
+
+    for (int sb = 0; sb < Mp3Filterbank::SUBBANDS; sb += 4) {
+        __m128 z[36];
+        if (sb < activeSubbands) {
+            const bool mixed = blockType == 2 && mixedBlock && sb == 0;
+            if (blockType != 2 || mixed) {
+                const float* window = t.windows[mixed ? 0 : blockType];
+                for (int i = 0; i < 9; ++i) {
+                    __m128 front = _mm_setzero_ps();
+                    __m128 back = _mm_setzero_ps();
+                    for (int k = 0; k < 18; ++k) {
+                        const __m128 x = _mm_loadu_ps(xt[k] + sb);
+                        front = _mm_add_ps(front, _mm_mul_ps(x, _mm_set1_ps(t.imdctLong[i][k])));
+                        back = _mm_add_ps(back, _mm_mul_ps(x, _mm_set1_ps(t.imdctLong[18 + i][k])));
+                    }
+                    z[i] = _mm_mul_ps(front, _mm_set1_ps(window[i]));
+                    z[17 - i] = _mm_mul_ps(_mm_xor_ps(front, sign), _mm_set1_ps(window[17 - i]));
+                    z[18 + i] = _mm_mul_ps(back, _mm_set1_ps(window[18 + i]));
+                    z[35 - i] = _mm_mul_ps(back, _mm_set1_ps(window[35 - i]));
+                }
+            }
+            if (blockType == 2) {
+                __m128 zs[36];
+                for (int i = 0; i < 36; ++i) {
+                    zs[i] = _mm_setzero_ps();
+                }
+                const float* window = t.windows[2];
+                for (int w = 0; w < 3; ++w) {
+                    __m128* zw = zs + 6 + 6 * w;
+                    for (int i = 0; i < 3; ++i) {
+                        __m128 front = _mm_setzero_ps();
+                        __m128 back = _mm_setzero_ps();
+                        for (int k = 0; k < 6; ++k) {
+                            const __m128 x = _mm_loadu_ps(xt[3 * k + w] + sb);
+                            front = _mm_add_ps(front, _mm_mul_ps(x, _mm_set1_ps(t.imdctShort[i][k])));
+                            back = _mm_add_ps(back, _mm_mul_ps(x, _mm_set1_ps(t.imdctShort[6 + i][k])));
+                        }
+                        zw[i] = _mm_add_ps(zw[i], _mm_mul_ps(front, _mm_set1_ps(window[i])));
+                        zw[5 - i] = _mm_add_ps(zw[5 - i],
+                                               _mm_mul_ps(_mm_xor_ps(front, sign), _mm_set1_ps(window[5 - i])));
+                        zw[6 + i] = _mm_add_ps(zw[6 + i], _mm_mul_ps(back, _mm_set1_ps(window[6 + i])));
+                        zw[11 - i] = _mm_add_ps(zw[11 - i], _mm_mul_ps(back, _mm_set1_ps(window[11 - i])));
+                    }
+                }
+                for (int i = 0; i < 36; ++i) {
+                    // Bloco misto: as duas primeiras sub-bandas ficam com a IMDCT longa
+                    z[i] = mixed ? _mm_or_ps(_mm_and_ps(longLanes, z[i]), _mm_andnot_ps(longLanes, zs[i])) : zs[i];
+                }
+            }
+        } else {
+            for (int i = 0; i < 36; ++i) {
+                z[i] = _mm_setzero_ps();
+            }
+        }
+
+        for (int i = 0; i < 18; ++i) {
+            __m128 sample = _mm_add_ps(z[i], _mm_loadu_ps(state.overlap[i] + sb));
+            _mm_storeu_ps(state.overlap[i] + sb, z[18 + i]);
+            if (i & 1) {
+                sample = _mm_xor_ps(sample, oddLanes);
+            }
+            _mm_storeu_ps(samples[i] + sb, sample);
+        }
+    }
+    return Mp3Filterbank::SUBBANDS;
+}
+
+// Linhas 0-15 e 33-48 da matriz; as outras saem por simetria (ver Mp3FilterbankTables::synthMatrix)
+size_t synthesizeSse2(ConstSamples samples, Mp3Filterbank::State& state, float* out, int stride) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    alignas(16) float pcm[32];
+
+    for (int slot = 0; slot < Mp3Filterbank::SLOTS; ++slot) {
+        state.offset = (state.offset - 64) & 1023;
+        const float* s = samples[slot];
+
+        __m128 u[8];
+        for (int q = 0; q < 8; ++q) {
+            u[q] = _mm_setzero_ps();
+        }
+        for (int k = 0; k < 32; ++k) {
+            const __m128 sk = _mm_set1_ps(s[k]);
+            for (int q = 0; q < 8; ++q) {
+                u[q] = _mm_add_ps(u[q], _mm_mul_ps(_mm_loadu_ps(t.synthMatrix[k] + 4 * q), sk));
+            }
+        }
+
+        float* v = state.v + state.offset;
+        for (int q = 0; q < 4; ++q) {
+            const __m128 reversed = _mm_shuffle_ps(u[q], u[q], _MM_SHUFFLE(0, 1, 2, 3));
+            _mm_storeu_ps(v + 4 * q, u[q]);
+            _mm_storeu_ps(v + 29 - 4 * q, _mm_xor_ps(reversed, sign));
+        }
+        v[16] = 0.0f;
+        for (int q = 4; q < 8; ++q) {
+            const __m128 reversed = _mm_shuffle_ps(u[q], u[q], _MM_SHUFFLE(0, 1, 2, 3));
+            _mm_storeu_ps(v + 17 + 4 * q, u[q]);
+            _mm_storeu_ps(v + 76 - 4 * q, reversed);
+        }
+
+        float* dst = stride == 1 ? out + slot * 32 : pcm;
+        for (int j = 0; j < 32; j += 4) {
+            __m128 sum = _mm_setzero_ps();
+            for (int i = 0; i < 8; ++i) {
+                const float* a = state.v + ((state.offset + 128 * i) & 1023) + j;
+                const float* b = state.v + ((state.offset + 128 * i + 96) & 1023) + j;
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(t.synthWindow + 64 * i + j)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(b), _mm_loadu_ps(t.synthWindow + 64 * i + 32 + j)));
+            }
+            _mm_storeu_ps(dst + j, sum);
+        }
+        if (stride != 1) {
+            storeSlots(pcm, out, slot, stride);
+        }
+    }
+    return Mp3Filterbank::SLOTS;
+}
+
+MP3PLAYER_TARGET_AVX2 size_t inverseMdctAvx2(const float* spectrum, int blockType, bool mixedBlock,
+                                             int activeSubbands, Mp3Filterbank::State& state, Samples samples) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    alignas(32) float xt[18][Mp3Filterbank::SUBBANDS];
+    const int end = std::min(Mp3Filterbank::SUBBANDS, (activeSubbands + 7) & ~7);
+    transposeSpectrum(spectrum, activeSubbands, end, xt);
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 oddLanes = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+
+    for (int sb = 0; sb < Mp3Filterbank::SUBBANDS; sb += 8) {
+        __m256 z[36];
+        if (sb < activeSubbands) {
+            const bool mixed = blockType == 2 && mixedBlock && sb == 0;
+            if (blockType != 2 || mixed) {
+                const float* window = t.windows[mixed ? 0 : blockType];
+                for (int i = 0; i < 9; ++i) {
+                    __m256 front = _mm256_setzero_ps();
+                    __m256 back = _mm256_setzero_ps();
+                    for (int k = 0; k < 18; ++k) {
+                        const __m256 x = _mm256_loadu_ps(xt[k] + sb);
+                        front = _mm256_add_ps(front, _mm256_mul_ps(x, _mm256_set1_ps(t.imdctLong[i][k])));
+                        back = _mm256_add_ps(back, _mm256_mul_ps(x, _mm256_set1_ps(t.imdctLong[18 + i][k])));
+                    }
+                    z[i] = _mm256_mul_ps(front, _mm256_set1_ps(window[i]));
+                    z[17 - i] = _mm256_mul_ps(_mm256_xor_ps(front, sign), _mm256_set1_ps(window[17 - i]));
+                    z[18 + i] = _mm256_mul_ps(back, _mm256_set1_ps(window[18 + i]));
+                    z[35 - i] = _mm256_mul_ps(back, _mm256_set1_ps(window[35 - i]));
+                }
+            }
+            if (blockType == 2) {
+                __m256 zs[36];
+                for (int i = 0; i < 36; ++i) {
+                    zs[i] = _mm256_setzero_ps();
+                }
+                const float* window = t.windows[2];
+                for (int w = 0; w < 3; ++w) {
+                    __m256* zw = zs + 6 + 6 * w;
+                    for (int i = 0; i < 3; ++i) {
+                        __m256 front = _mm256_setzero_ps();
+                        __m256 back = _mm256_setzero_ps();
+                        for (int k = 0; k < 6; ++k) {
+                            const __m256 x = _mm256_loadu_ps(xt[3 * k + w] + sb);
+                            front = _mm256_add_ps(front, _mm256_mul_ps(x, _mm256_set1_ps(t.imdctShort[i][k])));
+                            back = _mm256_add_ps(back, _mm256_mul_ps(x, _mm256_set1_ps(t.imdctShort[6 + i][k])));
+                        }
+                        zw[i] = _mm256_add_ps(zw[i], _mm256_mul_ps(front, _mm256_set1_ps(window[i])));
+                        zw[5 - i] = _mm256_add_ps(
+                            zw[5 - i], _mm256_mul_ps(_mm256_xor_ps(front, sign), _mm256_set1_ps(window[5 - i])));
+                        zw[6 + i] = _mm256_add_ps(zw[6 + i], _mm256_mul_ps(back, _mm256_set1_ps(window[6 + i])));
+                        zw[11 - i] = _mm256_add_ps(zw[11 - i], _mm256_mul_ps(back, _mm256_set1_ps(window[11 - i])));
+                    }
+                }
+                for (int i = 0; i < 36; ++i) {
+                    // Bloco misto: as duas primeiras sub-bandas ficam com a IMDCT longa
+                    z[i] = mixed ? _mm256_blend_ps(zs[i], z[i], 0x03) : zs[i];
+                }
+            }
+        } else {
+            for (int i = 0; i < 36; ++i) {
+                z[i] = _mm256_setzero_ps();
+            }
+        }
+
+        for (int i = 0; i < 18; ++i) {
+            __m256 sample = _mm256_add_ps(z[i], _mm256_loadu_ps(state.overlap[i] + sb));
+            _mm256_storeu_ps(state.overlap[i] + sb, z[18 + i]);
+            if (i & 1) {
+                sample = _mm256_xor_ps(sample, oddLanes);
+            }
+            _mm256_storeu_ps(samples[i] + sb, sample);
+        }
+    }
+    return Mp3Filterbank::SUBBANDS;
+}
+
+MP3PLAYER_TARGET_AVX2 size_t synthesizeAvx2(ConstSamples samples, Mp3Filterbank::State& state, float* out,
+                                            int stride) {
+    const Mp3FilterbankTables& t = kMp3Filterbank;
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    alignas(32) float pcm[32];
+
+    for (int slot = 0; slot < Mp3Filterbank::SLOTS; ++slot) {
+        state.offset = (state.offset - 64) & 1023;
+        const float* s = samples[slot];
+
+        __m256 u[4];
+        for (int q = 0; q < 4; ++q) {
+            u[q] = _mm256_setzero_ps();
+        }
+        for (int k = 0; k < 32; ++k) {
+            const __m256 sk = _mm256_set1_ps(s[k]);
+            for (int q = 0; q < 4; ++q) {
+                u[q] = _mm256_add_ps(u[q], _mm256_mul_ps(_mm256_loadu_ps(t.synthMatrix[k] + 8 * q), sk));
+            }
+        }
+
+        float* v = state.v + state.offset;
+        for (int q = 0; q < 2; ++q) {
+            const __m256 reversed = _mm256_permutevar8x32_ps(u[q], reverse);
+            _mm256_storeu_ps(v + 8 * q, u[q]);
+            _mm256_storeu_ps(v + 25 - 8 * q, _mm256_xor_ps(reversed, sign));
+        }
+        v[16] = 0.0f;
+        for (int q = 2; q < 4; ++q) {
+            const __m256 reversed = _mm256_permutevar8x32_ps(u[q], reverse);
+            _mm256_storeu_ps(v + 17 + 8 * q, u[q]);
+            _mm256_storeu_ps(v + 72 - 8 * q, reversed);
+        }
+
+        float* dst = stride == 1 ? out + slot * 32 : pcm;
+        for (int j = 0; j < 32; j += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (int i = 0; i < 8; ++i) {
+                const float* a = state.v + ((state.offset + 128 * i) & 1023) + j;
+                const float* b = state.v + ((state.offset + 128 * i + 96) & 1023) + j;
+                sum = _mm256_add_ps(sum,
+                                    _mm256_mul_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(t.synthWindow + 64 * i + j)));
+                sum = _mm256_add_ps(
+                    sum, _mm256_mul_ps(_mm256_loadu_ps(b), _mm256_loadu_ps(t.synthWindow + 64 * i + 32 + j)));
+            }
+            _mm256_storeu_ps(dst + j, sum);
+        }
+        if (stride != 1) {
+            storeSlots(pcm, out, slot, stride);
+        }
+    }
+    return Mp3Filterbank::SLOTS;
+}
+
+#endif
+
+} // namespace
+
+void Mp3Filterbank::inverseMdct(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                                State& state, float (*samples)[SUBBANDS]) {
+    inverseMdct(spectrum, blockType, mixedBlock, activeSubbands, state, samples, CpuFeatures::getSimdLevel());
+}
+
+void Mp3Filterbank::inverseMdct(const float* spectrum, int blockType, bool mixedBlock, int activeSubbands,
+                                State& state, float (*samples)[SUBBANDS], CpuFeatures::SimdLevel level) {
+    size_t sb = 0;
+    switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            sb = inverseMdctAvx2(spectrum, blockType, mixedBlock, activeSubbands, state, samples);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            sb = inverseMdctSse2(spectrum, blockType, mixedBlock, activeSubbands, state, samples);
+            break;
+#endif
+        default:
+            break;
+    }
+    inverseMdctScalar(spectrum, blockType, mixedBlock, activeSubbands, state, samples, static_cast<int>(sb));
+}
+
+void Mp3Filterbank::synthesize(const float (*samples)[SUBBANDS], State& state, float* out, int stride) {
+    synthesize(samples, state, out, stride, CpuFeatures::getSimdLevel());
+}
+
+void Mp3Filterbank::synthesize(const float (*samples)[SUBBANDS], State& state, float* out, int stride,
+                               CpuFeatures::SimdLevel level) {
+    size_t slot = 0;
+    switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            slot = synthesizeAvx2(samples, state, out, stride);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            slot = synthesizeSse2(samples, state, out, stride);
+            break;
+#endif
+        default:
+            break;
+    }
+    synthesizeScalar(samples, state, out, stride, static_cast<int>(slot));
+}
@@ -0,0 +1,89 @@
+#include "Mp3FrameIndex.h"
+#include <algorithm>
+
+Mp3FrameIndex::Mp3FrameIndex(int frameSamples)
+    : samplesPerFrame(frameSamples), lastOffset(0) {}
+
+Mp3FrameIndex::Mp3FrameIndex(int frameSamples, const View& external, std::shared_ptr<const void> owner)
+    : samplesPerFrame(frameSamples), lastOffset(0), mappedView(external), mappingOwner(std::move(owner)) {}
+
+Mp3FrameIndex::View Mp3FrameIndex::view() const {
+    if (mappingOwner) {
+        return mappedView;
+    }
+    View owned;
+    owned.checkpoints = checkpoints.data();
+    owned.checkpointCount = checkpoints.size();
+    owned.frameSpans = frameSpans.data();
+    owned.frameCount = frameSpans.size();
+    owned.longSpans = longSpans.data();
+    owned.longSpanCount = longSpans.size();
+    return owned;
+}
+
+void Mp3FrameIndex::reserve(size_t frames) {
+    frameSpans.reserve(frames);
+    checkpoints.reserve(frames / CHECKPOINT_INTERVAL + 1);
+}
+
+void Mp3FrameIndex::addFrame(uint64_t offset, size_t bytes) {
+    // A distância real do quadro anterior só é conhecida agora (pode haver lixo entre eles)
+    if (!frameSpans.empty()) {
+        uint64_t span = offset - lastOffset;
+        if (span <= 0xFFFF) {
+            frameSpans.back() = static_cast<uint16_t>(span);
+        } else {
+            frameSpans.back() = 0;
+            longSpans.push_back({frameSpans.size() - 1, span});
+        }
+    }
+
+    if (frameSpans.size() % CHECKPOINT_INTERVAL == 0) {
+        checkpoints.push_back(offset);
+    }
+    frameSpans.push_back(static_cast<uint16_t>(bytes));
+    lastOffset = offset;
+}
+
+uint64_t Mp3FrameIndex::getFrameSpan(size_t frame) const {
+    const View data = view();
+    uint16_t span = data.frameSpans[frame];
+    if (span != 0) {
+        return span;
+    }
+    const LongSpan* end = data.longSpans + data.longSpanCount;
+    const LongSpan* it = std::lower_bound(data.longSpans, end, static_cast<uint64_t>(frame),
+                                          [](const LongSpan& entry, uint64_t value) {
+                                              return entry.frame < value;
+                                          });
+    return it != end && it->frame == frame ? it->bytes : 0;
+}
+
+uint64_t Mp3FrameIndex::getTotalSamples() const {
+    return static_cast<uint64_t>(getFrameCount()) * static_cast<uint64_t>(samplesPerFrame);
+}
+
+uint64_t Mp3FrameIndex::getFrameOffset(size_t frame) const {
+    const View data = view();
+    const size_t group = frame / CHECKPOINT_INTERVAL;
+    uint64_t offset = data.checkpoints[group];
+    for (size_t i = group * CHECKPOINT_INTERVAL; i < frame; ++i) {
+        offset += data.frameSpans[i] != 0 ? data.frameSpans[i] : getFrameSpan(i);
+    }
+    return offset;
+}
+
+size_t Mp3FrameIndex::findFrameForSample(uint64_t sample) const {
+    const size_t frames = getFrameCount();
+    if (frames == 0) {
+        return 0;
+    }
+    size_t frame = static_cast<size_t>(sample / static_cast<uint64_t>(samplesPerFrame));
+    return std::min(frame, frames - 1);
+}
+
+size_t Mp3FrameIndex::getMemoryUsage() const {
+    const View data = view();
+    return data.checkpointCount * sizeof(uint64_t) + data.frameCount * sizeof(uint16_t) +
+           data.longSpanCount * sizeof(LongSpan);
+}
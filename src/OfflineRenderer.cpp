@@ -0,0 +1,247 @@
+#include "OfflineRenderer.h"
+#include "AudioEngine.h"
+#include "ResamplingDecoder.h"
+#include "VolumeStage.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr size_t COPY_FRAMES = 16384; // Quadros por leitura ao concatenar
+
+// Adapta o número de canais: mono é duplicado, saída mono recebe a média, demais layouts
+// mapeiam canal a canal (canais de entrada excedentes são descartados)
+void mapChannels(const float* input, int inputChannels, float* output, int outputChannels, size_t frames) {
+    if (inputChannels == outputChannels) {
+        std::copy_n(input, frames * static_cast<size_t>(inputChannels), output);
+        return;
+    }
+    for (size_t f = 0; f < frames; ++f) {
+        const float* in = input + f * static_cast<size_t>(inputChannels);
+        float* out = output + f * static_cast<size_t>(outputChannels);
+        if (outputChannels == 1) {
+            float sum = 0.0f;
+            for (int c = 0; c < inputChannels; ++c) {
+                sum += in[c];
+            }
+            out[0] = sum / static_cast<float>(inputChannels);
+        } else {
+            for (int c = 0; c < outputChannels; ++c) {
+                out[c] = in[std::min(c, inputChannels - 1)];
+            }
+        }
+    }
+}
+
+} // namespace
+
+// Faixa renderizada por uma thread do pool e entregue à thread de render() pelo estado
+struct OfflineRenderer::Slot {
+    enum class State { PENDING, DONE, FAILED };
+
+    State state = State::PENDING;   // Protegido pelo mutex de render()
+    std::FILE* file = nullptr;      // Float32 intercalado no formato de saída (apagado ao fechar)
+    uint64_t frames = 0;
+    std::string error;
+
+    Slot() = default;
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+    ~Slot() {
+        if (file) {
+            std::fclose(file);
+        }
+    }
+};
+
+OfflineRenderer::OfflineRenderer() : OfflineRenderer(Options()) {}
+
+OfflineRenderer::OfflineRenderer(Options renderOptions) : options(std::move(renderOptions)), cancelRequested(false) {}
+
+bool OfflineRenderer::renderTrack(const Track& track, int rate, int channels, Slot& slot) const {
+    try {
+        std::unique_ptr<AudioDecoder> decoder = AudioDecoder::createForFile(track.getFilePath());
+        if (decoder->getSampleRate() != rate) {
+            decoder = std::make_unique<ResamplingDecoder>(std::move(decoder), rate, options.quality);
+        }
+        const int sourceChannels = decoder->getChannels();
+
+        // Cópias próprias: nenhum estado compartilhado entre as threads do pool
+        Equalizer equalizer;
+        if (options.equalizer) {
+            equalizer = *options.equalizer;
+        }
+        equalizer.setSampleRate(rate);
+        VolumeStage volume(options.volume);
+        volume.setLimiterEnabled(options.limiter);
+        if (options.replayGain != MP3Player::ReplayGainMode::OFF) {
+            volume.setNormalizationGain(track.getReplayGainDb(options.replayGain == MP3Player::ReplayGainMode::ALBUM));
+        }
+        volume.prepare(rate);
+
+        slot.file = std::tmpfile();
+        if (!slot.file) {
+            slot.error = "não foi possível criar arquivo temporário";
+            return false;
+        }
+
+        // O limitador atrasa o sinal: descartar o início e empurrar o mesmo tanto de silêncio
+        size_t skip = volume.getLatencyFrames();
+        size_t tail = skip;
+        const size_t blockFrames = AudioEngine::BLOCK_FRAMES;
+        std::vector<float> decoded(blockFrames * static_cast<size_t>(sourceChannels));
+        std::vector<float> block(blockFrames * static_cast<size_t>(channels));
+        while (true) {
+            if (cancelRequested.load(std::memory_order_relaxed)) {
+                slot.error = "cancelado";
+                return false;
+            }
+            size_t frames = decoder->decode(decoded.data(), blockFrames);
+            if (frames > 0) {
+                mapChannels(decoded.data(), sourceChannels, block.data(), channels, frames);
+                equalizer.process(block.data(), frames, channels);
+            } else if (tail > 0) {
+                frames = std::min(tail, blockFrames);
+                tail -= frames;
+                std::fill_n(block.begin(), frames * static_cast<size_t>(channels), 0.0f);
+            } else {
+                break;
+            }
+            volume.process(block.data(), frames, channels);
+
+            const size_t dropped = std::min(skip, frames);
+            skip -= dropped;
+            const size_t kept = frames - dropped;
+            if (kept > 0 && std::fwrite(block.data() + dropped * static_cast<size_t>(channels),
+                                        sizeof(float) * static_cast<size_t>(channels), kept, slot.file) != kept) {
+                slot.error = "falha ao gravar arquivo temporário";
+                return false;
+            }
+            slot.frames += kept;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        slot.error = e.what();
+        return false;
+    }
+}
+
+OfflineRenderer::Result OfflineRenderer::render(const std::vector<std::shared_ptr<Track>>& tracks,
+                                                const std::string& outputPath, ProgressCallback progress) {
+    using Clock = std::chrono::steady_clock;
+    const auto begin = Clock::now();
+    cancelRequested.store(false);
+    Result result;
+    result.tracks = tracks.size();
+
+    // Formato de saída: o das opções ou o da primeira faixa que abrir
+    int rate = options.sampleRate;
+    int channels = options.channels;
+    if (rate <= 0 || channels <= 0) {
+        for (const auto& track : tracks) {
+            try {
+                if (track) {
+                    auto decoder = AudioDecoder::createForFile(track->getFilePath());
+                    rate = rate > 0 ? rate : decoder->getSampleRate();
+                    channels = channels > 0 ? channels : decoder->getChannels();
+                    break;
+                }
+            } catch (const AudioDecoder::DecoderException&) {
+                // Tentar a próxima; a falha aparece de novo no resultado
+            }
+        }
+        if (rate <= 0 || channels <= 0) {
+            throw RenderException("Nenhuma faixa da playlist pôde ser aberta");
+        }
+    }
+    channels = std::min(channels, VolumeStage::MAX_CHANNELS);
+
+    WavFileSink sink(outputPath, options.format);
+    if (!sink.open(rate, channels)) {
+        throw RenderException("Não foi possível criar o arquivo de saída: " + outputPath);
+    }
+    result.sampleRate = rate;
+    result.channels = channels;
+
+    // Pool fixo: cada thread pega a próxima faixa e a deixa pronta no seu slot
+    std::vector<Slot> slots(tracks.size());
+    std::mutex slotMutex;
+    std::condition_variable slotFinished;
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        while (!cancelRequested.load(std::memory_order_relaxed)) {
+            const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= tracks.size()) {
+                return;
+            }
+            Slot& slot = slots[i];
+            bool ok = false;
+            if (tracks[i]) {
+                ok = renderTrack(*tracks[i], rate, channels, slot);
+            } else {
+                slot.error = "faixa inválida";
+            }
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                slot.state = ok ? Slot::State::DONE : Slot::State::FAILED;
+            }
+            slotFinished.notify_all();
+        }
+    };
+    const unsigned threadCount = options.threads > 0 ? options.threads
+                                                     : std::max(1u, std::thread::hardware_concurrency());
+    result.threads = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(tracks.size(), 1)));
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < result.threads; ++t) {
+        pool.emplace_back(worker);
+    }
+
+    // Concatenação em ordem enquanto as faixas seguintes ainda renderizam
+    std::vector<float> buffer(COPY_FRAMES * static_cast<size_t>(channels));
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Slot& slot = slots[i];
+        {
+            std::unique_lock<std::mutex> lock(slotMutex);
+            while (slot.state == Slot::State::PENDING && !cancelRequested.load()) {
+                slotFinished.wait_for(lock, std::chrono::milliseconds(50)); // cancel() não notifica
+            }
+        }
+        if (cancelRequested.load()) {
+            break;
+        }
+        const std::string path = tracks[i] ? tracks[i]->getFilePath() : std::string();
+        if (slot.state == Slot::State::FAILED) {
+            ++result.failed;
+            result.errors.push_back(path + ": " + slot.error);
+        } else {
+            std::rewind(slot.file);
+            size_t frames = 0;
+            while ((frames = std::fread(buffer.data(), sizeof(float) * static_cast<size_t>(channels), COPY_FRAMES,
+                                        slot.file)) > 0) {
+                sink.write(buffer.data(), frames);
+            }
+            std::fclose(slot.file); // Libera o espaço temporário já
+            slot.file = nullptr;
+            ++result.rendered;
+            result.frames += slot.frames;
+        }
+        if (progress) {
+            progress(i + 1, slots.size(), path);
+        }
+    }
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    sink.close();
+
+    result.cancelled = cancelRequested.load();
+    result.audioSeconds = static_cast<double>(result.frames) / rate;
+    result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    result.speedFactor = result.seconds > 0.0 ? result.audioSeconds / result.seconds : 0.0;
+    return result;
+}
@@ -0,0 +1,355 @@
+#include "OggDemuxer.h"
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t FLAG_CONTINUED = 0x01;
+constexpr uint8_t FLAG_BOS = 0x02;
+constexpr uint8_t FLAG_EOS = 0x04;
+
+constexpr size_t TAIL_CHUNK_BYTES = 64 * 1024;
+
+// CRC-32 do Ogg: polinômio 0x04c11db7, sem reflexão, valor inicial e final 0.
+// Tabelas para 8 bytes por passo (slicing-by-8): table[k][i] é o CRC do byte i seguido de
+// k bytes zero, então os 8 bytes são consultados de forma independente em vez de em cadeia
+constexpr std::array<std::array<uint32_t, 256>, 8> makeCrcTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t r = i << 24;
+        for (int bit = 0; bit < 8; ++bit) {
+            r = (r & 0x80000000u) ? (r << 1) ^ 0x04c11db7u : r << 1;
+        }
+        tables[0][i] = r;
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            const uint32_t previous = tables[k - 1][i];
+            tables[k][i] = (previous << 8) ^ tables[0][previous >> 24];
+        }
+    }
+    return tables;
+}
+
+constexpr std::array<std::array<uint32_t, 256>, 8> CRC_TABLES = makeCrcTables();
+
+uint32_t readLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+int64_t readLe64(const uint8_t* p) {
+    return static_cast<int64_t>(static_cast<uint64_t>(readLe32(p)) | (static_cast<uint64_t>(readLe32(p + 4)) << 32));
+}
+
+bool isCapture(const uint8_t* p) {
+    return p[0] == 'O' && p[1] == 'g' && p[2] == 'g' && p[3] == 'S';
+}
+
+// Próximo padrão "OggS" em [from, size); size se não houver
+uint64_t findCapture(const uint8_t* data, uint64_t from, uint64_t size) {
+    while (from + 4 <= size) {
+        const void* hit = std::memchr(data + from, 'O', static_cast<size_t>(size - from - 3));
+        if (!hit) {
+            break;
+        }
+        from = static_cast<uint64_t>(static_cast<const uint8_t*>(hit) - data);
+        if (isCapture(data + from)) {
+            return from;
+        }
+        ++from;
+    }
+    return size;
+}
+
+} // namespace
+
+uint32_t OggDemuxer::crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    const auto& t = CRC_TABLES;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        const uint32_t high = crc ^ ((static_cast<uint32_t>(data[i]) << 24) | (static_cast<uint32_t>(data[i + 1]) << 16) |
+                                     (static_cast<uint32_t>(data[i + 2]) << 8) | data[i + 3]);
+        crc = t[7][high >> 24] ^ t[6][(high >> 16) & 0xff] ^ t[5][(high >> 8) & 0xff] ^ t[4][high & 0xff] ^
+              t[3][data[i + 4]] ^ t[2][data[i + 5]] ^ t[1][data[i + 6]] ^ t[0][data[i + 7]];
+    }
+    for (; i < length; ++i) {
+        crc = (crc << 8) ^ t[0][((crc >> 24) ^ data[i]) & 0xff];
+    }
+    return crc;
+}
+
+OggDemuxer::OggDemuxer()
+    : serial(0), pageLoaded(false), readOffset(0), segmentIndex(0), bodyPosition(0), finished(true),
+      indexBuilt(false), indexStart(0) {}
+
+bool OggDemuxer::open(const std::string& path) {
+    close();
+    if (!file.open(path, true)) {
+        return false;
+    }
+
+    // Os streams lógicos começam todos nas páginas BOS do início do arquivo
+    uint64_t offset = 0;
+    Page header;
+    while (parsePage(offset, true, header) && (header.flags & FLAG_BOS)) {
+        serials.push_back(header.serial);
+        offset = header.nextOffset;
+    }
+    if (serials.empty()) {
+        close();
+        return false;
+    }
+    assembly.reserve(MAX_PAGE_BYTES);
+    selectStream(serials.front());
+    return true;
+}
+
+void OggDemuxer::close() {
+    file.close();
+    serials.clear();
+    serial = 0;
+    pageLoaded = false;
+    readOffset = 0;
+    finished = true;
+    assembly.clear();
+    index.clear();
+    indexBuilt = false;
+    statistics = Statistics();
+}
+
+void OggDemuxer::selectStream(uint32_t serialNumber) {
+    if (serialNumber != serial) {
+        index.clear();
+        indexBuilt = false;
+    }
+    serial = serialNumber;
+    seekToPage(0);
+}
+
+void OggDemuxer::seekToPage(uint64_t offset) {
+    pageLoaded = false;
+    readOffset = offset;
+    segmentIndex = 0;
+    bodyPosition = 0;
+    finished = !file.isOpen();
+}
+
+bool OggDemuxer::parsePage(uint64_t offset, bool verifyCrc, Page& out) const {
+    const uint64_t size = file.size();
+    if (offset + HEADER_BYTES > size) {
+        return false;
+    }
+    const uint8_t* p = file.data() + offset;
+    if (!isCapture(p) || p[4] != 0) {
+        return false;
+    }
+    const size_t segmentCount = p[26];
+    const size_t headerBytes = HEADER_BYTES + segmentCount;
+    if (offset + headerBytes > size) {
+        return false;
+    }
+    size_t bodyBytes = 0;
+    for (size_t i = 0; i < segmentCount; ++i) {
+        bodyBytes += p[HEADER_BYTES + i];
+    }
+    if (offset + headerBytes + bodyBytes > size) {
+        return false;
+    }
+
+    if (verifyCrc) {
+        // O campo do CRC entra no cálculo como zero
+        static const uint8_t zeros[4] = {0, 0, 0, 0};
+        uint32_t crc = crc32(p, 22);
+        crc = crc32(zeros, 4, crc);
+        crc = crc32(p + 26, headerBytes + bodyBytes - 26, crc);
+        if (crc != readLe32(p + 22)) {
+            return false;
+        }
+    }
+
+    out.offset = offset;
+    out.nextOffset = offset + headerBytes + bodyBytes;
+    out.flags = p[5];
+    out.granule = readLe64(p + 6);
+    out.serial = readLe32(p + 14);
+    out.segments = p + HEADER_BYTES;
+    out.segmentCount = segmentCount;
+    out.body = p + headerBytes;
+    return true;
+}
+
+bool OggDemuxer::findPage(uint64_t offset, bool verifyCrc, Page& out) {
+    const uint8_t* data = file.data();
+    const uint64_t size = file.size();
+    while (offset + HEADER_BYTES <= size) {
+        if (parsePage(offset, verifyCrc, out)) {
+            return true;
+        }
+        if (isCapture(data + offset)) {
+            ++statistics.crcFailures;
+        }
+        // Ressincroniza no próximo padrão de captura
+        const uint64_t next = findCapture(data, offset + 1, size);
+        statistics.bytesSkipped += next - offset;
+        offset = next;
+    }
+    return false;
+}
+
+bool OggDemuxer::loadNextPage(uint64_t offset) {
+    Page candidate;
+    while (findPage(offset, true, candidate)) {
+        if (candidate.serial == serial) {
+            page = candidate;
+            pageLoaded = true;
+            segmentIndex = 0;
+            bodyPosition = 0;
+            ++statistics.pages;
+            return true;
+        }
+        offset = candidate.nextOffset; // Outro stream lógico multiplexado
+    }
+    pageLoaded = false;
+    return false;
+}
+
+bool OggDemuxer::nextPacket(Packet& packet) {
+    bool assembling = false;
+    uint64_t startPage = 0;
+    assembly.clear();
+
+    while (true) {
+        if (!pageLoaded || segmentIndex >= page.segmentCount) {
+            if (finished) {
+                return false;
+            }
+            if (pageLoaded && (page.flags & FLAG_EOS)) {
+                finished = true;
+                return false;
+            }
+            if (!loadNextPage(pageLoaded ? page.nextOffset : readOffset)) {
+                finished = true;
+                return false;
+            }
+
+            const bool continued = (page.flags & FLAG_CONTINUED) != 0;
+            if (continued && !assembling) {
+                // Final de um pacote cujo início não foi lido (seek ou página perdida)
+                while (segmentIndex < page.segmentCount) {
+                    const uint8_t length = page.segments[segmentIndex++];
+                    bodyPosition += length;
+                    if (length < 255) {
+                        break;
+                    }
+                }
+                continue;
+            }
+            if (!continued && assembling) {
+                // A continuação se perdeu: o pacote incompleto é descartado
+                assembly.clear();
+                assembling = false;
+            }
+        }
+
+        // Segmentos de 255 bytes continuam o pacote; o primeiro menor o termina
+        if (!assembling) {
+            startPage = page.offset;
+        }
+        const size_t start = bodyPosition;
+        size_t length = 0;
+        bool complete = false;
+        while (segmentIndex < page.segmentCount) {
+            const uint8_t segment = page.segments[segmentIndex++];
+            length += segment;
+            if (segment < 255) {
+                complete = true;
+                break;
+            }
+        }
+        bodyPosition += length;
+
+        if (!complete) {
+            assembly.insert(assembly.end(), page.body + start, page.body + start + length);
+            assembling = true;
+            continue;
+        }
+
+        if (assembling) {
+            assembly.insert(assembly.end(), page.body + start, page.body + start + length);
+            packet.data = assembly.data();
+            packet.size = assembly.size();
+            ++statistics.packetsAssembled;
+        } else {
+            packet.data = page.body + start;
+            packet.size = length;
+        }
+
+        // O granule da página vale para o último pacote que termina nela
+        bool last = true;
+        for (size_t i = segmentIndex; i < page.segmentCount; ++i) {
+            if (page.segments[i] < 255) {
+                last = false;
+                break;
+            }
+        }
+        packet.granule = last ? page.granule : -1;
+        packet.endOfStream = last && (page.flags & FLAG_EOS) != 0;
+        packet.pageOffset = startPage;
+        return true;
+    }
+}
+
+const std::vector<OggDemuxer::PageEntry>& OggDemuxer::getPageIndex(uint64_t startOffset) {
+    if (indexBuilt && indexStart == startOffset) {
+        return index;
+    }
+    index.clear();
+
+    // Só os cabeçalhos são lidos; o CRC fica para quando a página for decodificada
+    uint64_t offset = startOffset;
+    Page candidate;
+    while (findPage(offset, false, candidate)) {
+        if (candidate.serial == serial) {
+            if (candidate.granule != -1) {
+                index.push_back({candidate.offset, candidate.nextOffset, candidate.granule});
+            }
+            if (candidate.flags & FLAG_EOS) {
+                break;
+            }
+        }
+        offset = candidate.nextOffset;
+    }
+    indexBuilt = true;
+    indexStart = startOffset;
+    return index;
+}
+
+int64_t OggDemuxer::findLastGranule() {
+    if (indexBuilt && !index.empty()) {
+        return index.back().granule;
+    }
+
+    // Blocos de trás para frente até achar uma página do stream com granule
+    const uint8_t* data = file.data();
+    uint64_t end = file.size();
+    while (end > 0) {
+        const uint64_t begin = end > TAIL_CHUNK_BYTES ? end - TAIL_CHUNK_BYTES : 0;
+        int64_t granule = -1;
+        Page candidate;
+        for (uint64_t offset = findCapture(data, begin, file.size()); offset < end;
+             offset = findCapture(data, offset + 1, file.size())) {
+            if (parsePage(offset, true, candidate) && candidate.serial == serial && candidate.granule != -1) {
+                granule = candidate.granule;
+                if (candidate.flags & FLAG_EOS) {
+                    break;
+                }
+            }
+        }
+        if (granule != -1) {
+            return granule;
+        }
+        end = begin;
+    }
+    return -1;
+}
@@ -0,0 +1,334 @@
+#include "PartitionedConvolver.h"
+#include "CpuFeatures.h"
+#include "Fft.h"
+#include "WavReader.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// acc += x * h para bins complexos em formato dividido
+void multiplyAccumulateScalar(const float* xr, const float* xi, const float* hr, const float* hi, float* accR,
+                              float* accI, size_t begin, size_t bins) {
+    for (size_t k = begin; k < bins; ++k) {
+        accR[k] += xr[k] * hr[k] - xi[k] * hi[k];
+        accI[k] += xr[k] * hi[k] + xi[k] * hr[k];
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+void multiplyAccumulateSse2(const float* xr, const float* xi, const float* hr, const float* hi, float* accR,
+                            float* accI, size_t bins) {
+    size_t k = 0;
+    for (; k + 4 <= bins; k += 4) {
+        const __m128 xR = _mm_loadu_ps(xr + k), xI = _mm_loadu_ps(xi + k);
+        const __m128 hR = _mm_loadu_ps(hr + k), hI = _mm_loadu_ps(hi + k);
+        const __m128 re = _mm_sub_ps(_mm_mul_ps(xR, hR), _mm_mul_ps(xI, hI));
+        const __m128 im = _mm_add_ps(_mm_mul_ps(xR, hI), _mm_mul_ps(xI, hR));
+        _mm_storeu_ps(accR + k, _mm_add_ps(_mm_loadu_ps(accR + k), re));
+        _mm_storeu_ps(accI + k, _mm_add_ps(_mm_loadu_ps(accI + k), im));
+    }
+    multiplyAccumulateScalar(xr, xi, hr, hi, accR, accI, k, bins);
+}
+
+MP3PLAYER_TARGET_AVX2_FMA void multiplyAccumulateAvx2(const float* xr, const float* xi, const float* hr,
+                                                      const float* hi, float* accR, float* accI, size_t bins) {
+    size_t k = 0;
+    for (; k + 8 <= bins; k += 8) {
+        const __m256 xR = _mm256_loadu_ps(xr + k), xI = _mm256_loadu_ps(xi + k);
+        const __m256 hR = _mm256_loadu_ps(hr + k), hI = _mm256_loadu_ps(hi + k);
+        __m256 re = _mm256_fmadd_ps(xR, hR, _mm256_loadu_ps(accR + k));
+        __m256 im = _mm256_fmadd_ps(xR, hI, _mm256_loadu_ps(accI + k));
+        re = _mm256_fnmadd_ps(xI, hI, re);
+        im = _mm256_fmadd_ps(xI, hR, im);
+        _mm256_storeu_ps(accR + k, re);
+        _mm256_storeu_ps(accI + k, im);
+    }
+    multiplyAccumulateScalar(xr, xi, hr, hi, accR, accI, k, bins);
+}
+
+#endif
+
+// Vetor de floats com início alinhado a linha de cache (loads AVX2 sem cruzar linhas)
+class AlignedBuffer {
+private:
+    static constexpr size_t ALIGN_FLOATS = 16;
+    std::vector<float> storage;
+    float* begin = nullptr;
+
+public:
+    AlignedBuffer() = default;
+    AlignedBuffer(const AlignedBuffer&) = delete; // begin aponta para dentro de storage
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    void assign(size_t count) {
+        storage.assign(count + ALIGN_FLOATS, 0.0f);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+        const uintptr_t aligned = (address + ALIGN_FLOATS * sizeof(float) - 1) & ~(ALIGN_FLOATS * sizeof(float) - 1);
+        begin = storage.data() + (aligned - address) / sizeof(float);
+    }
+    float* data() { return begin; }
+    const float* data() const { return begin; }
+
+    // Distância entre espectros: bins arredondados para múltiplo de uma linha de cache
+    static size_t paddedStride(size_t count) { return (count + ALIGN_FLOATS - 1) & ~(ALIGN_FLOATS - 1); }
+};
+
+} // namespace
+
+// Filtros de uma resposta ao impulso + estado de um stream (partitions == 0: sinal inalterado)
+struct PartitionedConvolver::Kernel {
+    size_t block = 0;
+    size_t bins = 0;
+    size_t binStride = 0;                 // bins com preenchimento até a próxima linha de cache
+    size_t partitions = 0;
+    int channels = 0;
+    CpuFeatures::SimdLevel level = CpuFeatures::SimdLevel::Scalar;
+    std::unique_ptr<Fft> fft;
+
+    // Espectros das partições: [canal da IR][partição][bin]
+    AlignedBuffer filterRe;
+    AlignedBuffer filterIm;
+    std::vector<size_t> filterOffset;     // Canal do stream -> início dos seus filtros
+
+    // Linha de atraso de espectros de entrada: [canal][partição][bin], circular em head
+    AlignedBuffer spectraRe;
+    AlignedBuffer spectraIm;
+    size_t head = 0;
+
+    std::vector<float> window;            // [canal][2B]: bloco anterior + bloco atual
+    std::vector<float> inputBlock;        // B quadros intercalados sendo acumulados
+    std::vector<float> outputBlock;       // Saída do bloco anterior (latência de B quadros)
+    size_t fill = 0;
+    AlignedBuffer accumRe;
+    AlignedBuffer accumIm;
+    std::vector<float> timeBuffer;
+
+    Kernel() = default;
+
+    Kernel(const ImpulseResponse& impulse, size_t blockFrames, int streamChannels)
+        : block(blockFrames), bins(blockFrames + 1), binStride(AlignedBuffer::paddedStride(blockFrames + 1)),
+          partitions((impulse.frames + blockFrames - 1) / blockFrames), channels(streamChannels),
+          level(CpuFeatures::getSimdLevel()), fft(std::make_unique<Fft>(2 * blockFrames)) {
+        if (level == CpuFeatures::SimdLevel::AVX2 && !CpuFeatures::get().fma) {
+            level = CpuFeatures::SimdLevel::SSE2; // Kernel AVX2 usa FMA
+        }
+
+        // Canais da IR usados: um por canal do stream, repetindo o último se faltarem
+        const size_t irChannels = static_cast<size_t>(std::min(impulse.channels, streamChannels));
+        const size_t perChannel = partitions * binStride;
+        filterRe.assign(irChannels * perChannel);
+        filterIm.assign(irChannels * perChannel);
+        std::vector<float> segment(2 * block);
+        for (size_t ir = 0; ir < irChannels; ++ir) {
+            for (size_t p = 0; p < partitions; ++p) {
+                // Partição com B amostras seguida de B zeros
+                std::fill(segment.begin(), segment.end(), 0.0f);
+                const size_t first = p * block;
+                const size_t count = std::min(block, impulse.frames - first);
+                for (size_t t = 0; t < count; ++t) {
+                    segment[t] = impulse.samples[(first + t) * static_cast<size_t>(impulse.channels) + ir];
+                }
+                const size_t offset = ir * perChannel + p * binStride;
+                fft->forward(segment.data(), filterRe.data() + offset, filterIm.data() + offset, level);
+            }
+        }
+        for (int c = 0; c < channels; ++c) {
+            filterOffset.push_back(std::min(static_cast<size_t>(c), irChannels - 1) * perChannel);
+        }
+
+        const size_t streamCount = static_cast<size_t>(channels);
+        spectraRe.assign(streamCount * perChannel);
+        spectraIm.assign(streamCount * perChannel);
+        window.assign(streamCount * 2 * block, 0.0f);
+        inputBlock.assign(streamCount * block, 0.0f);
+        outputBlock.assign(streamCount * block, 0.0f);
+        accumRe.assign(binStride);
+        accumIm.assign(binStride);
+        timeBuffer.resize(2 * block);
+    }
+
+    void multiplyAccumulate(const float* xr, const float* xi, const float* hr, const float* hi) {
+        switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+            case CpuFeatures::SimdLevel::AVX2:
+                multiplyAccumulateAvx2(xr, xi, hr, hi, accumRe.data(), accumIm.data(), bins);
+                break;
+            case CpuFeatures::SimdLevel::SSE2:
+                multiplyAccumulateSse2(xr, xi, hr, hi, accumRe.data(), accumIm.data(), bins);
+                break;
+#endif
+            default:
+                multiplyAccumulateScalar(xr, xi, hr, hi, accumRe.data(), accumIm.data(), 0, bins);
+                break;
+        }
+    }
+
+    // Um bloco completo de B quadros: entra em inputBlock, sai em outputBlock
+    void runPartition() {
+        const size_t stride = static_cast<size_t>(channels);
+        const size_t perChannel = partitions * binStride;
+        for (size_t c = 0; c < stride; ++c) {
+            float* frame = window.data() + c * 2 * block;
+            std::copy(frame + block, frame + 2 * block, frame);
+            for (size_t t = 0; t < block; ++t) {
+                frame[block + t] = inputBlock[t * stride + c];
+            }
+
+            float* spectrumRe = spectraRe.data() + c * perChannel;
+            float* spectrumIm = spectraIm.data() + c * perChannel;
+            fft->forward(frame, spectrumRe + head * binStride, spectrumIm + head * binStride, level);
+
+            // Y = sum_p X[bloco - p] * H[p]
+            std::fill(accumRe.data(), accumRe.data() + bins, 0.0f);
+            std::fill(accumIm.data(), accumIm.data() + bins, 0.0f);
+            const float* hr = filterRe.data() + filterOffset[c];
+            const float* hi = filterIm.data() + filterOffset[c];
+            size_t slot = head;
+            for (size_t p = 0; p < partitions; ++p) {
+                multiplyAccumulate(spectrumRe + slot * binStride, spectrumIm + slot * binStride, hr + p * binStride,
+                                   hi + p * binStride);
+                slot = slot == 0 ? partitions - 1 : slot - 1;
+            }
+
+            // Overlap-save: só a segunda metade da convolução circular é válida
+            fft->inverse(accumRe.data(), accumIm.data(), timeBuffer.data(), level);
+            for (size_t t = 0; t < block; ++t) {
+                outputBlock[t * stride + c] = timeBuffer[block + t];
+            }
+        }
+        head = head + 1 == partitions ? 0 : head + 1;
+    }
+
+    void process(float* interleaved, size_t frames) {
+        const size_t stride = static_cast<size_t>(channels);
+        while (frames > 0) {
+            const size_t count = std::min(frames, block - fill);
+            float* in = inputBlock.data() + fill * stride;
+            const float* out = outputBlock.data() + fill * stride;
+            for (size_t i = 0; i < count * stride; ++i) {
+                const float sample = interleaved[i];
+                interleaved[i] = out[i];
+                in[i] = sample;
+            }
+            interleaved += count * stride;
+            frames -= count;
+            fill += count;
+            if (fill == block) {
+                runPartition();
+                fill = 0;
+            }
+        }
+    }
+};
+
+PartitionedConvolver::PartitionedConvolver(size_t partitionFrames)
+    : partitionFrames(partitionFrames), streamSampleRate(0), streamChannels(0), enabled(true), active(false),
+      pending(nullptr), current(nullptr) {
+    if (!Fft::isPowerOfTwo(partitionFrames) || 2 * partitionFrames < Fft::MIN_SIZE) {
+        throw std::invalid_argument("Tamanho de partição deve ser potência de 2 e >= 8");
+    }
+    for (auto& slot : retired) {
+        slot.store(nullptr);
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    delete pending.exchange(nullptr);
+    collectRetired();
+    delete current;
+}
+
+void PartitionedConvolver::loadImpulseResponse(const std::string& path) {
+    WavReader::Format format;
+    std::vector<float> samples = WavReader::loadFile(path, format);
+    setImpulseResponse(std::move(samples), format.channels, format.sampleRate, path);
+}
+
+void PartitionedConvolver::setImpulseResponse(std::vector<float> interleaved, int channels, int sampleRate,
+                                              const std::string& source) {
+    if (channels <= 0 || sampleRate <= 0 || interleaved.size() < static_cast<size_t>(channels)) {
+        throw std::invalid_argument("Resposta ao impulso vazia: " + source);
+    }
+    auto response = std::make_shared<ImpulseResponse>();
+    response->frames = interleaved.size() / static_cast<size_t>(channels);
+    if (response->frames > MAX_IMPULSE_FRAMES) {
+        throw std::invalid_argument("Resposta ao impulso longa demais: " + source);
+    }
+    response->samples = std::move(interleaved);
+    response->channels = channels;
+    response->sampleRate = sampleRate;
+    response->source = source;
+    impulse = std::move(response);
+    rebuild();
+}
+
+void PartitionedConvolver::clearImpulseResponse() {
+    impulse.reset();
+    rebuild();
+}
+
+bool PartitionedConvolver::prepare(int sampleRate, int channels) {
+    streamSampleRate = sampleRate;
+    streamChannels = channels;
+    rebuild(); // Também descarta o histórico do stream anterior
+    return active || !impulse || !enabled;
+}
+
+void PartitionedConvolver::setEnabled(bool enable) {
+    if (enable != enabled) {
+        enabled = enable;
+        rebuild();
+    }
+}
+
+size_t PartitionedConvolver::getPartitionCount() const {
+    return impulse ? (impulse->frames + partitionFrames - 1) / partitionFrames : 0;
+}
+
+void PartitionedConvolver::rebuild() {
+    active = enabled && impulse && streamSampleRate == impulse->sampleRate && streamChannels > 0 &&
+             streamChannels <= MAX_CHANNELS;
+    publish(active ? new Kernel(*impulse, partitionFrames, streamChannels) : new Kernel());
+}
+
+void PartitionedConvolver::publish(Kernel* kernel) {
+    collectRetired();
+    // Kernel substituído antes de a thread de áudio adotá-lo nunca foi visto por ela
+    delete pending.exchange(kernel, std::memory_order_acq_rel);
+}
+
+void PartitionedConvolver::collectRetired() {
+    for (auto& slot : retired) {
+        delete slot.exchange(nullptr, std::memory_order_acq_rel);
+    }
+}
+
+void PartitionedConvolver::adoptPending() {
+    // O kernel em uso volta por um slot livre; sem slot livre a troca fica para o próximo bloco
+    for (auto& slot : retired) {
+        if (slot.load(std::memory_order_acquire) == nullptr) {
+            Kernel* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+            if (next) {
+                slot.store(current, std::memory_order_release);
+                current = next;
+            }
+            return;
+        }
+    }
+}
+
+void PartitionedConvolver::process(float* interleaved, size_t frames, int channels) {
+    if (pending.load(std::memory_order_relaxed) != nullptr) {
+        adoptPending();
+    }
+    if (!current || current->partitions == 0 || channels != current->channels || !interleaved) {
+        return;
+    }
+    current->process(interleaved, frames);
+}
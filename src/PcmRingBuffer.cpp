@@ -0,0 +1,140 @@
+#include "PcmRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+size_t nextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+PcmRingBuffer::PcmRingBuffer(size_t capacityFrames, int channelCount)
+    : writeIndex(0), cachedReadIndex(0),
+      readIndex(0), cachedWriteIndex(0),
+      flushIndex(0), framesFlushed(0), peakFill(0),
+      capacity(nextPowerOfTwo(std::max<size_t>(capacityFrames, 2))),
+      mask(capacity - 1),
+      channels(std::max(channelCount, 1)),
+      storage(capacity * static_cast<size_t>(channels), 0.0f) {}
+
+size_t PcmRingBuffer::write(const float* interleaved, size_t frames) {
+    const uint64_t w = writeIndex.load(std::memory_order_relaxed);
+
+    size_t freeFrames = capacity - static_cast<size_t>(w - cachedReadIndex);
+    if (freeFrames < frames) {
+        // Só toca a linha de cache do consumidor quando a cópia local não basta
+        cachedReadIndex = readIndex.load(std::memory_order_acquire);
+        freeFrames = capacity - static_cast<size_t>(w - cachedReadIndex);
+    }
+
+    const size_t count = std::min(frames, freeFrames);
+    if (count == 0) {
+        return 0;
+    }
+
+    const size_t start = static_cast<size_t>(w) & mask;
+    const size_t firstPart = std::min(count, capacity - start);
+    const size_t stride = static_cast<size_t>(channels);
+    std::memcpy(&storage[start * stride], interleaved, firstPart * stride * sizeof(float));
+    if (count > firstPart) {
+        std::memcpy(&storage[0], interleaved + firstPart * stride,
+                    (count - firstPart) * stride * sizeof(float));
+    }
+
+    writeIndex.store(w + count, std::memory_order_release);
+
+    const size_t fill = static_cast<size_t>(w + count - cachedReadIndex);
+    if (fill > peakFill.load(std::memory_order_relaxed)) {
+        peakFill.store(fill, std::memory_order_relaxed); // Único escritor: o produtor
+    }
+    return count;
+}
+
+void PcmRingBuffer::applyPendingFlush() {
+    const uint64_t target = flushIndex.load(std::memory_order_acquire);
+    const uint64_t r = readIndex.load(std::memory_order_relaxed);
+    if (target > r) {
+        readIndex.store(target, std::memory_order_release);
+        framesFlushed.fetch_add(target - r, std::memory_order_relaxed);
+        cachedWriteIndex = std::max(cachedWriteIndex, target);
+    }
+}
+
+size_t PcmRingBuffer::read(float* interleaved, size_t frames) {
+    applyPendingFlush();
+
+    const uint64_t r = readIndex.load(std::memory_order_relaxed);
+
+    size_t available = static_cast<size_t>(cachedWriteIndex - r);
+    if (available < frames) {
+        cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+        available = static_cast<size_t>(cachedWriteIndex - r);
+    }
+
+    const size_t count = std::min(frames, available);
+    if (count == 0) {
+        return 0;
+    }
+
+    const size_t start = static_cast<size_t>(r) & mask;
+    const size_t firstPart = std::min(count, capacity - start);
+    const size_t stride = static_cast<size_t>(channels);
+    std::memcpy(interleaved, &storage[start * stride], firstPart * stride * sizeof(float));
+    if (count > firstPart) {
+        std::memcpy(interleaved + firstPart * stride, &storage[0],
+                    (count - firstPart) * stride * sizeof(float));
+    }
+
+    readIndex.store(r + count, std::memory_order_release);
+    return count;
+}
+
+void PcmRingBuffer::requestFlush() {
+    // Avança o alvo de flush monotonicamente até o índice de escrita atual
+    const uint64_t w = writeIndex.load(std::memory_order_acquire);
+    uint64_t current = flushIndex.load(std::memory_order_relaxed);
+    while (current < w &&
+           !flushIndex.compare_exchange_weak(current, w, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+    }
+}
+
+void PcmRingBuffer::reset() {
+    writeIndex.store(0, std::memory_order_relaxed);
+    readIndex.store(0, std::memory_order_relaxed);
+    flushIndex.store(0, std::memory_order_relaxed);
+    cachedReadIndex = 0;
+    cachedWriteIndex = 0;
+    framesFlushed.store(0, std::memory_order_relaxed);
+    peakFill.store(0, std::memory_order_relaxed);
+}
+
+size_t PcmRingBuffer::availableToRead() const {
+    const uint64_t w = writeIndex.load(std::memory_order_acquire);
+    const uint64_t r = std::max(readIndex.load(std::memory_order_acquire),
+                                flushIndex.load(std::memory_order_acquire));
+    return w > r ? static_cast<size_t>(w - r) : 0;
+}
+
+size_t PcmRingBuffer::availableToWrite() const {
+    const uint64_t w = writeIndex.load(std::memory_order_acquire);
+    const uint64_t r = readIndex.load(std::memory_order_acquire);
+    return capacity - static_cast<size_t>(w - r);
+}
+
+PcmRingBuffer::Statistics PcmRingBuffer::getStatistics() const {
+    Statistics stats;
+    stats.capacityFrames = capacity;
+    stats.fillFrames = availableToRead();
+    stats.peakFillFrames = peakFill.load(std::memory_order_relaxed);
+    stats.framesWritten = writeIndex.load(std::memory_order_acquire);
+    stats.framesFlushed = framesFlushed.load(std::memory_order_relaxed);
+    stats.framesRead = readIndex.load(std::memory_order_acquire) - stats.framesFlushed;
+    return stats;
+}
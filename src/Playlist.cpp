@@ -1,6 +1,8 @@
 #include "Playlist.h"
 #include <algorithm>
+#include <iomanip>
 #include <random>
+#include <sstream>
 #include <stdexcept>
 
 Playlist::Playlist() : name("Nova Playlist"), currentIndex(0), 
@@ -200,6 +202,30 @@ std::shared_ptr<Track> Playlist::previous() {
     return getCurrentTrack();
 }
 
+std::vector<std::shared_ptr<Track>> Playlist::getUpcomingTracks(size_t maxTracks) const {
+    std::vector<std::shared_ptr<Track>> upcoming;
+    if (tracks.empty()) {
+        return upcoming;
+    }
+
+    // Mesma regra de next(): sem repetição a lista termina na última faixa
+    const size_t maxIndex = shuffleMode ? shuffleOrder.size() : tracks.size();
+    size_t index = currentIndex;
+    while (upcoming.size() < maxTracks) {
+        ++index;
+        if (index >= maxIndex) {
+            if (!repeatMode) {
+                break;
+            }
+            index = 0;
+        }
+        const size_t actualIndex = shuffleMode && !shuffleOrder.empty() ? shuffleOrder[index % shuffleOrder.size()]
+                                                                        : index;
+        upcoming.push_back(getTrack(actualIndex));
+    }
+    return upcoming;
+}
+
 bool Playlist::setCurrentIndex(size_t index) {
     size_t maxIndex = shuffleMode ? shuffleOrder.size() : tracks.size();
     if (index < maxIndex) {
@@ -248,6 +274,21 @@ std::chrono::seconds Playlist::getTotalDuration() const {
     return total;
 }
 
+std::string Playlist::getTotalDurationString() const {
+    auto totalSeconds = getTotalDuration().count();
+    auto hours = totalSeconds / 3600;
+    auto minutes = (totalSeconds / 60) % 60;
+    auto seconds = totalSeconds % 60;
+
+    std::stringstream ss;
+    ss << std::setfill('0');
+    if (hours > 0) {
+        ss << hours << ":";
+    }
+    ss << std::setw(2) << minutes << ":" << std::setw(2) << seconds;
+    return ss.str();
+}
+
 std::vector<std::shared_ptr<Track>> Playlist::getAllTracks() const {
     return tracks;
 }
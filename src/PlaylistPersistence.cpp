@@ -3,12 +3,140 @@
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <iomanip>
+
+namespace {
+
+// Aspas, barras invertidas e caracteres de controle escapados (RFC 8259); o restante vai como está (UTF-8)
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            case '\b': escaped += "\\b"; break;
+            case '\f': escaped += "\\f"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char hex[] = "0123456789abcdef";
+                    escaped += "\\u00";
+                    escaped += hex[(c >> 4) & 0xF];
+                    escaped += hex[c & 0xF];
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// Código \uXXXX em UTF-8 (pares substitutos ficam como U+FFFD)
+void appendCodePoint(std::string& out, unsigned codePoint) {
+    if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+        codePoint = 0xFFFD;
+    }
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+// Posição do valor de "key" dentro de json (depois dos dois-pontos e espaços), ou npos
+size_t findValue(const std::string& json, const std::string& key) {
+    const size_t keyPos = json.find("\"" + key + "\"");
+    if (keyPos == std::string::npos) {
+        return std::string::npos;
+    }
+    size_t pos = json.find(':', keyPos + key.size() + 2);
+    if (pos == std::string::npos) {
+        return pos;
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + 1);
+    return pos;
+}
+
+std::optional<std::string> readString(const std::string& json, const std::string& key) {
+    size_t pos = findValue(json, key);
+    if (pos == std::string::npos || json[pos] != '"') {
+        return std::nullopt;
+    }
+    std::string value;
+    for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+        if (json[pos] != '\\' || pos + 1 >= json.size()) {
+            value += json[pos];
+            continue;
+        }
+        switch (json[++pos]) {
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'u':
+                if (pos + 4 < json.size()) {
+                    appendCodePoint(value, static_cast<unsigned>(std::stoul(json.substr(pos + 1, 4), nullptr, 16)));
+                    pos += 4;
+                }
+                break;
+            default: value += json[pos]; break; // \" \\ \/
+        }
+    }
+    return value;
+}
+
+// Número de "key"; nullopt se ausente ou null
+std::optional<double> readNumber(const std::string& json, const std::string& key) {
+    const size_t pos = findValue(json, key);
+    if (pos == std::string::npos || json.compare(pos, 4, "null") == 0) {
+        return std::nullopt;
+    }
+    try {
+        return std::stod(json.substr(pos, 32));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+// Objeto {...} que começa em start, respeitando chaves dentro de strings; vazio se incompleto
+std::string extractObject(const std::string& json, size_t start) {
+    int depth = 0;
+    bool inString = false;
+    for (size_t pos = start; pos < json.size(); ++pos) {
+        const char c = json[pos];
+        if (inString) {
+            if (c == '\\') {
+                ++pos;
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}' && --depth == 0) {
+            return json.substr(start, pos - start + 1);
+        }
+    }
+    return "";
+}
+
+} // namespace
 
 JsonPlaylistPersistence::JsonPlaylistPersistence() 
-    : formatVersion("1.0"), prettyPrint(true) {}
+    : formatVersion("1.1"), prettyPrint(true) {}
 
 JsonPlaylistPersistence::JsonPlaylistPersistence(bool prettyFormat)
-    : formatVersion("1.0"), prettyPrint(prettyFormat) {}
+    : formatVersion("1.1"), prettyPrint(prettyFormat) {}
 
 bool JsonPlaylistPersistence::savePlaylist(const Playlist& playlist, const std::string& filePath) {
     try {
@@ -50,22 +178,25 @@ std::optional<Playlist> JsonPlaylistPersistence::loadPlaylist(const std::string&
         
         std::string content = buffer.str();
         
-        // Parsing JSON simples (implementação básica)
+        // Parsing JSON simples: só o formato gravado por serializePlaylist
         Playlist playlist;
-        
-        // Extrair nome da playlist
-        size_t nameStart = content.find("\"name\":\"") + 8;
-        size_t nameEnd = content.find("\"", nameStart);
-        if (nameStart != std::string::npos && nameEnd != std::string::npos) {
-            std::string name = content.substr(nameStart, nameEnd - nameStart);
-            playlist.setName(name);
+        if (auto name = readString(content, "name")) {
+            playlist.setName(*name);
         }
-        
-        // Extrair tracks (implementação básica)
-        size_t tracksStart = content.find("\"tracks\":[");
-        if (tracksStart != std::string::npos) {
-            // Para esta implementação básica, vamos criar algumas tracks de exemplo
-            // Em uma implementação real, faria parsing completo do JSON
+
+        // Cada objeto do array "tracks" (com o objeto "loudness" aninhado) vira uma faixa
+        size_t pos = findValue(content, "tracks");
+        if (pos != std::string::npos && content[pos] == '[') {
+            while ((pos = content.find_first_of("{]", pos + 1)) != std::string::npos && content[pos] == '{') {
+                const std::string object = extractObject(content, pos);
+                if (object.empty()) {
+                    throw ParseException("faixa incompleta em " + filePath);
+                }
+                if (auto track = deserializeTrack(object)) {
+                    playlist.addTrack(std::make_shared<Track>(std::move(*track)));
+                }
+                pos += object.size() - 1;
+            }
         }
         
         return playlist;
@@ -111,24 +242,90 @@ bool JsonPlaylistPersistence::isValidFormat(const std::string& filePath) const {
 std::string JsonPlaylistPersistence::serializeTrack(const Track& track) const {
     std::stringstream ss;
     ss << "    {\n";
-    ss << "      \"filePath\": \"" << track.getFilePath() << "\",\n";
-    ss << "      \"title\": \"" << track.getTitle() << "\",\n";
-    ss << "      \"artist\": \"" << track.getArtist() << "\",\n";
-    ss << "      \"album\": \"" << track.getAlbum() << "\",\n";
-    ss << "      \"genre\": \"" << track.getGenre() << "\",\n";
+    ss << "      \"filePath\": \"" << escapeJson(track.getFilePath()) << "\",\n";
+    ss << "      \"title\": \"" << escapeJson(track.getTitle()) << "\",\n";
+    ss << "      \"artist\": \"" << escapeJson(track.getArtist()) << "\",\n";
+    ss << "      \"album\": \"" << escapeJson(track.getAlbum()) << "\",\n";
+    ss << "      \"genre\": \"" << escapeJson(track.getGenre()) << "\",\n";
     ss << "      \"year\": " << track.getYear() << ",\n";
     ss << "      \"duration\": " << track.getDuration().count() << ",\n";
-    ss << "      \"format\": \"" << track.getFormat() << "\"\n";
+    ss << "      \"format\": \"" << track.getFormat() << "\",\n";
+    // Loudness (EBU R128 / ReplayGain 2.0), null enquanto a faixa não foi analisada
+    if (const auto& loudness = track.getLoudness()) {
+        ss << std::fixed << std::setprecision(2);
+        ss << "      \"loudness\": {\n";
+        ss << "        \"integratedLufs\": " << loudness->integratedLufs << ",\n";
+        ss << "        \"truePeakDb\": " << loudness->truePeakDb << ",\n";
+        ss << "        \"trackGainDb\": " << loudness->trackGainDb << ",\n";
+        if (loudness->hasAlbumGain) {
+            ss << "        \"albumGainDb\": " << loudness->albumGainDb << ",\n";
+            ss << "        \"albumPeakDb\": " << loudness->albumPeakDb << "\n";
+        } else {
+            ss << "        \"albumGainDb\": null,\n";
+            ss << "        \"albumPeakDb\": null\n";
+        }
+        ss << "      }\n";
+    } else {
+        ss << "      \"loudness\": null\n";
+    }
     ss << "    }";
     return ss.str();
 }
 
 std::optional<Track> JsonPlaylistPersistence::deserializeTrack(const std::string& jsonTrack) const {
-    // Implementação básica de parsing JSON
-    // Em uma implementação real, usaria uma biblioteca JSON como nlohmann/json
+    // Metadados gravados por serializeTrack; o arquivo não é reaberto nem reanalisado
     try {
+        auto path = readString(jsonTrack, "filePath");
+        if (!path || path->empty()) {
+            return std::nullopt;
+        }
         Track track;
-        // Por simplicidade, retornar track padrão
+        track.setFilePath(*path);
+        if (auto title = readString(jsonTrack, "title"); title && !title->empty()) {
+            track.setTitle(*title);
+        }
+        if (auto artist = readString(jsonTrack, "artist"); artist && !artist->empty()) {
+            track.setArtist(*artist);
+        }
+        if (auto album = readString(jsonTrack, "album")) {
+            track.setAlbum(*album);
+        }
+        if (auto genre = readString(jsonTrack, "genre")) {
+            track.setGenre(*genre);
+        }
+        if (auto format = readString(jsonTrack, "format"); format && !format->empty()) {
+            track.setFormat(*format);
+        }
+        if (auto year = readNumber(jsonTrack, "year")) {
+            track.setYear(static_cast<int>(*year));
+        }
+        if (auto duration = readNumber(jsonTrack, "duration")) {
+            track.setDuration(std::chrono::seconds(static_cast<long long>(*duration)));
+        }
+
+        // Loudness: objeto completo ou null; albumGainDb null = sem ganho de álbum
+        const size_t loudnessPos = findValue(jsonTrack, "loudness");
+        if (loudnessPos != std::string::npos && jsonTrack[loudnessPos] == '{') {
+            const std::string object = extractObject(jsonTrack, loudnessPos);
+            auto integrated = readNumber(object, "integratedLufs");
+            auto truePeak = readNumber(object, "truePeakDb");
+            auto trackGain = readNumber(object, "trackGainDb");
+            if (!integrated || !truePeak || !trackGain) {
+                throw ParseException("loudness incompleto para " + *path);
+            }
+            Track::Loudness loudness;
+            loudness.integratedLufs = *integrated;
+            loudness.truePeakDb = *truePeak;
+            loudness.trackGainDb = *trackGain;
+            auto albumGain = readNumber(object, "albumGainDb");
+            auto albumPeak = readNumber(object, "albumPeakDb");
+            if (albumGain && albumPeak) {
+                loudness.hasAlbumGain = true;
+                loudness.albumGainDb = *albumGain;
+                loudness.albumPeakDb = *albumPeak;
+            }
+            track.setLoudness(loudness);
+        }
         return track;
     } catch (const std::exception&) {
         return std::nullopt;
@@ -140,7 +337,7 @@ std::string JsonPlaylistPersistence::serializePlaylist(const Playlist& playlist)
     
     ss << "{\n";
     ss << "  \"formatVersion\": \"" << formatVersion << "\",\n";
-    ss << "  \"name\": \"" << playlist.getName() << "\",\n";
+    ss << "  \"name\": \"" << escapeJson(playlist.getName()) << "\",\n";
     ss << "  \"shuffleMode\": " << (playlist.getShuffleMode() ? "true" : "false") << ",\n";
     ss << "  \"repeatMode\": " << (playlist.getRepeatMode() ? "true" : "false") << ",\n";
     ss << "  \"currentIndex\": " << playlist.getCurrentIndex() << ",\n";
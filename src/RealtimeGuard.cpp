@@ -0,0 +1,361 @@
+#include "RealtimeGuard.h"
+#include <atomic>
+#include <sstream>
+
+#if defined(MP3PLAYER_RT_GUARD)
+#include <cstdlib>
+#include <new>
+#if defined(__GLIBC__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#endif
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+#endif
+
+namespace {
+
+// Slot pré-alocado: preenchido dentro do gancho, portanto só tipos triviais
+struct Record {
+    std::atomic<bool> ready;
+    RealtimeGuard::ViolationKind kind;
+    size_t bytes;
+    int depth;
+    void* frames[RealtimeGuard::MAX_FRAMES];
+};
+
+std::atomic<uint64_t> counts[RealtimeGuard::KIND_COUNT];
+std::atomic<size_t> recordedCount{0};
+Record records[RealtimeGuard::MAX_RECORDED];
+
+thread_local int realtimeDepth = 0;
+thread_local bool recording = false; // O próprio registro (backtrace) não conta como violação
+
+void record(RealtimeGuard::ViolationKind kind, size_t bytes) {
+    recording = true;
+    counts[static_cast<size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+    const size_t slot = recordedCount.fetch_add(1, std::memory_order_relaxed);
+    if (slot < RealtimeGuard::MAX_RECORDED) {
+        Record& entry = records[slot];
+        entry.kind = kind;
+        entry.bytes = bytes;
+#if defined(MP3PLAYER_RT_GUARD) && defined(__GLIBC__)
+        entry.depth = backtrace(entry.frames, static_cast<int>(RealtimeGuard::MAX_FRAMES));
+#else
+        entry.depth = 0;
+#endif
+        entry.ready.store(true, std::memory_order_release);
+    }
+    recording = false;
+}
+
+inline void check(RealtimeGuard::ViolationKind kind, size_t bytes = 0) {
+    if (realtimeDepth > 0 && !recording) {
+        record(kind, bytes);
+    }
+}
+
+#if defined(MP3PLAYER_RT_GUARD)
+
+// Carregar agora o que backtrace() e dlsym() carregam na primeira chamada (dlopen aloca
+// e trava), para que o primeiro registro dentro da thread de áudio não dispare outros
+struct Warmup {
+    Warmup() {
+#if defined(__GLIBC__)
+        void* frames[2];
+        backtrace(frames, 2);
+#endif
+    }
+} warmup;
+
+#endif
+
+#if defined(MP3PLAYER_RT_GUARD) && defined(__GLIBC__)
+
+std::string demangle(const char* symbol) {
+    // Formato do glibc: "binario(nome+0x1f) [0x...]"
+    std::string text(symbol);
+    const size_t open = text.find('(');
+    const size_t plus = text.find('+', open);
+    if (open != std::string::npos && plus != std::string::npos && plus > open + 1) {
+        const std::string mangled = text.substr(open + 1, plus - open - 1);
+        int status = 0;
+        char* name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        if (status == 0 && name) {
+            text = text.substr(0, open + 1) + name + text.substr(plus);
+            std::free(name);
+        }
+    }
+    return text;
+}
+
+#endif
+
+} // namespace
+
+// ===================== RealtimeGuard =====================
+
+#if defined(MP3PLAYER_RT_GUARD)
+
+RealtimeGuard::Scope::Scope() {
+    ++realtimeDepth;
+}
+
+RealtimeGuard::Scope::~Scope() {
+    --realtimeDepth;
+}
+
+#endif
+
+bool RealtimeGuard::isCompiledIn() {
+#if defined(MP3PLAYER_RT_GUARD)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RealtimeGuard::isInRealtimeScope() {
+    return realtimeDepth > 0;
+}
+
+void RealtimeGuard::reportViolation(ViolationKind kind, size_t bytes) {
+    check(kind, bytes);
+}
+
+RealtimeGuard::Statistics RealtimeGuard::getStatistics() {
+    Statistics result;
+    for (size_t i = 0; i < KIND_COUNT; ++i) {
+        result.counts[i] = counts[i].load(std::memory_order_relaxed);
+        result.total += result.counts[i];
+    }
+    const size_t recorded = recordedCount.load(std::memory_order_relaxed);
+    result.recorded = recorded < MAX_RECORDED ? recorded : MAX_RECORDED;
+    return result;
+}
+
+std::vector<RealtimeGuard::Violation> RealtimeGuard::getViolations() {
+    std::vector<Violation> violations;
+    const size_t recorded = getStatistics().recorded;
+    for (size_t i = 0; i < recorded; ++i) {
+        const Record& entry = records[i];
+        if (!entry.ready.load(std::memory_order_acquire)) {
+            continue; // Ainda sendo preenchido por outra thread
+        }
+        Violation violation{entry.kind, entry.bytes, {}};
+#if defined(MP3PLAYER_RT_GUARD) && defined(__GLIBC__)
+        // Pular o próprio registro: o primeiro quadro mostrado é o gancho (operator new, mutex...)
+        const int skip = entry.depth > 1 ? 1 : 0;
+        char** symbols = backtrace_symbols(const_cast<void* const*>(entry.frames + skip), entry.depth - skip);
+        if (symbols) {
+            for (int f = 0; f < entry.depth - skip; ++f) {
+                violation.backtrace.push_back(demangle(symbols[f]));
+            }
+            std::free(symbols);
+        }
+#endif
+        violations.push_back(std::move(violation));
+    }
+    return violations;
+}
+
+std::string RealtimeGuard::formatReport() {
+    const Statistics stats = getStatistics();
+    std::ostringstream report;
+    report << "[RT-GUARD] " << stats.total << " violação(ões) na thread de áudio:";
+    for (size_t i = 0; i < KIND_COUNT; ++i) {
+        if (stats.counts[i] > 0) {
+            report << " " << getKindName(static_cast<ViolationKind>(i)) << "=" << stats.counts[i];
+        }
+    }
+    report << "\n";
+    int index = 0;
+    for (const auto& violation : getViolations()) {
+        report << "  #" << ++index << " " << getKindName(violation.kind);
+        if (violation.kind == ViolationKind::ALLOCATION) {
+            report << " (" << violation.bytes << " bytes)";
+        }
+        report << "\n";
+        for (const auto& frame : violation.backtrace) {
+            report << "      " << frame << "\n";
+        }
+    }
+    return report.str();
+}
+
+void RealtimeGuard::reset() {
+    for (auto& count : counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    for (auto& entry : records) {
+        entry.ready.store(false, std::memory_order_relaxed);
+    }
+    recordedCount.store(0, std::memory_order_relaxed);
+}
+
+std::string RealtimeGuard::getKindName(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::ALLOCATION: return "alocação";
+        case ViolationKind::DEALLOCATION: return "liberação";
+        case ViolationKind::LOCK: return "mutex";
+        case ViolationKind::WAIT: return "espera";
+        case ViolationKind::SLEEP: return "sleep";
+        case ViolationKind::IO: return "E/S";
+    }
+    return "desconhecida";
+}
+
+#if defined(MP3PLAYER_RT_GUARD)
+
+// ===================== operator new/delete =====================
+
+namespace {
+
+void* allocate(size_t size) {
+    check(RealtimeGuard::ViolationKind::ALLOCATION, size);
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    check(RealtimeGuard::ViolationKind::ALLOCATION, size);
+    void* pointer = nullptr;
+    const size_t align = static_cast<size_t>(alignment) < sizeof(void*) ? sizeof(void*)
+                                                                         : static_cast<size_t>(alignment);
+    if (posix_memalign(&pointer, align, size ? size : 1) != 0) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void release(void* pointer) {
+    if (pointer) {
+        check(RealtimeGuard::ViolationKind::DEALLOCATION);
+        std::free(pointer);
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+
+// ===================== Chamadas bloqueantes (Linux) =====================
+
+#if defined(__linux__)
+
+namespace {
+
+// Ponteiro para a implementação seguinte (libc); atômico sem guarda de inicialização, porque
+// a guarda de estáticos locais pode ela mesma travar um mutex
+template <typename Function>
+Function next(std::atomic<void*>& cache, const char* name) {
+    void* pointer = cache.load(std::memory_order_acquire);
+    if (!pointer) {
+        pointer = dlsym(RTLD_NEXT, name);
+        cache.store(pointer, std::memory_order_release);
+    }
+    return reinterpret_cast<Function>(pointer);
+}
+
+std::atomic<void*> realMutexLock{nullptr};
+std::atomic<void*> realCondWait{nullptr};
+std::atomic<void*> realCondTimedWait{nullptr};
+std::atomic<void*> realNanosleep{nullptr};
+std::atomic<void*> realClockNanosleep{nullptr};
+std::atomic<void*> realUsleep{nullptr};
+std::atomic<void*> realWrite{nullptr};
+std::atomic<void*> realFwrite{nullptr};
+std::atomic<void*> realFflush{nullptr};
+
+} // namespace
+
+extern "C" {
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    check(RealtimeGuard::ViolationKind::LOCK);
+    return next<int (*)(pthread_mutex_t*)>(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+    check(RealtimeGuard::ViolationKind::WAIT);
+    return next<int (*)(pthread_cond_t*, pthread_mutex_t*)>(realCondWait, "pthread_cond_wait")(condition, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* deadline) {
+    check(RealtimeGuard::ViolationKind::WAIT);
+    return next<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)>(
+        realCondTimedWait, "pthread_cond_timedwait")(condition, mutex, deadline);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+    check(RealtimeGuard::ViolationKind::SLEEP);
+    return next<int (*)(const struct timespec*, struct timespec*)>(realNanosleep, "nanosleep")(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining) {
+    check(RealtimeGuard::ViolationKind::SLEEP);
+    return next<int (*)(clockid_t, int, const struct timespec*, struct timespec*)>(
+        realClockNanosleep, "clock_nanosleep")(clock, flags, duration, remaining);
+}
+
+int usleep(useconds_t microseconds) {
+    check(RealtimeGuard::ViolationKind::SLEEP);
+    return next<int (*)(useconds_t)>(realUsleep, "usleep")(microseconds);
+}
+
+ssize_t write(int descriptor, const void* data, size_t bytes) {
+    check(RealtimeGuard::ViolationKind::IO);
+    return next<ssize_t (*)(int, const void*, size_t)>(realWrite, "write")(descriptor, data, bytes);
+}
+
+size_t fwrite(const void* data, size_t size, size_t count, FILE* stream) {
+    check(RealtimeGuard::ViolationKind::IO);
+    return next<size_t (*)(const void*, size_t, size_t, FILE*)>(realFwrite, "fwrite")(data, size, count, stream);
+}
+
+int fflush(FILE* stream) {
+    check(RealtimeGuard::ViolationKind::IO);
+    return next<int (*)(FILE*)>(realFflush, "fflush")(stream);
+}
+
+} // extern "C"
+
+#endif // __linux__
+
+#endif // MP3PLAYER_RT_GUARD
@@ -0,0 +1,334 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Função de Bessel modificada de ordem zero (janela de Kaiser)
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64 && term > 1e-14 * sum; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Um quadro de saída: produto escalar da fase com a janela de cada canal (count múltiplo de 8).
+// Canais em pares reaproveitam cada carga de coeficientes.
+void frameScalar(const float* taps, const float* window, size_t lineStride, int channels, size_t count,
+                 float* out) {
+    for (int c = 0; c < channels; ++c) {
+        const float* x = window + static_cast<size_t>(c) * lineStride;
+        float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+        for (size_t k = 0; k < count; k += 4) {
+            acc0 += taps[k] * x[k];
+            acc1 += taps[k + 1] * x[k + 1];
+            acc2 += taps[k + 2] * x[k + 2];
+            acc3 += taps[k + 3] * x[k + 3];
+        }
+        out[c] = (acc0 + acc1) + (acc2 + acc3);
+    }
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+inline float horizontalSum(__m128 sum) {
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+void frameSse2(const float* taps, const float* window, size_t lineStride, int channels, size_t count,
+               float* out) {
+    int c = 0;
+    for (; c + 2 <= channels; c += 2) {
+        const float* a = window + static_cast<size_t>(c) * lineStride;
+        const float* b = a + lineStride;
+        __m128 accA0 = _mm_setzero_ps(), accA1 = _mm_setzero_ps();
+        __m128 accB0 = _mm_setzero_ps(), accB1 = _mm_setzero_ps();
+        for (size_t k = 0; k < count; k += 8) {
+            const __m128 h0 = _mm_loadu_ps(taps + k), h1 = _mm_loadu_ps(taps + k + 4);
+            accA0 = _mm_add_ps(accA0, _mm_mul_ps(h0, _mm_loadu_ps(a + k)));
+            accA1 = _mm_add_ps(accA1, _mm_mul_ps(h1, _mm_loadu_ps(a + k + 4)));
+            accB0 = _mm_add_ps(accB0, _mm_mul_ps(h0, _mm_loadu_ps(b + k)));
+            accB1 = _mm_add_ps(accB1, _mm_mul_ps(h1, _mm_loadu_ps(b + k + 4)));
+        }
+        out[c] = horizontalSum(_mm_add_ps(accA0, accA1));
+        out[c + 1] = horizontalSum(_mm_add_ps(accB0, accB1));
+    }
+    if (c < channels) {
+        const float* a = window + static_cast<size_t>(c) * lineStride;
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        for (size_t k = 0; k < count; k += 8) {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(taps + k), _mm_loadu_ps(a + k)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(taps + k + 4), _mm_loadu_ps(a + k + 4)));
+        }
+        out[c] = horizontalSum(_mm_add_ps(acc0, acc1));
+    }
+}
+
+MP3PLAYER_TARGET_AVX2_FMA inline float horizontalSumAvx(__m256 total) {
+    return horizontalSum(_mm_add_ps(_mm256_castps256_ps128(total), _mm256_extractf128_ps(total, 1)));
+}
+
+MP3PLAYER_TARGET_AVX2_FMA void frameAvx2(const float* taps, const float* window, size_t lineStride, int channels,
+                                         size_t count, float* out) {
+    int c = 0;
+    for (; c + 2 <= channels; c += 2) {
+        const float* a = window + static_cast<size_t>(c) * lineStride;
+        const float* b = a + lineStride;
+        __m256 accA = _mm256_setzero_ps(), accB = _mm256_setzero_ps();
+        for (size_t k = 0; k < count; k += 8) {
+            const __m256 h = _mm256_loadu_ps(taps + k);
+            accA = _mm256_fmadd_ps(h, _mm256_loadu_ps(a + k), accA);
+            accB = _mm256_fmadd_ps(h, _mm256_loadu_ps(b + k), accB);
+        }
+        out[c] = horizontalSumAvx(accA);
+        out[c + 1] = horizontalSumAvx(accB);
+    }
+    if (c < channels) {
+        const float* a = window + static_cast<size_t>(c) * lineStride;
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        size_t k = 0;
+        for (; k + 16 <= count; k += 16) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k), _mm256_loadu_ps(a + k), acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k + 8), _mm256_loadu_ps(a + k + 8), acc1);
+        }
+        if (k < count) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k), _mm256_loadu_ps(a + k), acc0);
+        }
+        out[c] = horizontalSumAvx(_mm256_add_ps(acc0, acc1));
+    }
+}
+
+#endif
+
+} // namespace
+
+Resampler::Resampler(int inputRate, int outputRate, int channels, Quality quality)
+    : inputRate(inputRate), outputRate(outputRate), channels(channels), quality(quality),
+      level(CpuFeatures::getSimdLevel()), interpolation(1), decimation(1), stepWhole(1), stepFraction(0),
+      tapsPerPhase(8), cutoff(0.5), lineCapacity(0), filled(0), windowStart(0), phase(0) {
+    if (inputRate <= 0 || outputRate <= 0) {
+        throw std::invalid_argument("Taxas de amostragem devem ser positivas");
+    }
+    if (channels <= 0 || channels > MAX_CHANNELS) {
+        throw std::invalid_argument("Número de canais não suportado: " + std::to_string(channels));
+    }
+    if (outputRate > inputRate * 64LL || inputRate > outputRate * 64LL) {
+        throw std::invalid_argument("Razão de conversão fora de 1/64..64");
+    }
+    if (level == CpuFeatures::SimdLevel::AVX2 && !CpuFeatures::get().fma) {
+        level = CpuFeatures::SimdLevel::SSE2; // Kernel AVX2 usa FMA
+    }
+
+    const int divisor = std::gcd(inputRate, outputRate);
+    uint64_t num = static_cast<uint64_t>(outputRate / divisor);
+    uint64_t den = static_cast<uint64_t>(inputRate / divisor);
+    if (num <= MAX_PHASES) {
+        interpolation = static_cast<uint32_t>(num);
+        decimation = static_cast<uint32_t>(den);
+    } else {
+        // Último convergente da fração contínua de saída/entrada com no máximo MAX_PHASES fases
+        uint64_t h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+        while (den != 0) {
+            const uint64_t a = num / den;
+            const uint64_t h2 = a * h1 + h0, k2 = a * k1 + k0;
+            if (h2 > MAX_PHASES) {
+                break;
+            }
+            h0 = h1;
+            h1 = h2;
+            k0 = k1;
+            k1 = k2;
+            const uint64_t remainder = num - a * den;
+            num = den;
+            den = remainder;
+        }
+        interpolation = static_cast<uint32_t>(h1);
+        decimation = static_cast<uint32_t>(k1);
+    }
+    stepWhole = decimation / interpolation;
+    stepFraction = decimation % interpolation;
+
+    buildPhases();
+    lineCapacity = tapsPerPhase + stepWhole + 1 + CHUNK_FRAMES;
+    lines.assign(lineCapacity * static_cast<size_t>(channels), 0.0f);
+    reset();
+}
+
+void Resampler::buildPhases() {
+    const QualitySpec spec = getQualitySpec(quality);
+    // Em downsampling a banda passante encolhe na razão L/M; mais taps mantêm a transição
+    // estreita em relação à Nyquist de saída
+    const double scale = std::min(1.0, static_cast<double>(interpolation) / decimation);
+    auto taps = static_cast<size_t>(std::ceil(spec.tapsPerPhase / scale));
+    tapsPerPhase = std::min((taps + 7) / 8 * 8, MAX_TAPS_PER_PHASE);
+
+    // Kaiser: largura da transição para a atenuação pedida; a borda da rejeição fica na
+    // Nyquist da menor taxa e o corte (-6 dB) no meio da transição
+    const double transition = (spec.attenuationDb - 7.95) / (14.36 * static_cast<double>(tapsPerPhase));
+    cutoff = std::max(0.5 * scale - transition / 2.0, 0.25 * scale);
+    const double beta = 0.1102 * (spec.attenuationDb - 8.7);
+    const double half = static_cast<double>(tapsPerPhase / 2);
+    const double normalizer = besselI0(beta);
+
+    phases.assign(static_cast<size_t>(interpolation) * tapsPerPhase, 0.0f);
+    std::vector<double> row(tapsPerPhase);
+    for (uint32_t p = 0; p < interpolation; ++p) {
+        // Tap k multiplica x[i - half + 1 + k]; distância ao instante i + p / L
+        const double offset = static_cast<double>(p) / interpolation;
+        double sum = 0.0;
+        for (size_t k = 0; k < tapsPerPhase; ++k) {
+            const double d = static_cast<double>(k) - half + 1.0 - offset;
+            const double r = d / half;
+            const double x = 2.0 * cutoff * d;
+            const double sinc = std::fabs(x) < 1e-12 ? 1.0 : std::sin(PI * x) / (PI * x);
+            row[k] = 2.0 * cutoff * sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / normalizer;
+            sum += row[k];
+        }
+        // Ganho DC exato em cada fase: sem modulação de nível entre quadros de saída
+        float* target = phases.data() + static_cast<size_t>(p) * tapsPerPhase;
+        for (size_t k = 0; k < tapsPerPhase; ++k) {
+            target[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+}
+
+void Resampler::reset() {
+    // Meia janela de silêncio antes do primeiro quadro: a saída 0 cai sobre a entrada 0
+    filled = tapsPerPhase / 2 - 1;
+    for (int c = 0; c < channels; ++c) {
+        float* line = lines.data() + static_cast<size_t>(c) * lineCapacity;
+        std::fill(line, line + filled, 0.0f);
+    }
+    windowStart = 0;
+    phase = 0;
+}
+
+size_t Resampler::getMaxOutputFrames(size_t inputFrames) const {
+    // Histórico pendente (< taps) mais a cauda do flush (taps / 2)
+    const uint64_t frames = static_cast<uint64_t>(inputFrames) + 2 * tapsPerPhase;
+    return static_cast<size_t>(frames * interpolation / decimation + 2);
+}
+
+bool Resampler::isExact() const {
+    return static_cast<uint64_t>(interpolation) * static_cast<uint64_t>(inputRate) ==
+           static_cast<uint64_t>(decimation) * static_cast<uint64_t>(outputRate);
+}
+
+size_t Resampler::process(const float* interleaved, size_t frames, float* output) {
+    if (!interleaved || !output) {
+        return 0;
+    }
+    return feed(interleaved, frames, output);
+}
+
+size_t Resampler::flush(float* output) {
+    if (!output) {
+        return 0;
+    }
+    // Meia janela de silêncio depois do último quadro completa as saídas até o fim da entrada
+    const size_t produced = feed(nullptr, tapsPerPhase / 2, output);
+    reset();
+    return produced;
+}
+
+size_t Resampler::feed(const float* interleaved, size_t frames, float* output) {
+    const size_t stride = static_cast<size_t>(channels);
+    size_t produced = 0;
+    while (frames > 0) {
+        // Desintercalar no histórico de cada canal (nullptr = silêncio)
+        const size_t count = std::min(frames, lineCapacity - filled);
+        for (size_t c = 0; c < stride; ++c) {
+            float* line = lines.data() + c * lineCapacity + filled;
+            if (interleaved) {
+                for (size_t f = 0; f < count; ++f) {
+                    line[f] = interleaved[f * stride + c];
+                }
+            } else {
+                std::fill(line, line + count, 0.0f);
+            }
+        }
+        if (interleaved) {
+            interleaved += count * stride;
+        }
+        filled += count;
+        frames -= count;
+
+        produced += render(output + produced * stride);
+
+        // Descartar o que ficou para trás da próxima janela
+        const size_t shift = std::min(windowStart, filled);
+        if (shift > 0) {
+            for (size_t c = 0; c < stride; ++c) {
+                float* line = lines.data() + c * lineCapacity;
+                std::copy(line + shift, line + filled, line);
+            }
+            filled -= shift;
+            windowStart -= shift;
+        }
+    }
+    return produced;
+}
+
+size_t Resampler::render(float* output) {
+    void (*kernel)(const float*, const float*, size_t, int, size_t, float*) = frameScalar;
+#if defined(MP3PLAYER_ARCH_X86)
+    switch (level) {
+        case CpuFeatures::SimdLevel::AVX2:
+            kernel = frameAvx2;
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            kernel = frameSse2;
+            break;
+        default:
+            break;
+    }
+#endif
+
+    size_t produced = 0;
+    while (windowStart + tapsPerPhase <= filled) {
+        const float* taps = phases.data() + static_cast<size_t>(phase) * tapsPerPhase;
+        kernel(taps, lines.data() + windowStart, lineCapacity, channels, tapsPerPhase, output);
+        output += channels;
+        ++produced;
+
+        windowStart += stepWhole;
+        phase += stepFraction;
+        if (phase >= interpolation) {
+            phase -= interpolation;
+            ++windowStart;
+        }
+    }
+    return produced;
+}
+
+Resampler::QualitySpec Resampler::getQualitySpec(Quality quality) {
+    switch (quality) {
+        case Quality::FAST:
+            return {16, 60.0};
+        case Quality::BEST:
+            return {128, 120.0};
+        case Quality::MEDIUM:
+        default:
+            return {64, 96.0};
+    }
+}
+
+std::string Resampler::getQualityName(Quality quality) {
+    switch (quality) {
+        case Quality::FAST: return "fast";
+        case Quality::MEDIUM: return "medium";
+        case Quality::BEST: return "best";
+    }
+    return "unknown";
+}
@@ -0,0 +1,115 @@
+#include "ResamplingDecoder.h"
+#include <algorithm>
+#include <stdexcept>
+
+ResamplingDecoder::ResamplingDecoder(std::unique_ptr<AudioDecoder> sourceDecoder, int outputSampleRate,
+                                     Resampler::Quality resamplerQuality)
+    : source(std::move(sourceDecoder)), outputRate(outputSampleRate), quality(resamplerQuality),
+      pendingOffset(0), pendingFrames(0), position(0), sourceFinished(false) {
+    if (!source) {
+        throw DecoderException("Decodificador de origem ausente");
+    }
+    if (source->isOpen()) {
+        configure();
+    }
+}
+
+void ResamplingDecoder::open(const std::string& filePath) {
+    source->open(filePath);
+    configure();
+}
+
+void ResamplingDecoder::configure() {
+    try {
+        resampler = std::make_unique<Resampler>(source->getSampleRate(), outputRate, source->getChannels(), quality);
+    } catch (const std::invalid_argument& e) {
+        throw DecoderException("Conversão de " + std::to_string(source->getSampleRate()) + " para " +
+                               std::to_string(outputRate) + " Hz indisponível: " + e.what());
+    }
+    const size_t channels = static_cast<size_t>(source->getChannels());
+    sourceBuffer.assign(SOURCE_FRAMES * channels, 0.0f);
+    pending.assign(resampler->getMaxOutputFrames(SOURCE_FRAMES) * channels, 0.0f);
+    pendingOffset = pendingFrames = 0;
+    position = toOutputFrames(source->getPosition());
+    sourceFinished = false;
+}
+
+void ResamplingDecoder::close() {
+    source->close();
+    resampler.reset();
+    pendingOffset = pendingFrames = 0;
+    position = 0;
+}
+
+bool ResamplingDecoder::isOpen() const {
+    return resampler && source->isOpen();
+}
+
+int ResamplingDecoder::getChannels() const {
+    return source->getChannels();
+}
+
+uint64_t ResamplingDecoder::getTotalFrames() const {
+    const uint64_t total = source->getTotalFrames();
+    if (total == 0 || !resampler) {
+        return 0;
+    }
+    // Mesma contagem que o resampler produz: ceil(total * L / M)
+    const uint64_t l = resampler->getPhaseCount();
+    const uint64_t m = resampler->getDecimation();
+    return (total * l + m - 1) / m;
+}
+
+std::string ResamplingDecoder::getFormatName() const {
+    return source->getFormatName() + " (" + std::to_string(source->getSampleRate()) + " -> " +
+           std::to_string(outputRate) + " Hz)";
+}
+
+uint64_t ResamplingDecoder::toOutputFrames(uint64_t sourceFrames) const {
+    return static_cast<uint64_t>(static_cast<double>(sourceFrames) * resampler->getRatio() + 0.5);
+}
+
+size_t ResamplingDecoder::decode(float* out, size_t maxFrames) {
+    if (!isOpen() || !out) {
+        return 0;
+    }
+    const size_t channels = static_cast<size_t>(source->getChannels());
+    size_t delivered = 0;
+    while (delivered < maxFrames) {
+        if (pendingFrames == 0) {
+            if (sourceFinished) {
+                break;
+            }
+            const size_t frames = source->decode(sourceBuffer.data(), SOURCE_FRAMES);
+            if (frames > 0) {
+                pendingFrames = resampler->process(sourceBuffer.data(), frames, pending.data());
+            } else {
+                pendingFrames = resampler->flush(pending.data()); // Cauda do filtro
+                sourceFinished = true;
+            }
+            pendingOffset = 0;
+            continue;
+        }
+        const size_t count = std::min(pendingFrames, maxFrames - delivered);
+        std::copy_n(pending.data() + pendingOffset * channels, count * channels, out + delivered * channels);
+        pendingOffset += count;
+        pendingFrames -= count;
+        delivered += count;
+    }
+    position += delivered;
+    return delivered;
+}
+
+bool ResamplingDecoder::seek(uint64_t frame) {
+    if (!isOpen()) {
+        return false;
+    }
+    const auto sourceFrame = static_cast<uint64_t>(static_cast<double>(frame) / resampler->getRatio());
+    const bool ok = source->seek(sourceFrame);
+    // O histórico do filtro pertence à posição antiga
+    resampler->reset();
+    pendingOffset = pendingFrames = 0;
+    sourceFinished = false;
+    position = toOutputFrames(source->getPosition());
+    return ok;
+}
@@ -0,0 +1,191 @@
+#include "SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Potência de bin de uma senoide de amplitude 1 sob janela de Hann (ganho coerente 1/2)
+constexpr double FULL_SCALE_POWER = (SpectrumAnalyzer::FFT_SIZE / 4.0) * (SpectrumAnalyzer::FFT_SIZE / 4.0);
+
+} // namespace
+
+SpectrumAnalyzer::SpectrumAnalyzer(size_t bars)
+    : enabled(true), sampleRate(0), history(), historyPosition(0), framesSincePublish(0), publishSerial(0),
+      snapshots(), fft(FFT_SIZE), window(FFT_SIZE), windowed(FFT_SIZE), real(fft.getBinCount()),
+      imag(fft.getBinCount()), barCount(std::max<size_t>(bars, 1)), barFirstBin(barCount), barLastBin(barCount),
+      mappedRate(0), targetDb(barCount, static_cast<float>(FLOOR_DB)), levelDb(barCount, static_cast<float>(FLOOR_DB)),
+      peakDb(barCount, static_cast<float>(FLOOR_DB)), peakAge(barCount, 0.0f), staleSeconds(STALE_SECONDS),
+      peakFrequency(0.0), analyzedSerial(0), analysisCount(0) {
+    for (size_t i = 0; i < FFT_SIZE; ++i) {
+        window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * static_cast<double>(i) / FFT_SIZE));
+    }
+}
+
+void SpectrumAnalyzer::push(const float* interleaved, size_t frames, int channels) {
+    if (!enabled.load(std::memory_order_relaxed) || !interleaved || channels <= 0) {
+        return;
+    }
+    const int rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate <= 0) {
+        return;
+    }
+
+    // Mono: média dos canais, no histórico circular (FFT_SIZE é potência de 2)
+    const size_t stride = static_cast<size_t>(channels);
+    const float scale = 1.0f / static_cast<float>(channels);
+    size_t position = historyPosition;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const float* samples = interleaved + frame * stride;
+        float sum = 0.0f;
+        for (size_t c = 0; c < stride; ++c) {
+            sum += samples[c];
+        }
+        history[position] = sum * scale;
+        position = (position + 1) & (FFT_SIZE - 1);
+    }
+    historyPosition = position;
+
+    framesSincePublish += frames;
+    if (static_cast<double>(framesSincePublish) * PUBLISH_HZ < static_cast<double>(rate)) {
+        return;
+    }
+    framesSincePublish = 0;
+
+    // Histórico desenrolado, do mais antigo (posição atual) ao mais recente
+    Snapshot& slot = snapshots.getWriteBuffer();
+    std::copy(history.begin() + static_cast<std::ptrdiff_t>(position), history.end(), slot.samples.begin());
+    std::copy(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(position),
+              slot.samples.begin() + static_cast<std::ptrdiff_t>(FFT_SIZE - position));
+    slot.sampleRate = rate;
+    slot.serial = ++publishSerial;
+    snapshots.publish();
+}
+
+void SpectrumAnalyzer::mapBars(int rate) {
+    const double nyquist = rate / 2.0;
+    const double top = std::min(MAX_FREQUENCY, nyquist);
+    const double bottom = std::min(MIN_FREQUENCY, top / 2.0);
+    const double binWidth = static_cast<double>(rate) / FFT_SIZE;
+    const size_t lastBin = fft.getBinCount() - 1;
+
+    for (size_t bar = 0; bar < barCount; ++bar) {
+        const double low = bottom * std::pow(top / bottom, static_cast<double>(bar) / barCount);
+        const double high = bottom * std::pow(top / bottom, static_cast<double>(bar + 1) / barCount);
+        size_t first = static_cast<size_t>(std::ceil(low / binWidth));
+        size_t last = static_cast<size_t>(std::ceil(high / binWidth));
+        last = last > 0 ? last - 1 : 0;
+        if (last < first) {
+            // Faixa mais estreita que um bin (graves): o bin mais próximo do centro
+            first = last = static_cast<size_t>(std::lround(std::sqrt(low * high) / binWidth));
+        }
+        barFirstBin[bar] = std::min(std::max<size_t>(first, 1), lastBin);
+        barLastBin[bar] = std::min(std::max(last, barFirstBin[bar]), lastBin);
+    }
+    mappedRate = rate;
+}
+
+void SpectrumAnalyzer::measure(const Snapshot& snapshot) {
+    if (snapshot.sampleRate != mappedRate) {
+        mapBars(snapshot.sampleRate);
+    }
+
+    for (size_t i = 0; i < FFT_SIZE; ++i) {
+        windowed[i] = snapshot.samples[i] * window[i];
+    }
+    fft.forward(windowed.data(), real.data(), imag.data());
+
+    // Potência por bin, reaproveitando 'real'
+    const size_t bins = fft.getBinCount();
+    size_t strongest = 0;
+    for (size_t k = 0; k < bins; ++k) {
+        real[k] = real[k] * real[k] + imag[k] * imag[k];
+        if (k > 0 && real[k] > real[strongest]) {
+            strongest = k;
+        }
+    }
+
+    const double floorPower = FULL_SCALE_POWER * std::pow(10.0, FLOOR_DB / 10.0);
+    if (strongest > 0 && real[strongest] > floorPower) {
+        // Interpolação parabólica sobre os vizinhos, em dB
+        double offset = 0.0;
+        if (strongest + 1 < bins) {
+            const double a = std::log10(std::max<double>(real[strongest - 1], 1e-20));
+            const double b = std::log10(static_cast<double>(real[strongest]));
+            const double c = std::log10(std::max<double>(real[strongest + 1], 1e-20));
+            const double denominator = a - 2.0 * b + c;
+            if (denominator < 0.0) {
+                offset = std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5);
+            }
+        }
+        peakFrequency = (static_cast<double>(strongest) + offset) * snapshot.sampleRate / FFT_SIZE;
+    } else {
+        peakFrequency = 0.0;
+    }
+
+    for (size_t bar = 0; bar < barCount; ++bar) {
+        float power = 0.0f;
+        for (size_t k = barFirstBin[bar]; k <= barLastBin[bar]; ++k) {
+            power = std::max(power, real[k]);
+        }
+        const double db = power > 0.0f ? 10.0 * std::log10(power / FULL_SCALE_POWER) : FLOOR_DB;
+        targetDb[bar] = static_cast<float>(std::max(db, FLOOR_DB));
+    }
+}
+
+bool SpectrumAnalyzer::analyze(double elapsedSeconds) {
+    elapsedSeconds = std::max(elapsedSeconds, 0.0);
+    bool fresh = snapshots.update();
+    const Snapshot& snapshot = snapshots.getReadBuffer();
+    fresh = fresh && snapshot.serial != 0 && snapshot.serial != analyzedSerial && snapshot.sampleRate > 0;
+
+    if (fresh) {
+        measure(snapshot);
+        analyzedSerial = snapshot.serial;
+        staleSeconds = 0.0;
+        ++analysisCount;
+    } else {
+        staleSeconds += elapsedSeconds;
+        if (staleSeconds >= STALE_SECONDS) {
+            std::fill(targetDb.begin(), targetDb.end(), static_cast<float>(FLOOR_DB));
+            peakFrequency = 0.0;
+        }
+    }
+
+    const float fall = static_cast<float>(FALL_DB_PER_SECOND * elapsedSeconds);
+    for (size_t bar = 0; bar < barCount; ++bar) {
+        levelDb[bar] = std::max(targetDb[bar], levelDb[bar] - fall);
+        if (levelDb[bar] >= peakDb[bar]) {
+            peakDb[bar] = levelDb[bar];
+            peakAge[bar] = 0.0f;
+        } else {
+            peakAge[bar] += static_cast<float>(elapsedSeconds);
+            if (peakAge[bar] > PEAK_HOLD_SECONDS) {
+                peakDb[bar] = std::max(levelDb[bar], peakDb[bar] - fall);
+            }
+        }
+    }
+    return fresh;
+}
+
+float SpectrumAnalyzer::getLevel(size_t bar) const {
+    if (bar >= barCount) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::clamp((levelDb[bar] - FLOOR_DB) / -FLOOR_DB, 0.0, 1.0));
+}
+
+float SpectrumAnalyzer::getPeak(size_t bar) const {
+    if (bar >= barCount) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::clamp((peakDb[bar] - FLOOR_DB) / -FLOOR_DB, 0.0, 1.0));
+}
+
+double SpectrumAnalyzer::getBarFrequency(size_t bar) const {
+    const int rate = mappedRate > 0 ? mappedRate : sampleRate.load(std::memory_order_relaxed);
+    const double top = rate > 0 ? std::min(MAX_FREQUENCY, rate / 2.0) : MAX_FREQUENCY;
+    const double bottom = std::min(MIN_FREQUENCY, top / 2.0);
+    return bottom * std::pow(top / bottom, (static_cast<double>(bar) + 0.5) / barCount);
+}
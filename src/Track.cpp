@@ -1,8 +1,11 @@
 #include "Track.h"
+#include "DurationScanner.h"
 #include <filesystem>
 #include <sstream>
 #include <stdexcept>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
 
 Track::Track() 
     : title("Untitled"), artist("Unknown Artist"), album("Unknown Album"),
@@ -37,13 +40,16 @@ Track::Track(const std::string& path)
         format = "WAV";
     } else if (extension == ".ogg" || extension == ".OGG") {
         format = "OGG";
+    } else if (extension == ".flac" || extension == ".FLAC") {
+        format = "FLAC";
     }
     
-    // Duração padrão baseada no tamanho (estimativa)
-    if (fileSize > 0) {
-        // Estimativa: ~1MB por minuto para MP3 de qualidade média
-        auto estimatedMinutes = fileSize / (1024 * 1024);
-        duration = std::chrono::seconds(estimatedMinutes * 60);
+    // Duração exata a partir do conteúdo (cabeçalho Xing/RIFF, granule Ogg, STREAMINFO ou varredura)
+    DurationScanner::Result scan;
+    if (fileSize > 0 && DurationScanner::scanFile(path, scan) && scan.sampleRate > 0) {
+        format = scan.format;
+        auto rate = static_cast<uint64_t>(scan.sampleRate);
+        duration = std::chrono::seconds((scan.totalFrames + rate / 2) / rate);
     }
 }
 
@@ -104,6 +110,13 @@ void Track::setFilePath(const std::string& path) {
     filePath = path;
 }
 
+void Track::setLoudness(const Loudness& newLoudness) {
+    if (!std::isfinite(newLoudness.integratedLufs) || !std::isfinite(newLoudness.trackGainDb)) {
+        throw std::invalid_argument("Loudness inválido para a faixa");
+    }
+    loudness = newLoudness;
+}
+
 bool Track::operator==(const Track& other) const {
     return filePath == other.filePath;
 }
@@ -124,11 +137,15 @@ bool Track::operator>(const Track& other) const {
 }
 
 bool Track::isValid() const {
+    // Arquivos sem tags (artista vazio) continuam reproduzíveis
     return !filePath.empty() && std::filesystem::exists(filePath) && 
-           !title.empty() && !artist.empty();
+           !title.empty();
 }
 
 std::string Track::getDisplayName() const {
+    if (artist.empty()) {
+        return title;
+    }
     return artist + " - " + title;
 }
 
@@ -143,6 +160,16 @@ std::string Track::getDurationString() const {
     return ss.str();
 }
 
+double Track::getReplayGainDb(bool albumMode) const {
+    if (!loudness) {
+        return 0.0;
+    }
+    const bool album = albumMode && loudness->hasAlbumGain;
+    const double gain = album ? loudness->albumGainDb : loudness->trackGainDb;
+    const double peak = album ? loudness->albumPeakDb : loudness->truePeakDb;
+    return std::min(gain, -peak);
+}
+
 std::shared_ptr<Track> Track::createFromFile(const std::string& filePath) {
     try {
         return std::make_shared<Track>(filePath);
@@ -0,0 +1,452 @@
+#include "VolumeStage.h"
+#include <algorithm>
+#include <cmath>
+#if defined(MP3PLAYER_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Ganho constante
+void scaleScalar(float* data, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] *= gain;
+    }
+}
+
+// Ganho por quadro: g0 + step * f (linear) ou g0 * step^f (exponencial)
+void rampScalar(float* data, size_t frames, int channels, float g0, float step, bool exponential) {
+    float gain = g0;
+    for (size_t f = 0; f < frames; ++f) {
+        if (!exponential) {
+            gain = g0 + step * static_cast<float>(f);
+        }
+        for (int c = 0; c < channels; ++c) {
+            data[f * channels + c] *= gain;
+        }
+        if (exponential) {
+            gain *= step;
+        }
+    }
+}
+
+float peakScalar(const float* data, size_t count) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, std::fabs(data[i]));
+    }
+    return peak;
+}
+
+// Ganho inicial de cada lane: lane l pertence ao quadro l / channels do vetor
+void laneGains(float* gains, int lanes, int channels, float g0, float step, bool exponential) {
+    for (int l = 0; l < lanes; ++l) {
+        const float frame = static_cast<float>(l / channels);
+        gains[l] = exponential ? g0 * std::pow(step, frame) : g0 + step * frame;
+    }
+}
+
+float gainAtFrame(float g0, float step, size_t frame, bool exponential) {
+    return exponential ? g0 * std::pow(step, static_cast<float>(frame)) : g0 + step * static_cast<float>(frame);
+}
+
+#if defined(MP3PLAYER_ARCH_X86)
+
+void scaleSse2(float* data, size_t count, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+        _mm_storeu_ps(data + i + 4, _mm_mul_ps(_mm_loadu_ps(data + i + 4), g));
+    }
+    scaleScalar(data + i, count - i, gain);
+}
+
+// Requer 4 % channels == 0
+void rampSse2(float* data, size_t frames, int channels, float g0, float step, bool exponential) {
+    const size_t framesPerVector = static_cast<size_t>(4 / channels);
+    alignas(16) float initial[4];
+    laneGains(initial, 4, channels, g0, step, exponential);
+    __m128 gain = _mm_load_ps(initial);
+    const __m128 advance = _mm_set1_ps(exponential ? std::pow(step, static_cast<float>(framesPerVector))
+                                                   : step * static_cast<float>(framesPerVector));
+    size_t f = 0;
+    if (exponential) {
+        for (; f + framesPerVector <= frames; f += framesPerVector) {
+            float* p = data + f * channels;
+            _mm_storeu_ps(p, _mm_mul_ps(_mm_loadu_ps(p), gain));
+            gain = _mm_mul_ps(gain, advance);
+        }
+    } else {
+        // Posição absoluta na rampa (sem acumular erro de arredondamento)
+        const __m128 base = gain;
+        __m128 offset = _mm_setzero_ps();
+        for (; f + framesPerVector <= frames; f += framesPerVector) {
+            float* p = data + f * channels;
+            _mm_storeu_ps(p, _mm_mul_ps(_mm_loadu_ps(p), _mm_add_ps(base, offset)));
+            offset = _mm_add_ps(offset, advance);
+        }
+    }
+    rampScalar(data + f * channels, frames - f, channels, gainAtFrame(g0, step, f, exponential), step, exponential);
+}
+
+float peakSse2(const float* data, size_t count) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 peak0 = _mm_setzero_ps(), peak1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        peak0 = _mm_max_ps(peak0, _mm_and_ps(_mm_loadu_ps(data + i), absMask));
+        peak1 = _mm_max_ps(peak1, _mm_and_ps(_mm_loadu_ps(data + i + 4), absMask));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_max_ps(peak0, peak1));
+    const float tail = peakScalar(data + i, count - i);
+    return std::max({lanes[0], lanes[1], lanes[2], lanes[3], tail});
+}
+
+MP3PLAYER_TARGET_AVX2 void scaleAvx2(float* data, size_t count, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+        _mm256_storeu_ps(data + i + 8, _mm256_mul_ps(_mm256_loadu_ps(data + i + 8), g));
+    }
+    scaleScalar(data + i, count - i, gain);
+}
+
+// Requer 8 % channels == 0
+MP3PLAYER_TARGET_AVX2 void rampAvx2(float* data, size_t frames, int channels, float g0, float step,
+                                    bool exponential) {
+    const size_t framesPerVector = static_cast<size_t>(8 / channels);
+    alignas(32) float initial[8];
+    laneGains(initial, 8, channels, g0, step, exponential);
+    __m256 gain = _mm256_load_ps(initial);
+    const __m256 advance = _mm256_set1_ps(exponential ? std::pow(step, static_cast<float>(framesPerVector))
+                                                      : step * static_cast<float>(framesPerVector));
+    size_t f = 0;
+    if (exponential) {
+        for (; f + framesPerVector <= frames; f += framesPerVector) {
+            float* p = data + f * channels;
+            _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_loadu_ps(p), gain));
+            gain = _mm256_mul_ps(gain, advance);
+        }
+    } else {
+        const __m256 base = gain;
+        __m256 offset = _mm256_setzero_ps();
+        for (; f + framesPerVector <= frames; f += framesPerVector) {
+            float* p = data + f * channels;
+            _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_loadu_ps(p), _mm256_add_ps(base, offset)));
+            offset = _mm256_add_ps(offset, advance);
+        }
+    }
+    rampScalar(data + f * channels, frames - f, channels, gainAtFrame(g0, step, f, exponential), step, exponential);
+}
+
+MP3PLAYER_TARGET_AVX2 float peakAvx2(const float* data, size_t count) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 peak0 = _mm256_setzero_ps(), peak1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+        peak1 = _mm256_max_ps(peak1, _mm256_and_ps(_mm256_loadu_ps(data + i + 8), absMask));
+    }
+    const __m256 peak = _mm256_max_ps(peak0, peak1);
+    const __m128 half = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, half);
+    const float tail = peakScalar(data + i, count - i);
+    return std::max({lanes[0], lanes[1], lanes[2], lanes[3], tail});
+}
+
+#endif
+
+// Curva do limitador: abaixo do joelho, ganho 1; acima, o pico de saída se aproxima
+// assintoticamente do teto (x / (1 + x): derivada contínua no joelho, uma divisão por quadro)
+float limiterGain(float peak) {
+    constexpr float knee = VolumeStage::LIMITER_KNEE;
+    constexpr float range = VolumeStage::LIMITER_CEILING - VolumeStage::LIMITER_KNEE;
+    if (peak <= knee) {
+        return 1.0f;
+    }
+    const float excess = peak - knee;
+    return (knee + range * excess / (range + excess)) / peak;
+}
+
+size_t lookaheadForRate(int rate) {
+    const auto frames = static_cast<size_t>(std::lround(VolumeStage::LIMITER_LOOKAHEAD_SECONDS * rate));
+    return std::clamp<size_t>(frames, 1, VolumeStage::MAX_LOOKAHEAD_FRAMES);
+}
+
+} // namespace
+
+VolumeStage::VolumeStage(double initialVolume)
+    : targetGain(static_cast<float>(std::clamp(initialVolume, 0.0, 1.0))), normalizationGain(1.0f),
+      rampShape(static_cast<int>(RampShape::EXPONENTIAL)), limiterEnabled(true), sampleRate(DEFAULT_SAMPLE_RATE),
+      prepareSerial(0), level(CpuFeatures::getSimdLevel()), currentGain(targetGain.load()),
+      rampFrom(currentGain), rampTo(currentGain), rampStep(0.0f), activeShape(RampShape::EXPONENTIAL),
+      rampFrames(1), rampPosition(1), appliedSerial(0), appliedChannels(0), lookaheadFrames(1),
+      releaseCoefficient(1.0f), delayLine(MAX_LOOKAHEAD_FRAMES * MAX_CHANNELS, 0.0f), delayPosition(0),
+      holdFrames(MAX_LOOKAHEAD_FRAMES + 1, 0), holdGains(MAX_LOOKAHEAD_FRAMES + 1, 1.0f), holdHead(0),
+      holdCount(0), smoothingWindow(MAX_LOOKAHEAD_FRAMES, 1.0f), smoothingPosition(0), smoothingSum(1.0),
+      envelope(1.0f), frameCounter(0), unityFrames(1) {}
+
+void VolumeStage::setVolume(double volume) {
+    targetGain.store(static_cast<float>(std::clamp(volume, 0.0, 1.0)), std::memory_order_relaxed);
+}
+
+void VolumeStage::setNormalizationGain(double gainDb) {
+    const double clamped = std::clamp(gainDb, -MAX_NORMALIZATION_DB, MAX_NORMALIZATION_DB);
+    normalizationGain.store(static_cast<float>(std::pow(10.0, clamped / 20.0)), std::memory_order_relaxed);
+}
+
+double VolumeStage::getNormalizationGain() const {
+    return 20.0 * std::log10(normalizationGain.load(std::memory_order_relaxed));
+}
+
+void VolumeStage::setRampShape(RampShape shape) {
+    rampShape.store(static_cast<int>(shape), std::memory_order_relaxed);
+}
+
+void VolumeStage::setLimiterEnabled(bool enable) {
+    limiterEnabled.store(enable, std::memory_order_relaxed);
+}
+
+void VolumeStage::prepare(int streamSampleRate) {
+    if (streamSampleRate <= 0) {
+        return;
+    }
+    sampleRate.store(streamSampleRate, std::memory_order_relaxed);
+    prepareSerial.fetch_add(1, std::memory_order_release);
+}
+
+size_t VolumeStage::getLatencyFrames() const {
+    return lookaheadForRate(sampleRate.load(std::memory_order_relaxed));
+}
+
+void VolumeStage::configure(int rate, int channels) {
+    appliedChannels = channels;
+    rampFrames = rampPosition = std::max<size_t>(static_cast<size_t>(std::lround(RAMP_SECONDS * rate)), 1);
+
+    // Limitador: atraso zerado, nenhuma redução em curso
+    lookaheadFrames = lookaheadForRate(rate);
+    releaseCoefficient = static_cast<float>(1.0 - std::exp(-1.0 / (LIMITER_RELEASE_SECONDS * rate)));
+    std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+    delayPosition = 0;
+    holdHead = holdCount = 0;
+    std::fill(smoothingWindow.begin(), smoothingWindow.end(), 1.0f);
+    smoothingPosition = 0;
+    smoothingSum = static_cast<double>(lookaheadFrames);
+    envelope = 1.0f;
+    frameCounter = 0;
+    unityFrames = lookaheadFrames;
+}
+
+float VolumeStage::rampGainAt(size_t position) const {
+    const float t = static_cast<float>(position) / static_cast<float>(rampFrames);
+    if (activeShape == RampShape::LINEAR) {
+        return rampFrom + (rampTo - rampFrom) * t;
+    }
+    const float from = std::max(rampFrom, EXPONENTIAL_FLOOR);
+    const float to = std::max(rampTo, EXPONENTIAL_FLOOR);
+    return from * std::pow(to / from, t);
+}
+
+void VolumeStage::startRamp(float target) {
+    if (rampPosition < rampFrames) {
+        currentGain = rampGainAt(rampPosition); // Nova rampa parte de onde a anterior está
+    }
+    rampFrom = currentGain;
+    rampTo = target;
+    activeShape = static_cast<RampShape>(rampShape.load(std::memory_order_relaxed));
+    rampPosition = 0;
+    const float frames = static_cast<float>(rampFrames);
+    if (activeShape == RampShape::LINEAR) {
+        rampStep = (rampTo - rampFrom) / frames;
+    } else {
+        const float from = std::max(rampFrom, EXPONENTIAL_FLOOR);
+        const float to = std::max(rampTo, EXPONENTIAL_FLOOR);
+        rampStep = std::pow(to / from, 1.0f / frames);
+    }
+}
+
+void VolumeStage::applyGain(float* interleaved, size_t frames, int channels) {
+    const size_t stride = static_cast<size_t>(channels);
+    size_t done = 0;
+    if (rampPosition < rampFrames) {
+        const size_t count = std::min(frames, rampFrames - rampPosition);
+        const float g0 = rampGainAt(rampPosition);
+        const bool exponential = activeShape == RampShape::EXPONENTIAL;
+        switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+            case CpuFeatures::SimdLevel::AVX2:
+                if (8 % channels == 0) {
+                    rampAvx2(interleaved, count, channels, g0, rampStep, exponential);
+                    break;
+                }
+                [[fallthrough]];
+            case CpuFeatures::SimdLevel::SSE2:
+                if (4 % channels == 0) {
+                    rampSse2(interleaved, count, channels, g0, rampStep, exponential);
+                    break;
+                }
+                [[fallthrough]];
+#endif
+            default:
+                rampScalar(interleaved, count, channels, g0, rampStep, exponential);
+                break;
+        }
+        rampPosition += count;
+        currentGain = rampPosition == rampFrames ? rampTo : rampGainAt(rampPosition);
+        done = count;
+    }
+
+    if (done == frames || currentGain == 1.0f) {
+        return; // Volume máximo fora de rampa: nada a multiplicar
+    }
+    float* rest = interleaved + done * stride;
+    const size_t count = (frames - done) * stride;
+    switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+        case CpuFeatures::SimdLevel::AVX2:
+            scaleAvx2(rest, count, currentGain);
+            break;
+        case CpuFeatures::SimdLevel::SSE2:
+            scaleSse2(rest, count, currentGain);
+            break;
+#endif
+        default:
+            scaleScalar(rest, count, currentGain);
+            break;
+    }
+}
+
+bool VolumeStage::limiterIdle() const {
+    return holdCount == 0 && envelope == 1.0f && unityFrames >= lookaheadFrames;
+}
+
+void VolumeStage::limit(float* interleaved, size_t frames, int channels) {
+    const size_t stride = static_cast<size_t>(channels);
+    const bool reduce = limiterEnabled.load(std::memory_order_relaxed);
+
+    if (limiterIdle()) {
+        float peak = 0.0f;
+        if (reduce) {
+            switch (level) {
+#if defined(MP3PLAYER_ARCH_X86)
+                case CpuFeatures::SimdLevel::AVX2:
+                    peak = peakAvx2(interleaved, frames * stride);
+                    break;
+                case CpuFeatures::SimdLevel::SSE2:
+                    peak = peakSse2(interleaved, frames * stride);
+                    break;
+#endif
+                default:
+                    peak = peakScalar(interleaved, frames * stride);
+                    break;
+            }
+        }
+        if (peak <= LIMITER_KNEE) {
+            // Nenhum pico acima do joelho e nenhuma redução em curso: apenas o atraso
+            float* ring = delayLine.data();
+            const size_t ringSamples = lookaheadFrames * stride;
+            const size_t total = frames * stride;
+            size_t position = delayPosition * stride;
+            for (size_t i = 0; i < total;) {
+                const size_t count = std::min(total - i, ringSamples - position);
+                std::swap_ranges(interleaved + i, interleaved + i + count, ring + position);
+                i += count;
+                position += count;
+                if (position == ringSamples) {
+                    position = 0;
+                }
+            }
+            delayPosition = position / stride;
+            frameCounter += frames;
+            return;
+        }
+    }
+
+    const size_t capacity = lookaheadFrames + 1;
+    const double windowScale = 1.0 / static_cast<double>(lookaheadFrames);
+    for (size_t f = 0; f < frames; ++f) {
+        float* frame = interleaved + f * stride;
+        float peak = 0.0f;
+        for (size_t c = 0; c < stride; ++c) {
+            peak = std::max(peak, std::fabs(frame[c]));
+        }
+        const float required = reduce ? limiterGain(peak) : 1.0f;
+
+        // Mínimo deslizante sobre os últimos lookaheadFrames + 1 quadros (fila monotônica)
+        const uint64_t now = frameCounter++;
+        if (holdCount > 0 && holdFrames[holdHead] + lookaheadFrames < now) {
+            holdHead = holdHead + 1 == capacity ? 0 : holdHead + 1;
+            --holdCount;
+        }
+        if (required < 1.0f) {
+            auto slot = [&](size_t offset) {
+                const size_t index = holdHead + offset;
+                return index >= capacity ? index - capacity : index;
+            };
+            while (holdCount > 0 && holdGains[slot(holdCount - 1)] >= required) {
+                --holdCount;
+            }
+            const size_t tail = slot(holdCount);
+            holdFrames[tail] = now;
+            holdGains[tail] = required;
+            ++holdCount;
+        }
+        const float hold = holdCount > 0 ? holdGains[holdHead] : 1.0f;
+
+        // Ataque imediato, liberação exponencial; perto de 1 encaixa para voltar ao repouso
+        if (hold < envelope) {
+            envelope = hold;
+        } else {
+            envelope += (hold - envelope) * releaseCoefficient;
+            if (1.0f - envelope < 1e-4f) {
+                envelope = 1.0f;
+            }
+        }
+
+        // Média móvel de lookaheadFrames: a redução chega ao mínimo quando o pico sai do atraso
+        smoothingSum += static_cast<double>(envelope) - smoothingWindow[smoothingPosition];
+        smoothingWindow[smoothingPosition] = envelope;
+        smoothingPosition = smoothingPosition + 1 == lookaheadFrames ? 0 : smoothingPosition + 1;
+        unityFrames = envelope == 1.0f ? std::min(unityFrames + 1, lookaheadFrames) : 0;
+        if (unityFrames == lookaheadFrames) {
+            smoothingSum = static_cast<double>(lookaheadFrames); // Janela toda em 1: sem deriva
+        }
+        const float gain = static_cast<float>(smoothingSum * windowScale);
+
+        float* delayed = delayLine.data() + delayPosition * stride;
+        for (size_t c = 0; c < stride; ++c) {
+            const float input = frame[c];
+            frame[c] = delayed[c] * gain;
+            delayed[c] = input;
+        }
+        delayPosition = delayPosition + 1 == lookaheadFrames ? 0 : delayPosition + 1;
+    }
+}
+
+void VolumeStage::process(float* interleaved, size_t frames, int channels) {
+    if (!interleaved || frames == 0 || channels <= 0) {
+        return;
+    }
+    const uint32_t serial = prepareSerial.load(std::memory_order_acquire);
+    const bool newStream = serial != appliedSerial || channels != appliedChannels;
+    if (newStream) {
+        appliedSerial = serial;
+        configure(sampleRate.load(std::memory_order_relaxed), channels);
+    }
+
+    const float target =
+        targetGain.load(std::memory_order_relaxed) * normalizationGain.load(std::memory_order_relaxed);
+    if (newStream) {
+        currentGain = rampFrom = rampTo = target; // Stream novo começa do silêncio: sem rampa
+    } else if (target != rampTo) {
+        startRamp(target);
+    }
+    applyGain(interleaved, frames, channels);
+    if (channels <= MAX_CHANNELS) {
+        limit(interleaved, frames, channels);
+    }
+}
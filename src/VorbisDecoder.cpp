@@ -0,0 +1,1192 @@
+#include "VorbisDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+/**
+ * @brief Leitor de bits do Vorbis: LSB primeiro, cache de 64 bits
+ *
+ * Bits além do fim do pacote são lidos como zero e marcam o leitor como esgotado; a
+ * especificação trata esse caso como fim do pacote, não como erro.
+ */
+class VorbisBitReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bytePos;
+    uint64_t cache;
+    int cacheBits;
+    bool overrun;
+
+    void refill() {
+        while (cacheBits <= 56 && bytePos < size) {
+            cache |= static_cast<uint64_t>(data[bytePos++]) << cacheBits;
+            cacheBits += 8;
+        }
+    }
+
+public:
+    VorbisBitReader(const uint8_t* bytes, size_t length)
+        : data(bytes), size(length), bytePos(0), cache(0), cacheBits(0), overrun(false) {}
+
+    // Próximos n bits (n <= 32) sem consumi-los
+    uint32_t peek(int n) {
+        if (cacheBits < n) {
+            refill();
+        }
+        return static_cast<uint32_t>(cache & ((static_cast<uint64_t>(1) << n) - 1));
+    }
+
+    void consume(int n) {
+        if (n > cacheBits) {
+            overrun = true;
+            cache = 0;
+            cacheBits = 0;
+            return;
+        }
+        cache >>= n;
+        cacheBits -= n;
+    }
+
+    uint32_t read(int n) {
+        if (n == 0) {
+            return 0;
+        }
+        const uint32_t value = peek(n);
+        consume(n);
+        return value;
+    }
+
+    bool hasOverrun() const { return overrun; }
+};
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Ordem WAV/SMPTE a partir da ordem Vorbis (seção 4.3.9 da especificação)
+constexpr int CHANNEL_ORDERS[VorbisDecoder::MAX_CHANNELS][VorbisDecoder::MAX_CHANNELS] = {
+    {0},
+    {0, 1},
+    {0, 2, 1},
+    {0, 1, 2, 3},
+    {0, 2, 1, 3, 4},
+    {0, 2, 1, 5, 3, 4},
+    {0, 2, 1, 6, 5, 3, 4},
+    {0, 2, 1, 7, 5, 6, 3, 4},
+};
+
+constexpr int FLOOR1_RANGES[4] = {256, 128, 86, 64};
+
+int ilog(int64_t value) {
+    int bits = 0;
+    while (value > 0) {
+        ++bits;
+        value >>= 1;
+    }
+    return bits;
+}
+
+uint32_t reverseBits(uint32_t v) {
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0f0f0f0fu) | ((v & 0x0f0f0f0fu) << 4);
+    v = ((v >> 8) & 0x00ff00ffu) | ((v & 0x00ff00ffu) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+float unpackFloat32(uint32_t x) {
+    int32_t mantissa = static_cast<int32_t>(x & 0x1fffff);
+    const int exponent = static_cast<int>((x & 0x7fe00000u) >> 21);
+    if (x & 0x80000000u) {
+        mantissa = -mantissa;
+    }
+    return static_cast<float>(std::ldexp(static_cast<double>(mantissa), exponent - 788));
+}
+
+// Maior r com r^dimensions <= entries
+int lookup1Values(int entries, int dimensions) {
+    auto power = [dimensions](int base) {
+        double result = 1.0;
+        for (int i = 0; i < dimensions; ++i) {
+            result *= base;
+        }
+        return result;
+    };
+    int r = static_cast<int>(std::floor(std::exp(std::log(static_cast<double>(entries)) / dimensions)));
+    while (power(r + 1) <= entries) {
+        ++r;
+    }
+    while (r > 0 && power(r) > entries) {
+        --r;
+    }
+    return r;
+}
+
+// Tabela de dB inverso do floor 1: 1.0649863e-07 * r^i, com o último valor em 1.0
+const float* inverseDbTable() {
+    static const auto table = [] {
+        std::array<float, 256> values{};
+        const double ratio = std::pow(1.0 / 1.0649863e-07, 1.0 / 255.0);
+        for (int i = 0; i < 256; ++i) {
+            values[i] = static_cast<float>(1.0649863e-07 * std::pow(ratio, i));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+int renderPoint(int x0, int y0, int x1, int y1, int x) {
+    const int dy = y1 - y0;
+    const int adx = x1 - x0;
+    const int offset = std::abs(dy) * (x - x0) / adx;
+    return dy < 0 ? y0 - offset : y0 + offset;
+}
+
+// Reta de Bresenham da especificação, de x0 (inclusive) até x1 (exclusive), limitada a n
+void renderLine(int x0, int y0, int x1, int y1, float* curve, int n) {
+    const float* db = inverseDbTable();
+    const int dy = y1 - y0;
+    const int adx = x1 - x0;
+    const int base = dy / adx;
+    const int sy = dy < 0 ? base - 1 : base + 1;
+    const int ady = std::abs(dy) - std::abs(base) * adx;
+    const int end = std::min(x1, n);
+    int y = y0;
+    int err = 0;
+    if (x0 < end) {
+        curve[x0] = db[std::clamp(y, 0, 255)];
+    }
+    for (int x = x0 + 1; x < end; ++x) {
+        err += ady;
+        if (err >= adx) {
+            err -= adx;
+            y += sy;
+        } else {
+            y += base;
+        }
+        curve[x] = db[std::clamp(y, 0, 255)];
+    }
+}
+
+bool matchesSignature(const uint8_t* data, size_t size, uint8_t type) {
+    return size >= 7 && data[0] == type && std::memcmp(data + 1, "vorbis", 6) == 0;
+}
+
+} // namespace
+
+VorbisDecoder::VorbisDecoder()
+    : channels(0), sampleRate(0), blockSizes{0, 0}, channelOrder{}, modeBits(0), hasFloor{}, skipResidue{},
+      pendingStart(0), pendingCount(0), previousBlockSize(0), skipPackets(0), seekIndexBuilt(false), audioStart(0),
+      streamStart(0), streamEnd(-1), decodedEnd(0), discardBefore(0), position(0) {}
+
+VorbisDecoder::~VorbisDecoder() = default;
+
+void VorbisDecoder::open(const std::string& filePath) {
+    close();
+    if (!demuxer.open(filePath)) {
+        throw DecoderException("Não foi possível abrir o arquivo Ogg: " + filePath);
+    }
+    try {
+        if (!readHeaders()) {
+            throw DecoderException("Nenhum stream Vorbis válido em: " + filePath);
+        }
+    } catch (const DecoderException&) {
+        close();
+        throw;
+    }
+    allocateState();
+
+    streamEnd = demuxer.findLastGranule();
+    restartAt(audioStart, 0, findStreamBase(), 0);
+    // A primeira amostra é a de granule 0, a menos que o stream comece depois dela
+    streamStart = std::max<int64_t>(decodedEnd, 0);
+    discardBefore = streamStart;
+    position = 0;
+}
+
+void VorbisDecoder::close() {
+    demuxer.close();
+    channels = 0;
+    sampleRate = 0;
+    blockSizes = {0, 0};
+    codebooks.clear();
+    floors.clear();
+    residues.clear();
+    mappings.clear();
+    modes.clear();
+    pendingStart = pendingCount = 0;
+    previousBlockSize = 0;
+    skipPackets = 0;
+    seekPages.clear();
+    seekPoints.clear();
+    seekIndexBuilt = false;
+    audioStart = 0;
+    streamStart = 0;
+    streamEnd = -1;
+    decodedEnd = discardBefore = 0;
+    position = 0;
+}
+
+bool VorbisDecoder::readHeaders() {
+    // O primeiro stream lógico cujo pacote inicial é uma identificação Vorbis
+    OggDemuxer::Packet packet;
+    bool identified = false;
+    const std::vector<uint32_t> serials = demuxer.getStreamSerials();
+    for (uint32_t serial : serials) {
+        demuxer.selectStream(serial);
+        if (demuxer.nextPacket(packet) && readIdentification(packet.data, packet.size)) {
+            identified = true;
+            break;
+        }
+    }
+    if (!identified) {
+        return false;
+    }
+
+    if (!demuxer.nextPacket(packet) || !matchesSignature(packet.data, packet.size, 3)) {
+        return false;
+    }
+    if (!demuxer.nextPacket(packet) || !readSetup(packet.data, packet.size)) {
+        return false;
+    }
+    // O primeiro pacote de áudio sempre começa em uma página nova
+    audioStart = demuxer.getNextPageOffset();
+    return true;
+}
+
+bool VorbisDecoder::readIdentification(const uint8_t* data, size_t size) {
+    if (!matchesSignature(data, size, 1) || size < 30) {
+        return false;
+    }
+    VorbisBitReader bits(data + 7, size - 7);
+    const uint32_t version = bits.read(32);
+    const int channelCount = static_cast<int>(bits.read(8));
+    const uint32_t rate = bits.read(32);
+    bits.read(32); // Taxas de bits máxima, nominal e mínima (informativas)
+    bits.read(32);
+    bits.read(32);
+    const int shortBlock = 1 << bits.read(4);
+    const int longBlock = 1 << bits.read(4);
+    const bool framing = bits.read(1) != 0;
+
+    if (version != 0 || channelCount < 1 || rate == 0 || rate > 768000 || !framing || shortBlock < 64 ||
+        longBlock > 8192 || shortBlock > longBlock) {
+        return false;
+    }
+    if (channelCount > MAX_CHANNELS) {
+        throw DecoderException("Vorbis com mais de 8 canais não é suportado");
+    }
+    channels = channelCount;
+    sampleRate = static_cast<int>(rate);
+    blockSizes = {shortBlock, longBlock};
+    for (int c = 0; c < channels; ++c) {
+        channelOrder[c] = CHANNEL_ORDERS[channels - 1][c];
+    }
+    return true;
+}
+
+bool VorbisDecoder::readSetup(const uint8_t* data, size_t size) {
+    if (!matchesSignature(data, size, 5)) {
+        return false;
+    }
+    VorbisBitReader bits(data + 7, size - 7);
+
+    codebooks.resize(bits.read(8) + 1);
+    for (Codebook& book : codebooks) {
+        if (!readCodebook(bits, book)) {
+            return false;
+        }
+    }
+
+    // Transformadas no domínio do tempo: reservadas, sempre 0
+    const int timeCount = static_cast<int>(bits.read(6)) + 1;
+    for (int i = 0; i < timeCount; ++i) {
+        if (bits.read(16) != 0) {
+            return false;
+        }
+    }
+
+    floors.resize(bits.read(6) + 1);
+    for (Floor1& floor : floors) {
+        const uint32_t type = bits.read(16);
+        if (type == 0) {
+            throw DecoderException("Vorbis com floor tipo 0 não é suportado");
+        }
+        if (type != 1 || !readFloor(bits, floor)) {
+            return false;
+        }
+    }
+
+    residues.resize(bits.read(6) + 1);
+    for (Residue& residue : residues) {
+        residue.type = static_cast<int>(bits.read(16));
+        if (residue.type > 2 || !readResidue(bits, residue)) {
+            return false;
+        }
+    }
+
+    mappings.resize(bits.read(6) + 1);
+    for (Mapping& mapping : mappings) {
+        if (bits.read(16) != 0 || !readMapping(bits, mapping)) {
+            return false;
+        }
+    }
+
+    modes.resize(bits.read(6) + 1);
+    for (Mode& mode : modes) {
+        mode.blockFlag = bits.read(1) != 0;
+        const uint32_t windowType = bits.read(16);
+        const uint32_t transformType = bits.read(16);
+        mode.mapping = static_cast<int>(bits.read(8));
+        if (windowType != 0 || transformType != 0 || mode.mapping >= static_cast<int>(mappings.size())) {
+            return false;
+        }
+    }
+    modeBits = ilog(static_cast<int64_t>(modes.size()) - 1);
+
+    const bool framing = bits.read(1) != 0;
+    return framing && !bits.hasOverrun();
+}
+
+bool VorbisDecoder::readCodebook(VorbisBitReader& bits, Codebook& book) {
+    if (bits.read(24) != 0x564342) {
+        return false;
+    }
+    book.dimensions = static_cast<int>(bits.read(16));
+    book.entries = static_cast<int>(bits.read(24));
+    if (book.dimensions == 0 || book.entries == 0 || bits.hasOverrun()) {
+        return false;
+    }
+
+    book.lengths.assign(book.entries, 0);
+    if (bits.read(1) == 0) {
+        const bool sparse = bits.read(1) != 0;
+        for (int i = 0; i < book.entries; ++i) {
+            if (!sparse || bits.read(1)) {
+                book.lengths[i] = static_cast<uint8_t>(bits.read(5) + 1);
+            }
+        }
+    } else {
+        // Comprimentos em ordem crescente, em sequências
+        int entry = 0;
+        int length = static_cast<int>(bits.read(5)) + 1;
+        while (entry < book.entries) {
+            const int count = static_cast<int>(bits.read(ilog(book.entries - entry)));
+            if (length > 32 || entry + count > book.entries) {
+                return false;
+            }
+            std::fill_n(book.lengths.begin() + entry, count, static_cast<uint8_t>(length));
+            entry += count;
+            ++length;
+        }
+    }
+    if (bits.hasOverrun()) {
+        return false;
+    }
+
+    // Palavras de código pela ordem das entradas (algoritmo de marcadores do libvorbis)
+    std::vector<uint32_t> codes(book.entries, 0);
+    uint32_t marker[33] = {0};
+    for (int i = 0; i < book.entries; ++i) {
+        const int length = book.lengths[i];
+        if (length == 0) {
+            continue;
+        }
+        uint32_t entry = marker[length];
+        if (length < 32 && (entry >> length) != 0) {
+            return false; // Árvore com palavras demais
+        }
+        codes[i] = entry;
+        for (int j = length; j > 0; --j) {
+            if (marker[j] & 1) {
+                if (j == 1) {
+                    ++marker[1];
+                } else {
+                    marker[j] = marker[j - 1] << 1;
+                }
+                break;
+            }
+            ++marker[j];
+        }
+        for (int j = length + 1; j < 33; ++j) {
+            if ((marker[j] >> 1) != entry) {
+                break;
+            }
+            entry = marker[j];
+            marker[j] = marker[j - 1] << 1;
+        }
+    }
+
+    // Tabela direta para palavras curtas (bits na ordem de leitura) e busca binária para as demais
+    book.fast.assign(static_cast<size_t>(1) << FAST_BITS, -1);
+    std::vector<int> used;
+    for (int i = 0; i < book.entries; ++i) {
+        const int length = book.lengths[i];
+        if (length == 0) {
+            continue;
+        }
+        used.push_back(i);
+        if (length <= FAST_BITS) {
+            const uint32_t reversed = reverseBits(codes[i]) >> (32 - length);
+            for (uint32_t index = reversed; index < book.fast.size(); index += 1u << length) {
+                book.fast[index] = i;
+            }
+        }
+    }
+    auto leftAligned = [&](int entry) { return codes[entry] << (32 - book.lengths[entry]); };
+    std::sort(used.begin(), used.end(), [&](int a, int b) { return leftAligned(a) < leftAligned(b); });
+    book.sortedCodes.resize(used.size());
+    book.sortedLengths.resize(used.size());
+    book.sortedEntries.resize(used.size());
+    for (size_t i = 0; i < used.size(); ++i) {
+        book.sortedCodes[i] = leftAligned(used[i]);
+        book.sortedLengths[i] = book.lengths[used[i]];
+        book.sortedEntries[i] = used[i];
+    }
+
+    book.lookupType = static_cast<int>(bits.read(4));
+    if (book.lookupType == 0) {
+        return !bits.hasOverrun();
+    }
+    if (book.lookupType > 2) {
+        return false;
+    }
+    const float minimum = unpackFloat32(bits.read(32));
+    const float delta = unpackFloat32(bits.read(32));
+    const int valueBits = static_cast<int>(bits.read(4)) + 1;
+    const bool sequential = bits.read(1) != 0;
+    const int64_t lookupValues = book.lookupType == 1 ? lookup1Values(book.entries, book.dimensions)
+                                                      : static_cast<int64_t>(book.entries) * book.dimensions;
+    if (lookupValues <= 0 || lookupValues > (1 << 24)) {
+        return false;
+    }
+    std::vector<uint32_t> multiplicands(static_cast<size_t>(lookupValues));
+    for (uint32_t& value : multiplicands) {
+        value = bits.read(valueBits);
+    }
+    if (bits.hasOverrun()) {
+        return false;
+    }
+
+    // Vetores de todas as entradas, calculados uma vez
+    book.vectors.assign(static_cast<size_t>(book.entries) * book.dimensions, 0.0f);
+    for (int entry = 0; entry < book.entries; ++entry) {
+        float* vector = book.vectors.data() + static_cast<size_t>(entry) * book.dimensions;
+        float last = 0.0f;
+        int64_t divisor = 1;
+        for (int i = 0; i < book.dimensions; ++i) {
+            const size_t offset = book.lookupType == 1
+                                      ? static_cast<size_t>((entry / divisor) % lookupValues)
+                                      : static_cast<size_t>(entry) * book.dimensions + i;
+            const float value = static_cast<float>(multiplicands[offset]) * delta + minimum + last;
+            vector[i] = value;
+            if (sequential) {
+                last = value;
+            }
+            if (book.lookupType == 1) {
+                divisor *= lookupValues;
+            }
+        }
+    }
+    return true;
+}
+
+bool VorbisDecoder::readFloor(VorbisBitReader& bits, Floor1& floor) {
+    const int books = static_cast<int>(codebooks.size());
+    const int partitions = static_cast<int>(bits.read(5));
+    floor.partitionClass.resize(partitions);
+    int maxClass = -1;
+    for (int& partitionClass : floor.partitionClass) {
+        partitionClass = static_cast<int>(bits.read(4));
+        maxClass = std::max(maxClass, partitionClass);
+    }
+    for (int c = 0; c <= maxClass; ++c) {
+        floor.classDimensions[c] = static_cast<int>(bits.read(3)) + 1;
+        floor.classSubclasses[c] = static_cast<int>(bits.read(2));
+        if (floor.classSubclasses[c] > 0) {
+            floor.classMasterbook[c] = static_cast<int>(bits.read(8));
+            if (floor.classMasterbook[c] >= books) {
+                return false;
+            }
+        }
+        for (int j = 0; j < (1 << floor.classSubclasses[c]); ++j) {
+            floor.subclassBooks[c][j] = static_cast<int>(bits.read(8)) - 1;
+            if (floor.subclassBooks[c][j] >= books) {
+                return false;
+            }
+        }
+    }
+    floor.multiplier = static_cast<int>(bits.read(2)) + 1;
+    const int rangeBits = static_cast<int>(bits.read(4));
+    floor.xList = {0, 1 << rangeBits};
+    for (int partitionClass : floor.partitionClass) {
+        for (int j = 0; j < floor.classDimensions[partitionClass]; ++j) {
+            floor.xList.push_back(static_cast<int>(bits.read(rangeBits)));
+        }
+    }
+    if (bits.hasOverrun() || floor.xList.size() > 65) {
+        return false;
+    }
+
+    const int values = static_cast<int>(floor.xList.size());
+    floor.sortedOrder.resize(values);
+    std::iota(floor.sortedOrder.begin(), floor.sortedOrder.end(), 0);
+    std::sort(floor.sortedOrder.begin(), floor.sortedOrder.end(),
+              [&](int a, int b) { return floor.xList[a] < floor.xList[b]; });
+    for (int i = 1; i < values; ++i) {
+        if (floor.xList[floor.sortedOrder[i]] == floor.xList[floor.sortedOrder[i - 1]]) {
+            return false; // X repetido tornaria as retas degeneradas
+        }
+    }
+
+    // Vizinhos anteriores mais próximos abaixo e acima de cada X
+    floor.lowNeighbor.assign(values, 0);
+    floor.highNeighbor.assign(values, 1);
+    for (int i = 2; i < values; ++i) {
+        int low = 0;
+        int high = 1;
+        for (int j = 0; j < i; ++j) {
+            if (floor.xList[j] < floor.xList[i] && floor.xList[j] > floor.xList[low]) {
+                low = j;
+            }
+            if (floor.xList[j] > floor.xList[i] && floor.xList[j] < floor.xList[high]) {
+                high = j;
+            }
+        }
+        floor.lowNeighbor[i] = low;
+        floor.highNeighbor[i] = high;
+    }
+    return true;
+}
+
+bool VorbisDecoder::readResidue(VorbisBitReader& bits, Residue& residue) {
+    residue.begin = bits.read(24);
+    residue.end = bits.read(24);
+    residue.partitionSize = bits.read(24) + 1;
+    residue.classifications = static_cast<int>(bits.read(6)) + 1;
+    residue.classbook = static_cast<int>(bits.read(8));
+    if (residue.classbook >= static_cast<int>(codebooks.size())) {
+        return false;
+    }
+
+    std::vector<int> cascade(residue.classifications);
+    for (int& passes : cascade) {
+        const int low = static_cast<int>(bits.read(3));
+        const int high = bits.read(1) ? static_cast<int>(bits.read(5)) : 0;
+        passes = high * 8 + low;
+    }
+    residue.books.resize(residue.classifications);
+    for (int c = 0; c < residue.classifications; ++c) {
+        for (int pass = 0; pass < 8; ++pass) {
+            int book = -1;
+            if (cascade[c] & (1 << pass)) {
+                book = static_cast<int>(bits.read(8));
+                if (book >= static_cast<int>(codebooks.size()) || codebooks[book].lookupType == 0) {
+                    return false;
+                }
+            }
+            residue.books[c][pass] = static_cast<int16_t>(book);
+        }
+    }
+    return !bits.hasOverrun();
+}
+
+bool VorbisDecoder::readMapping(VorbisBitReader& bits, Mapping& mapping) {
+    const int submaps = bits.read(1) ? static_cast<int>(bits.read(4)) + 1 : 1;
+    if (bits.read(1)) {
+        const int steps = static_cast<int>(bits.read(8)) + 1;
+        const int channelBits = ilog(channels - 1);
+        for (int i = 0; i < steps; ++i) {
+            const int magnitude = static_cast<int>(bits.read(channelBits));
+            const int angle = static_cast<int>(bits.read(channelBits));
+            if (magnitude == angle || magnitude >= channels || angle >= channels) {
+                return false;
+            }
+            mapping.coupling.emplace_back(magnitude, angle);
+        }
+    }
+    if (bits.read(2) != 0) {
+        return false;
+    }
+    mapping.mux.assign(channels, 0);
+    if (submaps > 1) {
+        for (int& mux : mapping.mux) {
+            mux = static_cast<int>(bits.read(4));
+            if (mux >= submaps) {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < submaps; ++i) {
+        bits.read(8); // Configuração de tempo, sem uso
+        const int floor = static_cast<int>(bits.read(8));
+        const int residue = static_cast<int>(bits.read(8));
+        if (floor >= static_cast<int>(floors.size()) || residue >= static_cast<int>(residues.size())) {
+            return false;
+        }
+        mapping.submapFloor.push_back(floor);
+        mapping.submapResidue.push_back(residue);
+    }
+    return !bits.hasOverrun();
+}
+
+void VorbisDecoder::allocateState() {
+    const int longBlock = blockSizes[1];
+    for (int flag = 0; flag < 2; ++flag) {
+        imdct[flag] = std::make_unique<Imdct>(static_cast<size_t>(blockSizes[flag]));
+
+        // Rampa da janela Vorbis: sin(π/2 sin²((i + 1/2) / L · π/2))
+        const int slope = blockSizes[flag] / 2;
+        rise[flag].resize(slope);
+        fall[flag].resize(slope);
+        for (int i = 0; i < slope; ++i) {
+            const double s = std::sin((i + 0.5) / slope * PI / 2.0);
+            rise[flag][i] = static_cast<float>(std::sin(PI / 2.0 * s * s));
+        }
+        std::reverse_copy(rise[flag].begin(), rise[flag].end(), fall[flag].begin());
+    }
+
+    // Classificações: partições do maior vetor (resíduo tipo 2 intercala todos os canais)
+    size_t classificationSlots = 0;
+    for (const Residue& residue : residues) {
+        const uint64_t size = static_cast<uint64_t>(longBlock / 2) * (residue.type == 2 ? channels : 1);
+        const uint64_t begin = std::min<uint64_t>(residue.begin, size);
+        const uint64_t end = std::min<uint64_t>(residue.end, size);
+        const uint64_t partitions = end > begin ? (end - begin) / residue.partitionSize : 0;
+        classificationSlots = std::max<size_t>(classificationSlots,
+                                               partitions + codebooks[residue.classbook].dimensions);
+    }
+
+    const size_t half = static_cast<size_t>(longBlock / 2);
+    spectrum.assign(channels, std::vector<float>(half, 0.0f));
+    block.assign(channels, std::vector<float>(longBlock, 0.0f));
+    saved.assign(channels, std::vector<float>(half, 0.0f));
+    planar.assign(channels, std::vector<float>(half, 0.0f));
+    floorY.assign(channels, std::vector<int>(65, 0));
+    floorStep2.assign(channels, std::vector<uint8_t>(65, 0));
+    floorCurve.assign(channels, std::vector<float>(half, 0.0f));
+    classifications.assign(channels, std::vector<uint8_t>(classificationSlots, 0));
+    interleavedResidue.assign(half * channels, 0.0f);
+    submapChannels.reserve(channels);
+    pending.assign(half * channels, 0.0f);
+}
+
+int VorbisDecoder::decodeEntry(const Codebook& book, VorbisBitReader& bits) const {
+    if (book.sortedCodes.empty()) {
+        return -1;
+    }
+    const int32_t fast = book.fast[bits.peek(FAST_BITS)];
+    if (fast >= 0) {
+        bits.consume(book.lengths[fast]);
+        return bits.hasOverrun() ? -1 : fast;
+    }
+
+    // Maior palavra alinhada à esquerda <= próximos 32 bits (em ordem de leitura)
+    const uint32_t value = reverseBits(bits.peek(32));
+    auto it = std::upper_bound(book.sortedCodes.begin(), book.sortedCodes.end(), value);
+    if (it == book.sortedCodes.begin()) {
+        return -1;
+    }
+    const size_t index = static_cast<size_t>(it - book.sortedCodes.begin()) - 1;
+    const int length = book.sortedLengths[index];
+    if (length < 32 && ((value ^ book.sortedCodes[index]) >> (32 - length)) != 0) {
+        return -1; // Árvore incompleta: nenhuma palavra é prefixo dos bits
+    }
+    bits.consume(length);
+    return bits.hasOverrun() ? -1 : book.sortedEntries[index];
+}
+
+bool VorbisDecoder::decodeFloor(const Floor1& floor, VorbisBitReader& bits, int channel) {
+    if (bits.read(1) == 0) {
+        return false; // Canal sem energia neste bloco
+    }
+    const int range = FLOOR1_RANGES[floor.multiplier - 1];
+    std::vector<int>& y = floorY[channel];
+    const int yBits = ilog(range - 1);
+    y[0] = static_cast<int>(bits.read(yBits));
+    y[1] = static_cast<int>(bits.read(yBits));
+
+    size_t offset = 2;
+    for (int partitionClass : floor.partitionClass) {
+        const int dimensions = floor.classDimensions[partitionClass];
+        const int classBits = floor.classSubclasses[partitionClass];
+        const int mask = (1 << classBits) - 1;
+        int classValue = 0;
+        if (classBits > 0) {
+            classValue = decodeEntry(codebooks[floor.classMasterbook[partitionClass]], bits);
+            if (classValue < 0) {
+                return false;
+            }
+        }
+        for (int j = 0; j < dimensions; ++j) {
+            const int book = floor.subclassBooks[partitionClass][classValue & mask];
+            classValue >>= classBits;
+            int value = 0;
+            if (book >= 0) {
+                value = decodeEntry(codebooks[book], bits);
+                if (value < 0) {
+                    return false; // Fim do pacote: o canal fica sem floor
+                }
+            }
+            y[offset + j] = value;
+        }
+        offset += static_cast<size_t>(dimensions);
+    }
+    if (bits.hasOverrun()) {
+        return false;
+    }
+
+    // Síntese das amplitudes: cada Y é codificado como diferença da reta dos vizinhos
+    std::vector<uint8_t>& step2 = floorStep2[channel];
+    const int values = static_cast<int>(floor.xList.size());
+    step2[0] = step2[1] = 1;
+    for (int i = 2; i < values; ++i) {
+        const int low = floor.lowNeighbor[i];
+        const int high = floor.highNeighbor[i];
+        const int predicted = renderPoint(floor.xList[low], y[low], floor.xList[high], y[high], floor.xList[i]);
+        const int value = y[i];
+        const int highRoom = range - predicted;
+        const int lowRoom = predicted;
+        const int room = std::min(highRoom, lowRoom) * 2;
+        if (value == 0) {
+            step2[i] = 0;
+            y[i] = predicted;
+            continue;
+        }
+        step2[low] = step2[high] = step2[i] = 1;
+        if (value >= room) {
+            y[i] = highRoom > lowRoom ? value - lowRoom + predicted : predicted - value + highRoom - 1;
+        } else {
+            y[i] = (value & 1) ? predicted - (value + 1) / 2 : predicted + value / 2;
+        }
+    }
+    return true;
+}
+
+void VorbisDecoder::renderFloor(const Floor1& floor, int channel, int n) {
+    const std::vector<int>& y = floorY[channel];
+    const std::vector<uint8_t>& step2 = floorStep2[channel];
+    float* curve = floorCurve[channel].data();
+
+    int lx = 0;
+    int ly = y[floor.sortedOrder[0]] * floor.multiplier;
+    int hx = 0;
+    int hy = ly;
+    for (size_t j = 1; j < floor.sortedOrder.size(); ++j) {
+        const int i = floor.sortedOrder[j];
+        if (!step2[i]) {
+            continue;
+        }
+        hy = y[i] * floor.multiplier;
+        hx = floor.xList[i];
+        renderLine(lx, ly, hx, hy, curve, n);
+        lx = hx;
+        ly = hy;
+    }
+    if (hx < n) {
+        renderLine(hx, hy, n, hy, curve, n);
+    }
+}
+
+void VorbisDecoder::decodeResidue(const Residue& residue, VorbisBitReader& bits,
+                                  const std::vector<int>& vectorChannels, int n) {
+    // Tipo 2: um único vetor com os canais intercalados, decodificado como o tipo 1
+    const bool interleaved = residue.type == 2;
+    const int vectorCount = interleaved ? 1 : static_cast<int>(vectorChannels.size());
+    const uint32_t size = static_cast<uint32_t>(n) * (interleaved ? static_cast<uint32_t>(vectorChannels.size()) : 1);
+
+    float* vectors[MAX_CHANNELS];
+    bool decodeVector[MAX_CHANNELS];
+    if (interleaved) {
+        bool any = false;
+        for (int channel : vectorChannels) {
+            any = any || !skipResidue[channel];
+        }
+        if (!any) {
+            return;
+        }
+        std::fill_n(interleavedResidue.begin(), size, 0.0f);
+        vectors[0] = interleavedResidue.data();
+        decodeVector[0] = true;
+    } else {
+        for (int v = 0; v < vectorCount; ++v) {
+            vectors[v] = spectrum[vectorChannels[v]].data();
+            decodeVector[v] = !skipResidue[vectorChannels[v]];
+        }
+    }
+
+    const uint32_t begin = std::min(residue.begin, size);
+    const uint32_t end = std::min(residue.end, size);
+    const uint32_t partitionSize = residue.partitionSize;
+    const uint32_t partitionsToRead = end > begin ? (end - begin) / partitionSize : 0;
+    const Codebook& classbook = codebooks[residue.classbook];
+    const int classWords = classbook.dimensions;
+    const int format = interleaved ? 1 : residue.type;
+
+    bool endOfPacket = partitionsToRead == 0;
+    for (int pass = 0; pass < 8 && !endOfPacket; ++pass) {
+        uint32_t partition = 0;
+        while (partition < partitionsToRead && !endOfPacket) {
+            if (pass == 0) {
+                for (int v = 0; v < vectorCount && !endOfPacket; ++v) {
+                    if (!decodeVector[v]) {
+                        continue;
+                    }
+                    int value = decodeEntry(classbook, bits);
+                    if (value < 0) {
+                        endOfPacket = true;
+                        break;
+                    }
+                    uint8_t* classes = classifications[v].data() + partition;
+                    for (int i = classWords - 1; i >= 0; --i) {
+                        classes[i] = static_cast<uint8_t>(value % residue.classifications);
+                        value /= residue.classifications;
+                    }
+                }
+            }
+            for (int i = 0; i < classWords && partition < partitionsToRead && !endOfPacket; ++i, ++partition) {
+                for (int v = 0; v < vectorCount && !endOfPacket; ++v) {
+                    if (!decodeVector[v]) {
+                        continue;
+                    }
+                    const int book = residue.books[classifications[v][partition]][pass];
+                    if (book < 0) {
+                        continue;
+                    }
+                    const Codebook& codebook = codebooks[book];
+                    const int dimensions = codebook.dimensions;
+                    float* target = vectors[v] + begin + partition * partitionSize;
+                    if (format == 0) {
+                        // Tipo 0: as dimensões de cada entrada ficam espaçadas por 'step'
+                        const uint32_t step = partitionSize / static_cast<uint32_t>(dimensions);
+                        for (uint32_t k = 0; k < step; ++k) {
+                            const int entry = decodeEntry(codebook, bits);
+                            if (entry < 0) {
+                                endOfPacket = true;
+                                break;
+                            }
+                            const float* values = codebook.vectors.data() + static_cast<size_t>(entry) * dimensions;
+                            for (int d = 0; d < dimensions; ++d) {
+                                target[k + d * step] += values[d];
+                            }
+                        }
+                    } else {
+                        for (uint32_t k = 0; k < partitionSize;) {
+                            const int entry = decodeEntry(codebook, bits);
+                            if (entry < 0) {
+                                endOfPacket = true;
+                                break;
+                            }
+                            const float* values = codebook.vectors.data() + static_cast<size_t>(entry) * dimensions;
+                            for (int d = 0; d < dimensions && k < partitionSize; ++d, ++k) {
+                                target[k] += values[d];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (interleaved) {
+        const size_t stride = vectorChannels.size();
+        for (size_t c = 0; c < stride; ++c) {
+            float* out = spectrum[vectorChannels[c]].data();
+            const float* in = interleavedResidue.data() + c;
+            for (int i = 0; i < n; ++i) {
+                out[i] = in[static_cast<size_t>(i) * stride];
+            }
+        }
+    }
+}
+
+int VorbisDecoder::packetBlockSize(const OggDemuxer::Packet& packet) const {
+    if (packet.size == 0 || (packet.data[0] & 1) != 0) {
+        return 0;
+    }
+    const size_t mode = (packet.data[0] >> 1) & ((1u << modeBits) - 1);
+    return mode < modes.size() ? blockSizes[modes[mode].blockFlag] : 0;
+}
+
+bool VorbisDecoder::decodePacket() {
+    OggDemuxer::Packet packet;
+    while (demuxer.nextPacket(packet)) {
+        if (packet.size == 0) {
+            continue;
+        }
+        VorbisBitReader bits(packet.data, packet.size);
+        if (bits.read(1) != 0) {
+            continue; // Cabeçalho repetido ou lixo
+        }
+        const size_t modeNumber = bits.read(modeBits);
+        if (modeNumber >= modes.size()) {
+            continue;
+        }
+        if (skipPackets > 0) {
+            --skipPackets; // Antes do pacote que prepara a sobreposição do alvo
+            continue;
+        }
+        const Mode& mode = modes[modeNumber];
+        const int n = blockSizes[mode.blockFlag];
+        const int half = n / 2;
+        if (mode.blockFlag) {
+            bits.read(2); // Formas das janelas vizinhas: deduzidas do bloco anterior e do seguinte
+        }
+        const Mapping& mapping = mappings[mode.mapping];
+
+        for (int c = 0; c < channels; ++c) {
+            const Floor1& floor = floors[mapping.submapFloor[mapping.mux[c]]];
+            hasFloor[c] = decodeFloor(floor, bits, c);
+            skipResidue[c] = !hasFloor[c];
+            std::fill_n(spectrum[c].begin(), half, 0.0f);
+        }
+        // Canais acoplados: se um tem energia, o resíduo dos dois é decodificado
+        for (const auto& step : mapping.coupling) {
+            if (!skipResidue[step.first] || !skipResidue[step.second]) {
+                skipResidue[step.first] = skipResidue[step.second] = false;
+            }
+        }
+
+        for (size_t submap = 0; submap < mapping.submapResidue.size(); ++submap) {
+            submapChannels.clear();
+            for (int c = 0; c < channels; ++c) {
+                if (mapping.mux[c] == static_cast<int>(submap)) {
+                    submapChannels.push_back(c);
+                }
+            }
+            decodeResidue(residues[mapping.submapResidue[submap]], bits, submapChannels, half);
+        }
+
+        // Acoplamento quadrado-polar inverso, na ordem reversa dos passos
+        for (auto step = mapping.coupling.rbegin(); step != mapping.coupling.rend(); ++step) {
+            float* magnitude = spectrum[step->first].data();
+            float* angle = spectrum[step->second].data();
+            for (int i = 0; i < half; ++i) {
+                const float m = magnitude[i];
+                const float a = angle[i];
+                const bool positiveM = m > 0.0f;
+                const bool positiveA = a > 0.0f;
+                magnitude[i] = positiveA ? m : (positiveM ? m + a : m - a);
+                angle[i] = positiveA ? (positiveM ? m - a : m + a) : m;
+            }
+        }
+
+        const size_t flag = mode.blockFlag ? 1 : 0;
+        for (int c = 0; c < channels; ++c) {
+            if (!hasFloor[c]) {
+                std::fill_n(block[c].begin(), n, 0.0f);
+                continue;
+            }
+            renderFloor(floors[mapping.submapFloor[mapping.mux[c]]], c, half);
+            float* coefficients = spectrum[c].data();
+            const float* curve = floorCurve[c].data();
+            for (int i = 0; i < half; ++i) {
+                coefficients[i] *= curve[i];
+            }
+            imdct[flag]->inverse(coefficients, block[c].data());
+        }
+
+        if (previousBlockSize == 0) {
+            // Primeiro bloco depois de abrir ou de um seek: só prepara a sobreposição
+            for (int c = 0; c < channels; ++c) {
+                std::copy_n(block[c].begin() + half, half, saved[c].begin());
+            }
+            previousBlockSize = n;
+            continue;
+        }
+
+        const int64_t frames = previousBlockSize / 4 + n / 4;
+        emitFrames(n);
+        int64_t start = decodedEnd;
+        int64_t count = frames;
+        if (packet.granule >= 0) {
+            if (packet.endOfStream && packet.granule < start + count) {
+                // Página final: o granule corta o preenchimento do último bloco
+                count = std::max<int64_t>(packet.granule - start, 0);
+            } else if (packet.granule != start + count) {
+                start = packet.granule - count; // Realinha depois de páginas perdidas
+            }
+        }
+        decodedEnd = start + count;
+
+        const int64_t skip = std::clamp<int64_t>(discardBefore - start, 0, count);
+        if (skip == count) {
+            continue;
+        }
+        const size_t stride = static_cast<size_t>(channels);
+        for (int64_t f = skip; f < count; ++f) {
+            float* out = pending.data() + static_cast<size_t>(f) * stride;
+            for (size_t c = 0; c < stride; ++c) {
+                out[c] = planar[channelOrder[c]][static_cast<size_t>(f)];
+            }
+        }
+        pendingStart = static_cast<size_t>(skip);
+        pendingCount = static_cast<size_t>(count - skip);
+        return true;
+    }
+    return false;
+}
+
+void VorbisDecoder::emitFrames(int blockSize) {
+    const int previous = previousBlockSize;
+    const int slope = std::min(previous, blockSize) / 2;
+    const size_t flag = slope == blockSizes[1] / 2 ? 1 : 0;
+    // Saída: do centro do bloco anterior ao centro do atual (P/4 + C/4 quadros)
+    const int flatPrevious = previous / 4 - slope / 2;  // Trecho só do bloco anterior
+    const int slopeStart = blockSize / 4 - slope / 2;    // Início da rampa no bloco atual
+    const int half = blockSize / 2;
+
+    for (int c = 0; c < channels; ++c) {
+        float* out = planar[c].data();
+        const float* last = saved[c].data();
+        const float* current = block[c].data();
+        std::copy_n(last, flatPrevious, out);
+        Imdct::overlapAdd(last + flatPrevious, fall[flag].data(), current + slopeStart, rise[flag].data(),
+                          out + flatPrevious, static_cast<size_t>(slope));
+        std::copy(current + slopeStart + slope, current + half, out + flatPrevious + slope);
+        std::copy_n(current + half, half, saved[c].begin());
+    }
+    previousBlockSize = blockSize;
+}
+
+int64_t VorbisDecoder::findStreamBase() {
+    // Granule ao fim do primeiro pacote: o primeiro granule de página menos as amostras dos
+    // pacotes até ele, só pelos bits de modo. O da página EOS pode ter sido cortado e não
+    // serve de referência (stream curto: começa em 0)
+    demuxer.seekToPage(audioStart);
+    OggDemuxer::Packet packet;
+    int64_t samples = 0;
+    int previous = 0;
+    while (demuxer.nextPacket(packet)) {
+        const int size = packetBlockSize(packet);
+        if (size == 0) {
+            continue;
+        }
+        if (previous != 0) {
+            samples += previous / 4 + size / 4;
+        }
+        previous = size;
+        if (packet.granule >= 0) {
+            return packet.endOfStream ? 0 : packet.granule - samples;
+        }
+    }
+    return 0;
+}
+
+void VorbisDecoder::buildSeekIndex() {
+    // Uma passada pelos pacotes de áudio, só com os bits de modo, com o mesmo realinhamento
+    // pelo granule de página que decodePacket() aplica: o fim de cada pacote no índice é o
+    // decodedEnd que a decodificação contínua teria depois dele
+    seekPages.clear();
+    seekPoints.clear();
+    demuxer.seekToPage(audioStart);
+    OggDemuxer::Packet packet;
+    int previous = 0;
+    int64_t end = 0;
+    bool aligned = false;                      // Algum granule já tornou os fins absolutos
+    uint32_t skip = 0;
+    while (demuxer.nextPacket(packet)) {
+        const int size = packetBlockSize(packet);
+        if (size == 0) {
+            continue;
+        }
+        if (seekPages.empty() || seekPages.back() != packet.pageOffset) {
+            seekPages.push_back(packet.pageOffset);
+            skip = 0;
+        }
+        const int64_t start = end;
+        if (previous != 0) {
+            end += previous / 4 + size / 4;
+        }
+        previous = size;
+        if (packet.granule >= 0) {
+            if (packet.endOfStream && packet.granule < end) {
+                end = std::max(packet.granule, start); // Página final: o granule corta o último bloco
+            } else {
+                if (!aligned && !packet.endOfStream) {
+                    // Primeiro granule: os pacotes anteriores passam a ser absolutos
+                    const int64_t shift = packet.granule - end;
+                    for (SeekPoint& point : seekPoints) {
+                        point.end += shift;
+                    }
+                }
+                end = packet.granule;
+            }
+            aligned = true;
+        }
+        seekPoints.push_back({end, static_cast<uint32_t>(seekPages.size() - 1), skip++});
+    }
+    seekIndexBuilt = true;
+}
+
+void VorbisDecoder::restartAt(uint64_t pageOffset, size_t skip, int64_t end, int64_t target) {
+    // O primeiro pacote decodificado (depois de 'skip' na página) só prepara a sobreposição
+    // e termina em 'end'; a saída é descartada até o alvo
+    demuxer.seekToPage(pageOffset);
+    previousBlockSize = 0;
+    pendingStart = pendingCount = 0;
+    skipPackets = skip;
+    decodedEnd = end;
+    discardBefore = target;
+}
+
+size_t VorbisDecoder::decode(float* out, size_t maxFrames) {
+    if (!isOpen()) {
+        return 0;
+    }
+    const size_t stride = static_cast<size_t>(channels);
+    size_t done = 0;
+    while (done < maxFrames) {
+        if (pendingCount == 0) {
+            if (!decodePacket()) {
+                break;
+            }
+            continue;
+        }
+        const size_t count = std::min(pendingCount, maxFrames - done);
+        std::copy_n(pending.data() + pendingStart * stride, count * stride, out + done * stride);
+        pendingStart += count;
+        pendingCount -= count;
+        done += count;
+    }
+    position += done;
+    return done;
+}
+
+bool VorbisDecoder::seek(uint64_t frame) {
+    if (!isOpen()) {
+        return false;
+    }
+    const int64_t target = streamStart + static_cast<int64_t>(frame);
+    if (streamEnd >= 0 && target >= streamEnd) {
+        // Além do fim: o próximo decode() retorna 0
+        demuxer.seekToPage(demuxer.getFileSize());
+        pendingStart = pendingCount = 0;
+        position = getTotalFrames();
+        return true;
+    }
+
+    if (!seekIndexBuilt) {
+        buildSeekIndex();
+    }
+    if (seekPoints.empty()) {
+        restartAt(audioStart, 0, streamStart, target);
+    } else {
+        // Último pacote que termina até o alvo: o seguinte contém o alvo e precisa dele para
+        // a sobreposição
+        auto it = std::upper_bound(seekPoints.begin(), seekPoints.end(), target,
+                                   [](int64_t value, const SeekPoint& point) { return value < point.end; });
+        if (it != seekPoints.begin()) {
+            --it;
+        }
+        restartAt(seekPages[it->page], it->skip, it->end, target);
+    }
+    position = frame;
+    return true;
+}
+
+uint64_t VorbisDecoder::getTotalFrames() const {
+    return streamEnd > streamStart ? static_cast<uint64_t>(streamEnd - streamStart) : 0;
+}
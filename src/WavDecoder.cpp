@@ -0,0 +1,9 @@
+#include "WavDecoder.h"
+
+WavDecoder::WavDecoder(WavReader::AccessMode access) : accessMode(access) {}
+
+void WavDecoder::open(const std::string& filePath) {
+    if (!reader.open(filePath, accessMode)) {
+        throw DecoderException("Arquivo WAV inválido ou formato não suportado: " + filePath);
+    }
+}
@@ -0,0 +1,382 @@
+#include "WavReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/vfs.h>
+#endif
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint32_t readLittleEndian32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readLittleEndian16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// Conversão de uma amostra; o laço externo fica especializado por formato
+template <typename Convert>
+void convertSamples(const uint8_t* in, size_t count, size_t bytesPerSample, float* out, Convert convert) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = convert(in + i * bytesPerSample);
+    }
+}
+
+// Faltas de página acumuladas pela thread atual; false onde não há contagem por thread
+bool getThreadFaults(uint64_t& minor, uint64_t& major) {
+#if defined(RUSAGE_THREAD)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        minor = static_cast<uint64_t>(usage.ru_minflt);
+        major = static_cast<uint64_t>(usage.ru_majflt);
+        return true;
+    }
+#endif
+    minor = 0;
+    major = 0;
+    return false;
+}
+
+} // namespace
+
+WavReader::WavReader()
+    : descriptor(-1), mode(AccessMode::MAPPED), samples(nullptr), fileBytes(0), dataOffset(0), bytesPerFrame(0),
+      position(0), readaheadEnd(0), bufferStart(0), bufferFill(0) {}
+
+WavReader::~WavReader() {
+    close();
+}
+
+bool WavReader::open(const std::string& path, AccessMode access) {
+    close();
+    if (access == AccessMode::AUTO) {
+        access = prefersBufferedAccess(path) ? AccessMode::BUFFERED : AccessMode::MAPPED;
+    }
+#ifdef _WIN32
+    access = AccessMode::MAPPED; // Sem pread: MappedFile já lê o arquivo para a memória
+#endif
+
+    bool opened = false;
+    if (access == AccessMode::MAPPED && file.open(path, true)) {
+        mode = AccessMode::MAPPED;
+        fileBytes = file.size();
+        opened = parseHeader();
+    } else {
+        // Pedido explícito ou mmap indisponível para este arquivo
+        opened = openBuffered(path) && parseHeader();
+    }
+    if (!opened) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool WavReader::openBuffered(const std::string& path) {
+#ifndef _WIN32
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+        return false;
+    }
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    mode = AccessMode::BUFFERED;
+    fileBytes = static_cast<uint64_t>(info.st_size);
+    buffer.resize(BUFFER_BYTES);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void WavReader::close() {
+    file.close();
+#ifndef _WIN32
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+#endif
+    descriptor = -1;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    mode = AccessMode::MAPPED;
+    format = Format();
+    samples = nullptr;
+    fileBytes = 0;
+    dataOffset = 0;
+    bytesPerFrame = 0;
+    position = 0;
+    readaheadEnd = 0;
+    bufferStart = 0;
+    bufferFill = 0;
+    statistics = Statistics();
+}
+
+bool WavReader::fetch(uint64_t offset, void* destination, size_t count) {
+    if (offset > fileBytes || count > fileBytes - offset) {
+        return false;
+    }
+    if (mode == AccessMode::MAPPED) {
+        std::memcpy(destination, file.data() + offset, count);
+        return true;
+    }
+#ifndef _WIN32
+    uint8_t* out = static_cast<uint8_t*>(destination);
+    while (count > 0) {
+        const ssize_t got = pread(descriptor, out, count, static_cast<off_t>(offset));
+        ++statistics.readCalls;
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false; // Erro de E/S ou arquivo truncado depois do open
+        }
+        out += got;
+        offset += static_cast<uint64_t>(got);
+        count -= static_cast<size_t>(got);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool WavReader::parseHeader() {
+    uint8_t riff[12];
+    if (!fetch(0, riff, sizeof(riff)) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint16_t formatTag = 0;
+    uint64_t pos = 12;
+    while (pos + 8 <= fileBytes) {
+        uint8_t chunk[8];
+        if (!fetch(pos, chunk, sizeof(chunk))) {
+            return false;
+        }
+        uint64_t chunkSize = readLittleEndian32(chunk + 4);
+        pos += 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && pos + 16 <= fileBytes) {
+            uint8_t fmt[40] = {};
+            const size_t length = static_cast<size_t>(std::min<uint64_t>({chunkSize, sizeof(fmt), fileBytes - pos}));
+            if (!fetch(pos, fmt, length)) {
+                return false;
+            }
+            formatTag = readLittleEndian16(fmt);
+            format.channels = readLittleEndian16(fmt + 2);
+            format.sampleRate = static_cast<int>(readLittleEndian32(fmt + 4));
+            format.bitsPerSample = readLittleEndian16(fmt + 14);
+            // EXTENSIBLE: o formato real são os dois primeiros bytes do GUID do subformato
+            if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40 && length >= 26) {
+                formatTag = readLittleEndian16(fmt + 24);
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            format.floatingPoint = formatTag == WAVE_FORMAT_IEEE_FLOAT;
+            const bool supported =
+                (formatTag == WAVE_FORMAT_PCM && (format.bitsPerSample == 8 || format.bitsPerSample == 16 ||
+                                                  format.bitsPerSample == 24 || format.bitsPerSample == 32)) ||
+                (format.floatingPoint && (format.bitsPerSample == 32 || format.bitsPerSample == 64));
+            if (!supported || format.channels <= 0 || format.channels > MAX_CHANNELS || format.sampleRate <= 0) {
+                return false; // "data" antes de "fmt " ou formato não suportado
+            }
+            const uint64_t available = fileBytes - pos;
+            if (chunkSize == 0xFFFFFFFFu || chunkSize > available) {
+                chunkSize = available; // Gravação em streaming ou arquivo truncado
+            }
+            bytesPerFrame = static_cast<size_t>(format.channels) * static_cast<size_t>(format.bitsPerSample / 8);
+            format.totalFrames = chunkSize / bytesPerFrame;
+            dataOffset = pos;
+            samples = mode == AccessMode::MAPPED ? file.data() + pos : nullptr;
+            position = 0;
+            return true;
+        }
+        pos += chunkSize + (chunkSize & 1); // Chunks são alinhados em 2 bytes
+    }
+    return false;
+}
+
+void WavReader::requestReadahead(uint64_t byteOffset) {
+    // Nova janela quando falta menos de meia janela pedida à frente da leitura
+    const uint64_t dataBytes = format.totalFrames * bytesPerFrame;
+    if (readaheadEnd >= dataBytes || readaheadEnd >= byteOffset + READAHEAD_BYTES / 2) {
+        return;
+    }
+    const uint64_t begin = std::max(readaheadEnd, byteOffset);
+    const uint64_t end = std::min<uint64_t>(byteOffset + READAHEAD_BYTES, dataBytes);
+    if (mode == AccessMode::MAPPED) {
+        file.adviseWillNeed(static_cast<size_t>(dataOffset + begin), static_cast<size_t>(end - begin));
+    } else {
+#ifndef _WIN32
+        posix_fadvise(descriptor, static_cast<off_t>(dataOffset + begin), static_cast<off_t>(end - begin),
+                      POSIX_FADV_WILLNEED);
+#endif
+    }
+    readaheadEnd = end;
+    ++statistics.readaheadHints;
+}
+
+void WavReader::convert(const uint8_t* in, size_t count, float* out) const {
+    // Leitura byte a byte (ou memcpy): dados mapeados não têm alinhamento garantido
+    switch (format.bitsPerSample) {
+        case 8:
+            convertSamples(in, count, 1, out, [](const uint8_t* p) {
+                return (static_cast<float>(p[0]) - 128.0f) * (1.0f / 128.0f);
+            });
+            break;
+        case 16:
+            convertSamples(in, count, 2, out, [](const uint8_t* p) {
+                return static_cast<float>(static_cast<int16_t>(readLittleEndian16(p))) * (1.0f / 32768.0f);
+            });
+            break;
+        case 24:
+            convertSamples(in, count, 3, out, [](const uint8_t* p) {
+                const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                                           (static_cast<uint32_t>(p[1]) << 16) |
+                                                           (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+                return static_cast<float>(value) * (1.0f / 8388608.0f);
+            });
+            break;
+        case 32:
+            if (format.floatingPoint) {
+                convertSamples(in, count, 4, out, [](const uint8_t* p) {
+                    float value;
+                    std::memcpy(&value, p, sizeof(value));
+                    return value;
+                });
+            } else {
+                convertSamples(in, count, 4, out, [](const uint8_t* p) {
+                    return static_cast<float>(static_cast<int32_t>(readLittleEndian32(p))) * (1.0f / 2147483648.0f);
+                });
+            }
+            break;
+        default:
+            convertSamples(in, count, 8, out, [](const uint8_t* p) {
+                double value;
+                std::memcpy(&value, p, sizeof(value));
+                return static_cast<float>(value);
+            });
+            break;
+    }
+}
+
+size_t WavReader::read(float* out, size_t maxFrames) {
+    if (!isOpen() || position >= format.totalFrames) {
+        return 0;
+    }
+    size_t frames = static_cast<size_t>(std::min<uint64_t>(maxFrames, format.totalFrames - position));
+    const size_t channels = static_cast<size_t>(format.channels);
+    uint64_t minorBefore = 0;
+    uint64_t majorBefore = 0;
+    const bool countFaults = getThreadFaults(minorBefore, majorBefore);
+
+    requestReadahead(position * bytesPerFrame);
+    if (mode == AccessMode::MAPPED) {
+        convert(samples + position * bytesPerFrame, frames * channels, out);
+    } else {
+        // Blocos inteiros de BUFFER_BYTES; chamadas seguintes consomem o que já está no buffer
+        const size_t blockBytes = BUFFER_BYTES / bytesPerFrame * bytesPerFrame;
+        const uint64_t dataBytes = format.totalFrames * bytesPerFrame;
+        size_t done = 0;
+        while (done < frames) {
+            const uint64_t offset = (position + done) * bytesPerFrame;
+            if (offset < bufferStart || offset >= bufferStart + bufferFill) {
+                const size_t bytes = static_cast<size_t>(std::min<uint64_t>(blockBytes, dataBytes - offset));
+                if (!fetch(dataOffset + offset, buffer.data(), bytes)) {
+                    bufferFill = 0;
+                    break;
+                }
+                bufferStart = offset;
+                bufferFill = bytes;
+                statistics.bytesCopied += bytes;
+            }
+            const size_t inBuffer = static_cast<size_t>(offset - bufferStart);
+            const size_t count = std::min(frames - done, (bufferFill - inBuffer) / bytesPerFrame);
+            convert(buffer.data() + inBuffer, count * channels, out + done * channels);
+            done += count;
+        }
+        frames = done;
+    }
+
+    uint64_t minorAfter = 0;
+    uint64_t majorAfter = 0;
+    if (countFaults && getThreadFaults(minorAfter, majorAfter)) {
+        statistics.minorFaults += minorAfter - minorBefore;
+        statistics.majorFaults += majorAfter - majorBefore;
+    }
+    position += frames;
+    statistics.framesRead += frames;
+    statistics.bytesRead += frames * bytesPerFrame;
+    return frames;
+}
+
+bool WavReader::seek(uint64_t frame) {
+    if (!isOpen()) {
+        return false;
+    }
+    position = std::min(frame, format.totalFrames);
+    readaheadEnd = position * bytesPerFrame; // A janela recomeça no novo ponto
+    return true;
+}
+
+std::vector<float> WavReader::loadFile(const std::string& path, Format& format) {
+    WavReader reader;
+    if (!reader.open(path)) {
+        throw WavException("Arquivo WAV inválido ou formato não suportado: " + path);
+    }
+    format = reader.getFormat();
+    std::vector<float> interleaved(static_cast<size_t>(format.totalFrames) * static_cast<size_t>(format.channels));
+    reader.read(interleaved.data(), static_cast<size_t>(format.totalFrames));
+    return interleaved;
+}
+
+bool WavReader::prefersBufferedAccess(const std::string& path) {
+#ifdef __linux__
+    struct statfs info;
+    if (statfs(path.c_str(), &info) != 0) {
+        return false;
+    }
+    switch (static_cast<uint32_t>(info.f_type)) {
+        case 0x6969u:       // NFS
+        case 0x517Bu:       // SMB
+        case 0xFF534D42u:   // CIFS
+        case 0xFE534D42u:   // SMB2
+        case 0x65735546u:   // FUSE (sshfs, rclone, ...)
+        case 0x01021997u:   // 9p (VMs, WSL)
+        case 0x00C36400u:   // Ceph
+        case 0x6B414653u:   // AFS
+            return true;
+        default:
+            return false;
+    }
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+const char* WavReader::getAccessModeName(AccessMode mode) {
+    switch (mode) {
+        case AccessMode::AUTO: return "auto";
+        case AccessMode::MAPPED: return "mmap";
+        case AccessMode::BUFFERED: return "pread";
+    }
+    return "desconhecido";
+}
@@ -0,0 +1,453 @@
+#include "WaveformCache.h"
+#include "AudioDecoder.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'M', 'P', '3', 'W', 'A', 'V', 'E', '1'};
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint32_t ENDIAN_MARK = 0x01020304; // Rejeita caches gerados em outra arquitetura
+
+// Layout do arquivo: cabeçalho | picos por nível (u64) | picos de todos os níveis (6 bytes)
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianMark;
+    uint64_t mediaDevice;
+    uint64_t mediaInode;
+    uint64_t mediaSize;
+    int64_t mediaMtimeNs;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint32_t baseFrames;
+    uint32_t fanout;
+    uint64_t totalFrames;
+    uint64_t levelCount;
+};
+static_assert(sizeof(CacheHeader) % 8 == 0, "Seções seguintes precisam de alinhamento de 8 bytes");
+
+// Arquivo em geração: os segmentos escrevem no mesmo Builder, o último monta a pirâmide
+struct FileJob {
+    std::string path;
+    std::unique_ptr<WaveformOverview::Builder> builder;
+    int sampleRate = 0;
+    uint64_t totalFrames = 0;               // 0 = desconhecida (um único segmento)
+    std::atomic<size_t> remaining{0};
+    std::atomic<uint64_t> endFrame{0};      // Maior posição decodificada
+    std::atomic<bool> failed{false};
+    std::atomic<bool> cancelled{false};
+};
+
+struct Work {
+    size_t file;
+    uint64_t segment;                       // 0 = abrir o arquivo e dividir em segmentos
+};
+
+void raiseEndFrame(std::atomic<uint64_t>& endFrame, uint64_t frame) {
+    uint64_t current = endFrame.load(std::memory_order_relaxed);
+    while (frame > current && !endFrame.compare_exchange_weak(current, frame, std::memory_order_relaxed)) {
+    }
+}
+
+// Decodifica [start, start + SEGMENT_FRAMES) para o Builder; false se cancelado no meio
+bool decodeSegment(AudioDecoder& decoder, FileJob& job, uint64_t start, const std::atomic<bool>& cancel,
+                   uint64_t& decoded) {
+    const uint64_t end = job.totalFrames > 0 ? std::min(job.totalFrames, start + WaveformCache::SEGMENT_FRAMES)
+                                             : ~uint64_t(0);
+    std::vector<float> buffer(WaveformCache::DECODE_FRAMES * static_cast<size_t>(decoder.getChannels()));
+    uint64_t position = start;
+    size_t frames = 0;
+    while (position < end) {
+        const size_t request = static_cast<size_t>(std::min<uint64_t>(WaveformCache::DECODE_FRAMES, end - position));
+        if ((frames = decoder.decode(buffer.data(), request)) == 0) {
+            break;
+        }
+        job.builder->addFrames(position, buffer.data(), frames);
+        position += frames;
+        if (cancel.load(std::memory_order_relaxed)) {
+            decoded += position - start;
+            return false;
+        }
+    }
+    decoded += position - start;
+    raiseEndFrame(job.endFrame, position);
+    return true;
+}
+
+} // namespace
+
+WaveformCache::WaveformCache(const std::string& cacheDirectory, unsigned threads)
+    : directory(cacheDirectory), threadCount(threads), cancelRequested(false), generating(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+WaveformCache::~WaveformCache() {
+    cancel();
+    if (generationThread.joinable()) {
+        generationThread.join();
+    }
+}
+
+void WaveformCache::count(uint64_t Statistics::*counter) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ++(statistics.*counter);
+}
+
+WaveformCache::Statistics WaveformCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return statistics;
+}
+
+std::string WaveformCache::getDefaultDirectory() {
+    return (std::filesystem::path(FrameIndexCache::getDefaultDirectory()).parent_path() / "waveform").string();
+}
+
+std::string WaveformCache::entryPath(const FrameIndexCache::FileIdentity& identity) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.wfm",
+                  static_cast<unsigned long long>(identity.device),
+                  static_cast<unsigned long long>(identity.inode));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::shared_ptr<const WaveformOverview> WaveformCache::load(const std::string& mediaPath) {
+    FrameIndexCache::FileIdentity identity;
+    if (!FrameIndexCache::getFileIdentity(mediaPath, identity)) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    const std::string path = entryPath(identity);
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path) || mapping->size() < sizeof(CacheHeader)) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.endianMark != ENDIAN_MARK || header.baseFrames != WaveformOverview::BASE_FRAMES ||
+        header.fanout != WaveformOverview::FANOUT) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    // Mídia alterada desde a gravação: a entrada é descartada e será reconstruída
+    if (header.mediaSize != identity.size || header.mediaMtimeNs != identity.mtimeNs ||
+        header.mediaInode != identity.inode || header.mediaDevice != identity.device) {
+        count(&Statistics::stale);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return nullptr;
+    }
+
+    // Contagens conferidas contra a duração: arquivo truncado ou corrompido vira falta
+    if (header.levelCount != WaveformOverview::getLevelCountFor(header.totalFrames) ||
+        sizeof(CacheHeader) + header.levelCount * sizeof(uint64_t) > mapping->size()) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+    const uint8_t* cursor = mapping->data() + sizeof(CacheHeader);
+    const uint8_t* peaks = cursor + header.levelCount * sizeof(uint64_t);
+    WaveformOverview::View view;
+    view.levelCount = static_cast<size_t>(header.levelCount);
+    uint64_t expected = (header.totalFrames + WaveformOverview::BASE_FRAMES - 1) / WaveformOverview::BASE_FRAMES;
+    uint64_t required = static_cast<uint64_t>(peaks - mapping->data());
+    for (size_t level = 0; level < view.levelCount; ++level) {
+        uint64_t peakCount = 0;
+        std::memcpy(&peakCount, cursor + level * sizeof(uint64_t), sizeof(peakCount));
+        if (peakCount != expected) {
+            count(&Statistics::misses);
+            return nullptr;
+        }
+        view.levels[level] = reinterpret_cast<const WaveformOverview::Peak*>(mapping->data() + required);
+        view.counts[level] = static_cast<size_t>(peakCount);
+        required += peakCount * sizeof(WaveformOverview::Peak);
+        expected = (expected + WaveformOverview::FANOUT - 1) / WaveformOverview::FANOUT;
+    }
+    if (required > mapping->size()) {
+        count(&Statistics::misses);
+        return nullptr;
+    }
+
+    count(&Statistics::hits);
+    return std::make_shared<WaveformOverview>(static_cast<int>(header.sampleRate), static_cast<int>(header.channels),
+                                              header.totalFrames, view, mapping);
+}
+
+bool WaveformCache::store(const std::string& mediaPath, const WaveformOverview& overview) {
+    FrameIndexCache::FileIdentity identity;
+    if (!FrameIndexCache::getFileIdentity(mediaPath, identity)) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return false;
+    }
+
+    const WaveformOverview::View& view = overview.getView();
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.endianMark = ENDIAN_MARK;
+    header.mediaDevice = identity.device;
+    header.mediaInode = identity.inode;
+    header.mediaSize = identity.size;
+    header.mediaMtimeNs = identity.mtimeNs;
+    header.sampleRate = static_cast<uint32_t>(overview.getSampleRate());
+    header.channels = static_cast<uint32_t>(overview.getChannels());
+    header.baseFrames = static_cast<uint32_t>(WaveformOverview::BASE_FRAMES);
+    header.fanout = static_cast<uint32_t>(WaveformOverview::FANOUT);
+    header.totalFrames = overview.getTotalFrames();
+    header.levelCount = view.levelCount;
+
+    // Escrita em arquivo temporário + rename: leitores nunca veem uma entrada parcial
+    const std::string path = entryPath(identity);
+    const std::string temporary = path + ".tmp" + std::to_string(std::hash<std::string>{}(mediaPath));
+    {
+        std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            return false;
+        }
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t level = 0; level < view.levelCount; ++level) {
+            const uint64_t peakCount = view.counts[level];
+            output.write(reinterpret_cast<const char*>(&peakCount), sizeof(peakCount));
+        }
+        for (size_t level = 0; level < view.levelCount; ++level) {
+            output.write(reinterpret_cast<const char*>(view.levels[level]),
+                         static_cast<std::streamsize>(view.counts[level] * sizeof(WaveformOverview::Peak)));
+        }
+        if (!output) {
+            output.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    count(&Statistics::stores);
+    return true;
+}
+
+bool WaveformCache::remove(const std::string& mediaPath) {
+    FrameIndexCache::FileIdentity identity;
+    if (!FrameIndexCache::getFileIdentity(mediaPath, identity)) {
+        return false;
+    }
+    std::error_code error;
+    return std::filesystem::remove(entryPath(identity), error);
+}
+
+std::unique_ptr<WaveformOverview> WaveformCache::buildFile(const std::string& mediaPath) {
+    auto decoder = AudioDecoder::createForFile(mediaPath);
+    WaveformOverview::Builder builder(decoder->getTotalFrames(), decoder->getChannels());
+    std::vector<float> buffer(DECODE_FRAMES * static_cast<size_t>(decoder->getChannels()));
+    uint64_t position = 0;
+    size_t frames = 0;
+    while ((frames = decoder->decode(buffer.data(), DECODE_FRAMES)) > 0) {
+        builder.addFrames(position, buffer.data(), frames);
+        position += frames;
+    }
+    return builder.build(decoder->getSampleRate(), position);
+}
+
+std::shared_ptr<const WaveformOverview> WaveformCache::getOrBuild(const std::string& mediaPath) {
+    if (auto cached = load(mediaPath)) {
+        return cached;
+    }
+    std::shared_ptr<const WaveformOverview> overview = buildFile(mediaPath);
+    store(mediaPath, *overview); // Falha de escrita só custa uma nova decodificação depois
+    return overview;
+}
+
+WaveformCache::Summary WaveformCache::generate(const std::vector<std::string>& mediaPaths, ProgressCallback progress) {
+    cancelRequested.store(false);
+    return runGeneration(mediaPaths, progress);
+}
+
+WaveformCache::Summary WaveformCache::runGeneration(const std::vector<std::string>& mediaPaths,
+                                                    const ProgressCallback& progress) {
+    using Clock = std::chrono::steady_clock;
+    const auto begin = Clock::now();
+    Summary summary;
+
+    // Arquivos distintos ainda sem entrada válida; os demais já contam como concluídos
+    std::vector<std::unique_ptr<FileJob>> jobs;
+    std::deque<Work> queue;
+    std::unordered_set<std::string> seen;
+    for (const auto& path : mediaPaths) {
+        if (!seen.insert(path).second) {
+            continue;
+        }
+        if (load(path)) {
+            ++summary.cached;
+            continue;
+        }
+        auto job = std::make_unique<FileJob>();
+        job->path = path;
+        queue.push_back(Work{jobs.size(), 0});
+        jobs.push_back(std::move(job));
+    }
+    summary.files = seen.size();
+
+    // Pool fixo sobre uma fila: abrir um arquivo longo coloca os segmentos seguintes na
+    // frente, para que threads ociosas ajudem nele em vez de abrir outro arquivo
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    size_t opening = 0;                     // Trabalhos de abertura que ainda podem gerar segmentos
+    std::atomic<uint64_t> framesDecoded{0};
+    std::atomic<size_t> segments{0};
+    size_t done = summary.cached;
+
+    auto finishSegment = [&](FileJob& job) {
+        if (job.remaining.fetch_sub(1) != 1) {
+            return;
+        }
+        bool stored = false;
+        if (!job.failed.load() && !job.cancelled.load()) {
+            auto overview = job.builder->build(job.sampleRate, job.endFrame.load());
+            stored = overview->getLevelCount() > 0 && store(job.path, *overview);
+        }
+        job.builder.reset(); // Memória limitada aos arquivos em andamento
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (job.cancelled.load()) {
+            return;
+        }
+        ++(stored ? summary.generated : summary.failed);
+        ++done;
+        if (progress) {
+            progress(done, summary.files, job.path);
+        }
+    };
+
+    auto worker = [&]() {
+        uint64_t decoded = 0;
+        while (true) {
+            Work work;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [&]() { return !queue.empty() || opening == 0 || cancelRequested.load(); });
+                if (queue.empty() || cancelRequested.load()) {
+                    break;
+                }
+                work = queue.front();
+                queue.pop_front();
+                if (work.segment == 0) {
+                    ++opening;
+                }
+            }
+            FileJob& job = *jobs[work.file];
+            segments.fetch_add(1, std::memory_order_relaxed);
+
+            if (work.segment == 0) {
+                std::unique_ptr<AudioDecoder> decoder;
+                size_t extra = 0;
+                try {
+                    decoder = AudioDecoder::createForFile(job.path);
+                    job.sampleRate = decoder->getSampleRate();
+                    job.totalFrames = decoder->getTotalFrames();
+                    if (job.totalFrames > SEGMENT_FRAMES && decoder->seek(0)) {
+                        job.totalFrames = decoder->getTotalFrames(); // Índice montado: contagem exata
+                    }
+                    job.builder = std::make_unique<WaveformOverview::Builder>(job.totalFrames, decoder->getChannels());
+                    extra = job.totalFrames > 0
+                                ? static_cast<size_t>((job.totalFrames + SEGMENT_FRAMES - 1) / SEGMENT_FRAMES) - 1
+                                : 0;
+                } catch (const AudioDecoder::DecoderException&) {
+                    decoder.reset();
+                }
+                job.remaining.store(extra + 1);
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    for (size_t s = extra; s >= 1; --s) {
+                        queue.push_front(Work{work.file, s});
+                    }
+                    --opening;
+                }
+                queueReady.notify_all();
+                try {
+                    if (!decoder) {
+                        job.failed.store(true);
+                    } else if (!decodeSegment(*decoder, job, 0, cancelRequested, decoded)) {
+                        job.cancelled.store(true);
+                    }
+                } catch (const AudioDecoder::DecoderException&) {
+                    job.failed.store(true);
+                }
+            } else {
+                try {
+                    auto decoder = AudioDecoder::createForFile(job.path);
+                    const uint64_t start = work.segment * SEGMENT_FRAMES;
+                    if (!decoder->seek(start) || decoder->getPosition() != start) {
+                        job.failed.store(true); // Sem seek exato os picos sairiam deslocados
+                    } else if (!decodeSegment(*decoder, job, start, cancelRequested, decoded)) {
+                        job.cancelled.store(true);
+                    }
+                } catch (const AudioDecoder::DecoderException&) {
+                    job.failed.store(true);
+                }
+            }
+            finishSegment(job);
+        }
+        framesDecoded.fetch_add(decoded, std::memory_order_relaxed);
+        queueReady.notify_all(); // Cancelamento ou fila vazia: acordar quem ainda espera
+    };
+
+    summary.threads = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(jobs.size(), 1)));
+    if (!jobs.empty()) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < summary.threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+    summary.cancelled = cancelRequested.load();
+    summary.framesDecoded = framesDecoded.load();
+    summary.segments = segments.load();
+    summary.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return summary;
+}
+
+bool WaveformCache::startGeneration(const std::vector<std::string>& mediaPaths, ProgressCallback progress) {
+    if (generating.load()) {
+        return false;
+    }
+    if (generationThread.joinable()) {
+        generationThread.join(); // Geração anterior já terminou
+    }
+    generating.store(true);
+    cancelRequested.store(false);
+    generationThread = std::thread([this, mediaPaths, progress]() {
+        lastSummary = runGeneration(mediaPaths, progress);
+        generating.store(false);
+    });
+    return true;
+}
+
+WaveformCache::Summary WaveformCache::waitForGeneration() {
+    if (generationThread.joinable()) {
+        generationThread.join();
+    }
+    return lastSummary;
+}
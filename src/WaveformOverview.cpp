@@ -0,0 +1,200 @@
+#include "WaveformOverview.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr float PEAK_SCALE = 32767.0f;
+
+int16_t quantizeDown(float value) {
+    return static_cast<int16_t>(std::min(std::max(std::floor(value * PEAK_SCALE), -32768.0f), 32767.0f));
+}
+
+int16_t quantizeUp(float value) {
+    return static_cast<int16_t>(std::min(std::max(std::ceil(value * PEAK_SCALE), -32768.0f), 32767.0f));
+}
+
+} // namespace
+
+static_assert(sizeof(WaveformOverview::Peak) == 6, "Layout em disco de Peak");
+
+WaveformOverview::Builder::Builder(uint64_t totalFrames, int channelCount) : channels(std::max(channelCount, 1)) {
+    const size_t count = static_cast<size_t>((totalFrames + BASE_FRAMES - 1) / BASE_FRAMES);
+    minimum.assign(count, std::numeric_limits<float>::infinity());
+    maximum.assign(count, -std::numeric_limits<float>::infinity());
+    energy.assign(count, 0.0);
+}
+
+void WaveformOverview::Builder::addFrames(uint64_t startFrame, const float* interleaved, size_t frames) {
+    const size_t stride = static_cast<size_t>(channels);
+    size_t done = 0;
+    while (done < frames) {
+        const uint64_t frame = startFrame + done;
+        const size_t peak = static_cast<size_t>(frame / BASE_FRAMES);
+        const size_t count = std::min(frames - done, BASE_FRAMES - static_cast<size_t>(frame % BASE_FRAMES));
+        if (peak >= minimum.size()) {
+            // Duração desconhecida: cresce em blocos para não realocar a cada pico
+            const size_t grown = std::max(peak + 1, minimum.size() * 2);
+            minimum.resize(grown, std::numeric_limits<float>::infinity());
+            maximum.resize(grown, -std::numeric_limits<float>::infinity());
+            energy.resize(grown, 0.0);
+        }
+
+        float low = minimum[peak];
+        float high = maximum[peak];
+        double sum = 0.0;
+        const float* samples = interleaved + done * stride;
+        for (size_t i = 0; i < count * stride; ++i) {
+            low = std::min(low, samples[i]);
+            high = std::max(high, samples[i]);
+            sum += static_cast<double>(samples[i]) * samples[i];
+        }
+        minimum[peak] = low;
+        maximum[peak] = high;
+        energy[peak] += sum;
+        done += count;
+    }
+}
+
+std::unique_ptr<WaveformOverview> WaveformOverview::Builder::build(int sampleRate, uint64_t totalFrames) const {
+    auto overview = std::make_unique<WaveformOverview>(sampleRate, channels, totalFrames);
+    const size_t levelCount = getLevelCountFor(totalFrames);
+    if (levelCount == 0) {
+        return overview;
+    }
+
+    // Nível atual em precisão total: mín, máx, energia média por amostra e quadros cobertos
+    size_t count = static_cast<size_t>((totalFrames + BASE_FRAMES - 1) / BASE_FRAMES);
+    std::vector<float> low(count);
+    std::vector<float> high(count);
+    std::vector<double> meanSquare(count);
+    std::vector<uint64_t> covered(count);
+    for (size_t i = 0; i < count; ++i) {
+        covered[i] = std::min<uint64_t>(BASE_FRAMES, totalFrames - static_cast<uint64_t>(i) * BASE_FRAMES);
+        const bool written = i < minimum.size() && minimum[i] <= maximum[i];
+        low[i] = written ? minimum[i] : 0.0f;
+        high[i] = written ? maximum[i] : 0.0f;
+        meanSquare[i] = written ? energy[i] / static_cast<double>(covered[i] * static_cast<uint64_t>(channels)) : 0.0;
+    }
+
+    size_t total = 0;
+    for (size_t level = 0, levelPeaks = count; level < levelCount; ++level) {
+        total += levelPeaks;
+        levelPeaks = (levelPeaks + FANOUT - 1) / FANOUT;
+    }
+    overview->peaks.resize(total);
+
+    size_t offset = 0;
+    for (size_t level = 0; level < levelCount; ++level) {
+        Peak* out = overview->peaks.data() + offset;
+        for (size_t i = 0; i < count; ++i) {
+            out[i].min = quantizeDown(low[i]);
+            out[i].max = quantizeUp(high[i]);
+            out[i].rms = static_cast<uint16_t>(std::min(std::round(std::sqrt(meanSquare[i]) * PEAK_SCALE), 65535.0));
+        }
+        overview->levelView.levels[level] = out;
+        overview->levelView.counts[level] = count;
+        offset += count;
+
+        // Próximo nível: FANOUT picos viram um (RMS ponderado pelos quadros cobertos)
+        const size_t parents = (count + FANOUT - 1) / FANOUT;
+        for (size_t p = 0; p < parents; ++p) {
+            const size_t first = p * FANOUT;
+            const size_t last = std::min(first + FANOUT, count);
+            float parentLow = low[first];
+            float parentHigh = high[first];
+            double weighted = 0.0;
+            uint64_t frames = 0;
+            for (size_t i = first; i < last; ++i) {
+                parentLow = std::min(parentLow, low[i]);
+                parentHigh = std::max(parentHigh, high[i]);
+                weighted += meanSquare[i] * static_cast<double>(covered[i]);
+                frames += covered[i];
+            }
+            low[p] = parentLow;
+            high[p] = parentHigh;
+            meanSquare[p] = frames > 0 ? weighted / static_cast<double>(frames) : 0.0;
+            covered[p] = frames;
+        }
+        count = parents;
+    }
+    overview->levelView.levelCount = levelCount;
+    return overview;
+}
+
+WaveformOverview::WaveformOverview(int rate, int channelCount, uint64_t frames)
+    : sampleRate(rate), channels(channelCount), totalFrames(frames) {}
+
+WaveformOverview::WaveformOverview(int rate, int channelCount, uint64_t frames, const View& external,
+                                   std::shared_ptr<const void> owner)
+    : sampleRate(rate), channels(channelCount), totalFrames(frames), levelView(external),
+      mappingOwner(std::move(owner)) {}
+
+size_t WaveformOverview::getLevelCountFor(uint64_t totalFrames) {
+    if (totalFrames == 0) {
+        return 0;
+    }
+    size_t levels = 1;
+    for (uint64_t count = (totalFrames + BASE_FRAMES - 1) / BASE_FRAMES; count > 1 && levels < MAX_LEVELS;
+         count = (count + FANOUT - 1) / FANOUT) {
+        ++levels;
+    }
+    return levels;
+}
+
+uint64_t WaveformOverview::getFramesPerPeak(size_t level) {
+    uint64_t frames = BASE_FRAMES;
+    for (size_t i = 0; i < level; ++i) {
+        frames *= FANOUT;
+    }
+    return frames;
+}
+
+size_t WaveformOverview::getMemoryUsage() const {
+    size_t count = 0;
+    for (size_t level = 0; level < levelView.levelCount; ++level) {
+        count += levelView.counts[level];
+    }
+    return count * sizeof(Peak);
+}
+
+size_t WaveformOverview::selectLevel(double framesPerColumn) const {
+    size_t level = 0;
+    while (level + 1 < levelView.levelCount && static_cast<double>(getFramesPerPeak(level + 1)) <= framesPerColumn) {
+        ++level;
+    }
+    return level;
+}
+
+size_t WaveformOverview::query(uint64_t startFrame, uint64_t endFrame, Column* columns, size_t count) const {
+    endFrame = std::min(endFrame, totalFrames);
+    if (!columns || count == 0 || levelView.levelCount == 0 || startFrame >= endFrame) {
+        return 0;
+    }
+    const uint64_t span = endFrame - startFrame;
+    const size_t level = selectLevel(static_cast<double>(span) / static_cast<double>(count));
+    const uint64_t framesPerPeak = getFramesPerPeak(level);
+    const Peak* levelPeaks = levelView.levels[level];
+    const size_t peakCount = levelView.counts[level];
+
+    // Cada coluna cobre no máximo ~2 * FANOUT picos do nível escolhido
+    for (size_t c = 0; c < count; ++c) {
+        const uint64_t begin = startFrame + span * c / count;
+        const uint64_t end = std::max(startFrame + span * (c + 1) / count, begin + 1);
+        const size_t first = static_cast<size_t>(begin / framesPerPeak);
+        const size_t last = std::min(static_cast<size_t>((end - 1) / framesPerPeak), peakCount - 1);
+        int low = levelPeaks[first].min;
+        int high = levelPeaks[first].max;
+        double energy = 0.0;
+        for (size_t i = first; i <= last; ++i) {
+            low = std::min<int>(low, levelPeaks[i].min);
+            high = std::max<int>(high, levelPeaks[i].max);
+            energy += static_cast<double>(levelPeaks[i].rms) * levelPeaks[i].rms;
+        }
+        columns[c].min = static_cast<float>(low) / PEAK_SCALE;
+        columns[c].max = static_cast<float>(high) / PEAK_SCALE;
+        columns[c].rms = static_cast<float>(std::sqrt(energy / static_cast<double>(last - first + 1)) / PEAK_SCALE);
+    }
+    return count;
+}
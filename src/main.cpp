@@ -1,7 +1,15 @@
 #include <iostream>
 #include <memory>
 #include <exception>
+#include <string>
 #include "CLI.h"
+#include "AudioSink.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
 
 /**
  * @file main.cpp
@@ -26,16 +34,69 @@
  * - Operator Overloading: Sobrecarga em classes como Track
  */
 
-int main() {
+namespace {
+
+void showUsage(const char* program) {
+    std::cout << "Uso: " << program << " [--sink <saída>] [--list-sinks]\n\n";
+    std::cout << "Saídas de áudio disponíveis:\n";
+    for (const auto& sink : AudioSink::getAvailableSinks()) {
+        std::cout << "  " << sink.first << "\n      " << sink.second << "\n";
+    }
+}
+
+// O áudio ocupa o stdout original (já duplicado pela saída); mensagens vão para o stderr
+void redirectConsoleToStderr() {
+    std::cout.flush();
+#ifndef _WIN32
+    ::dup2(STDERR_FILENO, STDOUT_FILENO);
+#else
+    _dup2(_fileno(stderr), _fileno(stdout));
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
     try {
+        // Opções de linha de comando: escolha da saída de áudio antes de qualquer mensagem
+        std::unique_ptr<AudioSink> sink;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            std::string spec;
+            if (arg == "--help" || arg == "-h" || arg == "--list-sinks") {
+                showUsage(argv[0]);
+                return 0;
+            } else if (arg == "--sink" && i + 1 < argc) {
+                spec = argv[++i];
+            } else if (arg.rfind("--sink=", 0) == 0) {
+                spec = arg.substr(7);
+            } else {
+                std::cerr << "Opção desconhecida: " << arg << "\n";
+                showUsage(argv[0]);
+                return 1;
+            }
+            sink = AudioSink::createFromSpec(spec);
+            if (!sink) {
+                std::cerr << "Saída de áudio inválida ou indisponível neste build: " << spec << "\n";
+                return 1;
+            }
+        }
+        if (dynamic_cast<StdoutAudioSink*>(sink.get())) {
+            redirectConsoleToStderr();
+        }
+
         // Mostrar informações do sistema
         std::cout << "MP3 Player - Sistema de Música Avançado\n";
         std::cout << "Programação Orientada a Objetos - Etapa 2\n";
         std::cout << "Universidade - 2024\n";
         std::cout << "Compilado com C++17\n\n";
         
-        // Criar e executar interface CLI
-        auto cli = std::make_unique<CLI>();
+        // Criar e executar interface CLI (saída padrão do player se nenhuma foi escolhida)
+        auto app = std::make_unique<MP3PlayerApp>();
+        if (sink) {
+            app->getPlayer()->setAudioSink(std::move(sink));
+        }
+        auto cli = std::make_unique<CLI>(std::move(app));
         cli->run();
         
         return 0;